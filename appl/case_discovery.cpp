@@ -0,0 +1,488 @@
+/*
+   Copyright 2022 Equinor ASA.
+
+   This file is part of the Open Porous Media project (OPM).
+
+   OPM is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   OPM is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#include <appl/case_discovery.hpp>
+
+#include <omp.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <set>
+
+#include <fnmatch.h>
+
+
+namespace {
+
+// directory levels below a directory argument, limits the walk if symlinks make a loop
+
+const int max_scan_depth = 32;
+
+bool is_summary_file(const std::filesystem::path& fname)
+{
+    auto ext = fname.extension();
+    return (ext == ".SMSPEC") || (ext == ".FSMSPEC") || (ext == ".ESMRY");
+}
+
+bool is_digit(char c)
+{
+    return (c >= '0') && (c <= '9');
+}
+
+bool has_wildcard(const std::string& str)
+{
+    return str.find_first_of("*?[") != std::string::npos;
+}
+
+std::string trim(const std::string& str)
+{
+    auto p1 = str.find_first_not_of(" \t\r");
+
+    if (p1 == std::string::npos)
+        return "";
+
+    auto p2 = str.find_last_not_of(" \t\r");
+    return str.substr(p1, p2 - p1 + 1);
+}
+
+int32_t read_int(const char* p)
+{
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return static_cast<int32_t>(__builtin_bswap32(v));
+}
+
+// binary array header, one record with name (8 characters), number of items and type
+
+bool read_header(std::ifstream& ifs, std::string& name, size_t& count, std::string& type)
+{
+    char buf[24];
+
+    if (!ifs.read(buf, sizeof(buf)))
+        return false;
+
+    if ((read_int(buf) != 16) || (read_int(buf + 20) != 16))
+        return false;
+
+    name = trim(std::string(buf + 4, 8));
+    count = static_cast<size_t>(read_int(buf + 12));
+    type = std::string(buf + 16, 4);
+
+    return true;
+}
+
+// unified summary file with at least one complete PARAMS array. Only the arrays
+// before the first PARAMS array are read (SEQHDR and MINISTEP)
+
+bool has_summary_data(const std::filesystem::path& unsmry_file)
+{
+    std::error_code ec;
+    size_t file_size = std::filesystem::file_size(unsmry_file, ec);
+
+    if (ec)
+        return false;
+
+    std::ifstream ifs(unsmry_file, std::ios::binary);
+
+    std::string name, type;
+    size_t count;
+
+    for (int n = 0; (n < 3) && read_header(ifs, name, count, type); n++) {
+
+        if ((type != "INTE") && (type != "REAL"))
+            return false;
+
+        // data in blocks of 1000 items with 8 bytes record markers
+
+        size_t data_size = count * 4 + ((count + 999) / 1000) * 8;
+        size_t data_pos = static_cast<size_t>(ifs.tellg());
+
+        if (name == "PARAMS")
+            return data_pos + data_size <= file_size;
+
+        ifs.seekg(data_size, std::ios::cur);
+    }
+
+    return false;
+}
+
+bool is_complete_run(const std::filesystem::path& fname)
+{
+    std::string name, type;
+    size_t count;
+
+    auto ext = fname.extension();
+
+    if (ext == ".FSMSPEC") {
+        auto funsmry_file = fname;
+        funsmry_file.replace_extension(".FUNSMRY");
+
+        std::error_code ec;
+        return std::filesystem::file_size(funsmry_file, ec) > 0 && !ec;
+    }
+
+    std::ifstream ifs(fname, std::ios::binary);
+
+    if (!read_header(ifs, name, count, type))
+        return false;
+
+    if (ext == ".ESMRY")
+        return name == "START";
+
+    auto unsmry_file = fname;
+    unsmry_file.replace_extension(".UNSMRY");
+
+    return has_summary_data(unsmry_file);
+}
+
+// one case for each root name, SMSPEC preferred over ESMRY and FSMSPEC
+
+int file_rank(const std::filesystem::path& fname)
+{
+    if (fname.extension() == ".SMSPEC")
+        return 0;
+    else if (fname.extension() == ".ESMRY")
+        return 1;
+
+    return 2;
+}
+
+} // anonymous namespace
+
+
+bool natural_less(const std::string& a, const std::string& b)
+{
+    size_t i = 0;
+    size_t j = 0;
+
+    while ((i < a.size()) && (j < b.size())) {
+
+        if (is_digit(a[i]) && is_digit(b[j])) {
+
+            size_t i1 = i;
+            size_t j1 = j;
+
+            while ((i1 < a.size()) && (a[i1] == '0'))
+                i1++;
+
+            while ((j1 < b.size()) && (b[j1] == '0'))
+                j1++;
+
+            size_t i2 = i1;
+            size_t j2 = j1;
+
+            while ((i2 < a.size()) && is_digit(a[i2]))
+                i2++;
+
+            while ((j2 < b.size()) && is_digit(b[j2]))
+                j2++;
+
+            if (i2 - i1 != j2 - j1)
+                return i2 - i1 < j2 - j1;
+
+            int c = a.compare(i1, i2 - i1, b, j1, j2 - j1);
+
+            if (c != 0)
+                return c < 0;
+
+            i = i2;
+            j = j2;
+
+        } else {
+
+            if (a[i] != b[j])
+                return a[i] < b[j];
+
+            i++;
+            j++;
+        }
+    }
+
+    return (a.size() - i) < (b.size() - j);
+}
+
+
+void CaseDiscovery::add_argument(const std::string& arg)
+{
+    m_arguments.push_back(arg);
+}
+
+
+void CaseDiscovery::add_cases_from(const std::filesystem::path& list_file)
+{
+    std::ifstream ifs(list_file);
+
+    if (!ifs)
+        throw std::runtime_error("Error opening case list file " + list_file.string());
+
+    m_discovery_used = true;
+
+    // relative paths are relative to the folder of the list file
+
+    auto folder = list_file.parent_path();
+
+    std::string line;
+
+    while (std::getline(ifs, line)) {
+
+        line = trim(line);
+
+        if ((line.size() == 0) || (line[0] == '#'))
+            continue;
+
+        std::filesystem::path fname(line);
+
+        if (fname.is_relative() && !folder.empty())
+            fname = folder / fname;
+
+        m_arguments.push_back(fname.string());
+    }
+}
+
+
+std::vector<std::filesystem::path> CaseDiscovery::scan_directory(const std::filesystem::path& dir)
+{
+    std::vector<std::filesystem::path> found;
+    std::vector<std::filesystem::path> level = { dir };
+
+    for (int depth = 0; (depth < max_scan_depth) && (level.size() > 0); depth++) {
+
+        std::vector<std::vector<std::filesystem::path>> sub_dirs(level.size());
+        std::vector<std::vector<std::filesystem::path>> files(level.size());
+
+        #pragma omp parallel for schedule(dynamic) num_threads(m_max_threads)
+        for (size_t n = 0; n < level.size(); n++) {
+
+            std::error_code ec;
+            auto opts = std::filesystem::directory_options::skip_permission_denied;
+
+            for (auto it = std::filesystem::directory_iterator(level[n], opts, ec);
+                 !ec && (it != std::filesystem::directory_iterator()); it.increment(ec)) {
+
+                std::error_code entry_ec;
+
+                if (it->is_directory(entry_ec))
+                    sub_dirs[n].push_back(it->path());
+                else if (is_summary_file(it->path()))
+                    files[n].push_back(it->path());
+            }
+        }
+
+        m_dirs_scanned += level.size();
+
+        level.clear();
+
+        for (size_t n = 0; n < files.size(); n++) {
+            found.insert(found.end(), files[n].begin(), files[n].end());
+            level.insert(level.end(), sub_dirs[n].begin(), sub_dirs[n].end());
+        }
+    }
+
+    return found;
+}
+
+
+std::vector<std::filesystem::path> CaseDiscovery::expand_pattern(const std::string& pattern)
+{
+    std::filesystem::path pattern_path(pattern);
+
+    std::vector<std::filesystem::path> current = { pattern_path.root_path() };
+
+    // matches for one path component at the time, directories matched in parallel
+
+    for (auto& component : pattern_path.relative_path()) {
+
+        std::string comp_str = component.string();
+
+        if (!has_wildcard(comp_str)) {
+            for (auto& fname : current)
+                fname /= component;
+
+            continue;
+        }
+
+        std::vector<std::vector<std::filesystem::path>> matches(current.size());
+
+        #pragma omp parallel for schedule(dynamic) num_threads(m_max_threads)
+        for (size_t n = 0; n < current.size(); n++) {
+
+            std::error_code ec;
+            auto dir = current[n].empty() ? std::filesystem::path(".") : current[n];
+            auto opts = std::filesystem::directory_options::skip_permission_denied;
+
+            for (auto it = std::filesystem::directory_iterator(dir, opts, ec);
+                 !ec && (it != std::filesystem::directory_iterator()); it.increment(ec)) {
+
+                std::string name = it->path().filename().string();
+
+                if (fnmatch(comp_str.c_str(), name.c_str(), FNM_PERIOD) == 0)
+                    matches[n].push_back(current[n] / name);
+            }
+        }
+
+        m_dirs_scanned += current.size();
+
+        current.clear();
+
+        for (auto& match_list : matches)
+            current.insert(current.end(), match_list.begin(), match_list.end());
+    }
+
+    // matched directories are searched for summary files
+
+    std::vector<std::filesystem::path> found;
+
+    for (auto& fname : current) {
+        std::error_code ec;
+
+        if (std::filesystem::is_directory(fname, ec)) {
+            auto dir_files = this->scan_directory(fname);
+            found.insert(found.end(), dir_files.begin(), dir_files.end());
+        } else if (is_summary_file(fname) && std::filesystem::exists(fname, ec)) {
+            found.push_back(fname);
+        }
+    }
+
+    return found;
+}
+
+
+std::vector<std::string> CaseDiscovery::find_cases()
+{
+    // file name and true if discovered from directory or pattern
+
+    std::vector<std::pair<std::string, bool>> candidates;
+
+    for (auto& arg : m_arguments) {
+
+        std::filesystem::path fname(arg);
+        std::error_code ec;
+
+        std::vector<std::filesystem::path> found;
+
+        if (has_wildcard(arg) && !std::filesystem::exists(fname, ec))
+            found = this->expand_pattern(arg);
+        else if (std::filesystem::is_directory(fname, ec))
+            found = this->scan_directory(fname);
+        else {
+
+            // summary file or root name
+
+            std::string file_arg = arg;
+            std::string ext = fname.extension().string();
+
+            auto l = file_arg.size();
+
+            if ((ext != ".SMSPEC") && (ext != ".FSMSPEC") && (ext != ".ESMRY")) {
+
+                if (file_arg.substr(l-1) == ".")
+                    file_arg = file_arg + "SMSPEC";
+                else if (file_arg.size() <  7)
+                    file_arg = file_arg + ".SMSPEC";
+                else if (file_arg.substr(l-7) != ".SMSPEC")
+                    file_arg = file_arg + ".SMSPEC";
+            }
+
+            l = file_arg.size();
+
+            if (file_arg.substr(l-7) == ".SMSPEC"){
+                std::string unsmry_str = file_arg.substr(0, l-7) + ".UNSMRY";
+                std::filesystem::path unsmry_file(unsmry_str);
+
+                if (std::filesystem::exists(unsmry_file))
+                    candidates.push_back({ file_arg, false });
+                else
+                    m_skipped.push_back(file_arg);
+
+            } else
+                candidates.push_back({ file_arg, false });
+
+            continue;
+        }
+
+        m_discovery_used = true;
+
+        std::sort(found.begin(), found.end(), [](const std::filesystem::path& a, const std::filesystem::path& b) {
+            auto root_a = a.parent_path() / a.stem();
+            auto root_b = b.parent_path() / b.stem();
+
+            if (root_a != root_b)
+                return natural_less(root_a.string(), root_b.string());
+
+            return file_rank(a) < file_rank(b);
+        });
+
+        for (size_t n = 0; n < found.size(); n++)
+            if ((n == 0) || (found[n].parent_path() / found[n].stem() != found[n-1].parent_path() / found[n-1].stem()))
+                candidates.push_back({ found[n].string(), true });
+    }
+
+    // headers of discovered cases checked in parallel
+
+    std::vector<char> complete(candidates.size(), 1);
+
+    #pragma omp parallel for schedule(dynamic) num_threads(m_max_threads)
+    for (size_t n = 0; n < candidates.size(); n++)
+        if (candidates[n].second)
+            complete[n] = is_complete_run(candidates[n].first) ? 1 : 0;
+
+    // cases discovered more than once are only used first time
+
+    std::vector<std::string> cases;
+    std::set<std::filesystem::path> case_set;
+
+    for (size_t n = 0; n < candidates.size(); n++) {
+
+        std::error_code ec;
+        auto abs_path = std::filesystem::absolute(candidates[n].first, ec).lexically_normal();
+
+        if (candidates[n].second && (case_set.count(abs_path) > 0))
+            continue;
+
+        if (complete[n] == 0) {
+            m_skipped.push_back(candidates[n].first);
+            continue;
+        }
+
+        case_set.insert(abs_path);
+        cases.push_back(candidates[n].first);
+    }
+
+    m_num_cases = cases.size();
+
+    return cases;
+}
+
+
+void CaseDiscovery::print_summary(double elapsed) const
+{
+    const size_t max_skipped_print = 10;
+
+    std::cout << "\nCase discovery: " << m_num_cases << " cases, " << m_dirs_scanned << " directories scanned, "
+              << m_skipped.size() << " incomplete runs skipped, elapsed " << elapsed;
+
+    for (size_t n = 0; (n < m_skipped.size()) && (n < max_skipped_print); n++)
+        std::cout << "\n   skipped: " << m_skipped[n];
+
+    if (m_skipped.size() > max_skipped_print)
+        std::cout << "\n   ... " << m_skipped.size() - max_skipped_print << " more";
+
+    std::cout << std::endl;
+}
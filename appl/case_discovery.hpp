@@ -0,0 +1,77 @@
+/*
+   Copyright 2022 Equinor ASA.
+
+   This file is part of the Open Porous Media project (OPM).
+
+   OPM is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   OPM is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#ifndef SMRY_APPL_CASE_DISCOVERY_HPP
+#define SMRY_APPL_CASE_DISCOVERY_HPP
+
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+
+// Summary cases from command line arguments. An argument is a summary file or root name,
+// a directory searched recursively for summary files, or a glob pattern with wildcards in
+// any path component, e.g. realization-*/iter-*/eclipse/model/*.SMSPEC. Directories and
+// patterns are expanded level by level, with the directories in one level listed in
+// parallel. Discovered cases are checked in parallel from the file headers, and runs
+// without summary data are skipped. Explicit file arguments are used as before.
+
+class CaseDiscovery
+{
+public:
+
+    explicit CaseDiscovery(int max_threads = 16) : m_max_threads(max_threads) {}
+
+    void add_argument(const std::string& arg);
+
+    // one argument on each line, empty lines and lines starting with # are ignored
+    void add_cases_from(const std::filesystem::path& list_file);
+
+    // cases in argument order. Cases found in directories and patterns are in natural
+    // order (realization-2 before realization-10), one case for each root name
+    std::vector<std::string> find_cases();
+
+    bool discovery_used() const { return m_discovery_used; }
+
+    size_t number_of_cases() const { return m_num_cases; }
+    size_t directories_scanned() const { return m_dirs_scanned; }
+    const std::vector<std::string>& skipped() const { return m_skipped; }
+
+    void print_summary(double elapsed) const;
+
+private:
+
+    int m_max_threads;
+
+    std::vector<std::string> m_arguments;
+
+    bool m_discovery_used = false;
+    size_t m_num_cases = 0;
+    size_t m_dirs_scanned = 0;
+    std::vector<std::string> m_skipped;
+
+    std::vector<std::filesystem::path> scan_directory(const std::filesystem::path& dir);
+    std::vector<std::filesystem::path> expand_pattern(const std::string& pattern);
+};
+
+
+// a < b with digit sequences compared as numbers
+bool natural_less(const std::string& a, const std::string& b);
+
+#endif // SMRY_APPL_CASE_DISCOVERY_HPP
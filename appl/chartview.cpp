@@ -66,18 +66,22 @@ void ChartView::keyPressEvent(QKeyEvent *event)
 
 void ChartView::resizeEvent(QResizeEvent *event)
 {
-    if (scene()) {
-         scene()->setSceneRect(QRect(QPoint(0, 0), event->size()));
-         m_chart->resize(event->size());
-    }
+    resize_scene(event->size());
 
     QGraphicsView::resizeEvent(event);
 }
 
+void ChartView::resize_scene(const QSize& size)
+{
+    if (scene()) {
+         scene()->setSceneRect(QRect(QPoint(0, 0), size));
+         m_chart->resize(size);
+    }
+}
+
 
-void ChartView::set_xaxis_ticks(const std::vector<std::tuple<std::string, double>>& xaxis_ticks)
+void ChartView::set_xaxis_ticks(const XaxisTicks::tick_list_type& xaxis_ticks)
 {
-    m_xaxis_ticks = xaxis_ticks;
     m_xaxis_obj->set_xaxis_ticks(xaxis_ticks);
 }
 
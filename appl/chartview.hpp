@@ -32,8 +32,9 @@ public:
 
     ChartView(QChart *chart, QWidget *parent = 0);
 
-    void set_xaxis_ticks(const std::vector<std::tuple<std::string, double>>& xaxis_ticks);
+    void set_xaxis_ticks(const XaxisTicks::tick_list_type& xaxis_ticks);
     void update_geometry();
+    void resize_scene(const QSize& size);
 
     void update_graphics();
     void hide_xaxis_obj();
@@ -52,7 +53,6 @@ private:
     QChart *m_chart;
 
     XaxisTicks *m_xaxis_obj;
-    std::vector<std::tuple<std::string, double>> m_xaxis_ticks;
 };
 
 #endif
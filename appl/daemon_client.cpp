@@ -0,0 +1,424 @@
+/*
+   Copyright 2022 Equinor ASA.
+
+   This file is part of the Open Porous Media project (OPM).
+
+   OPM is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   OPM is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#include <appl/daemon_client.hpp>
+
+#include <chrono>
+#include <cerrno>
+
+#include <fnmatch.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+
+namespace DaemonProtocol {
+
+void Writer::put_string(const std::string& str)
+{
+    put(static_cast<uint32_t>(str.size()));
+    m_payload.append(str);
+}
+
+void Writer::put_floats(const std::vector<float>& values)
+{
+    put(static_cast<uint64_t>(values.size()));
+    m_payload.append(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(float));
+}
+
+std::string Writer::frame(uint8_t type) const
+{
+    std::string frame;
+    frame.reserve(m_payload.size() + 9);
+
+    uint64_t size = m_payload.size() + 1;
+
+    frame.append(reinterpret_cast<const char*>(&size), sizeof(size));
+    frame.push_back(static_cast<char>(type));
+    frame.append(m_payload);
+
+    return frame;
+}
+
+void Reader::check(size_t n) const
+{
+    if (m_pos + n > m_size)
+        throw std::runtime_error("truncated message from summary daemon");
+}
+
+std::string Reader::get_string()
+{
+    size_t len = get<uint32_t>();
+    check(len);
+
+    std::string str(m_data + m_pos, len);
+    m_pos += len;
+
+    return str;
+}
+
+std::vector<float> Reader::get_floats()
+{
+    uint64_t n = get<uint64_t>();
+    check(n * sizeof(float));
+
+    std::vector<float> values(n);
+    std::memcpy(values.data(), m_data + m_pos, n * sizeof(float));
+    m_pos += n * sizeof(float);
+
+    return values;
+}
+
+size_t frame_length(const std::string& buffer)
+{
+    if (buffer.size() < sizeof(uint64_t))
+        return 0;
+
+    uint64_t size;
+    std::memcpy(&size, buffer.data(), sizeof(size));
+
+    if ((size == 0) || (size > max_frame_size))
+        throw std::runtime_error("invalid frame size " + std::to_string(size) + " in summary daemon message");
+
+    if (buffer.size() - sizeof(uint64_t) < size)
+        return 0;
+
+    return size + sizeof(uint64_t);
+}
+
+void CaseInfo::write(Writer& writer) const
+{
+    writer.put<uint8_t>(updated ? 1 : 0);
+    writer.put<uint32_t>(case_id);
+    writer.put<uint32_t>(generation);
+    writer.put_string(rootname);
+    writer.put<int64_t>(startdate_msec);
+
+    for (auto v : start_date)
+        writer.put<int32_t>(v);
+
+    writer.put<int32_t>(num_steps);
+    writer.put<uint8_t>(all_steps_available ? 1 : 0);
+    writer.put<uint32_t>(static_cast<uint32_t>(keys.size()));
+
+    for (size_t n = 0; n < keys.size(); n++) {
+        writer.put_string(keys[n]);
+        writer.put_string(units[n]);
+    }
+
+    writer.put<uint32_t>(static_cast<uint32_t>(report_step_index.size()));
+
+    for (auto t : report_step_index)
+        writer.put<uint32_t>(static_cast<uint32_t>(t));
+}
+
+CaseInfo CaseInfo::read(Reader& reader)
+{
+    CaseInfo info;
+
+    info.updated = reader.get<uint8_t>() != 0;
+    info.case_id = reader.get<uint32_t>();
+    info.generation = reader.get<uint32_t>();
+    info.rootname = reader.get_string();
+    info.startdate_msec = reader.get<int64_t>();
+
+    for (auto& v : info.start_date)
+        v = reader.get<int32_t>();
+
+    info.num_steps = reader.get<int32_t>();
+    info.all_steps_available = reader.get<uint8_t>() != 0;
+
+    size_t num_keys = reader.get<uint32_t>();
+
+    info.keys.reserve(num_keys);
+    info.units.reserve(num_keys);
+
+    for (size_t n = 0; n < num_keys; n++) {
+        info.keys.push_back(reader.get_string());
+        info.units.push_back(reader.get_string());
+    }
+
+    size_t num_rsteps = reader.get<uint32_t>();
+
+    for (size_t n = 0; n < num_rsteps; n++)
+        info.report_step_index.push_back(reader.get<uint32_t>());
+
+    return info;
+}
+
+} // namespace DaemonProtocol
+
+
+std::filesystem::path daemon_socket_path(const std::string& name)
+{
+    if (name.find('/') != std::string::npos)
+        return std::filesystem::path(name);
+
+    return std::filesystem::temp_directory_path() / name;
+}
+
+
+SmryDaemonClient::SmryDaemonClient(const std::string& name) :
+    m_socket_path(daemon_socket_path(name))
+{
+}
+
+SmryDaemonClient::~SmryDaemonClient()
+{
+    if (m_fd >= 0)
+        ::close(m_fd);
+}
+
+bool SmryDaemonClient::connect()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_fd >= 0)
+        return true;
+
+    sockaddr_un addr {};
+    addr.sun_family = AF_UNIX;
+
+    std::string path = m_socket_path.string();
+
+    if (path.size() >= sizeof(addr.sun_path))
+        return false;
+
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+    m_fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if (m_fd < 0)
+        return false;
+
+    if (::connect(m_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        ::close(m_fd);
+        m_fd = -1;
+        return false;
+    }
+
+    return true;
+}
+
+void SmryDaemonClient::write_all(const char* data, size_t size)
+{
+    while (size > 0) {
+        ssize_t n = ::send(m_fd, data, size, MSG_NOSIGNAL);
+
+        if ((n < 0) && (errno == EINTR))
+            continue;
+
+        if (n <= 0)
+            throw std::runtime_error("connection to summary daemon lost");
+
+        data += n;
+        size -= n;
+    }
+}
+
+void SmryDaemonClient::read_all(char* data, size_t size)
+{
+    while (size > 0) {
+        ssize_t n = ::recv(m_fd, data, size, 0);
+
+        if ((n < 0) && (errno == EINTR))
+            continue;
+
+        if (n <= 0)
+            throw std::runtime_error("connection to summary daemon lost");
+
+        data += n;
+        size -= n;
+    }
+}
+
+std::string SmryDaemonClient::request(const std::string& frame, uint8_t reply_type)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_fd < 0)
+        throw std::runtime_error("not connected to summary daemon");
+
+    write_all(frame.data(), frame.size());
+
+    uint64_t size;
+    read_all(reinterpret_cast<char*>(&size), sizeof(size));
+
+    if ((size == 0) || (size > DaemonProtocol::max_frame_size))
+        throw std::runtime_error("invalid frame size " + std::to_string(size) + " from summary daemon");
+
+    std::string reply(size, '\0');
+    read_all(reply.data(), size);
+
+    uint8_t type = static_cast<uint8_t>(reply[0]);
+    reply.erase(0, 1);
+
+    if (type == DaemonProtocol::error) {
+        DaemonProtocol::Reader reader(reply.data(), reply.size());
+        throw std::runtime_error("summary daemon: " + reader.get_string());
+    }
+
+    if (type != reply_type)
+        throw std::runtime_error("unexpected message type " + std::to_string(type) + " from summary daemon");
+
+    return reply;
+}
+
+DaemonProtocol::CaseInfo SmryDaemonClient::open(const std::filesystem::path& smry_file)
+{
+    DaemonProtocol::Writer writer;
+    writer.put_string(std::filesystem::absolute(smry_file).lexically_normal().string());
+
+    std::string reply = request(writer.frame(DaemonProtocol::open), DaemonProtocol::case_info);
+    DaemonProtocol::Reader reader(reply.data(), reply.size());
+
+    return DaemonProtocol::CaseInfo::read(reader);
+}
+
+std::vector<std::vector<float>> SmryDaemonClient::load(uint32_t case_id, const std::vector<std::string>& keys)
+{
+    DaemonProtocol::Writer writer;
+    writer.put<uint32_t>(case_id);
+    writer.put<uint32_t>(static_cast<uint32_t>(keys.size()));
+
+    for (auto& key : keys)
+        writer.put_string(key);
+
+    std::string reply = request(writer.frame(DaemonProtocol::load), DaemonProtocol::data);
+    DaemonProtocol::Reader reader(reply.data(), reply.size());
+
+    std::vector<std::vector<float>> data;
+    data.reserve(keys.size());
+
+    for (size_t n = 0; n < keys.size(); n++)
+        data.push_back(reader.get_floats());
+
+    return data;
+}
+
+DaemonProtocol::CaseInfo SmryDaemonClient::reopen(uint32_t case_id, uint32_t generation)
+{
+    DaemonProtocol::Writer writer;
+    writer.put<uint32_t>(case_id);
+    writer.put<uint32_t>(generation);
+
+    std::string reply = request(writer.frame(DaemonProtocol::reopen), DaemonProtocol::case_info);
+    DaemonProtocol::Reader reader(reply.data(), reply.size());
+
+    return DaemonProtocol::CaseInfo::read(reader);
+}
+
+
+DaemonSource::DaemonSource(std::shared_ptr<SmryDaemonClient> client, const std::filesystem::path& smry_file) :
+    SummarySource(smry_file), m_client(client)
+{
+    auto start = std::chrono::system_clock::now();
+
+    this->set_info(m_client->open(smry_file));
+
+    std::chrono::duration<double> elapsed = std::chrono::system_clock::now() - start;
+    m_open_elapsed = elapsed.count();
+}
+
+void DaemonSource::set_info(DaemonProtocol::CaseInfo&& info)
+{
+    m_info = std::move(info);
+
+    m_index.clear();
+
+    for (size_t n = 0; n < m_info.keys.size(); n++)
+        m_index[m_info.keys[n]] = n;
+
+    m_data.clear();
+}
+
+std::vector<std::string> DaemonSource::keyword_list(const std::string& pattern) const
+{
+    std::vector<std::string> key_list;
+
+    for (auto& key : m_info.keys)
+        if (fnmatch(pattern.c_str(), key.c_str(), 0) == 0)
+            key_list.push_back(key);
+
+    return key_list;
+}
+
+std::string DaemonSource::get_unit(const std::string& key) const
+{
+    auto it = m_index.find(key);
+
+    if (it == m_index.end())
+        throw std::invalid_argument("key " + key + " not found in " + m_info.rootname);
+
+    return m_info.units[it->second];
+}
+
+SummarySource::time_point DaemonSource::startdate() const
+{
+    return time_point(std::chrono::milliseconds(m_info.startdate_msec));
+}
+
+void DaemonSource::load_keys(const std::vector<std::string>& keys) const
+{
+    std::vector<std::string> load_list;
+
+    for (auto& key : keys)
+        if ((m_data.count(key) == 0) && (m_index.count(key) > 0))
+            load_list.push_back(key);
+
+    if (load_list.size() == 0)
+        return;
+
+    auto start = std::chrono::system_clock::now();
+
+    auto data = m_client->load(m_info.case_id, load_list);
+
+    for (size_t n = 0; n < load_list.size(); n++)
+        m_data[load_list[n]] = std::move(data[n]);
+
+    std::chrono::duration<double> elapsed = std::chrono::system_clock::now() - start;
+    m_load_elapsed += elapsed.count();
+}
+
+void DaemonSource::load(const std::vector<std::string>& keys)
+{
+    this->load_keys(keys);
+}
+
+const std::vector<float>& DaemonSource::get(const std::string& key) const
+{
+    if (m_index.count(key) == 0)
+        throw std::invalid_argument("key " + key + " not found in " + m_info.rootname);
+
+    this->load_keys({ key });
+
+    return m_data.at(key);
+}
+
+bool DaemonSource::reopen()
+{
+    auto info = m_client->reopen(m_info.case_id, m_info.generation);
+
+    if (!info.updated)
+        return false;
+
+    this->set_info(std::move(info));
+    this->update_file_stamp();
+
+    return true;
+}
@@ -0,0 +1,223 @@
+/*
+   Copyright 2022 Equinor ASA.
+
+   This file is part of the Open Porous Media project (OPM).
+
+   OPM is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   OPM is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#ifndef SMRY_APPL_DAEMON_CLIENT_HPP
+#define SMRY_APPL_DAEMON_CLIENT_HPP
+
+#include <appl/summary_source.hpp>
+
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+// Messages between qsummary and the summary daemon (see smry_daemon.hpp) over a Unix domain
+// socket. Client and daemon run on the same host, numbers are in native byte order.
+//
+//   frame   : uint64 size (number of bytes after this field), uint8 type, payload
+//   string  : uint32 length, characters
+//
+//   OPEN    : type 1, string absolute file name                      -> CASE
+//   LOAD    : type 2, uint32 case id, uint32 n, n strings keys        -> DATA
+//   REOPEN  : type 3, uint32 case id, uint32 generation known by client -> CASE
+//
+//   CASE    : type 10, uint8 updated, uint32 case id, uint32 generation, string root name,
+//             int64 start date (ms since epoch), int32 x 7 start date, int32 time steps,
+//             uint8 all steps available, uint32 n, n times string key + string unit,
+//             uint32 m, m uint32 report step index (see SummarySource::report_step_index)
+//   DATA    : type 11, for each key in request uint64 n + n float32
+//   ERROR   : type 12, string message
+//
+// The generation is incremented each time the daemon reopens a case, all clients see the update.
+
+namespace DaemonProtocol {
+
+enum MessageType : uint8_t { open = 1, load = 2, reopen = 3, case_info = 10, data = 11, error = 12 };
+
+// frames larger than this are treated as a corrupt stream
+const uint64_t max_frame_size = uint64_t(1) << 36;
+
+class Writer {
+
+public:
+
+    template <typename T>
+    void put(T value) { m_payload.append(reinterpret_cast<const char*>(&value), sizeof(T)); }
+
+    void put_string(const std::string& str);
+    void put_floats(const std::vector<float>& values);
+
+    // size and type added in front of the payload
+    std::string frame(uint8_t type) const;
+
+private:
+
+    std::string m_payload;
+};
+
+
+// throws std::runtime_error when reading past the end of the payload
+
+class Reader {
+
+public:
+
+    Reader(const char* data, size_t size) : m_data(data), m_size(size) {}
+
+    template <typename T>
+    T get()
+    {
+        check(sizeof(T));
+
+        T value;
+        std::memcpy(&value, m_data + m_pos, sizeof(T));
+        m_pos += sizeof(T);
+
+        return value;
+    }
+
+    std::string get_string();
+    std::vector<float> get_floats();
+
+private:
+
+    const char* m_data;
+    size_t m_size;
+    size_t m_pos = 0;
+
+    void check(size_t n) const;
+};
+
+// length of the first frame in buffer including the size field, 0 if not complete
+size_t frame_length(const std::string& buffer);
+
+struct CaseInfo {
+
+    bool updated = false;
+    uint32_t case_id = 0;
+    uint32_t generation = 0;
+    std::string rootname;
+    int64_t startdate_msec = 0;
+    std::array<int, 7> start_date {};
+    int num_steps = 0;
+    bool all_steps_available = true;
+    std::vector<std::string> keys;
+    std::vector<std::string> units;
+    std::vector<size_t> report_step_index;
+
+    void write(Writer& writer) const;
+    static CaseInfo read(Reader& reader);
+};
+
+} // namespace DaemonProtocol
+
+
+// socket file for a daemon name, names without a path are placed in the temp folder
+// (same location as QLocalServer uses)
+std::filesystem::path daemon_socket_path(const std::string& name);
+
+
+// Blocking connection to the daemon. Requests are serialized, sources opened through the same
+// client can be loaded from different threads
+
+class SmryDaemonClient {
+
+public:
+
+    explicit SmryDaemonClient(const std::string& name);
+    ~SmryDaemonClient();
+
+    // false if no daemon is running with this name
+    bool connect();
+    bool connected() const { return m_fd >= 0; }
+
+    // throws std::runtime_error if the daemon reports an error, or the connection is lost
+    DaemonProtocol::CaseInfo open(const std::filesystem::path& smry_file);
+    std::vector<std::vector<float>> load(uint32_t case_id, const std::vector<std::string>& keys);
+    DaemonProtocol::CaseInfo reopen(uint32_t case_id, uint32_t generation);
+
+private:
+
+    std::filesystem::path m_socket_path;
+    int m_fd = -1;
+
+    std::mutex m_mutex;
+
+    std::string request(const std::string& frame, uint8_t reply_type);
+
+    void write_all(const char* data, size_t size);
+    void read_all(char* data, size_t size);
+};
+
+
+// Case served by the daemon, vectors are copied from the daemon when first used
+
+class DaemonSource : public SummarySource {
+
+public:
+
+    DaemonSource(std::shared_ptr<SmryDaemonClient> client, const std::filesystem::path& smry_file);
+
+    FileType file_type() const override { return FileType::REMOTE; }
+    std::string rootname() const override { return m_info.rootname; }
+
+    bool has_key(const std::string& key) const override { return m_index.count(key) > 0; }
+    std::vector<std::string> keyword_list() const override { return m_info.keys; }
+    std::vector<std::string> keyword_list(const std::string& pattern) const override;
+    std::string get_unit(const std::string& key) const override;
+    bool all_steps_available() const override { return m_info.all_steps_available; }
+    int number_of_time_steps() const override { return m_info.num_steps; }
+
+    time_point startdate() const override;
+    std::array<int, 7> start_date() const override { return m_info.start_date; }
+
+    std::tuple<double, double> io_elapsed() const override { return { m_open_elapsed, m_load_elapsed }; }
+
+    void load(const std::vector<std::string>& keys) override;
+    const std::vector<float>& get(const std::string& key) const override;
+
+    bool reopen() override;
+
+protected:
+
+    // report steps from the daemon, no data is loaded
+    std::vector<size_t> make_report_step_index() const override { return m_info.report_step_index; }
+
+private:
+
+    std::shared_ptr<SmryDaemonClient> m_client;
+
+    DaemonProtocol::CaseInfo m_info;
+    std::unordered_map<std::string, size_t> m_index;
+
+    mutable std::unordered_map<std::string, std::vector<float>> m_data;
+
+    double m_open_elapsed = 0.0;
+    mutable double m_load_elapsed = 0.0;
+
+    void set_info(DaemonProtocol::CaseInfo&& info);
+    void load_keys(const std::vector<std::string>& keys) const;
+};
+
+#endif // SMRY_APPL_DAEMON_CLIENT_HPP
@@ -26,27 +26,28 @@
 DerivedSmry::DerivedSmry(QsumCMDF cmdfile, const std::vector<FileType>& file_type,
                          std::unordered_map<int, std::unique_ptr<Opm::EclIO::ESmry>>& esmry_loader,
                          std::unordered_map<int, std::unique_ptr<Opm::EclIO::ExtESmry>>& lodsmry_loader
-)
+) : DerivedSmry(std::move(cmdfile), make_summary_sources(file_type, esmry_loader, lodsmry_loader))
+{
+}
+
+DerivedSmry::DerivedSmry(QsumCMDF cmdfile, const source_list_type& sources)
 {
     QsumCMDF::define_vect_type define_vect = cmdfile.get_define_vect();
-    m_max_cases = file_type.size();
+    m_max_cases = sources.size();
 
-    if (file_type[0]==FileType::SMSPEC)
-        m_startdat = esmry_loader[0]->startdate();
-    else
-        m_startdat = lodsmry_loader[0]->startdate();
+    m_startdat = sources[0]->startdate();
 
     make_define_table(define_vect);
 
-    check_smry_exists(file_type, esmry_loader, lodsmry_loader);
+    check_smry_exists(sources);
 
-    load_smry_data(file_type, esmry_loader, lodsmry_loader);
+    load_smry_data(sources);
 
-    chk_startd_concistency(file_type, esmry_loader, lodsmry_loader);
+    chk_startd_concistency(sources);
 
-    make_global_time_vect(file_type, esmry_loader, lodsmry_loader);
+    make_global_time_vect(sources);
 
-    calc_derived_smry(file_type, esmry_loader, lodsmry_loader);
+    calc_derived_smry(sources);
 
     for (auto it = m_smry_data.begin(); it != m_smry_data.end(); it++)
         m_derived_smry_list.push_back(it->first);
@@ -57,13 +58,20 @@ void DerivedSmry::recalc(const std::vector<FileType>& file_type,
                 std::unordered_map<int, std::unique_ptr<Opm::EclIO::ExtESmry>>& lodsmry_loader)
 {
 
+    auto sources = make_summary_sources(file_type, esmry_loader, lodsmry_loader);
+
+    this->recalc(sources);
+}
+
+void DerivedSmry::recalc(const source_list_type& sources)
+{
     m_smry_data.clear();
 
-    load_smry_data(file_type, esmry_loader, lodsmry_loader);
+    load_smry_data(sources);
 
-    make_global_time_vect(file_type, esmry_loader, lodsmry_loader);
+    make_global_time_vect(sources);
 
-    calc_derived_smry(file_type, esmry_loader, lodsmry_loader);
+    calc_derived_smry(sources);
 
     m_derived_smry_list.clear();
 
@@ -138,9 +146,7 @@ void DerivedSmry::make_define_table(const QsumCMDF::define_vect_type& define_vec
     }
 }
 
-void DerivedSmry::chk_startd_concistency(const std::vector<FileType>& file_type,
-                std::unordered_map<int, std::unique_ptr<Opm::EclIO::ESmry>>& esmry_loader,
-                std::unordered_map<int, std::unique_ptr<Opm::EclIO::ExtESmry>>& lodsmry_loader)
+void DerivedSmry::chk_startd_concistency(const source_list_type& sources)
 {
     for (auto& define: m_define_table){
 
@@ -151,10 +157,8 @@ void DerivedSmry::chk_startd_concistency(const std::vector<FileType>& file_type,
 
         if (var_smry_id < 0)
             startd_var = startdate();
-        else  if (file_type[var_smry_id] == FileType::SMSPEC)
-            startd_var = esmry_loader[var_smry_id]->startdate();
-        else  if (file_type[var_smry_id] == FileType::ESMRY)
-            startd_var = lodsmry_loader[var_smry_id]->startdate();
+        else
+            startd_var = sources[var_smry_id]->startdate();
 
 
         std::string var_smry_key = std::get<1>(var);
@@ -177,10 +181,8 @@ void DerivedSmry::chk_startd_concistency(const std::vector<FileType>& file_type,
 
             if (n < 0)
                 startd = startdate();
-            else  if (file_type[n] == FileType::SMSPEC)
-                startd = esmry_loader[n]->startdate();
-            else  if (file_type[n] == FileType::ESMRY)
-                startd = lodsmry_loader[n]->startdate();
+            else
+                startd = sources[n]->startdate();
 
             if (startd != startd_var){
                 std::string message = "Start date inconcistency for dervived smry " + std::to_string(var_smry_id);
@@ -193,9 +195,7 @@ void DerivedSmry::chk_startd_concistency(const std::vector<FileType>& file_type,
 }
 
 
-void DerivedSmry::check_smry_exists(const std::vector<FileType>& file_type,
-                std::unordered_map<int, std::unique_ptr<Opm::EclIO::ESmry>>& esmry_loader,
-                std::unordered_map<int, std::unique_ptr<Opm::EclIO::ExtESmry>>& lodsmry_loader)
+void DerivedSmry::check_smry_exists(const source_list_type& sources)
 {
     std::vector<std::tuple<int, std::string>> def_var_list;
 
@@ -229,24 +229,10 @@ void DerivedSmry::check_smry_exists(const std::vector<FileType>& file_type,
 
                 auto it = std::find (def_var_list.begin(), def_var_list.end(), cand);
 
-                if (it == def_var_list.end()){
-
-                    if (file_type[smry_id] == FileType::SMSPEC) {
-
-                        if (!esmry_loader[smry_id]->hasKey(smry_key)){
-                            std::cout << "in define " << var_smry_id << ":" << var_smry_key;
-                            std::cout << " key " << smry_id << ":" << smry_key << " not found \n";
-                           exit(1);
-                        }
-
-                    } else if (file_type[smry_id] == FileType::ESMRY) {
-
-                        if (!lodsmry_loader[smry_id]->hasKey(smry_key)){
-                           std::cout << "in define " << var_smry_id << ":" << var_smry_key;
-                           std::cout << " key " << smry_id << ":" << smry_key << " not found \n";
-                           exit(1);
-                        }
-                    }
+                if ((it == def_var_list.end()) && (!sources[smry_id]->has_key(smry_key))){
+                    std::cout << "in define " << var_smry_id << ":" << var_smry_key;
+                    std::cout << " key " << smry_id << ":" << smry_key << " not found \n";
+                    exit(1);
                 }
             }
         }
@@ -256,12 +242,10 @@ void DerivedSmry::check_smry_exists(const std::vector<FileType>& file_type,
 }
 
 
-void DerivedSmry::load_smry_data(const std::vector<FileType>& file_type,
-                std::unordered_map<int, std::unique_ptr<Opm::EclIO::ESmry>>& esmry_loader,
-                std::unordered_map<int, std::unique_ptr<Opm::EclIO::ExtESmry>>& lodsmry_loader)
+void DerivedSmry::load_smry_data(const source_list_type& sources)
 {
     std::vector<std::vector<std::string>> vect_load_list;
-    int max_cases = file_type.size();
+    int max_cases = sources.size();
 
     for (size_t n = 0; n < max_cases; n++)
         vect_load_list.push_back({"TIME"});
@@ -289,15 +273,8 @@ void DerivedSmry::load_smry_data(const std::vector<FileType>& file_type,
         }
     }
 
-    for (size_t n = 0; n < vect_load_list.size(); n++){
-        if (vect_load_list[n].size() > 0)
-            if (file_type[n] == FileType::SMSPEC)
-                esmry_loader[n]->loadData(vect_load_list[n]);
-            else if (file_type[n] == FileType::ESMRY)
-                lodsmry_loader[n]->loadData(vect_load_list[n]);
-            else
-                throw std::invalid_argument("invalied summary file type");
-    }
+    for (size_t n = 0; n < vect_load_list.size(); n++)
+        sources[n]->load(vect_load_list[n]);
 }
 
 
@@ -353,9 +330,7 @@ int DerivedSmry::param_exists(const param_list_type& param_list, int smry_id, co
 }
 
 
-void DerivedSmry::make_global_time_vect(const std::vector<FileType>& file_type,
-                std::unordered_map<int, std::unique_ptr<Opm::EclIO::ESmry>>& esmry_loader,
-                std::unordered_map<int, std::unique_ptr<Opm::EclIO::ExtESmry>>& lodsmry_loader)
+void DerivedSmry::make_global_time_vect(const source_list_type& sources)
 {
     std::set<int> smry_id_used_in_global;
 
@@ -378,26 +353,14 @@ void DerivedSmry::make_global_time_vect(const std::vector<FileType>& file_type,
         }
     }
 
-    std::vector<float> time_data;
-
-    if (file_type[0] == FileType::SMSPEC)
-        time_data = esmry_loader[0]->get("TIME");
-    else
-        time_data = lodsmry_loader[0]->get("TIME");
+    std::vector<float> time_data = sources[0]->get("TIME");
 
     std::set<float> time_data_set;
 
     for (auto it=smry_id_used_in_global.begin(); it!=smry_id_used_in_global.end(); ++it){
         int n = *it;
 
-        std::vector<float> time_data;
-
-        if (file_type[n] == FileType::SMSPEC)
-            time_data = esmry_loader[n]->get("TIME");
-        else  if (file_type[n] == FileType::ESMRY)
-            time_data = lodsmry_loader[n]->get("TIME");
-
-        for (auto time : time_data)
+        for (auto time : sources[n]->get_span("TIME"))
             time_data_set.insert(time);
     }
 
@@ -550,9 +513,7 @@ void DerivedSmry::calc_math_expr(std::vector<float>& derived_vect, const std::st
     }
 }
 
-void DerivedSmry::calc_derived_smry(const std::vector<FileType>& file_type,
-                std::unordered_map<int, std::unique_ptr<Opm::EclIO::ESmry>>& esmry_loader,
-                std::unordered_map<int, std::unique_ptr<Opm::EclIO::ExtESmry>>& lodsmry_loader)
+void DerivedSmry::calc_derived_smry(const source_list_type& sources)
 {
     //m_smry_data.clear();
     //m_unit_list.clear();
@@ -573,12 +534,8 @@ void DerivedSmry::calc_derived_smry(const std::vector<FileType>& file_type,
 
         if (var_smry_id < 0)
             time_vect.push_back(m_smry_data.at({-1, "TIME"}));
-        else if (file_type[var_smry_id] == FileType::SMSPEC)
-            time_vect.push_back(esmry_loader[var_smry_id]->get("TIME"));
-        else if (file_type[var_smry_id] == FileType::ESMRY)
-            time_vect.push_back(lodsmry_loader[var_smry_id]->get("TIME"));
         else
-            throw std::invalid_argument("in calculate routine, unknown file type");
+            time_vect.push_back(sources[var_smry_id]->get("TIME"));
 
         std::vector<std::vector<float>> param_data;
         std::vector<std::string> param_name_list;
@@ -593,12 +550,8 @@ void DerivedSmry::calc_derived_smry(const std::vector<FileType>& file_type,
 
             if (is_derived(smry_id, smry_key))
                 smry_vect = get(smry_id, smry_key);
-            else if (file_type[smry_id] == FileType::SMSPEC)
-                smry_vect = esmry_loader[smry_id]->get(smry_key);
-            else if (file_type[smry_id] == FileType::ESMRY)
-                smry_vect = lodsmry_loader[smry_id]->get(smry_key);
             else
-                throw std::invalid_argument("in calculate routine, unknown file type");
+                smry_vect = sources[smry_id]->get(smry_key);
 
             auto it = std::find(time_vect_smry_id_list.begin(), time_vect_smry_id_list.end(), smry_id);
 
@@ -607,12 +560,10 @@ void DerivedSmry::calc_derived_smry(const std::vector<FileType>& file_type,
                 param_time_vect_ind.push_back(time_vect_smry_id_list.size());
                 time_vect_smry_id_list.push_back(smry_id);
 
-                if (file_type[smry_id] == FileType::SMSPEC)
-                    time_vect.push_back(esmry_loader[smry_id]->get("TIME"));
-                else if (file_type[smry_id] == FileType::ESMRY)
-                    time_vect.push_back(lodsmry_loader[smry_id]->get("TIME"));
+                if (smry_id < 0)
+                    time_vect.push_back(m_smry_data.at({-1, "TIME"}));
                 else
-                    throw std::invalid_argument("in calculate routine, unknown file type");
+                    time_vect.push_back(sources[smry_id]->get("TIME"));
 
             } else {
                 int index = std::distance(time_vect_smry_id_list.begin(), it);
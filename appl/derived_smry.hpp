@@ -20,10 +20,10 @@
 #define DERIVED_SMRY
 
 #include <appl/qsum_cmdf.hpp>
+#include <appl/summary_source.hpp>
 
 #include <unordered_map>
 
-enum class FileType;
 class QsumCMDF;
 
 
@@ -52,10 +52,15 @@ public:
                 std::unordered_map<int, std::unique_ptr<Opm::EclIO::ESmry>>& esmry_loader,
                 std::unordered_map<int, std::unique_ptr<Opm::EclIO::ExtESmry>>& lodsmry_loader);
 
+    DerivedSmry(QsumCMDF cmdfile, const source_list_type& sources);
+
     void recalc(const std::vector<FileType>& file_type,
                 std::unordered_map<int, std::unique_ptr<Opm::EclIO::ESmry>>& esmry_loader,
                 std::unordered_map<int, std::unique_ptr<Opm::EclIO::ExtESmry>>& lodsmry_loader);
 
+    // cases with sources not made from the loaders (live cases) only through this one
+    void recalc(const source_list_type& sources);
+
     const std::vector<float>& get(int smry_id, const std::string& name) const;
     const std::string& get_unit(int smry_id, const std::string& name) const;
 
@@ -84,25 +89,15 @@ private:
     int param_exists(const param_list_type& param_list, int smry_id, const std::string& key);
     void make_define_table(const define_vect_type& define_vect);
 
-    void check_smry_exists(const std::vector<FileType>& file_type,
-                std::unordered_map<int, std::unique_ptr<Opm::EclIO::ESmry>>& esmry_loader,
-                std::unordered_map<int, std::unique_ptr<Opm::EclIO::ExtESmry>>& lodsmry_loader);
+    void check_smry_exists(const source_list_type& sources);
 
-    void chk_startd_concistency(const std::vector<FileType>& file_type,
-                std::unordered_map<int, std::unique_ptr<Opm::EclIO::ESmry>>& esmry_loader,
-                std::unordered_map<int, std::unique_ptr<Opm::EclIO::ExtESmry>>& lodsmry_loader);
+    void chk_startd_concistency(const source_list_type& sources);
 
-    void load_smry_data(const std::vector<FileType>& file_type,
-                std::unordered_map<int, std::unique_ptr<Opm::EclIO::ESmry>>& esmry_loader,
-                std::unordered_map<int, std::unique_ptr<Opm::EclIO::ExtESmry>>& lodsmry_loader);
+    void load_smry_data(const source_list_type& sources);
 
-    void make_global_time_vect(const std::vector<FileType>& file_type,
-                std::unordered_map<int, std::unique_ptr<Opm::EclIO::ESmry>>& esmry_loader,
-                std::unordered_map<int, std::unique_ptr<Opm::EclIO::ExtESmry>>& lodsmry_loader);
+    void make_global_time_vect(const source_list_type& sources);
 
-    void calc_derived_smry(const std::vector<FileType>& file_type,
-                std::unordered_map<int, std::unique_ptr<Opm::EclIO::ESmry>>& esmry_loader,
-                std::unordered_map<int, std::unique_ptr<Opm::EclIO::ExtESmry>>& lodsmry_loader);
+    void calc_derived_smry(const source_list_type& sources);
 
 
     std::vector<float> calc_derived_vect(const std::string& expr,
@@ -0,0 +1,182 @@
+/*
+   Copyright 2022 Equinor ASA.
+
+   This file is part of the Open Porous Media project (OPM).
+
+   OPM is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   OPM is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+
+#include <appl/ensemble_band.hpp>
+
+#include <QtGui/QPainter>
+#include <QtGui/QPolygonF>
+#include <QtCharts/QChart>
+
+#include <algorithm>
+#include <cmath>
+
+
+EnsembleBand::EnsembleBand(QChart *chart, std::shared_ptr<EnsembleData> ens_data, EnsembleMode mode,
+                           double multiplier, const QColor& color):
+    QGraphicsItem(chart),
+    m_chart(chart),
+    m_ens_data(ens_data),
+    m_mode(mode),
+    m_multiplier(multiplier),
+    m_color(color)
+{
+    // above chart background and plot area, below grid lines and series
+    setZValue(1);
+
+    if (m_mode == EnsembleMode::band){
+
+        m_pvalues = m_ens_data->percentiles({0.0, 10.0, 90.0, 100.0});
+
+        for (auto& pv : m_pvalues)
+            for (auto& v : pv)
+                v = v * m_multiplier;
+    }
+}
+
+
+void EnsembleBand::set_axes(QDateTimeAxis* xaxis, QValueAxis* yaxis)
+{
+    m_xaxis = xaxis;
+    m_yaxis = yaxis;
+}
+
+
+QRectF EnsembleBand::boundingRect() const
+{
+    QRectF rect = m_chart->rect();
+
+    return rect;
+}
+
+
+void EnsembleBand::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+    if ((m_xaxis == nullptr) || (m_yaxis == nullptr))
+        return;
+
+    QRectF plot = m_chart->plotArea();
+
+    qint64 t0 = m_xaxis->min().toMSecsSinceEpoch();
+    qint64 t1 = m_xaxis->max().toMSecsSinceEpoch();
+
+    double v0 = m_yaxis->min();
+    double v1 = m_yaxis->max();
+
+    if ((t1 <= t0) || (v1 <= v0) || plot.isEmpty())
+        return;
+
+    painter->save();
+    painter->setClipRect(plot);
+
+    if (m_mode == EnsembleMode::band)
+        paint_band(painter, plot, t0, t1, v0, v1);
+    else if (m_mode == EnsembleMode::density)
+        paint_density(painter, plot, t0, t1, v0, v1);
+
+    painter->restore();
+}
+
+
+void EnsembleBand::paint_band(QPainter *painter, const QRectF& plot, qint64 t0, qint64 t1, double v0, double v1)
+{
+    const auto& time = m_ens_data->time_grid();
+
+    auto xpos = [&](int64_t t){
+        return plot.x() + plot.width() * static_cast<double>(t - t0) / static_cast<double>(t1 - t0);
+    };
+
+    auto ypos = [&](double v){
+        return plot.y() + plot.height() * (v1 - v) / (v1 - v0);
+    };
+
+    // min-max band and P10-P90 band, upper curve forward and lower curve backward
+
+    const std::vector<std::tuple<size_t, size_t, int>> bands = { {0, 3, 50}, {1, 2, 110} };
+
+    painter->setPen(Qt::NoPen);
+
+    for (auto& [lower, upper, alpha] : bands) {
+
+        QPolygonF polygon;
+        polygon.reserve(2 * time.size());
+
+        for (size_t t = 0; t < time.size(); t++)
+            if (!std::isnan(m_pvalues[upper][t]))
+                polygon.append(QPointF(xpos(time[t]), ypos(m_pvalues[upper][t])));
+
+        for (size_t t = time.size(); t-- > 0; )
+            if (!std::isnan(m_pvalues[lower][t]))
+                polygon.append(QPointF(xpos(time[t]), ypos(m_pvalues[lower][t])));
+
+        QColor color = m_color;
+        color.setAlpha(alpha);
+
+        painter->setBrush(color);
+        painter->drawPolygon(polygon);
+    }
+}
+
+
+void EnsembleBand::paint_density(QPainter *painter, const QRectF& plot, qint64 t0, qint64 t1, double v0, double v1)
+{
+    auto key = std::make_tuple(plot.size(), t0, t1, v0, v1);
+
+    if ((m_density.isNull()) || (key != m_density_key)) {
+
+        size_t nx = std::max(1, static_cast<int>(plot.width()) / cell_size);
+        size_t ny = std::max(1, static_cast<int>(plot.height()) / cell_size);
+
+        std::vector<uint32_t> counts = m_ens_data->density(nx, ny, static_cast<double>(t0),
+                                                           static_cast<double>(t1), v0, v1, m_multiplier);
+
+        uint32_t max_count = *std::max_element(counts.begin(), counts.end());
+
+        m_density = QImage(static_cast<int>(nx), static_cast<int>(ny), QImage::Format_ARGB32_Premultiplied);
+        m_density.fill(Qt::transparent);
+
+        if (max_count > 0) {
+
+            // logarithmic opacity, single members still visible next to the dense core
+
+            double log_max = std::log1p(static_cast<double>(max_count));
+
+            for (size_t r = 0; r < ny; r++) {
+
+                // image row 0 on top, density row 0 at v0
+                QRgb* line = reinterpret_cast<QRgb*>(m_density.scanLine(static_cast<int>(ny - 1 - r)));
+
+                for (size_t i = 0; i < nx; i++) {
+
+                    uint32_t c = counts[r * nx + i];
+
+                    if (c == 0)
+                        continue;
+
+                    int alpha = static_cast<int>(40.0 + 215.0 * std::log1p(static_cast<double>(c)) / log_max);
+
+                    line[i] = qPremultiply(qRgba(m_color.red(), m_color.green(), m_color.blue(), alpha));
+                }
+            }
+        }
+
+        m_density_key = key;
+    }
+
+    painter->drawImage(plot, m_density);
+}
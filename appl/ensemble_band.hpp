@@ -0,0 +1,85 @@
+/*
+   Copyright 2022 Equinor ASA.
+
+   This file is part of the Open Porous Media project (OPM).
+
+   OPM is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   OPM is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#ifndef ENSEMBLEBAND_H
+#define ENSEMBLEBAND_H
+
+#include <QtCharts/QChartGlobal>
+#include <QtCharts/QDateTimeAxis>
+#include <QtCharts/QValueAxis>
+#include <QtWidgets/QGraphicsItem>
+#include <QtGui/QColor>
+#include <QtGui/QImage>
+
+#include <appl/ensemble_data.hpp>
+
+#include <memory>
+#include <tuple>
+#include <vector>
+
+QT_BEGIN_NAMESPACE
+class QChart;
+
+// lines: one series for each member, band: min-max and P10-P90 bands,
+// density: members binned to an image, colour by number of members in each cell
+enum class EnsembleMode{ lines, band, density };
+
+
+// All members of an ensemble drawn as one item in the plot area, below the series.
+// Band polygons are made from the percentiles on the ensemble time grid, the density
+// image is binned again only when plot area or axis ranges are changed.
+
+class EnsembleBand : public QGraphicsItem
+{
+public:
+
+    EnsembleBand(QChart *parent, std::shared_ptr<EnsembleData> ens_data, EnsembleMode mode,
+                 double multiplier, const QColor& color);
+
+    void set_axes(QDateTimeAxis* xaxis, QValueAxis* yaxis);
+
+    QRectF boundingRect() const;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget);
+
+    EnsembleMode mode() const { return m_mode; }
+
+private:
+
+    // density cell size in pixels
+    const int cell_size = 2;
+
+    QChart *m_chart;
+    QDateTimeAxis* m_xaxis = nullptr;
+    QValueAxis* m_yaxis = nullptr;
+
+    std::shared_ptr<EnsembleData> m_ens_data;
+    EnsembleMode m_mode;
+    double m_multiplier;
+    QColor m_color;
+
+    // min, P10, P90 and max on time grid, multiplier applied
+    std::vector<std::vector<double>> m_pvalues;
+
+    QImage m_density;
+    std::tuple<QSizeF, qint64, qint64, double, double> m_density_key;
+
+    void paint_band(QPainter *painter, const QRectF& plot, qint64 t0, qint64 t1, double v0, double v1);
+    void paint_density(QPainter *painter, const QRectF& plot, qint64 t0, qint64 t1, double v0, double v1);
+};
+
+#endif // ENSEMBLEBAND_H
@@ -0,0 +1,297 @@
+/*
+   Copyright 2022 Equinor ASA.
+
+   This file is part of the Open Porous Media project (OPM).
+
+   OPM is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   OPM is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#include <appl/ensemble_data.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <omp.h>
+
+
+namespace {
+
+// linear interpolation, x within time range of series and p index of first point
+// at or after x
+double value_at(const std::vector<int64_t>& time, const std::vector<double>& values, double x, size_t p)
+{
+    if (p == 0)
+        return values.front();
+
+    if (p >= time.size())
+        return values.back();
+
+    double w = (x - static_cast<double>(time[p - 1])) / static_cast<double>(time[p] - time[p - 1]);
+
+    return values[p - 1] + w * (values[p] - values[p - 1]);
+}
+
+}
+
+
+void EnsembleData::resize(size_t num_members)
+{
+    m_members.clear();
+    m_members.resize(num_members);
+
+    m_time_grid.clear();
+    m_grid_values.clear();
+}
+
+
+void EnsembleData::set_member(size_t n, std::vector<int64_t>&& time_ms, std::vector<double>&& values)
+{
+    m_members[n].assign(std::move(time_ms), std::move(values));
+}
+
+
+void EnsembleData::make_time_grid(size_t max_points)
+{
+    m_time_grid.clear();
+
+    m_min = std::numeric_limits<double>::max();
+    m_max = -std::numeric_limits<double>::max();
+
+    size_t total = 0;
+
+    for (auto& m : m_members){
+        total += m.size();
+
+        if (!m.empty()){
+            m_min = std::min(m_min, m.min_value());
+            m_max = std::max(m_max, m.max_value());
+        }
+    }
+
+    if (total == 0){
+        m_min = 0.0;
+        m_max = 0.0;
+        m_grid_values.clear();
+        return;
+    }
+
+    // members from same ensemble normally share report steps, union is
+    // close to size of one member
+
+    std::vector<int64_t> all_time;
+    all_time.reserve(total);
+
+    for (auto& m : m_members)
+        all_time.insert(all_time.end(), m.time().begin(), m.time().end());
+
+    std::sort(all_time.begin(), all_time.end());
+    all_time.erase(std::unique(all_time.begin(), all_time.end()), all_time.end());
+
+    if ((max_points > 1) && (all_time.size() > max_points)){
+
+        m_time_grid.reserve(max_points);
+
+        double step = static_cast<double>(all_time.size() - 1) / static_cast<double>(max_points - 1);
+
+        for (size_t n = 0; n < max_points; n++)
+            m_time_grid.push_back(all_time[static_cast<size_t>(std::round(n * step))]);
+
+        m_time_grid.erase(std::unique(m_time_grid.begin(), m_time_grid.end()), m_time_grid.end());
+
+    } else {
+        m_time_grid = std::move(all_time);
+    }
+
+    const size_t num_members = m_members.size();
+    const size_t num_grid = m_time_grid.size();
+
+    m_grid_values.assign(num_grid * num_members, std::numeric_limits<double>::quiet_NaN());
+
+    #pragma omp parallel for schedule(dynamic)
+    for (size_t m = 0; m < num_members; m++){
+
+        const auto& time = m_members[m].time();
+        const auto& values = m_members[m].values();
+
+        if (time.empty())
+            continue;
+
+        size_t p = 0;
+
+        for (size_t t = 0; t < num_grid; t++){
+
+            int64_t x = m_time_grid[t];
+
+            if ((x < time.front()) || (x > time.back()))
+                continue;
+
+            while ((p + 1 < time.size()) && (time[p + 1] <= x))
+                p++;
+
+            double v;
+
+            if ((time[p] == x) || (p + 1 == time.size())){
+                v = values[p];
+            } else {
+                double w = static_cast<double>(x - time[p]) / static_cast<double>(time[p + 1] - time[p]);
+                v = values[p] + w * (values[p + 1] - values[p]);
+            }
+
+            m_grid_values[t * num_members + m] = v;
+        }
+    }
+}
+
+
+std::vector<std::vector<double>> EnsembleData::percentiles(const std::vector<double>& p_list) const
+{
+    const size_t num_members = m_members.size();
+    const size_t num_grid = m_time_grid.size();
+
+    std::vector<std::vector<double>> res(p_list.size(),
+                                         std::vector<double>(num_grid, std::numeric_limits<double>::quiet_NaN()));
+
+    #pragma omp parallel
+    {
+        std::vector<double> buffer;
+        buffer.reserve(num_members);
+
+        #pragma omp for schedule(static)
+        for (size_t t = 0; t < num_grid; t++){
+
+            buffer.clear();
+
+            const double* values = grid_values(t);
+
+            for (size_t m = 0; m < num_members; m++)
+                if (!std::isnan(values[m]))
+                    buffer.push_back(values[m]);
+
+            if (buffer.empty())
+                continue;
+
+            std::sort(buffer.begin(), buffer.end());
+
+            for (size_t n = 0; n < p_list.size(); n++){
+
+                double rank = std::clamp(p_list[n], 0.0, 100.0) / 100.0 * static_cast<double>(buffer.size() - 1);
+
+                size_t r0 = static_cast<size_t>(std::floor(rank));
+                size_t r1 = std::min(r0 + 1, buffer.size() - 1);
+
+                res[n][t] = buffer[r0] + (rank - r0) * (buffer[r1] - buffer[r0]);
+            }
+        }
+    }
+
+    return res;
+}
+
+
+std::vector<uint32_t> EnsembleData::density(size_t nx, size_t ny, double t0, double t1,
+                                            double v0, double v1, double scale) const
+{
+    std::vector<uint32_t> res(nx * ny, 0);
+
+    if ((nx == 0) || (ny == 0) || (t1 <= t0) || (v1 <= v0))
+        return res;
+
+    const double dt = (t1 - t0) / static_cast<double>(nx);
+    const double dv = (v1 - v0) / static_cast<double>(ny);
+
+    // columns are binned in blocks, each block owns its cells and no synchronization is
+    // needed. Members are walked once per block, a member increments all rows between
+    // its min and max value inside a column, steep segments are drawn as vertical lines
+
+    std::vector<uint32_t> col_major(nx * ny, 0);
+
+    const size_t block_size = 32;
+    const size_t num_blocks = (nx + block_size - 1) / block_size;
+
+    #pragma omp parallel for schedule(dynamic)
+    for (size_t b = 0; b < num_blocks; b++){
+
+        size_t i0 = b * block_size;
+        size_t i1 = std::min(i0 + block_size, nx);
+
+        for (const auto& member : m_members){
+
+            const auto& time = member.time();
+            const auto& values = member.values();
+
+            double ta = t0 + static_cast<double>(i0) * dt;
+
+            if (time.empty() || (time.back() < ta) || (time.front() > t0 + static_cast<double>(i1) * dt))
+                continue;
+
+            // first point at or after start of block
+            size_t p = std::distance(time.begin(), std::lower_bound(time.begin(), time.end(), ta,
+                                                                    [](int64_t t, double v){ return t < v; }));
+
+            for (size_t i = i0; i < i1; i++){
+
+                ta = t0 + static_cast<double>(i) * dt;
+                double tb = ta + dt;
+
+                if ((time.back() < ta) || (time.front() > tb))
+                    continue;
+
+                double xa = std::max(ta, static_cast<double>(time.front()));
+                double xb = std::min(tb, static_cast<double>(time.back()));
+
+                double va = value_at(time, values, xa, p);
+
+                double vmin = va;
+                double vmax = va;
+
+                while ((p < time.size()) && (time[p] <= xb)){
+                    vmin = std::min(vmin, values[p]);
+                    vmax = std::max(vmax, values[p]);
+                    p++;
+                }
+
+                double vb = value_at(time, values, xb, p);
+
+                vmin = std::min(vmin, vb) * scale;
+                vmax = std::max(vmax, vb) * scale;
+
+                if (scale < 0.0)
+                    std::swap(vmin, vmax);
+
+                if ((vmax < v0) || (vmin > v1))
+                    continue;
+
+                long r0 = static_cast<long>(std::floor((vmin - v0) / dv));
+                long r1 = static_cast<long>(std::floor((vmax - v0) / dv));
+
+                r0 = std::clamp(r0, 0L, static_cast<long>(ny) - 1);
+                r1 = std::clamp(r1, 0L, static_cast<long>(ny) - 1);
+
+                uint32_t* column = &col_major[i * ny];
+
+                for (long r = r0; r <= r1; r++)
+                    column[r]++;
+            }
+        }
+    }
+
+    // counts accumulated column by column, transposed to rows
+
+    #pragma omp parallel for schedule(static)
+    for (size_t r = 0; r < ny; r++)
+        for (size_t i = 0; i < nx; i++)
+            res[r * nx + i] = col_major[i * ny + r];
+
+    return res;
+}
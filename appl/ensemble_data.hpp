@@ -0,0 +1,75 @@
+/*
+   Copyright 2022 Equinor ASA.
+
+   This file is part of the Open Porous Media project (OPM).
+
+   OPM is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   OPM is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#ifndef SMRY_APPL_ENSEMBLE_DATA_HPP
+#define SMRY_APPL_ENSEMBLE_DATA_HPP
+
+#include <appl/series_data.hpp>
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+
+// Summary vector from all members of an ensemble. Members are resampled to a
+// common time grid, union of member time steps thinned to a maximum number of
+// points. Members are interpolated linearly in time and do not contribute at
+// grid times outside their own time range.
+
+class EnsembleData {
+
+public:
+
+    void resize(size_t num_members);
+    void set_member(size_t n, std::vector<int64_t>&& time_ms, std::vector<double>&& values);
+
+    size_t number_of_members() const { return m_members.size(); }
+    const SeriesData& member(size_t n) const { return m_members[n]; }
+
+    void make_time_grid(size_t max_points = 2000);
+
+    const std::vector<int64_t>& time_grid() const { return m_time_grid; }
+
+    // member values at grid index t, NaN if member does not cover grid time
+    const double* grid_values(size_t t) const { return &m_grid_values[t * m_members.size()]; }
+
+    // percentiles in range [0, 100] for each grid time, one vector for each p.
+    // Interpolated between closest ranks, NaN if no member covers grid time
+    std::vector<std::vector<double>> percentiles(const std::vector<double>& p_list) const;
+
+    // number of members crossing each cell in a grid of nx time columns and ny value
+    // rows covering [t0, t1] x [v0, v1], row 0 at v0, index row * nx + column.
+    // Columns are binned in parallel, values multiplied with scale before binning
+    std::vector<uint32_t> density(size_t nx, size_t ny, double t0, double t1,
+                                  double v0, double v1, double scale = 1.0) const;
+
+    double min_value() const { return m_min; }
+    double max_value() const { return m_max; }
+
+private:
+
+    std::vector<SeriesData> m_members;
+
+    std::vector<int64_t> m_time_grid;
+    std::vector<double> m_grid_values;
+
+    double m_min = 0.0;
+    double m_max = 0.0;
+};
+
+#endif // SMRY_APPL_ENSEMBLE_DATA_HPP
@@ -0,0 +1,450 @@
+/*
+   Copyright 2022 Equinor ASA.
+
+   This file is part of the Open Porous Media project (OPM).
+
+   OPM is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   OPM is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#include <appl/esmry_cache.hpp>
+#include <appl/qsum_cmdf.hpp>
+#include <appl/formatted_smry.hpp>
+#include <appl/fnv1a_hash.hpp>
+
+#include <opm/io/eclipse/EclOutput.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+#include <unistd.h>
+
+
+static const std::string esmry_cache_version = "QSUM_ESMRY_CACHE 1";
+
+
+// UNSMRY for SMSPEC and FUNSMRY for formatted FSMSPEC
+
+static std::filesystem::path unified_file(const std::filesystem::path& smspec_file)
+{
+    auto unsmry_file = smspec_file;
+
+    if (smspec_file.extension() == ".FSMSPEC")
+        return unsmry_file.replace_extension(".FUNSMRY");
+
+    return unsmry_file.replace_extension(".UNSMRY");
+}
+
+
+// absolute path, size and modification time of SMSPEC and UNSMRY, empty if not available
+
+static std::string make_stamp(const std::filesystem::path& smspec_file)
+{
+    std::error_code ec;
+
+    auto abs_path = std::filesystem::absolute(smspec_file, ec);
+
+    if (ec)
+        return "";
+
+    auto unsmry_file = unified_file(smspec_file);
+
+    std::stringstream ss;
+    ss << esmry_cache_version << "\n" << abs_path.string() << "\n";
+
+    for (auto& fname : { smspec_file, unsmry_file }){
+
+        auto size = std::filesystem::file_size(fname, ec);
+
+        if (ec)
+            return "";
+
+        auto ftime = std::filesystem::last_write_time(fname, ec);
+
+        if (ec)
+            return "";
+
+        ss << size << " " << ftime.time_since_epoch().count() << "\n";
+    }
+
+    return ss.str();
+}
+
+
+static std::filesystem::path stamp_file(const std::filesystem::path& esmry_file)
+{
+    auto fname = esmry_file;
+    return fname.replace_extension(".stamp");
+}
+
+
+// report steps are the last time step in each report step, from the first time step in the next
+
+static std::vector<int> make_rstep(const std::vector<size_t>& report_step_index, size_t num_steps)
+{
+    std::vector<int> rstep(num_steps, 0);
+
+    for (auto t : report_step_index)
+        rstep[t] = 1;
+
+    return rstep;
+}
+
+
+// ESMRY file with vector data from get_data (index in keys), returns false if stopped
+
+static bool write_esmry(const std::filesystem::path& fname, const std::vector<int>& start,
+                        const std::vector<std::string>& keys, const std::vector<std::string>& units,
+                        const std::vector<int>& rstep, const std::function<const std::vector<float>&(size_t)>& get_data,
+                        const std::atomic<bool>* stop)
+{
+    std::vector<int> tstep(rstep.size());
+
+    for (size_t t = 0; t < tstep.size(); t++)
+        tstep[t] = t;
+
+    Opm::EclIO::EclOutput outfile(fname.string(), false, std::ios::out);
+
+    outfile.write<int>("START", start);
+    outfile.write<std::string>("KEYCHECK", keys);
+    outfile.write<std::string>("UNITS", units);
+    outfile.write<int>("RSTEP", rstep);
+    outfile.write<int>("TSTEP", tstep);
+
+    for (size_t n = 0; n < keys.size(); n++){
+
+        if ((stop != nullptr) && (*stop))
+            return false;
+
+        outfile.write<float>("V" + std::to_string(n), get_data(n));
+    }
+
+    return true;
+}
+
+
+static bool convert_smspec(const std::filesystem::path& smspec_file, const std::filesystem::path& fname,
+                           const std::atomic<bool>* stop)
+{
+    Opm::EclIO::ESmry smry(smspec_file);
+
+    auto keys = smry.keywordList();
+
+    // loaded in batches, a stopped conversion returns after the current batch instead
+    // of after loading all vectors
+
+    const size_t batch_size = 1000;
+
+    for (size_t n0 = 0; n0 < keys.size(); n0 += batch_size) {
+
+        if ((stop != nullptr) && (*stop))
+            return false;
+
+        size_t n1 = std::min(n0 + batch_size, keys.size());
+        smry.loadData(std::vector<std::string>(keys.begin() + n0, keys.begin() + n1));
+    }
+
+    std::vector<std::string> units;
+    units.reserve(keys.size());
+
+    for (auto& key : keys)
+        units.push_back(smry.get_unit(key));
+
+    const std::vector<float>& time = smry.get("TIME");
+    auto rstep = make_rstep(rstep_time_index(time, smry.get_at_rstep("TIME")), time.size());
+
+    // SMSPEC start date holds seconds and microseconds in one item
+
+    auto start_vect = smry.start_v();
+
+    std::vector<int> start = { start_vect[0], start_vect[1], start_vect[2], start_vect[3], start_vect[4],
+                               start_vect[5] / 1000000, (start_vect[5] % 1000000) / 1000 };
+
+    return write_esmry(fname, start, keys, units, rstep,
+                       [&smry, &keys](size_t n) -> const std::vector<float>& { return smry.get(keys[n]); }, stop);
+}
+
+
+static bool convert_formatted(const std::filesystem::path& fsmspec_file, const std::filesystem::path& fname,
+                              const std::atomic<bool>* stop)
+{
+    FormattedSmryReader smry(fsmspec_file);
+
+    auto& start_date = smry.start_date();
+    std::vector<int> start(start_date.begin(), start_date.end());
+
+    return write_esmry(fname, start, smry.keyword_list(), smry.units(), make_rstep(smry.report_step_index(), smry.number_of_time_steps()),
+                       [&smry](size_t n) -> const std::vector<float>& { return smry.get(n); }, stop);
+}
+
+
+std::filesystem::path EsmryCache::cache_dir()
+{
+    return QsumCMDF::cache_dir() / "esmry";
+}
+
+
+std::filesystem::path EsmryCache::cached_file(const std::filesystem::path& smspec_file)
+{
+    std::error_code ec;
+
+    auto abs_path = std::filesystem::absolute(smspec_file, ec);
+
+    if (ec)
+        abs_path = smspec_file;
+
+    std::stringstream ss;
+    ss << std::hex << std::setw(16) << std::setfill('0') << fnv1a_hash(abs_path.string());
+
+    auto esmry_file = cache_dir() / ss.str() / smspec_file.filename();
+
+    return esmry_file.replace_extension(".ESMRY");
+}
+
+
+bool EsmryCache::is_cacheable(const std::filesystem::path& smspec_file)
+{
+    if ((smspec_file.extension() != ".SMSPEC") && (smspec_file.extension() != ".FSMSPEC"))
+        return false;
+
+    return std::filesystem::exists(unified_file(smspec_file));
+}
+
+
+bool EsmryCache::is_valid(const std::filesystem::path& smspec_file)
+{
+    if (!is_cacheable(smspec_file))
+        return false;
+
+    auto esmry_file = cached_file(smspec_file);
+
+    if (!std::filesystem::exists(esmry_file))
+        return false;
+
+    std::ifstream stamp(stamp_file(esmry_file));
+
+    if (!stamp)
+        return false;
+
+    std::stringstream ss;
+    ss << stamp.rdbuf();
+
+    std::string current = make_stamp(smspec_file);
+
+    return (current.size() > 0) && (ss.str() == current);
+}
+
+
+bool EsmryCache::convert(const std::filesystem::path& smspec_file, const std::atomic<bool>* stop)
+{
+    // cache is optional, failing to convert is not an error. The stamp is made before
+    // loading, a case updated during conversion gives an outdated stamp
+
+    if (!is_cacheable(smspec_file))
+        return false;
+
+    std::string stamp = make_stamp(smspec_file);
+
+    if (stamp.empty())
+        return false;
+
+    auto esmry_file = cached_file(smspec_file);
+
+    std::error_code ec;
+    std::filesystem::create_directories(esmry_file.parent_path(), ec);
+
+    if (ec)
+        return false;
+
+    std::string pid_ext = ".tmp" + std::to_string(::getpid());
+
+    auto tmp_fname = esmry_file;
+    tmp_fname += pid_ext;
+
+    bool complete = false;
+
+    try {
+        if (smspec_file.extension() == ".FSMSPEC")
+            complete = convert_formatted(smspec_file, tmp_fname, stop);
+        else
+            complete = convert_smspec(smspec_file, tmp_fname, stop);
+    } catch (...) {
+        complete = false;
+    }
+
+    if (!complete){
+        std::filesystem::remove(tmp_fname, ec);
+        return false;
+    }
+
+    std::filesystem::rename(tmp_fname, esmry_file, ec);
+
+    if (ec){
+        std::filesystem::remove(tmp_fname, ec);
+        return false;
+    }
+
+    auto stamp_fname = stamp_file(esmry_file);
+
+    auto tmp_stamp = stamp_fname;
+    tmp_stamp += pid_ext;
+
+    {
+        std::ofstream ofs(tmp_stamp);
+        ofs << stamp;
+
+        if (!ofs){
+            ofs.close();
+            std::filesystem::remove(tmp_stamp, ec);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(tmp_stamp, stamp_fname, ec);
+
+    if (ec){
+        std::filesystem::remove(tmp_stamp, ec);
+        return false;
+    }
+
+    return true;
+}
+
+
+EsmryConverter::~EsmryConverter()
+{
+    m_stop = true;
+    this->wait();
+}
+
+
+void EsmryConverter::start(const std::vector<std::filesystem::path>& smspec_files)
+{
+    this->wait();
+
+    if (smspec_files.empty())
+        return;
+
+    m_stop = false;
+    m_running = true;
+
+    m_thread = std::thread([this, smspec_files](){
+
+        for (auto& fname : smspec_files){
+
+            if (m_stop)
+                break;
+
+            EsmryCache::convert(fname, &m_stop);
+        }
+
+        m_running = false;
+    });
+}
+
+
+void EsmryConverter::wait()
+{
+    if (m_thread.joinable())
+        m_thread.join();
+}
+
+
+CachedEsmrySource::CachedEsmrySource(std::unique_ptr<Opm::EclIO::ESmry>& smspec_loader,
+                                     std::unique_ptr<Opm::EclIO::ExtESmry>& cached_loader,
+                                     const std::filesystem::path& smspec_file) :
+    SummarySource(smspec_file), m_smspec_loader(smspec_loader), m_cached_loader(cached_loader)
+{
+    m_smspec = std::make_unique<ESmrySource>(m_smspec_loader, smspec_file);
+    m_cached = std::make_unique<ExtESmrySource>(m_cached_loader, EsmryCache::cached_file(smspec_file));
+
+    if (m_cached_loader != nullptr)
+        m_active = m_cached.get();
+    else
+        m_active = m_smspec.get();
+}
+
+
+bool CachedEsmrySource::reopen()
+{
+    // formatted cases are converted again when updated, parsing FUNSMRY with
+    // FormattedSmryReader is faster than reading it with ESmry
+
+    bool converted = false;
+
+    if ((m_file.extension() == ".FSMSPEC") && !EsmryCache::is_valid(m_file))
+        converted = EsmryCache::convert(m_file);
+
+    if (this->using_cache()){
+
+        if (EsmryCache::is_valid(m_file)){
+
+            if (!converted)
+                return false;
+
+            m_cached_loader = std::make_unique<Opm::EclIO::ExtESmry>(EsmryCache::cached_file(m_file));
+            this->update_file_stamp();
+
+            return true;
+        }
+
+        // case updated after conversion, continue with SMSPEC/UNSMRY
+
+        try {
+            m_smspec_loader = std::make_unique<Opm::EclIO::ESmry>(m_file);
+        } catch (...) {
+            std::string message = "Error with reopen loader, failed when opening summary file " + m_file.string();
+            throw std::runtime_error(message);
+        }
+
+        m_smspec = std::make_unique<ESmrySource>(m_smspec_loader, m_file);
+        m_active = m_smspec.get();
+        this->update_file_stamp();
+
+        return true;
+    }
+
+    if (EsmryCache::is_valid(m_file)){
+
+        try {
+            m_cached_loader = std::make_unique<Opm::EclIO::ExtESmry>(EsmryCache::cached_file(m_file));
+        } catch (...) {
+            return this->reopen_smspec();
+        }
+
+        // same case data from the cached file, only changed if the case was updated
+
+        bool changed = this->has_changed();
+
+        m_cached = std::make_unique<ExtESmrySource>(m_cached_loader, EsmryCache::cached_file(m_file));
+        m_active = m_cached.get();
+        this->update_file_stamp();
+
+        return changed;
+    }
+
+    return this->reopen_smspec();
+}
+
+bool CachedEsmrySource::reopen_smspec()
+{
+    bool updated = m_smspec->reopen();
+
+    if (updated)
+        this->reset_report_step_index();
+
+    return updated;
+}
@@ -0,0 +1,136 @@
+/*
+   Copyright 2022 Equinor ASA.
+
+   This file is part of the Open Porous Media project (OPM).
+
+   OPM is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   OPM is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#ifndef SMRY_APPL_ESMRY_CACHE_HPP
+#define SMRY_APPL_ESMRY_CACHE_HPP
+
+#include <appl/summary_source.hpp>
+
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <thread>
+#include <vector>
+
+
+// ESMRY copies of unified SMSPEC/UNSMRY and formatted FSMSPEC/FUNSMRY cases in the user
+// cache folder. The size and modification time of the SMSPEC and UNSMRY files are stored
+// in a stamp file next to the cached file when converted, the cached file is only used
+// while these are unchanged.
+
+class EsmryCache
+{
+public:
+
+    // sub folder esmry in QsumCMDF::cache_dir()
+    static std::filesystem::path cache_dir();
+
+    // one folder for each SMSPEC file (hash of absolute path), the cached file
+    // has the same root name as the SMSPEC file
+    static std::filesystem::path cached_file(const std::filesystem::path& smspec_file);
+
+    // SMSPEC or FSMSPEC with unified summary file, non-unified cases are not cached
+    static bool is_cacheable(const std::filesystem::path& smspec_file);
+
+    static bool is_valid(const std::filesystem::path& smspec_file);
+
+    // writes the cached file and stamp, returns false if conversion failed or was stopped
+    static bool convert(const std::filesystem::path& smspec_file, const std::atomic<bool>* stop = nullptr);
+};
+
+
+// Converts SMSPEC cases to ESMRY in a background thread, one case at the time. The
+// thread has its own loaders, the converter is stopped and joined when destroyed.
+// Vectors are loaded in batches, stopping waits for at most one batch.
+
+class EsmryConverter
+{
+public:
+
+    EsmryConverter() = default;
+    ~EsmryConverter();
+
+    EsmryConverter(const EsmryConverter&) = delete;
+    EsmryConverter& operator=(const EsmryConverter&) = delete;
+
+    void start(const std::vector<std::filesystem::path>& smspec_files);
+    void wait();
+
+    bool running() const { return m_running; }
+
+private:
+
+    std::thread m_thread;
+    std::atomic<bool> m_stop { false };
+    std::atomic<bool> m_running { false };
+};
+
+
+// SMSPEC case opened from the cached ESMRY file. Change detection is on the SMSPEC file,
+// if the case is updated after conversion the source continues with the SMSPEC file, and
+// switches back to the cached file on reload when converted again. Formatted cases are
+// converted again on reload.
+
+class CachedEsmrySource : public SummarySource {
+
+public:
+
+    CachedEsmrySource(std::unique_ptr<Opm::EclIO::ESmry>& smspec_loader,
+                      std::unique_ptr<Opm::EclIO::ExtESmry>& cached_loader,
+                      const std::filesystem::path& smspec_file);
+
+    FileType file_type() const override { return m_active->file_type(); }
+    std::string rootname() const override { return m_active->rootname(); }
+
+    bool has_key(const std::string& key) const override { return m_active->has_key(key); }
+    std::vector<std::string> keyword_list() const override { return m_active->keyword_list(); }
+    std::vector<std::string> keyword_list(const std::string& pattern) const override { return m_active->keyword_list(pattern); }
+    std::string get_unit(const std::string& key) const override { return m_active->get_unit(key); }
+    bool all_steps_available() const override { return m_active->all_steps_available(); }
+    int number_of_time_steps() const override { return m_active->number_of_time_steps(); }
+
+    time_point startdate() const override { return m_active->startdate(); }
+    std::array<int, 7> start_date() const override { return m_active->start_date(); }
+
+    std::tuple<double, double> io_elapsed() const override { return m_active->io_elapsed(); }
+
+    void load(const std::vector<std::string>& keys) override { m_active->load(keys); }
+    const std::vector<float>& get(const std::string& key) const override { return m_active->get(key); }
+
+    bool reopen() override;
+
+    bool using_cache() const { return m_active == m_cached.get(); }
+
+protected:
+
+    std::vector<size_t> make_report_step_index() const override { return m_active->report_step_index(); }
+
+private:
+
+    std::unique_ptr<Opm::EclIO::ESmry>& m_smspec_loader;
+    std::unique_ptr<Opm::EclIO::ExtESmry>& m_cached_loader;
+
+    std::unique_ptr<ESmrySource> m_smspec;
+    std::unique_ptr<ExtESmrySource> m_cached;
+
+    SummarySource* m_active;
+
+    bool reopen_smspec();
+};
+
+#endif // SMRY_APPL_ESMRY_CACHE_HPP
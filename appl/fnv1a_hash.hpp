@@ -0,0 +1,39 @@
+/*
+   Copyright 2022 Equinor ASA.
+
+   This file is part of the Open Porous Media project (OPM).
+
+   OPM is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   OPM is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#ifndef SMRY_APPL_FNV1A_HASH_HPP
+#define SMRY_APPL_FNV1A_HASH_HPP
+
+#include <cstdint>
+#include <string>
+
+
+// 64 bit FNV-1a hash, used for cache file names and keys. Not a cryptographic hash,
+// hash is the value from a previous call when hashing several strings.
+
+inline uint64_t fnv1a_hash(const std::string& str, uint64_t hash = 0xcbf29ce484222325ULL)
+{
+    for (unsigned char c : str){
+        hash ^= c;
+        hash *= 0x100000001b3ULL;
+    }
+
+    return hash;
+}
+
+#endif // SMRY_APPL_FNV1A_HASH_HPP
@@ -0,0 +1,398 @@
+/*
+   Copyright 2022 Equinor ASA.
+
+   This file is part of the Open Porous Media project (OPM).
+
+   OPM is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   OPM is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#include <appl/formatted_smry.hpp>
+#include <appl/unsmry_reader.hpp>
+
+#include <opm/io/eclipse/EclFile.hpp>
+
+#include <omp.h>
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#include <fnmatch.h>
+
+
+namespace {
+
+// formatted arrays, one header line followed by the data. Header line is name (8 characters)
+// in quotes, number of items and type in quotes, e.g.  'PARAMS  '        1234 'REAL'
+
+struct Chunk {
+    std::vector<float> params;
+    std::vector<bool> report_step;
+    bool trailing_seqhdr = false;
+    bool truncated = false;
+
+    // chunks are parsed in an OpenMP loop, errors are thrown after the loop
+    std::string error;
+};
+
+const size_t min_chunk_size = 1 << 20;
+
+bool is_header(const char* p, const char* end)
+{
+    return (end - p > 11) && (p[0] == ' ') && (p[1] == '\'') && (p[10] == '\'');
+}
+
+const char* next_line(const char* p, const char* end)
+{
+    auto eol = static_cast<const char*>(std::memchr(p, '\n', end - p));
+    return eol == nullptr ? end : eol + 1;
+}
+
+const char* next_header(const char* p, const char* end)
+{
+    while ((p < end) && !is_header(p, end))
+        p = next_line(p, end);
+
+    return p;
+}
+
+bool is_space(char c)
+{
+    return (c == ' ') || (c == '\n') || (c == '\r');
+}
+
+// Fortran E format, a three digit exponent is written without E (0.12345678+100)
+
+const char* parse_float(const char* p, const char* end, float& value)
+{
+    auto res = std::from_chars(p, end, value);
+
+    if ((res.ec != std::errc()) && (res.ec != std::errc::result_out_of_range))
+        return nullptr;
+
+    p = res.ptr;
+
+    if ((p < end) && ((*p == '+') || (*p == '-'))) {
+        int exponent = 0;
+        auto exp_res = std::from_chars(*p == '+' ? p + 1 : p, end, exponent);
+
+        if (exp_res.ec != std::errc())
+            return nullptr;
+
+        value = static_cast<float>(value * std::pow(10.0, exponent));
+        p = exp_res.ptr;
+    }
+
+    return p;
+}
+
+std::string trim(const std::string& str)
+{
+    auto p = str.find_last_not_of(' ');
+    return p == std::string::npos ? "" : str.substr(0, p + 1);
+}
+
+// parses arrays with header in [p, chunk_end), the last array may end after chunk_end
+
+void parse_chunk(const char* p, const char* chunk_end, const char* end, size_t nlist, Chunk& chunk)
+{
+    bool seqhdr = false;
+
+    while (p < chunk_end) {
+
+        const char* line_end = next_line(p, end);
+
+        std::string name = trim(std::string(p + 2, 8));
+
+        const char* q = p + 11;
+
+        while ((q < line_end) && (*q == ' '))
+            q++;
+
+        size_t count = 0;
+        std::from_chars(q, line_end, count);
+
+        p = line_end;
+
+        if (name != "PARAMS") {
+            seqhdr = seqhdr || (name == "SEQHDR");
+            p = next_header(p, end);
+            continue;
+        }
+
+        if (count != nlist) {
+            chunk.error = "Error in FUNSMRY file, PARAMS size not equal to NLIST in FSMSPEC";
+            return;
+        }
+
+        size_t offset = chunk.params.size();
+        chunk.params.resize(offset + nlist);
+
+        size_t n = 0;
+
+        for (; n < count; n++) {
+
+            while ((p < end) && is_space(*p))
+                p++;
+
+            if ((p == end) || (*p == '\''))
+                break;
+
+            p = parse_float(p, end, chunk.params[offset + n]);
+
+            if (p == nullptr) {
+                chunk.error = "Error in FUNSMRY file, invalid value in PARAMS";
+                return;
+            }
+        }
+
+        if (n < count) {
+            chunk.params.resize(offset);
+            chunk.truncated = true;
+            return;
+        }
+
+        chunk.report_step.push_back(seqhdr);
+        seqhdr = false;
+
+        p = next_header(next_line(p, end), end);
+    }
+
+    chunk.trailing_seqhdr = seqhdr;
+}
+
+} // anonymous namespace
+
+
+FormattedSmryReader::FormattedSmryReader(const std::filesystem::path& fsmspec_file)
+{
+    Opm::EclIO::EclFile smspec(fsmspec_file.string());
+
+    smspec.loadData();
+
+    auto units = smspec.get<std::string>("UNITS");
+    auto dimens = smspec.get<int>("DIMENS");
+    auto startdat = smspec.get<int>("STARTDAT");
+
+    // STARTDAT holds seconds and microseconds in one item
+
+    m_start_date = { startdat[0], startdat[1], startdat[2], 0, 0, 0, 0 };
+
+    if (startdat.size() > 5) {
+        m_start_date[3] = startdat[3];
+        m_start_date[4] = startdat[4];
+        m_start_date[5] = startdat[5] / 1000000;
+        m_start_date[6] = (startdat[5] % 1000000) / 1000;
+    }
+
+    auto index = make_smspec_index(fsmspec_file);
+
+    std::vector<std::pair<int, std::string>> key_list;
+
+    for (auto& entry : index)
+        key_list.push_back({ entry.second, entry.first });
+
+    std::sort(key_list.begin(), key_list.end());
+
+    std::vector<int> columns;
+
+    for (auto& entry : key_list) {
+        columns.push_back(entry.first);
+        m_keys.push_back(entry.second);
+        m_units.push_back(trim(units[entry.first]));
+    }
+
+    auto funsmry_file = fsmspec_file;
+    funsmry_file.replace_extension(".FUNSMRY");
+
+    this->parse_funsmry(funsmry_file, columns, static_cast<size_t>(dimens[0]));
+}
+
+void FormattedSmryReader::parse_funsmry(const std::filesystem::path& funsmry_file, const std::vector<int>& columns,
+                                        size_t nlist)
+{
+    std::ifstream ifs(funsmry_file, std::ios::binary);
+
+    if (!ifs)
+        throw std::runtime_error("Error opening FUNSMRY file " + funsmry_file.string());
+
+    std::string buffer;
+
+    ifs.seekg(0, std::ios::end);
+    buffer.resize(static_cast<size_t>(ifs.tellg()));
+    ifs.seekg(0, std::ios::beg);
+    ifs.read(buffer.data(), buffer.size());
+
+    const char* begin = buffer.data();
+    const char* end = begin + ifs.gcount();
+
+    size_t size = end - begin;
+
+    // chunk boundaries moved forward to the next array header
+
+    size_t num_chunks = std::min<size_t>(omp_get_max_threads() * 4, size / min_chunk_size + 1);
+
+    std::vector<const char*> chunk_begin(num_chunks + 1, end);
+
+    for (size_t n = 0; n < num_chunks; n++) {
+        const char* p = begin + size * n / num_chunks;
+
+        if ((p > begin) && (p[-1] != '\n'))
+            p = next_line(p, end);
+
+        chunk_begin[n] = next_header(p, end);
+    }
+
+    std::vector<Chunk> chunks(num_chunks);
+
+    #pragma omp parallel for schedule(dynamic)
+    for (size_t n = 0; n < num_chunks; n++)
+        parse_chunk(chunk_begin[n], chunk_begin[n + 1], end, nlist, chunks[n]);
+
+    // chunks after a truncated chunk are not used
+
+    for (auto& chunk : chunks) {
+
+        if (!chunk.error.empty())
+            throw std::runtime_error(chunk.error + " " + funsmry_file.string());
+
+        if (chunk.truncated)
+            break;
+    }
+
+    // time steps in file order, report step flag from SEQHDR at end of previous chunk
+
+    std::vector<const float*> step_params;
+    bool seqhdr = false;
+
+    for (auto& chunk : chunks) {
+
+        for (size_t t = 0; t < chunk.report_step.size(); t++) {
+            step_params.push_back(chunk.params.data() + t * nlist);
+            m_report_step.push_back(chunk.report_step[t] || (t == 0 && seqhdr));
+        }
+
+        if (chunk.truncated)
+            break;
+
+        seqhdr = chunk.trailing_seqhdr || (seqhdr && chunk.report_step.empty());
+    }
+
+    size_t num_steps = step_params.size();
+
+    m_data.resize(columns.size());
+
+    #pragma omp parallel for schedule(static)
+    for (size_t k = 0; k < columns.size(); k++) {
+
+        m_data[k].resize(num_steps);
+
+        for (size_t t = 0; t < num_steps; t++)
+            m_data[k][t] = step_params[t][columns[k]];
+    }
+}
+
+
+FormattedSource::FormattedSource(const std::filesystem::path& fsmspec_file) :
+    SummarySource(fsmspec_file)
+{
+    m_funsmry_file = fsmspec_file;
+    m_funsmry_file.replace_extension(".FUNSMRY");
+
+    this->open();
+}
+
+void FormattedSource::open()
+{
+    auto start = std::chrono::system_clock::now();
+
+    std::error_code ec;
+    auto funsmry_stamp = std::filesystem::last_write_time(m_funsmry_file, ec);
+
+    auto reader = std::make_unique<FormattedSmryReader>(m_file);
+
+    std::vector<std::string> keys = reader->keyword_list();
+    std::sort(keys.begin(), keys.end());
+
+    std::unordered_map<std::string, size_t> index;
+    const auto& reader_keys = reader->keyword_list();
+
+    for (size_t n = 0; n < reader_keys.size(); n++)
+        index[reader_keys[n]] = n;
+
+    m_reader = std::move(reader);
+    m_keys = std::move(keys);
+    m_index = std::move(index);
+    m_funsmry_stamp = funsmry_stamp;
+
+    std::chrono::duration<double> elapsed = std::chrono::system_clock::now() - start;
+    m_elapsed_open += elapsed.count();
+}
+
+std::vector<std::string> FormattedSource::keyword_list(const std::string& pattern) const
+{
+    std::vector<std::string> key_list;
+
+    for (auto& key : m_keys)
+        if (fnmatch(pattern.c_str(), key.c_str(), 0) == 0)
+            key_list.push_back(key);
+
+    return key_list;
+}
+
+std::string FormattedSource::get_unit(const std::string& key) const
+{
+    auto it = m_index.find(key);
+
+    if (it == m_index.end())
+        throw std::invalid_argument("key " + key + " not found in formatted case " + m_file.string());
+
+    return m_reader->units()[it->second];
+}
+
+const std::vector<float>& FormattedSource::get(const std::string& key) const
+{
+    auto it = m_index.find(key);
+
+    if (it == m_index.end())
+        throw std::invalid_argument("key " + key + " not found in formatted case " + m_file.string());
+
+    return m_reader->get(it->second);
+}
+
+bool FormattedSource::reopen()
+{
+    // FUNSMRY grows while FSMSPEC is unchanged for a running simulation
+
+    std::error_code ec;
+    auto funsmry_stamp = std::filesystem::last_write_time(m_funsmry_file, ec);
+
+    if (!this->has_changed() && (ec || (funsmry_stamp == m_funsmry_stamp)))
+        return false;
+
+    try {
+        this->open();
+    } catch (const std::exception& e) {
+        std::string message = "Error with reopen, failed when reading formatted summary file " + m_file.string();
+        throw std::runtime_error(message + ", " + e.what());
+    }
+
+    this->update_file_stamp();
+
+    return true;
+}
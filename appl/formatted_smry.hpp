@@ -0,0 +1,123 @@
+/*
+   Copyright 2022 Equinor ASA.
+
+   This file is part of the Open Porous Media project (OPM).
+
+   OPM is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   OPM is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#ifndef SMRY_APPL_FORMATTED_SMRY_HPP
+#define SMRY_APPL_FORMATTED_SMRY_HPP
+
+#include <appl/unsmry_reader.hpp>
+
+#include <array>
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+// Reader for formatted summary files (FSMSPEC/FUNSMRY). The FUNSMRY file is read into
+// memory and split in chunks on array headers, chunks are parsed in parallel with
+// std::from_chars. A file still being written is read up to the last complete PARAMS
+// array. Keys are made with make_smspec_index, see unsmry_reader.hpp.
+
+class FormattedSmryReader
+{
+public:
+
+    explicit FormattedSmryReader(const std::filesystem::path& fsmspec_file);
+
+    // sorted on column in PARAMS
+    const std::vector<std::string>& keyword_list() const { return m_keys; }
+    const std::vector<std::string>& units() const { return m_units; }
+
+    // day, month, year, hour, minute, second and millisecond
+    const std::array<int, 7>& start_date() const { return m_start_date; }
+
+    size_t number_of_time_steps() const { return m_report_step.size(); }
+
+    // index of the last time step in each report step, as SummarySource::report_step_index
+    std::vector<size_t> report_step_index() const { return last_step_index(m_report_step); }
+
+    // data for key number key_ind in keyword_list
+    const std::vector<float>& get(size_t key_ind) const { return m_data[key_ind]; }
+
+private:
+
+    void parse_funsmry(const std::filesystem::path& funsmry_file, const std::vector<int>& columns, size_t nlist);
+
+    std::vector<std::string> m_keys;
+    std::vector<std::string> m_units;
+    std::array<int, 7> m_start_date {};
+
+    std::vector<bool> m_report_step;
+    std::vector<std::vector<float>> m_data;
+};
+
+
+// Formatted case served from FormattedSmryReader, all data is parsed when opened and
+// reopened. The ESMRY cache (option -e) is used instead when enabled, see EsmryCache.
+
+class FormattedSource : public SummarySource {
+
+public:
+
+    explicit FormattedSource(const std::filesystem::path& fsmspec_file);
+
+    FileType file_type() const override { return FileType::FORMATTED; }
+    std::string rootname() const override { return m_file.stem().string(); }
+
+    bool has_key(const std::string& key) const override { return m_index.count(key) > 0; }
+    std::vector<std::string> keyword_list() const override { return m_keys; }
+    std::vector<std::string> keyword_list(const std::string& pattern) const override;
+    std::string get_unit(const std::string& key) const override;
+    bool all_steps_available() const override { return true; }
+    int number_of_time_steps() const override { return static_cast<int>(m_reader->number_of_time_steps()); }
+
+    time_point startdate() const override { return make_startdate(m_reader->start_date()); }
+    std::array<int, 7> start_date() const override { return m_reader->start_date(); }
+
+    std::tuple<double, double> io_elapsed() const override { return { m_elapsed_open, 0.0 }; }
+
+    // all data is in memory
+    void load(const std::vector<std::string>& /* keys */) override {}
+    const std::vector<float>& get(const std::string& key) const override;
+
+    // parses the case again if FSMSPEC or FUNSMRY is modified
+    bool reopen() override;
+
+protected:
+
+    std::vector<size_t> make_report_step_index() const override { return m_reader->report_step_index(); }
+
+private:
+
+    void open();
+
+    std::filesystem::path m_funsmry_file;
+    std::filesystem::file_time_type m_funsmry_stamp;
+
+    std::unique_ptr<FormattedSmryReader> m_reader;
+
+    // sorted as keyword_list for Opm::EclIO loaders, index in reader keyword_list
+    std::vector<std::string> m_keys;
+    std::unordered_map<std::string, size_t> m_index;
+
+    double m_elapsed_open = 0.0;
+};
+
+#endif // SMRY_APPL_FORMATTED_SMRY_HPP
@@ -0,0 +1,274 @@
+/*
+   Copyright 2022 Equinor ASA.
+
+   This file is part of the Open Porous Media project (OPM).
+
+   OPM is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   OPM is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#include <appl/keyword_catalogue.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <tuple>
+
+#include <fnmatch.h>
+
+
+uint32_t KeywordCatalogue::intern(const std::string& key)
+{
+    auto it = m_key_id.find(key);
+
+    if (it != m_key_id.end())
+        return it->second;
+
+    uint32_t id = static_cast<uint32_t>(m_key_table.size());
+
+    m_key_table.push_back(key);
+    m_key_id[key] = id;
+
+    return id;
+}
+
+
+size_t KeywordCatalogue::add_case(const std::vector<std::string>& keys)
+{
+    size_t case_ind = m_case_keys.size();
+
+    m_case_keys.push_back({});
+    m_case_sorted.push_back({});
+    m_case_bits.push_back({});
+
+    index_case(case_ind, keys);
+
+    return case_ind;
+}
+
+
+void KeywordCatalogue::update_case(size_t case_ind, const std::vector<std::string>& keys)
+{
+    if (case_ind >= m_case_keys.size())
+        throw std::invalid_argument("keyword catalogue, case index out of range");
+
+    index_case(case_ind, keys);
+}
+
+
+void KeywordCatalogue::clear()
+{
+    m_key_table.clear();
+    m_key_id.clear();
+
+    m_case_keys.clear();
+    m_case_sorted.clear();
+    m_case_bits.clear();
+}
+
+
+void KeywordCatalogue::index_case(size_t case_ind, const std::vector<std::string>& keys)
+{
+    auto& case_keys = m_case_keys[case_ind];
+    auto& case_sorted = m_case_sorted[case_ind];
+
+    case_keys.clear();
+    case_keys.reserve(keys.size());
+
+    for (auto& key : keys)
+        case_keys.push_back(intern(key));
+
+    case_sorted.resize(case_keys.size());
+
+    for (size_t n = 0; n < case_sorted.size(); n++)
+        case_sorted[n] = static_cast<uint32_t>(n);
+
+    std::sort(case_sorted.begin(), case_sorted.end(), [&](uint32_t a, uint32_t b) {
+        return m_key_table[case_keys[a]] < m_key_table[case_keys[b]];
+    });
+
+    // bitset is sized to the global table, keys interned by later cases are not set
+
+    auto& bits = m_case_bits[case_ind];
+    bits.assign((m_key_table.size() + 63) / 64, 0);
+
+    for (auto id : case_keys)
+        bits[id / 64] |= uint64_t(1) << (id % 64);
+}
+
+
+bool KeywordCatalogue::has_key(size_t case_ind, const std::string& key) const
+{
+    if (case_ind >= m_case_bits.size())
+        return false;
+
+    auto it = m_key_id.find(key);
+
+    if (it == m_key_id.end())
+        return false;
+
+    const auto& bits = m_case_bits[case_ind];
+    const uint32_t id = it->second;
+
+    if (id / 64 >= bits.size())
+        return false;
+
+    return (bits[id / 64] >> (id % 64)) & uint64_t(1);
+}
+
+
+std::string KeywordCatalogue::literal_prefix(const std::string& pattern)
+{
+    return pattern.substr(0, pattern.find_first_of("*?[\\"));
+}
+
+
+std::pair<size_t, size_t> KeywordCatalogue::prefix_range(size_t case_ind, const std::string& prefix) const
+{
+    return prefix_range(case_ind, prefix, std::make_pair(size_t(0), m_case_sorted[case_ind].size()));
+}
+
+
+std::pair<size_t, size_t> KeywordCatalogue::prefix_range(size_t case_ind, const std::string& prefix,
+                                                         const std::pair<size_t, size_t>& within) const
+{
+    const auto& case_keys = m_case_keys[case_ind];
+    const auto& case_sorted = m_case_sorted[case_ind];
+
+    auto first = std::lower_bound(case_sorted.begin() + within.first, case_sorted.begin() + within.second, prefix,
+                                  [&](uint32_t pos, const std::string& val) {
+        return m_key_table[case_keys[pos]] < val;
+    });
+
+    auto last = std::upper_bound(first, case_sorted.begin() + within.second, prefix,
+                                 [&](const std::string& val, uint32_t pos) {
+        return m_key_table[case_keys[pos]].compare(0, val.size(), val) > 0;
+    });
+
+    return std::make_pair(static_cast<size_t>(first - case_sorted.begin()),
+                          static_cast<size_t>(last - case_sorted.begin()));
+}
+
+
+const std::string& KeywordCatalogue::sorted_key(size_t case_ind, size_t n) const
+{
+    return m_key_table[m_case_keys[case_ind][m_case_sorted[case_ind][n]]];
+}
+
+
+std::vector<uint32_t> KeywordCatalogue::match(size_t case_ind, const std::string& pattern) const
+{
+    // only keys starting with the literal part of the pattern are tested
+
+    auto range = prefix_range(case_ind, literal_prefix(pattern));
+
+    const auto& case_keys = m_case_keys[case_ind];
+    const auto& case_sorted = m_case_sorted[case_ind];
+
+    std::vector<uint32_t> pos_list;
+
+    for (size_t n = range.first; n < range.second; n++) {
+
+        uint32_t pos = case_sorted[n];
+
+        if (fnmatch(pattern.c_str(), m_key_table[case_keys[pos]].c_str(), 0) == 0)
+            pos_list.push_back(pos);
+    }
+
+    std::sort(pos_list.begin(), pos_list.end());
+
+    return pos_list;
+}
+
+
+std::vector<std::string> KeywordCatalogue::keyword_list(size_t case_ind, const std::string& pattern) const
+{
+    std::vector<std::string> keys;
+
+    if (case_ind >= m_case_keys.size())
+        return keys;
+
+    auto pos_list = match(case_ind, pattern);
+
+    keys.reserve(pos_list.size());
+
+    for (auto pos : pos_list)
+        keys.push_back(m_key_table[m_case_keys[case_ind][pos]]);
+
+    return keys;
+}
+
+
+std::vector<std::string> KeywordCatalogue::keyword_list(size_t case_ind) const
+{
+    std::vector<std::string> keys;
+    keys.reserve(m_case_keys[case_ind].size());
+
+    for (auto id : m_case_keys[case_ind])
+        keys.push_back(m_key_table[id]);
+
+    return keys;
+}
+
+
+std::vector<std::string> KeywordCatalogue::item_names(size_t case_ind, const std::string& vect_name,
+                                                      const std::string& filt) const
+{
+    std::vector<std::string> names;
+
+    for (auto& key : keyword_list(case_ind, vect_name + ":" + filt))
+        names.push_back(key.substr(key.find_last_of(":") + 1));
+
+    return names;
+}
+
+
+std::vector<std::string> KeywordCatalogue::fuzzy_item_match(size_t case_ind, const std::string& vect_name,
+                                                            const std::string& name_part) const
+{
+    // span, start position, key
+    std::vector<std::tuple<size_t, size_t, const std::string*>> cand_list;
+
+    const std::string prefix = vect_name + ":";
+    auto range = prefix_range(case_ind, prefix);
+
+    for (size_t n = range.first; n < range.second; n++) {
+
+        const std::string& key = sorted_key(case_ind, n);
+
+        size_t first = std::string::npos;
+        size_t p = prefix.size();
+        size_t m = 0;
+
+        for (; (p < key.size()) && (m < name_part.size()); p++) {
+            if (key[p] == name_part[m]) {
+                if (m == 0)
+                    first = p;
+                m++;
+            }
+        }
+
+        if (m == name_part.size())
+            cand_list.push_back(std::make_tuple(p - first, first, &key));
+    }
+
+    std::stable_sort(cand_list.begin(), cand_list.end(), [](const auto& a, const auto& b) {
+        return std::make_pair(std::get<0>(a), std::get<1>(a)) < std::make_pair(std::get<0>(b), std::get<1>(b));
+    });
+
+    std::vector<std::string> keys;
+    keys.reserve(cand_list.size());
+
+    for (auto& cand : cand_list)
+        keys.push_back(*std::get<2>(cand));
+
+    return keys;
+}
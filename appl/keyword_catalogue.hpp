@@ -0,0 +1,96 @@
+/*
+   Copyright 2022 Equinor ASA.
+
+   This file is part of the Open Porous Media project (OPM).
+
+   OPM is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   OPM is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#ifndef KEYWORD_CATALOGUE_HPP
+#define KEYWORD_CATALOGUE_HPP
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+// Summary keys for all cases, built once when the summary files are opened.
+// Key names are interned in one global table, each case holds a bitset over
+// the global key ids (existence queries) and a sorted index over its keys
+// (prefix and pattern queries). Pattern results are returned in the same
+// order as the keyword list of the loader.
+
+class KeywordCatalogue
+{
+public:
+
+    KeywordCatalogue() = default;
+
+    size_t add_case(const std::vector<std::string>& keys);
+    void update_case(size_t case_ind, const std::vector<std::string>& keys);
+    void clear();
+
+    size_t number_of_cases() const { return m_case_keys.size(); }
+    size_t number_of_keys() const { return m_key_table.size(); }
+    size_t number_of_keys(size_t case_ind) const { return m_case_keys[case_ind].size(); }
+
+    bool has_key(size_t case_ind, const std::string& key) const;
+
+    // pattern with wildcards (fnmatch), keys in loader order
+    std::vector<std::string> keyword_list(size_t case_ind, const std::string& pattern) const;
+
+    // all keys of case in loader order
+    std::vector<std::string> keyword_list(size_t case_ind) const;
+
+    // names (after :) of keys vect_name:name, where name matches pattern filt
+    std::vector<std::string> item_names(size_t case_ind, const std::string& vect_name,
+                                        const std::string& filt) const;
+
+    // range [first, last) in sorted key list of case, keys starting with prefix
+    std::pair<size_t, size_t> prefix_range(size_t case_ind, const std::string& prefix) const;
+
+    // as above, searching only inside range of a shorter prefix (incremental narrowing)
+    std::pair<size_t, size_t> prefix_range(size_t case_ind, const std::string& prefix,
+                                           const std::pair<size_t, size_t>& within) const;
+
+    const std::string& sorted_key(size_t case_ind, size_t n) const;
+
+    // keys vect_name:name where the characters of name_part appear in order in name,
+    // best matches (shortest span, earliest start) first
+    std::vector<std::string> fuzzy_item_match(size_t case_ind, const std::string& vect_name,
+                                              const std::string& name_part) const;
+
+    static std::string literal_prefix(const std::string& pattern);
+
+private:
+
+    std::vector<std::string> m_key_table;
+    std::unordered_map<std::string, uint32_t> m_key_id;
+
+    // global key ids in loader order
+    std::vector<std::vector<uint32_t>> m_case_keys;
+
+    // positions in m_case_keys sorted on key name
+    std::vector<std::vector<uint32_t>> m_case_sorted;
+
+    std::vector<std::vector<uint64_t>> m_case_bits;
+
+    uint32_t intern(const std::string& key);
+    void index_case(size_t case_ind, const std::vector<std::string>& keys);
+
+    std::vector<uint32_t> match(size_t case_ind, const std::string& pattern) const;
+};
+
+#endif // KEYWORD_CATALOGUE_HPP
@@ -0,0 +1,439 @@
+/*
+   Copyright 2022 Equinor ASA.
+
+   This file is part of the Open Porous Media project (OPM).
+
+   OPM is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   OPM is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#include <appl/live_source.hpp>
+
+#include <QElapsedTimer>
+
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#include <fnmatch.h>
+
+
+namespace {
+
+// frames larger than this are treated as a corrupt stream
+
+const size_t max_frame_size = 256 * 1024 * 1024;
+
+uint32_t read_u32(const char* p)
+{
+    auto b = reinterpret_cast<const unsigned char*>(p);
+    return uint32_t(b[0]) | (uint32_t(b[1]) << 8) | (uint32_t(b[2]) << 16) | (uint32_t(b[3]) << 24);
+}
+
+uint16_t read_u16(const char* p)
+{
+    auto b = reinterpret_cast<const unsigned char*>(p);
+    return uint16_t(b[0]) | uint16_t(b[1] << 8);
+}
+
+float read_f32(const char* p)
+{
+    uint32_t v = read_u32(p);
+
+    float f;
+    std::memcpy(&f, &v, sizeof(f));
+    return f;
+}
+
+void put_u32(std::string& buffer, uint32_t v)
+{
+    for (int n = 0; n < 4; n++)
+        buffer.push_back(static_cast<char>((v >> (8 * n)) & 0xff));
+}
+
+void put_u16(std::string& buffer, uint16_t v)
+{
+    buffer.push_back(static_cast<char>(v & 0xff));
+    buffer.push_back(static_cast<char>((v >> 8) & 0xff));
+}
+
+void put_string(std::string& buffer, const std::string& str)
+{
+    put_u16(buffer, static_cast<uint16_t>(str.size()));
+    buffer.append(str);
+}
+
+std::string make_frame(uint8_t type, const std::string& payload)
+{
+    std::string frame;
+    frame.reserve(payload.size() + 5);
+
+    put_u32(frame, static_cast<uint32_t>(payload.size() + 1));
+    frame.push_back(static_cast<char>(type));
+    frame.append(payload);
+
+    return frame;
+}
+
+} // anonymous namespace
+
+
+LiveSource::LiveSource(const std::string& name) :
+    SummarySource(std::filesystem::path()), m_name(name)
+{
+}
+
+std::vector<std::string> LiveSource::keyword_list(const std::string& pattern) const
+{
+    std::vector<std::string> key_list;
+
+    for (auto& key : m_keys)
+        if (fnmatch(pattern.c_str(), key.c_str(), 0) == 0)
+            key_list.push_back(key);
+
+    return key_list;
+}
+
+std::string LiveSource::get_unit(const std::string& key) const
+{
+    auto it = m_index.find(key);
+
+    if (it == m_index.end())
+        throw std::invalid_argument("key " + key + " not found in live case " + m_name);
+
+    return m_units[it->second];
+}
+
+SummarySource::time_point LiveSource::startdate() const
+{
+    return make_startdate(m_start_date);
+}
+
+const std::vector<float>& LiveSource::get(const std::string& key) const
+{
+    auto it = m_index.find(key);
+
+    if (it == m_index.end())
+        throw std::invalid_argument("key " + key + " not found in live case " + m_name);
+
+    return m_data[it->second];
+}
+
+std::vector<size_t> LiveSource::make_report_step_index() const
+{
+    // last time step in each report step, from the first time step in the next
+
+    std::vector<size_t> index;
+
+    for (size_t t = 0; t + 1 < m_report_step.size(); t++)
+        if (m_report_step[t + 1])
+            index.push_back(t);
+
+    // all time steps if the simulator does not flag report steps
+
+    if (index.size() == 0)
+        return SummarySource::make_report_step_index();
+
+    index.push_back(m_report_step.size() - 1);
+
+    return index;
+}
+
+bool LiveSource::reopen()
+{
+    bool updated = m_header_count != m_reopen_header_count;
+    m_reopen_header_count = m_header_count;
+
+    return updated;
+}
+
+void LiveSource::set_header(const std::array<int, 7>& start_date, const std::vector<std::string>& keys,
+                            const std::vector<std::string>& units)
+{
+    if (keys.size() != units.size())
+        throw std::invalid_argument("number of keys and units not equal in live case " + m_name);
+
+    // case left unchanged if the header is rejected
+
+    std::unordered_map<std::string, size_t> index;
+
+    for (size_t n = 0; n < keys.size(); n++)
+        index[keys[n]] = n;
+
+    if (index.count("TIME") == 0)
+        throw std::invalid_argument("TIME missing in header for live case " + m_name);
+
+    m_start_date = start_date;
+    m_keys = keys;
+    m_units = units;
+    m_index = std::move(index);
+
+    // a new header starts the case again, the step count alone does not show the change
+    this->reset_report_step_index();
+
+    m_data.assign(m_keys.size(), {});
+    m_report_step.clear();
+
+    m_header_count++;
+    m_finished = false;
+}
+
+void LiveSource::append_step(const float* values, bool report_step)
+{
+    for (size_t n = 0; n < m_data.size(); n++)
+        m_data[n].push_back(values[n]);
+
+    m_report_step.push_back(report_step);
+}
+
+
+void LiveFrameDecoder::feed(const char* data, size_t size, LiveSource& source)
+{
+    m_buffer.append(data, size);
+
+    size_t pos = 0;
+
+    while (m_buffer.size() - pos >= 4) {
+
+        size_t frame_size = read_u32(m_buffer.data() + pos);
+
+        if ((frame_size == 0) || (frame_size > max_frame_size))
+            throw std::runtime_error("invalid frame size " + std::to_string(frame_size) + " in live feed");
+
+        if (m_buffer.size() - pos - 4 < frame_size)
+            break;
+
+        const char* frame = m_buffer.data() + pos + 4;
+
+        this->decode_frame(static_cast<uint8_t>(frame[0]), frame + 1, frame_size - 1, source);
+
+        pos += frame_size + 4;
+    }
+
+    m_buffer.erase(0, pos);
+}
+
+void LiveFrameDecoder::decode_frame(uint8_t type, const char* payload, size_t size, LiveSource& source)
+{
+    if (type == FrameType::header) {
+
+        if (size < 32)
+            throw std::runtime_error("live feed header frame too short");
+
+        std::array<int, 7> start_date;
+
+        for (size_t n = 0; n < 7; n++)
+            start_date[n] = static_cast<int32_t>(read_u32(payload + n * 4));
+
+        size_t num_keys = read_u32(payload + 28);
+        size_t pos = 32;
+
+        std::vector<std::string> keys;
+        std::vector<std::string> units;
+
+        auto read_string = [&](std::vector<std::string>& list) {
+            if (pos + 2 > size)
+                throw std::runtime_error("live feed header frame too short");
+
+            size_t len = read_u16(payload + pos);
+
+            if (pos + 2 + len > size)
+                throw std::runtime_error("live feed header frame too short");
+
+            list.push_back(std::string(payload + pos + 2, len));
+            pos += 2 + len;
+        };
+
+        for (size_t n = 0; n < num_keys; n++) {
+            read_string(keys);
+            read_string(units);
+        }
+
+        try {
+            source.set_header(start_date, keys, units);
+        } catch (const std::invalid_argument& e) {
+            throw std::runtime_error(e.what());
+        }
+
+    } else if (type == FrameType::step) {
+
+        size_t num_keys = source.number_of_keys();
+
+        if (num_keys == 0)
+            throw std::runtime_error("live feed time step received before header");
+
+        if (size != 1 + num_keys * 4)
+            throw std::runtime_error("live feed time step with " + std::to_string((size - 1) / 4)
+                                     + " values, expected " + std::to_string(num_keys));
+
+        std::vector<float> values(num_keys);
+
+        for (size_t n = 0; n < num_keys; n++)
+            values[n] = read_f32(payload + 1 + n * 4);
+
+        source.append_step(values.data(), payload[0] != 0);
+
+    } else if (type == FrameType::end) {
+
+        source.set_finished();
+
+    } else {
+
+        throw std::runtime_error("unknown frame type " + std::to_string(type) + " in live feed");
+    }
+}
+
+
+std::string encode_live_header(const std::array<int, 7>& start_date, const std::vector<std::string>& keys,
+                               const std::vector<std::string>& units)
+{
+    std::string payload;
+
+    for (auto v : start_date)
+        put_u32(payload, static_cast<uint32_t>(v));
+
+    put_u32(payload, static_cast<uint32_t>(keys.size()));
+
+    for (size_t n = 0; n < keys.size(); n++) {
+        put_string(payload, keys[n]);
+        put_string(payload, n < units.size() ? units[n] : "");
+    }
+
+    return make_frame(LiveFrameDecoder::header, payload);
+}
+
+std::string encode_live_step(const std::vector<float>& values, bool report_step)
+{
+    std::string payload;
+    payload.reserve(values.size() * 4 + 1);
+
+    payload.push_back(report_step ? 1 : 0);
+
+    for (auto v : values) {
+        uint32_t u;
+        std::memcpy(&u, &v, sizeof(u));
+        put_u32(payload, u);
+    }
+
+    return make_frame(LiveFrameDecoder::step, payload);
+}
+
+std::string encode_live_end()
+{
+    return make_frame(LiveFrameDecoder::end, "");
+}
+
+
+LiveFeed::LiveFeed(const QString& server_name, int smry_ind, LiveSource& source, QObject* parent) :
+    QObject(parent), m_server_name(server_name), m_smry_ind(smry_ind), m_source(source)
+{
+    m_server = new QLocalServer(this);
+
+    connect(m_server, &QLocalServer::newConnection, this, &LiveFeed::new_connection);
+}
+
+bool LiveFeed::listen()
+{
+    QLocalServer::removeServer(m_server_name);
+
+    if (!m_server->listen(m_server_name)) {
+        std::cout << "\n!Warning, live feed " << m_server_name.toStdString() << " failed to listen: "
+                  << m_server->errorString().toStdString() << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool LiveFeed::wait_for_data(int msecs)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    while ((m_source.header_count() == 0) || (m_source.number_of_time_steps() == 0)) {
+
+        int remaining = msecs - static_cast<int>(timer.elapsed());
+
+        if (remaining <= 0)
+            return false;
+
+        if (m_socket == nullptr) {
+
+            if (!m_server->waitForNewConnection(remaining))
+                return false;
+
+            if (m_socket == nullptr)
+                this->new_connection();
+
+        } else if (m_socket->bytesAvailable() > 0) {
+
+            this->read_data();
+
+        } else if (!m_socket->waitForReadyRead(remaining)) {
+
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void LiveFeed::new_connection()
+{
+    QLocalSocket* socket = m_server->nextPendingConnection();
+
+    if (socket == nullptr)
+        return;
+
+    if (m_socket != nullptr) {
+        m_socket->disconnect(this);
+        m_socket->abort();
+        m_socket->deleteLater();
+    }
+
+    m_socket = socket;
+    m_decoder.reset();
+
+    connect(m_socket, &QLocalSocket::readyRead, this, &LiveFeed::read_data);
+
+    connect(m_socket, &QLocalSocket::disconnected, this, [this, socket]() {
+        if (m_socket == socket)
+            m_socket = nullptr;
+
+        socket->deleteLater();
+    });
+}
+
+void LiveFeed::read_data()
+{
+    if (m_socket == nullptr)
+        return;
+
+    QByteArray bytes = m_socket->readAll();
+
+    int first_step = m_source.number_of_time_steps();
+    int header_count = m_source.header_count();
+
+    try {
+        m_decoder.feed(bytes.constData(), bytes.size(), m_source);
+    } catch (const std::runtime_error& e) {
+        std::cout << "\n!Warning, live feed " << m_server_name.toStdString() << ": " << e.what()
+                  << ", connection closed" << std::endl;
+
+        m_socket->abort();
+    }
+
+    if (m_source.header_count() != header_count)
+        emit header_received(m_smry_ind);
+    else if (m_source.number_of_time_steps() > first_step)
+        emit steps_received(m_smry_ind, first_step);
+}
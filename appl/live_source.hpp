@@ -0,0 +1,183 @@
+/*
+   Copyright 2022 Equinor ASA.
+
+   This file is part of the Open Porous Media project (OPM).
+
+   OPM is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   OPM is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#ifndef SMRY_APPL_LIVE_SOURCE_HPP
+#define SMRY_APPL_LIVE_SOURCE_HPP
+
+#include <appl/summary_source.hpp>
+
+#include <QObject>
+#include <QLocalServer>
+#include <QLocalSocket>
+
+#include <array>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+// Summary case pushed from a running simulator over a local socket (QLocalServer, a Unix
+// domain socket on Linux). Frames, all numbers little endian:
+//
+//   frame  : uint32 size (number of bytes after this field), uint8 type, payload
+//   HEADER : type 1, int32 x 7 start date (day, month, year, hour, minute, second, millisecond),
+//            uint32 number of keys, and for each key uint16 length + key, uint16 length + unit
+//   STEP   : type 2, uint8 report step (1 for first time step in report step), float32 for
+//            each key in header order
+//   END    : type 3, no payload, simulation finished
+//
+// Keys are named as in Opm::EclIO::ESmry (FOPR, WOPR:PROD-1, ..), the header must have TIME.
+// A new header starts the case again.
+
+class LiveSource : public SummarySource {
+
+public:
+
+    explicit LiveSource(const std::string& name);
+
+    FileType file_type() const override { return FileType::LIVE; }
+    std::string rootname() const override { return m_name; }
+
+    bool has_key(const std::string& key) const override { return m_index.count(key) > 0; }
+    std::vector<std::string> keyword_list() const override { return m_keys; }
+    std::vector<std::string> keyword_list(const std::string& pattern) const override;
+    std::string get_unit(const std::string& key) const override;
+    bool all_steps_available() const override { return true; }
+    int number_of_time_steps() const override { return static_cast<int>(m_report_step.size()); }
+
+    time_point startdate() const override;
+    std::array<int, 7> start_date() const override { return m_start_date; }
+
+    std::tuple<double, double> io_elapsed() const override { return { 0.0, 0.0 }; }
+
+    // all data is in memory
+    void load(const std::vector<std::string>& /* keys */) override {}
+    const std::vector<float>& get(const std::string& key) const override;
+
+    // true if a new header was received since last call. Time steps appended to an
+    // existing header are drawn directly, see SmryAppl::append_live_steps
+    bool reopen() override;
+
+    void set_header(const std::array<int, 7>& start_date, const std::vector<std::string>& keys,
+                    const std::vector<std::string>& units);
+
+    void append_step(const float* values, bool report_step);
+
+    void set_finished() { m_finished = true; }
+    bool finished() const { return m_finished; }
+
+    size_t number_of_keys() const { return m_keys.size(); }
+    int header_count() const { return m_header_count; }
+
+protected:
+
+    // from the report step flags of the time steps received so far
+    std::vector<size_t> make_report_step_index() const override;
+
+private:
+
+    std::string m_name;
+
+    std::array<int, 7> m_start_date {};
+    std::vector<std::string> m_keys;
+    std::vector<std::string> m_units;
+    std::unordered_map<std::string, size_t> m_index;
+
+    std::vector<std::vector<float>> m_data;
+    std::vector<bool> m_report_step;
+
+    int m_header_count = 0;
+    int m_reopen_header_count = 0;
+    bool m_finished = false;
+};
+
+
+// Splits the byte stream from the socket in frames, complete frames are applied to the source
+// and incomplete frames are kept until more data is received.
+
+class LiveFrameDecoder {
+
+public:
+
+    enum FrameType : uint8_t { header = 1, step = 2, end = 3 };
+
+    // throws std::runtime_error for invalid frames
+    void feed(const char* data, size_t size, LiveSource& source);
+
+    void reset() { m_buffer.clear(); }
+
+private:
+
+    std::string m_buffer;
+
+    void decode_frame(uint8_t type, const char* payload, size_t size, LiveSource& source);
+};
+
+
+// frames for producers, also used by the tests
+
+std::string encode_live_header(const std::array<int, 7>& start_date, const std::vector<std::string>& keys,
+                               const std::vector<std::string>& units);
+
+std::string encode_live_step(const std::vector<float>& values, bool report_step = false);
+
+std::string encode_live_end();
+
+
+// Local server for one live case. One producer connected at the time, a new connection
+// replaces the previous one.
+
+class LiveFeed : public QObject {
+
+    Q_OBJECT
+
+public:
+
+    LiveFeed(const QString& server_name, int smry_ind, LiveSource& source, QObject* parent = nullptr);
+
+    // removes a socket left by a server that was not closed
+    bool listen();
+
+    QString server_name() const { return m_server_name; }
+
+    // blocking, used before charts are made for a case without data
+    bool wait_for_data(int msecs);
+
+signals:
+
+    void header_received(int smry_ind);
+    void steps_received(int smry_ind, int first_step);
+
+private slots:
+
+    void new_connection();
+    void read_data();
+
+private:
+
+    QString m_server_name;
+    int m_smry_ind;
+
+    LiveSource& m_source;
+    LiveFrameDecoder m_decoder;
+
+    QLocalServer* m_server;
+    QLocalSocket* m_socket = nullptr;
+};
+
+#endif // SMRY_APPL_LIVE_SOURCE_HPP
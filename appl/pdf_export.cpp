@@ -0,0 +1,140 @@
+/*
+   Copyright 2022 Equinor ASA.
+
+   This file is part of the Open Porous Media project (OPM).
+
+   OPM is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   OPM is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#include <appl/pdf_export.hpp>
+#include <appl/chartview.hpp>
+
+#include <QImage>
+#include <QPainter>
+#include <QPdfWriter>
+#include <QPageSize>
+#include <QPageLayout>
+
+#include <omp.h>
+#include <algorithm>
+
+
+PdfExport::PdfExport(const QString& file_name, bool raster)
+    : m_file_name(file_name),
+      m_raster(raster)
+{
+}
+
+
+void PdfExport::add_chart(ChartView* chart_view, const QSize& size)
+{
+    // charts not visible in the stacked widget may not have been resized yet
+    chart_view->resize_scene(size);
+
+    QPicture picture;
+    QPainter painter(&picture);
+
+    chart_view->scene()->render(&painter, QRectF(0, 0, size.width(), size.height()),
+                                QRectF(0, 0, size.width(), size.height()));
+    painter.end();
+
+    m_pages.push_back(picture);
+    m_page_size.push_back(size);
+}
+
+
+bool PdfExport::write(progress_type progress)
+{
+    if (m_pages.size() == 0)
+        return false;
+
+    QPdfWriter writer(m_file_name);
+
+    QSizeF size1 ( 600, 1400 );
+    QPageSize page1 ( size1, QPageSize::Unit::Point, "Custom" );
+
+    writer.setPageSize ( page1 );
+    writer.setPageOrientation ( QPageLayout::Landscape );
+
+    QPainter painter;
+
+    if (!painter.begin(&writer))
+        return false;
+
+    const QRect viewport = painter.viewport();
+
+    auto target_rect = [&viewport](const QSize& size) {
+        QSize target = size.scaled(viewport.size(), Qt::KeepAspectRatio);
+        return QRect(viewport.topLeft(), target);
+    };
+
+    // raster pages are rendered in batches to limit memory use
+
+    const size_t batch_size = m_raster ? static_cast<size_t>(2 * omp_get_max_threads()) : 1;
+
+    std::vector<QImage> images;
+
+    for (size_t b0 = 0; b0 < m_pages.size(); b0 += batch_size) {
+
+        const size_t b1 = std::min(b0 + batch_size, m_pages.size());
+
+        if (m_raster) {
+
+            images.assign(b1 - b0, QImage());
+
+            #pragma omp parallel for
+            for (size_t n = b0; n < b1; n++) {
+
+                QSize img_size = m_page_size[n] * raster_scale;
+
+                QImage image(img_size, QImage::Format_ARGB32_Premultiplied);
+                image.fill(Qt::white);
+
+                QPainter img_painter(&image);
+                img_painter.setRenderHint(QPainter::Antialiasing);
+                img_painter.scale(raster_scale, raster_scale);
+                img_painter.drawPicture(0, 0, m_pages[n]);
+                img_painter.end();
+
+                images[n - b0] = image;
+            }
+        }
+
+        for (size_t n = b0; n < b1; n++) {
+
+            if (n > 0)
+                writer.newPage();
+
+            QRect target = target_rect(m_page_size[n]);
+
+            if (m_raster) {
+                painter.drawImage(target, images[n - b0]);
+
+            } else {
+                painter.save();
+                painter.translate(target.topLeft());
+                painter.scale(static_cast<double>(target.width()) / m_page_size[n].width(),
+                              static_cast<double>(target.height()) / m_page_size[n].height());
+                painter.drawPicture(0, 0, m_pages[n]);
+                painter.restore();
+            }
+
+            if (progress)
+                progress(n + 1, m_pages.size());
+        }
+    }
+
+    painter.end();
+
+    return true;
+}
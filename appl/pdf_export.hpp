@@ -0,0 +1,63 @@
+/*
+   Copyright 2022 Equinor ASA.
+
+   This file is part of the Open Porous Media project (OPM).
+
+   OPM is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   OPM is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#ifndef PDF_EXPORT_H
+#define PDF_EXPORT_H
+
+#include <QPicture>
+#include <QSize>
+#include <QString>
+
+#include <functional>
+#include <vector>
+
+class ChartView;
+
+
+// Multi-page pdf export. Charts are recorded to vector pictures on the GUI thread
+// (the graphics scene is not thread safe). Pages are then written to the pdf in order,
+// either as vector graphics or, in raster mode, as images rendered in parallel worker threads.
+
+class PdfExport
+{
+public:
+
+    // pages done, total number of pages
+    using progress_type = std::function<void(size_t, size_t)>;
+
+    PdfExport(const QString& file_name, bool raster = false);
+
+    void add_chart(ChartView* chart_view, const QSize& size);
+
+    size_t number_of_pages() const { return m_pages.size(); }
+
+    bool write(progress_type progress = nullptr);
+
+private:
+
+    QString m_file_name;
+    bool m_raster;
+
+    // resolution of raster pages relative to chart size on screen
+    const double raster_scale = 2.0;
+
+    std::vector<QPicture> m_pages;
+    std::vector<QSize> m_page_size;
+};
+
+#endif
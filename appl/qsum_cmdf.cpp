@@ -17,14 +17,25 @@
    */
 
 #include <appl/qsum_cmdf.hpp>
+#include <appl/fnv1a_hash.hpp>
 
 #include <iostream>
 
+#include <cstdlib>
 #include <filesystem>
 #include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
 
+#include <unistd.h>
 
-QsumCMDF::QsumCMDF(const std::string& cmd_file, int num_smry_files, const std::string& cmdl_list)
+
+// bump if the format of the processed command lines changes
+static const std::string cmdf_cache_version = "QSUM_CMDF_CACHE 2";
+
+
+QsumCMDF::QsumCMDF(const std::string& cmd_file, int num_smry_files, const std::string& cmdl_list, bool use_cache)
 
 {
     m_num_smry_files = num_smry_files;
@@ -32,14 +43,28 @@ QsumCMDF::QsumCMDF(const std::string& cmd_file, int num_smry_files, const std::s
     // reading command file, no processing stored in variable m_cmd_lines
     get_cmdlines(cmd_file);
 
-    // variable $NUM_CASES is processed if used, stored in variable m_cmd_lines
-    update_variables();
+    std::filesystem::path cache_fname;
+
+    if (use_cache){
+        cache_fname = cache_file(cmdl_list);
+        m_from_cache = read_cache(cache_fname);
+    }
+
+    if (!m_from_cache){
+
+        // variable $NUM_CASES is processed if used, stored in variable m_cmd_lines
+        update_variables();
 
-    // processing cmd_lines storing this in m_processed_cmd_lines
-    // for loops and lists are processed
-    process_cmdlines(cmdl_list);
+        // command lines parsed to tree, loops and lists are expanded
+        // and the result stored in m_processed_cmd_lines
+        parse_cmdlines(cmdl_list);
+        expand(m_cmd_tree);
 
-    update_rhs_cmd_lines_define();
+        update_rhs_cmd_lines_define();
+
+        if (use_cache)
+            write_cache(cache_fname);
+    }
 
     make_define_vect();
 }
@@ -63,16 +88,12 @@ void QsumCMDF::print_m_defined()
 
 int QsumCMDF::derived_key_index(const std::string& name)
 {
+    auto it = m_define_index.find(name);
 
-    for (size_t n = 0; n < m_define_vect.size(); n++){
-        auto def =  m_define_vect[n];
-        std::string def_name = std::get<0>(def);
+    if (it == m_define_index.end())
+        return -1;
 
-        if (def_name == name )
-            return n;
-    }
-
-    return -1;
+    return it->second;
 }
 
 
@@ -106,9 +127,15 @@ void QsumCMDF::make_define_vect()
 
             int key_index = derived_key_index(name);
 
-            if (key_index > -1)
+            if (key_index > -1){
+                // redefined, latest definition placed last
                 m_define_vect.erase(m_define_vect.begin() + key_index);
 
+                for (size_t m = key_index; m < m_define_vect.size(); m++)
+                    m_define_index[std::get<0>(m_define_vect[m])] = m;
+            }
+
+            m_define_index[name] = m_define_vect.size();
             m_define_vect.push_back(def);
         }
     }
@@ -120,32 +147,31 @@ void QsumCMDF::get_cmdlines(const std::string& filename)
     std::filesystem::path fs_cmdf(filename);
     auto file_size = std::filesystem::file_size(fs_cmdf);
 
-    char* buffer = new char [file_size];
+    std::string fileStr(file_size, '\0');
 
-    std::ifstream cmdf(filename);
-    cmdf.read (buffer, file_size);
+    std::ifstream cmdf(filename, std::ios::binary);
+    cmdf.read (fileStr.data(), file_size);
     cmdf.close();
 
-    std::string fileStr = std::string(buffer, file_size);
+    m_cmdf_hash = fnv1a_hash(fileStr);
 
-    delete[] buffer;
+    std::string_view file_view(fileStr);
 
-    bool end_of_file = false;
+    size_t p0 = 0;
 
-    int p0 = 0;
+    while (p0 <= file_view.size()) {
+        size_t p1 = file_view.find_first_of('\n', p0);
 
-    while (! end_of_file) {
-        int p1 = fileStr.find_first_of("\n", p0);
+        if (p1 == std::string_view::npos)
+            p1 = file_view.size();
 
-        std::string tmp = fileStr.substr(p0, p1-p0);
+        std::string_view line = file_view.substr(p0, p1 - p0);
 
-        remove_trailing_char(tmp," \t");
+        auto l = line.find_last_not_of(" \t");
+        line = (l == std::string_view::npos) ? std::string_view() : line.substr(0, l + 1);
 
-        if ((tmp.substr(0,2) != "--") and (tmp.size() > 0) and (tmp.substr(0,1) != "#"))
-            m_cmd_lines.push_back(tmp);
-
-        if (p1 >  fileStr.size())
-            end_of_file = true;
+        if ((line.size() > 0) && (line.substr(0,2) != "--") && (line[0] != '#'))
+            m_cmd_lines.emplace_back(line);
 
         p0 = p1 + 1;
     }
@@ -156,23 +182,17 @@ std::vector<std::string> QsumCMDF::split(const std::string& line, const std::str
 {
     std::vector<std::string> res;
 
-    int p0 = 0;
-    bool end_of_line = false;
+    size_t p0 = 0;
 
-    while (!end_of_line) {
+    while (p0 < line.size()) {
 
-        int p1 = line.find_first_of(delim, p0);
+        size_t p1 = line.find_first_of(delim, p0);
 
-        if (p1 != std::string::npos ) {
-            std::string tmp = line.substr(p0, p1-p0);
-            if (tmp.size()>0)
-                res.push_back(tmp);
-        } else {
-            end_of_line = true;
-            std::string tmp = line.substr(p0);
-            if (tmp.size()>0)
-                res.push_back(line.substr(p0));
-        }
+        if (p1 == std::string::npos)
+            p1 = line.size();
+
+        if (p1 > p0)
+            res.push_back(line.substr(p0, p1 - p0));
 
         p0 = p1 + 1;
     }
@@ -183,23 +203,23 @@ std::vector<std::string> QsumCMDF::split(const std::string& line, const std::str
 
 void QsumCMDF::remove_trailing_char(std::string& line, const std::string& charlist)
 {
-    size_t n = line.size();
+    auto n = line.find_last_not_of(charlist);
 
-    while ((n > 0) && (charlist.find(line.substr(n-1, 1)) != std::string::npos))
-       n--;
-
-    line = line.substr(0,n);
+    line.resize(n == std::string::npos ? 0 : n + 1);
 }
 
 
 bool QsumCMDF::update_variables()
 {
+    const std::string var_str = "$NUM_CASES";
+    const std::string num_str = std::to_string(m_num_smry_files);
+
     for (size_t n = 0; n < m_cmd_lines.size(); n++){
-        auto pos = m_cmd_lines[n].find("$NUM_CASES");
+        auto pos = m_cmd_lines[n].find(var_str);
 
         while (pos != std::string::npos){
-            m_cmd_lines[n].replace(pos,10, std::to_string(m_num_smry_files));
-            pos = m_cmd_lines[n].find("$NUM_CASES");
+            m_cmd_lines[n].replace(pos, var_str.size(), num_str);
+            pos = m_cmd_lines[n].find(var_str, pos + num_str.size());
         }
     }
 
@@ -210,20 +230,10 @@ bool QsumCMDF::update_variables()
 void QsumCMDF::add_series(input_list_type& input_charts, int smry_ind, const std::string& name, int axis_ind,
                 const std::string &xrange_input, bool is_derived)
 {
+    auto& chart_input = input_charts.back();
 
-    int chart_ind = input_charts.size() - 1;
-
-    std::tuple<int, std::string, int, bool> new_smry_vect = std::make_tuple(smry_ind, name, axis_ind, is_derived);
-
-    char_input_type chart_input = input_charts.back();
-
-    std::vector<vect_input_type> smry_vect_input = std::get<0>(chart_input);
-
-    smry_vect_input.push_back(new_smry_vect);
-
-    chart_input = std::make_tuple(smry_vect_input, xrange_input);
-
-    input_charts.back() = chart_input;
+    std::get<0>(chart_input).push_back(std::make_tuple(smry_ind, name, axis_ind, is_derived));
+    std::get<1>(chart_input) = xrange_input;
 }
 
 
@@ -232,11 +242,65 @@ void QsumCMDF::make_charts_from_cmd(input_list_type& input_charts, const std::st
 
     int chart_ind = -1;
 
+    // charts after GROUP belong to this group until END GROUP or next GROUP
+    std::string group_name;
+    bool lazy = false;
+    bool no_reload = false;
+
+    m_chart_props.clear();
+    m_preload_list.assign(m_num_smry_files, {});
+
     for (auto const &line : m_processed_cmd_lines){
 
         auto tokens = split(line, " \t");
 
-        if (tokens[0] == "ADD"){
+        if (tokens[0] == "GROUP"){
+
+            if (tokens.size() < 2){
+                std::cout << "error processing command file, GROUP needs a name \n\n";
+                exit(1);
+            }
+
+            group_name = tokens[1];
+            lazy = false;
+            no_reload = false;
+
+            for (size_t m = 2; m < tokens.size(); m++){
+                if (tokens[m] == "LAZY"){
+                    lazy = true;
+                } else if (tokens[m] == "NORELOAD"){
+                    no_reload = true;
+                } else {
+                    std::cout << "error processing command file, GROUP option should be LAZY or NORELOAD \n\n";
+                    exit(1);
+                }
+            }
+
+        } else if ((tokens[0] == "END") && (tokens.size() > 1) && (tokens[1] == "GROUP")){
+
+            group_name.clear();
+            lazy = false;
+            no_reload = false;
+
+        } else if (tokens[0] == "PRELOAD"){
+
+            if (tokens.size() < 3){
+                std::cout << "error processing command file, PRELOAD needs case and one or more vectors \n\n";
+                exit(1);
+            }
+
+            int smry_case = std::stoi(tokens[1]) - 1 ;
+
+            if ((smry_case < 0) || (smry_case > (m_num_smry_files -1))){
+                std::cout << "\n!Error processing command file: \n\nline > " << line << "\n";
+                std::cout << "\nNumber of cases loaded less than " << smry_case + 1 << "\n\n";
+                exit(1);
+            }
+
+            for (size_t m = 2; m < tokens.size(); m++)
+                m_preload_list[smry_case].push_back(tokens[m]);
+
+        } else if (tokens[0] == "ADD"){
 
             if ((tokens[1] != "CHART") && (tokens[1] != "SERIES")){
                 std::cout << "error processing command file, first arg in ADD should be CHART or SERIES \n\n";
@@ -247,7 +311,11 @@ void QsumCMDF::make_charts_from_cmd(input_list_type& input_charts, const std::st
 
                 chart_ind++;
 
-            input_charts.push_back({});
+                // ADD CHART ENSEMBLE, all series in chart shown as one ensemble
+                bool ensemble = (tokens.size() > 2) && (tokens[2] == "ENSEMBLE");
+
+                input_charts.push_back({});
+                m_chart_props.push_back(std::make_tuple(group_name, lazy, no_reload, ensemble));
 
             } else if (tokens[1] == "SERIES"){
 
@@ -310,16 +378,16 @@ std::string QsumCMDF::expand_line_define(const std::vector<std::string>& tokens,
 }
 
 
-std::vector<std::string> QsumCMDF::process_range(std::string& line, bool replace_on_line)
+std::vector<std::string> QsumCMDF::process_range(const std::string& range_str)
 {
-    auto start = line.find ( "RANGE(" );
-    auto end = line.find ( ")", start );
-
-    std::string range_str = line.substr ( start, start - end );
+    // range_str starts with RANGE(, example RANGE(1, 5)
 
     auto p1 = range_str.find("(");
-    auto p2 = range_str.find(",");
-    auto p3 = range_str.find(")");
+    auto p2 = range_str.find(",", p1);
+    auto p3 = range_str.find(")", p2);
+
+    if ((p2 == std::string::npos) || (p3 == std::string::npos))
+        throw std::runtime_error("Error processing command file. Syntax error in '" + range_str + "'");
 
     int from = std::stoi(range_str.substr(p1+1, p2-p1-1));
     int to = std::stoi(range_str.substr(p2+1, p3-p2-1));
@@ -329,42 +397,10 @@ std::vector<std::string> QsumCMDF::process_range(std::string& line, bool replace
     for (int n = from; n < (to + 1); n++)
         str_list.push_back(std::to_string(n));
 
-    if (replace_on_line){
-        std::string rep_str;
-
-        for (auto& element: str_list)
-            rep_str = rep_str + " " +  element;
-
-        line.replace(start, end, rep_str);
-    }
-
     return str_list;
 }
 
 
-int QsumCMDF::replace_all(std::string& line, const std::string& repstr1, const std::string& repstr2, const std::string& newstr)
-{
-    int count = 0;
-
-    for (auto& repstr : {
-                repstr1, repstr2
-            }) {
-
-        int p1 = line.find(repstr);
-
-        while ( p1 != std::string::npos ) {
-
-            line.replace(p1, repstr.size(), newstr);
-            count ++;
-
-            p1 = line.find(repstr);
-        }
-    }
-
-    return count;
-}
-
-
 void QsumCMDF::update_rhs_cmd_lines_define()
 {
     for (size_t n = 0; n < m_processed_cmd_lines.size(); n++) {
@@ -430,51 +466,168 @@ void QsumCMDF::update_rhs_cmd_lines_define()
     }
 }
 
-void QsumCMDF::process_for_loop(const std::vector<std::string>& tokens,
-                                int& lnr, std::map<std::string, std::string>& var_map,
-                                std::vector<std::string>& processed_for_lines)
+
+int QsumCMDF::intern_var(const std::string& name)
 {
-    std::string var_name = tokens[1];
-    std::string list_str = tokens[3];
+    auto it = m_var_ids.find(name);
 
-    if (list_str.substr(0,6) == "RANGE(") {
+    if (it != m_var_ids.end())
+        return it->second;
 
-        // make new list and add this to list_vect
-        // list names = DUMMY_LIST_X, when x is the first available integer
+    int id = m_var_names.size();
 
-        auto range_list = process_range(m_cmd_lines[lnr], false);
+    m_var_ids.emplace(name, id);
+    m_var_names.push_back(name);
+    m_var_values.push_back({});
+    m_var_bound.push_back(false);
+
+    return id;
+}
+
+
+void QsumCMDF::parse_cmdlines(const std::string& cmdl_list)
+{
+    // command lines parsed once. FOR loops hold their body as child nodes,
+    // variables in loops are interned and resolved when the tree is expanded
 
-        int tmp_num = 0;
-        std::string tmp_list_name = "DUMMY_LIST_" + std::to_string(tmp_num);
+    if (cmdl_list.size() > 0){
+        auto list_items = split(cmdl_list, ",");
+
+        std::string new_list_str = "LIST NEW CMDL_LIST";
+        for (auto& var : list_items)
+            new_list_str = new_list_str + " " + var;
 
-        while (std::find(m_list_names.begin(), m_list_names.end(), tmp_list_name) != m_list_names.end()) {
-            tmp_num ++;
-            tmp_list_name = "DUMMY_LIST_" + std::to_string(tmp_num);
+        m_cmd_lines.insert(m_cmd_lines.begin(), new_list_str);
+    }
+
+    std::vector<std::vector<CmdNode>*> stack = { &m_cmd_tree };
+    std::vector<size_t> for_lnr;
+
+    for (size_t lnr = 0; lnr < m_cmd_lines.size(); lnr++){
+
+        const std::string& line = m_cmd_lines[lnr];
+        auto tokens = split(line, ", \t");
+
+        if (tokens[0] == "FOR") {
+
+            if ((tokens.size() < 4) || (tokens[2] != "IN"))
+                throw std::runtime_error("Error processing command file. Syntax error in FOR loop: '" + line + "'");
+
+            CmdNode node { CmdNode::Type::for_loop, {}, intern_var(tokens[1]), {} };
+
+            auto p = line.find("RANGE(");
+
+            node.text = (p != std::string::npos) ? line.substr(p) : tokens[3];
+
+            stack.back()->push_back(std::move(node));
+            stack.push_back(&stack.back()->back().body);
+            for_lnr.push_back(lnr);
+
+        } else if (tokens[0] == "NEXT") {
+
+            if (for_lnr.empty())
+                throw std::runtime_error("Error processing command file. NEXT without matching FOR");
+
+            stack.pop_back();
+            for_lnr.pop_back();
+
+        } else if (tokens[0] == "LIST") {
+
+            stack.back()->push_back({ CmdNode::Type::list, line, -1, {} });
+
+        } else {
+
+            stack.back()->push_back({ CmdNode::Type::line, line, -1, {} });
         }
+    }
 
-        m_list_names.push_back(tmp_list_name);
-        m_list_vect.push_back(range_list);
+    if (!for_lnr.empty())
+        throw std::runtime_error("Error processing command file. FOR loop not closed with NEXT: '" +
+                                 m_cmd_lines[for_lnr.back()] + "'");
+}
 
-        list_str = tmp_list_name;
 
-    } else {
+std::string QsumCMDF::substitute(std::string_view line) const
+{
+    // loop variables replaced in one pass. ${NAME} must match a bound variable
+    // exactly, for $NAME the longest bound variable is used. Other $ left as is
+
+    std::string res;
+    res.reserve(line.size());
+
+    size_t p0 = 0;
+
+    while (p0 < line.size()){
 
-        if (list_str.substr(0,2) == "${") {
-            list_str = list_str.substr(2);
-            list_str.pop_back();
-        } else if (list_str[0] == '$') {
-            list_str = list_str.substr(1);
+        size_t p = line.find('$', p0);
+
+        if (p == std::string_view::npos){
+            res.append(line.substr(p0));
+            break;
+        }
+
+        res.append(line.substr(p0, p - p0));
+
+        int var_id = -1;
+        size_t len = 0;
+
+        if ((p + 1 < line.size()) && (line[p + 1] == '{')){
+
+            auto p_end = line.find('}', p + 2);
+
+            if (p_end != std::string_view::npos){
+                auto it = m_var_ids.find(line.substr(p + 2, p_end - p - 2));
+
+                if ((it != m_var_ids.end()) && (m_var_bound[it->second])){
+                    var_id = it->second;
+                    len = p_end - p + 1;
+                }
+            }
+
+        } else {
+
+            std::string_view rest = line.substr(p + 1);
+
+            for (size_t n = 0; n < m_var_names.size(); n++){
+                const auto& name = m_var_names[n];
+
+                if (m_var_bound[n] && (name.size() > len) && (rest.substr(0, name.size()) == name)){
+                    var_id = n;
+                    len = name.size() + 1;
+                }
+            }
+        }
+
+        if (var_id > -1){
+            res.append(m_var_values[var_id]);
+            p0 = p + len;
+        } else {
+            res.push_back('$');
+            p0 = p + 1;
         }
     }
 
-    int list_ind = -1;
+    return res;
+}
 
-    std::vector<std::string>::iterator itr = std::find(m_list_names.begin(), m_list_names.end(), list_str);
-    if (itr != m_list_names.end()) {
 
-        list_ind = std::distance(m_list_names.begin(), itr);
+std::vector<std::string> QsumCMDF::list_values(const std::string& list_expr)
+{
+    std::string list_str = substitute(list_expr);
 
-    } else {
+    if (list_str.substr(0,6) == "RANGE(")
+        return process_range(list_str);
+
+    if (list_str.substr(0,2) == "${") {
+        list_str = list_str.substr(2);
+        list_str.pop_back();
+    } else if (list_str[0] == '$') {
+        list_str = list_str.substr(1);
+    }
+
+    auto itr = std::find(m_list_names.begin(), m_list_names.end(), list_str);
+
+    if (itr == m_list_names.end()) {
         std::string message("Error processing command file.");
         message = message + " List '" + list_str + "' not found.";
 
@@ -484,208 +637,238 @@ void QsumCMDF::process_for_loop(const std::vector<std::string>& tokens,
         throw std::runtime_error(message);
     }
 
-    int lnr_from = lnr + 1;
-    int lnr_to;
-
-    for (auto var : m_list_vect[list_ind]) {
-
-        lnr = lnr_from;
-
-        auto tokens2 = split(m_cmd_lines[lnr], ", \t");
+    return m_list_vect[std::distance(m_list_names.begin(), itr)];
+}
 
-        while (tokens2[0] != "NEXT") {
 
-            if (tokens2[0] == "FOR") {
-                var_map[var_name] = var;
-                process_for_loop(tokens2, lnr, var_map, processed_for_lines);
+void QsumCMDF::process_list(const std::string& line)
+{
+    auto tokens = split(line, " \t");
 
-            } else {
+    if (tokens.size() < 4) {
+        std::cout << "error processing command file, list needs at least 3 arguments \n";
+        exit(1);
+    }
 
-                std::string new_line = m_cmd_lines[lnr];
+    if ((tokens[1] != "NEW") && (tokens[1] != "ADD")) {
+        std::cout << "error processing command file, first arg in LIST should be NEW or ADD \n";
+        exit(1);
+    }
 
-                std::string repstr1 = "${" + var_name + "}";
-                std::string repstr2 = "$" + var_name;
+    const std::string& name = tokens[2];
+    auto itr = std::find(m_list_names.begin(), m_list_names.end(), name);
 
-                int nrep = replace_all(new_line, repstr1, repstr2, var);
+    int list_ind = -1;
 
-                auto p1 = new_line.find_first_not_of(" \n");
+    if (tokens[1] == "NEW") {
 
-                if (p1 != std::string::npos)
-                    new_line = new_line.substr(p1);
+        if (itr != m_list_names.end()) {
 
-                for (auto it = var_map.begin(); it != var_map.end(); it++) {
-                    std::string repstr1 = "${" + it->first + "}";
-                    std::string repstr2 = "$" + it->first;
+            list_ind = std::distance(m_list_names.begin(), itr);
+            m_list_vect[list_ind].clear();
 
-                    int nrep = replace_all(new_line, repstr1, repstr2, it->second);
-                }
+        } else {
+            m_list_names.push_back(name);
+            m_list_vect.push_back({});
+            list_ind = m_list_names.size() -1;
+        }
 
-                processed_for_lines.push_back(new_line);
+        if (tokens[3].substr(0,6) == "RANGE("){
+            m_list_vect[list_ind] = process_range(line.substr(line.find("RANGE(")));
+            return;
+        }
 
-                lnr ++;
-            }
+    } else {
 
-            tokens2 = split(m_cmd_lines[lnr], ", \t");
+        if (itr == m_list_names.end()) {
+            std::cout << "error processing command file, LIST + ADD, list not found \n";
+            exit(1);
         }
+
+        list_ind = std::distance(m_list_names.begin(), itr);
     }
+
+    for (size_t n = 3; n < tokens.size(); n++)
+        m_list_vect[list_ind].push_back(tokens[n]);
 }
 
 
-void QsumCMDF::process_cmdlines(const std::string& cmdl_list)
+void QsumCMDF::add_processed_line(std::string line)
 {
-   // process LIST and FOR keywords
+    auto p1 = line.find_first_not_of(" \t\n");
 
-    std::vector<std::string> mod_cmd_lines;
+    if (p1 == std::string::npos)
+        return;
 
-    if (cmdl_list.size() > 0){
-        auto list_items = split(cmdl_list, ",");
+    if (p1 > 0)
+        line.erase(0, p1);
 
-        std::string new_list_str = "LIST NEW CMDL_LIST";
-        for (auto& var : list_items)
-            new_list_str = new_list_str + " " + var;
+    auto tokens = split(line, " \t");
 
-        m_cmd_lines.insert(m_cmd_lines.begin(), new_list_str);
-    }
+    if ((tokens.size() > 2) && (tokens[0] == "ADD") && (tokens[1] == "SERIES") &&
+            ( (tokens[2] == "*") || (tokens[2] == "?"))) {
 
-    int lnr = 0;
+        for (int n = 0; n < m_num_smry_files; n++)
+            m_processed_cmd_lines.push_back( expand_line_add_series(tokens, n));
 
-    while (lnr <  (m_cmd_lines.size())){
+    } else if ((tokens.size() > 2) && (tokens[0] == "PRELOAD") && ( (tokens[1] == "*") || (tokens[1] == "?"))) {
 
-        auto tokens = split(m_cmd_lines[lnr], " \t");
+        for (int n = 0; n < m_num_smry_files; n++){
+            std::string new_str = tokens[0] + " " + std::to_string(n + 1);
 
-        if (tokens[0] == "LIST") {
+            for (size_t m = 2; m < tokens.size(); m++)
+                new_str = new_str + " " + tokens[m];
 
-            if (tokens.size() < 4) {
-                std::cout << "error processing command file, list needs at least 3 arguments \n";
-                exit(1);
+            m_processed_cmd_lines.push_back(new_str);
+        }
+
+    } else if ((tokens.size() > 2) && (tokens[0] == "DEFINE")) {
+
+        if ( (tokens[1][0] == '*') || (tokens[1][0] == '?')) {
+            for (int n = 0; n < m_num_smry_files; n++)
+                m_processed_cmd_lines.push_back( expand_line_define(tokens, n));
+        } else {
+
+            if (tokens[1].substr(1,1) != ":") {
+                auto p = line.find(tokens[1]);
+                line.insert(p, "0:");
             }
 
-            if ((tokens[1] != "NEW") && (tokens[1] != "ADD")) {
-                std::cout << "error processing command file, first arg in LIST should be NEW or ADD \n";
-                exit(1);
+            if (tokens[2] == "=") {
+                auto p = line.find(tokens[2]);
+                line.insert(p, "None ");
             }
 
-            std::string name = tokens[2];
-            int list_ind = -1;
-            std::vector<std::string>::iterator itr = std::find(m_list_names.begin(), m_list_names.end(), name);
+            m_processed_cmd_lines.push_back(std::move(line));
+        }
+
+    } else {
+        m_processed_cmd_lines.push_back(std::move(line));
+    }
+}
 
-            if (tokens[1] == "NEW") {
 
-                if (itr != m_list_names.end()) {
+void QsumCMDF::expand(const std::vector<CmdNode>& nodes)
+{
+    for (auto& node : nodes){
 
-                    list_ind = std::distance(m_list_names.begin(), itr);
-                    m_list_vect[list_ind].clear();
+        if (node.type == CmdNode::Type::line) {
 
-                } else {
-                    m_list_names.push_back(name);
-                    m_list_vect.push_back({});
-                    list_ind = m_list_names.size() -1;
-                }
+            add_processed_line(substitute(node.text));
 
-                if (tokens[3].substr(0,6) == "RANGE("){
+        } else if (node.type == CmdNode::Type::list) {
 
-                    auto range_list = process_range(m_cmd_lines[lnr], true);
-                    tokens = split(m_cmd_lines[lnr], ", \t");
-                }
+            process_list(substitute(node.text));
 
-                for (size_t n = 3; n < tokens.size(); n++)
-                    m_list_vect[list_ind].push_back(tokens[n]);
+        } else {
 
-            } else if (tokens[1] == "ADD") {
+            auto values = list_values(node.text);
 
-                if (itr == m_list_names.end()) {
-                    std::cout << "error processing command file, LIST + ADD, list not found \n";
-                    exit(1);
-                }
+            // loop variable restored after loop, shadowed variable in nested loop with same name
+            bool prev_bound = m_var_bound[node.var_id];
+            std::string prev_value = m_var_values[node.var_id];
 
-                list_ind = std::distance(m_list_names.begin(), itr);
+            m_var_bound[node.var_id] = true;
 
-                for (size_t n = 3; n < tokens.size(); n++)
-                    m_list_vect[list_ind].push_back(tokens[n]);
+            for (auto& var : values){
+                m_var_values[node.var_id] = var;
+                expand(node.body);
             }
 
-        } else if (tokens[0] == "FOR"){
+            m_var_bound[node.var_id] = prev_bound;
+            m_var_values[node.var_id] = prev_value;
+        }
+    }
+}
+
+
+std::filesystem::path QsumCMDF::cache_dir()
+{
+    const char* xdg_cache = std::getenv("XDG_CACHE_HOME");
+
+    if ((xdg_cache != nullptr) && (std::string(xdg_cache).size() > 0))
+        return std::filesystem::path(xdg_cache) / "qsummary";
 
-            std::vector<std::string> processed_for_lines;
+    const char* home = std::getenv("HOME");
 
-            std::map<std::string, std::string> var_map;
+    if (home == nullptr)
+        return std::filesystem::temp_directory_path() / "qsummary";
 
-            process_for_loop(tokens, lnr, var_map, processed_for_lines);
+    return std::filesystem::path(home) / ".cache" / "qsummary";
+}
 
-            for (auto line: processed_for_lines) {
 
-                tokens = split(line, ", \t");
+std::filesystem::path QsumCMDF::cache_file(const std::string& cmdl_list) const
+{
+    uint64_t hash = fnv1a_hash(cmdf_cache_version, m_cmdf_hash);
+    hash = fnv1a_hash(cmdl_list + "\n" + std::to_string(m_num_smry_files), hash);
 
-                if ((tokens.size() > 2) && (tokens[0] == "ADD") && (tokens[1] == "SERIES") &&
-                        ( (tokens[2] == "*") || (tokens[2] == "?"))) {
+    std::stringstream ss;
+    ss << std::hex << std::setw(16) << std::setfill('0') << hash;
 
-                    for (size_t n = 0; n < m_num_smry_files; n++)
-                        mod_cmd_lines.push_back( expand_line_add_series(tokens, n));
+    return cache_dir() / (ss.str() + ".cmdf");
+}
 
-                } else if ((tokens.size() > 2) && (tokens[0] == "DEFINE")) {
 
-                    if ( (tokens[1].substr(0,1) == "*") || (tokens[1].substr(0,1) == "?")) {
-                        for (size_t n = 0; n < m_num_smry_files; n++)
-                            mod_cmd_lines.push_back( expand_line_define(tokens, n));
-                    } else {
+bool QsumCMDF::read_cache(const std::filesystem::path& fname)
+{
+    std::ifstream cache(fname);
 
-                        if (tokens[1].substr(1,1) != ":") {
-                            auto p =line.find(tokens[1]);
-                            line.insert(p, "0:");
-                        }
+    if (!cache)
+        return false;
 
-                        if (tokens[2] == "=") {
-                            auto p = line.find(tokens[2]);
-                            line.insert(p, "None ");
-                        }
+    std::string line;
 
-                        mod_cmd_lines.push_back(line);
-                    }
+    if ((!std::getline(cache, line)) || (line != cmdf_cache_version + " " + fname.stem().string()))
+        return false;
 
-                } else {
-                    mod_cmd_lines.push_back( line);
-                }
-            }
+    std::vector<std::string> cmd_lines;
 
-        } else {
+    while (std::getline(cache, line))
+        if (line.size() > 0)
+            cmd_lines.push_back(line);
+
+    m_processed_cmd_lines = std::move(cmd_lines);
+
+    return true;
+}
 
-            if ((tokens.size() > 2) && (tokens[0] == "ADD") && (tokens[1] == "SERIES") &&
-                    ( (tokens[2] == "*") || (tokens[2] == "?"))) {
 
-                for (size_t n = 0; n < m_num_smry_files; n++)
-                    mod_cmd_lines.push_back( expand_line_add_series(tokens, n));
+void QsumCMDF::write_cache(const std::filesystem::path& fname)
+{
+    // cache is optional, failing to write is not an error
 
-            } else if ((tokens.size() > 2) && (tokens[0] == "DEFINE")) {
+    std::error_code ec;
+    std::filesystem::create_directories(fname.parent_path(), ec);
 
-                if ( (tokens[1].substr(0,1) == "*") || (tokens[1].substr(0,1) == "?")) {
-                    for (size_t n = 0; n < m_num_smry_files; n++)
-                        mod_cmd_lines.push_back( expand_line_define(tokens, n));
-                } else {
+    if (ec)
+        return;
 
-                    if (tokens[1].substr(1,1) != ":"){
-                        auto p = m_cmd_lines[lnr].find(tokens[1]);
-                        m_cmd_lines[lnr].insert(p, "0:");
-                    }
+    auto tmp_fname = fname;
+    tmp_fname += ".tmp" + std::to_string(::getpid());
 
-                    if (tokens[2] == "=") {
-                        auto p = m_cmd_lines[lnr].find(tokens[2]);
-                        m_cmd_lines[lnr].insert(p, "None ");
-                    }
+    {
+        std::ofstream cache(tmp_fname);
 
-                    mod_cmd_lines.push_back(m_cmd_lines[lnr]);
-                }
+        if (!cache)
+            return;
 
-            } else {
+        cache << cmdf_cache_version << " " << fname.stem().string() << "\n";
 
-                int p1 = m_cmd_lines[lnr].find_first_not_of(" \n");
-                mod_cmd_lines.push_back(m_cmd_lines[lnr].substr(p1));
-            }
-        }
+        for (auto& line : m_processed_cmd_lines)
+            cache << line << "\n";
 
-        lnr++;
+        if (!cache){
+            cache.close();
+            std::filesystem::remove(tmp_fname, ec);
+            return;
+        }
     }
 
-    m_processed_cmd_lines = mod_cmd_lines;
+    std::filesystem::rename(tmp_fname, fname, ec);
+
+    if (ec)
+        std::filesystem::remove(tmp_fname, ec);
 }
 
 
@@ -701,5 +884,3 @@ void QsumCMDF::print_processd_cmd_lines()
     for (auto& line : m_processed_cmd_lines)
         std::cout << line << std::endl;
 }
-
-
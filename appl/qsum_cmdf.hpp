@@ -24,7 +24,11 @@
 #include <opm/io/eclipse/ESmry.hpp>
 #include <opm/io/eclipse/ExtESmry.hpp>
 
+#include <cstdint>
+#include <filesystem>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 #include <map>
 
@@ -39,10 +43,16 @@ public:
     using char_input_type = std::tuple<std::vector<vect_input_type>, std::string>;
     using input_list_type = std::vector<char_input_type>;
 
+    // group name, lazy, no reload, ensemble. One element for each chart
+    using chart_props_type = SmryAppl::chart_props_type;
+    using chart_props_list_type = SmryAppl::chart_props_list_type;
+
     // name, expression and unit
     using define_vect_type = std::vector<std::tuple<std::string, std::string, std::string>>;
 
-    QsumCMDF(const std::string& cmd_file, int num_smry_files,const std::string& cmdl_list);
+    // with use_cache, the expanded command lines are stored in the cache directory, keyed
+    // by a hash of the command file, the command line list and the number of cases
+    QsumCMDF(const std::string& cmd_file, int num_smry_files,const std::string& cmdl_list, bool use_cache = false);
 
     void make_charts_from_cmd(input_list_type& input_charts, const std::string xrange_str );
 
@@ -57,30 +67,67 @@ public:
 
     define_vect_type get_define_vect() { return m_define_vect;}
 
+    bool loaded_from_cache() const { return m_from_cache; }
+
+    // GROUP and PRELOAD directives, available after make_charts_from_cmd
+    chart_props_list_type get_chart_props() { return m_chart_props; }
+    std::vector<std::vector<std::string>> get_preload_list() { return m_preload_list; }
+
+    static std::filesystem::path cache_dir();
+
 private:
 
+    // command file parsed into a tree, FOR loops hold their body.
+    // line: text of command line, for_loop: text is list expression, var_id is loop variable
+    struct CmdNode {
+        enum class Type { line, list, for_loop };
+
+        Type type;
+        std::string text;
+        int var_id = -1;
+        std::vector<CmdNode> body;
+    };
+
     std::vector<std::string> m_cmd_lines;
     std::vector<std::string> m_processed_cmd_lines;
 
+    std::vector<CmdNode> m_cmd_tree;
+
+    // loop variables, interned. Values are set while expanding loops
+    std::map<std::string, int, std::less<>> m_var_ids;
+    std::vector<std::string> m_var_names;
+    std::vector<std::string> m_var_values;
+    std::vector<bool> m_var_bound;
+
     std::vector<std::vector<std::string>> m_list_vect;
     std::vector<std::string> m_list_names;
 
     // name, rhs expression and unit
     define_vect_type m_define_vect;
+    std::unordered_map<std::string, int> m_define_index;
+
+    chart_props_list_type m_chart_props;
+    std::vector<std::vector<std::string>> m_preload_list;
 
     int m_num_smry_files;
 
+    uint64_t m_cmdf_hash = 0;
+    bool m_from_cache = false;
+
     void get_cmdlines(const std::string& filename);
     void remove_trailing_char(std::string& line, const std::string& charlist);
     bool update_variables();
     std::vector<std::string> split(const std::string& line, const std::string& delim);
-    void process_cmdlines(const std::string& cmdl_list);
-    std::vector<std::string> process_range(std::string& line, bool replace_on_line);
 
-    void process_for_loop(const std::vector<std::string>& tokens, int& lnr,
-                          std::map<std::string, std::string>& var_map,
-                          std::vector<std::string>& processed_for_lines);
+    void parse_cmdlines(const std::string& cmdl_list);
+    void expand(const std::vector<CmdNode>& nodes);
+    void process_list(const std::string& line);
+    void add_processed_line(std::string line);
 
+    int intern_var(const std::string& name);
+    std::string substitute(std::string_view line) const;
+    std::vector<std::string> list_values(const std::string& list_expr);
+    std::vector<std::string> process_range(const std::string& range_str);
 
     std::string expand_line_add_series(const std::vector<std::string>& tokens, int smry_ind);
     std::string expand_line_define(const std::vector<std::string>& tokens, int smry_ind);
@@ -90,8 +137,10 @@ private:
 
     void add_series(input_list_type& input_charts, int smry_ind, const std::string& name, int axis_ind, const std::string &xrange_input, bool is_derived);
 
+    std::filesystem::path cache_file(const std::string& cmdl_list) const;
+    bool read_cache(const std::filesystem::path& fname);
+    void write_cache(const std::filesystem::path& fname);
 
-    int replace_all(std::string& line, const std::string& repstr1, const std::string& repstr2, const std::string& newstr);
     bool is_number(const std::string& numstr);
 
 };
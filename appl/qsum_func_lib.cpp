@@ -19,6 +19,9 @@
 #include <appl/qsum_func_lib.hpp>
 
 #include <algorithm>
+#include <unordered_set>
+#include <unordered_map>
+#include <cmath>
 #include <omp.h>
 #include <iostream>
 
@@ -72,11 +75,55 @@ std::tuple<std::vector<std::string>, std::string> parse_vect(const std::string&
 }
 
 
-template <typename T>
-std::vector<std::string> get_vect_list(T& loader,const std::string& vect)
+std::vector<std::string> merge_lists(const std::vector<std::vector<std::string>>& lists, bool intersect)
+{
+    // union keeps order of first case, followed by new items from the next cases.
+    // intersection keeps order of first case
+
+    std::vector<std::string> merged;
+
+    if (lists.size() == 0)
+        return merged;
+
+    if (intersect) {
+
+        std::vector<std::set<std::string>> sets;
+
+        for (size_t n = 1; n < lists.size(); n++)
+            sets.emplace_back(lists[n].begin(), lists[n].end());
+
+        for (auto& item : lists[0]) {
+
+            bool in_all = true;
+
+            for (auto& other : sets)
+                if (other.count(item) == 0)
+                    in_all = false;
+
+            if (in_all)
+                merged.push_back(item);
+        }
+
+    } else {
+
+        std::set<std::string> item_set;
+
+        for (auto& list : lists)
+            for (auto& item : list)
+                if (item_set.insert(item).second)
+                    merged.push_back(item);
+    }
+
+    return merged;
+}
+
+
+std::vector<std::string> QSum::expand_pattern(const KeywordCatalogue& catalogue, const std::string& vect, bool intersect)
 {
     std::vector<std::string> keyw_list;
 
+    const size_t num_cases = catalogue.number_of_cases();
+
     int p2 = vect.find_first_of("+");
 
     if (p2 > -1 ){
@@ -102,32 +149,29 @@ std::vector<std::string> get_vect_list(T& loader,const std::string& vect)
             }
         }
 
-        std::vector<std::vector<std::string>> ref_keylist;
-        ref_keylist.resize(nKeys);
+        std::vector<std::vector<std::string>> name_lists(num_cases);
 
-        for (size_t n = 0; n < nKeys; n ++){
-            ref_keylist[n] = loader->keywordList(keys[n] + ":" + pattern);
-        }
+        #pragma omp parallel for
+        for (size_t c = 0; c < num_cases; c++)
+            name_lists[c] = catalogue.item_names(c, keys[0], pattern);
 
-        std::set<std::string> wg_list;
+        auto merged = merge_lists(name_lists, intersect);
 
-        for (auto& key_name : ref_keylist[0]){
-            int p1 = key_name.find_first_of(":");
-            std::string wg_name = key_name.substr(p1 + 1);
-            wg_list.insert(wg_name);
-        }
+        std::set<std::string> wg_list(merged.begin(), merged.end());
 
         for (auto wg_name = wg_list.begin(); wg_name != wg_list.end(); wg_name++){
             std::string key_str;
 
             for (int n = 0; n < nKeys; n++){
 
-                std::string cand = keys[n] + ":" + *wg_name;
+                size_t count = 0;
 
-                if (std::find(ref_keylist[n].begin(), ref_keylist[n].end(), cand) != ref_keylist[n].end()) {
-                    key_str = key_str + keys[n] + "+";
+                for (size_t c = 0; c < num_cases; c++)
+                    if (catalogue.has_key(c, keys[n] + ":" + *wg_name))
+                        count++;
 
-                }
+                if ((count == num_cases) || ((!intersect) && (count > 0)))
+                    key_str = key_str + keys[n] + "+";
             }
 
             if (key_str.size() > 0){
@@ -138,12 +182,44 @@ std::vector<std::string> get_vect_list(T& loader,const std::string& vect)
         }
 
     } else {
-        keyw_list = loader->keywordList(vect);
+
+        std::vector<std::vector<std::string>> key_lists(num_cases);
+
+        #pragma omp parallel for
+        for (size_t c = 0; c < num_cases; c++)
+            key_lists[c] = catalogue.keyword_list(c, vect);
+
+        keyw_list = merge_lists(key_lists, intersect);
     }
 
     return keyw_list;
 }
 
+
+KeywordCatalogue QSum::make_keyword_catalogue(const std::vector<FileType>& file_type,
+                                              std::unordered_map<int, std::unique_ptr<Opm::EclIO::ESmry>>& esmry_loader,
+                                              std::unordered_map<int, std::unique_ptr<Opm::EclIO::ExtESmry>>& lodsmry_loader)
+{
+    return make_keyword_catalogue(make_summary_sources(file_type, esmry_loader, lodsmry_loader));
+}
+
+KeywordCatalogue QSum::make_keyword_catalogue(const source_list_type& sources)
+{
+    std::vector<std::vector<std::string>> keyw_lists(sources.size());
+
+    #pragma omp parallel for
+    for (size_t n = 0; n < sources.size(); n++)
+        keyw_lists[n] = sources[n]->keyword_list();
+
+    KeywordCatalogue catalogue;
+
+    for (auto& keyw_list : keyw_lists)
+        catalogue.add_case(keyw_list);
+
+    return catalogue;
+}
+
+
 void QSum::chart_input_from_string(std::string& vect_string,
                                    SmryAppl::input_list_type& input_charts,
                                    const std::vector<FileType>& file_type,
@@ -152,6 +228,20 @@ void QSum::chart_input_from_string(std::string& vect_string,
                                    const int max_number_of_charts,
                                    const std::string& xrange
                                   )
+{
+    auto catalogue = make_keyword_catalogue(file_type, esmry_loader, lodsmry_loader);
+
+    chart_input_from_string(vect_string, input_charts, catalogue, max_number_of_charts, xrange);
+}
+
+
+void QSum::chart_input_from_string(std::string& vect_string,
+                                   SmryAppl::input_list_type& input_charts,
+                                   const KeywordCatalogue& catalogue,
+                                   const int max_number_of_charts,
+                                   const std::string& xrange,
+                                   bool intersect
+                                  )
 {
     std::transform(vect_string.begin(), vect_string.end(), vect_string.begin(), ::toupper);
 
@@ -178,15 +268,12 @@ void QSum::chart_input_from_string(std::string& vect_string,
         std::vector<std::string> keyw_list;
 
         if (p1 > -1) {
-            if (file_type[0] == FileType::SMSPEC)
-                keyw_list = get_vect_list(esmry_loader[0], vect);
-            else if (file_type[0] == FileType::ESMRY)
-                keyw_list = get_vect_list(lodsmry_loader[0], vect);
+            keyw_list = QSum::expand_pattern(catalogue, vect, intersect);
         } else {
             keyw_list.push_back(vect);
         }
 
-        QSum::update_input(input_charts, keyw_list, file_type, esmry_loader, lodsmry_loader, max_number_of_charts, xrange);
+        QSum::update_input(input_charts, keyw_list, catalogue, max_number_of_charts, xrange);
     }
 
 }
@@ -199,6 +286,18 @@ void QSum::update_input(SmryAppl::input_list_type& input_charts,
                   const int max_number_of_charts,
                   const std::string& xrange
                  )
+{
+    auto catalogue = make_keyword_catalogue(file_type, esmry_loader, lodsmry_loader);
+
+    update_input(input_charts, keyw_list, catalogue, max_number_of_charts, xrange);
+}
+
+void QSum::update_input(SmryAppl::input_list_type& input_charts,
+                  const std::vector<std::string>& keyw_list,
+                  const KeywordCatalogue& catalogue,
+                  const int max_number_of_charts,
+                  const std::string& xrange
+                 )
 {
     for (auto v : keyw_list) {
 
@@ -224,16 +323,9 @@ void QSum::update_input(SmryAppl::input_list_type& input_charts,
 
         for (auto& var : varlist) {
 
-            for (size_t n = 0; n < file_type.size(); n ++) {
-
-                bool hasVect;
-
-                if (file_type[n] == FileType::SMSPEC)
-                    hasVect = esmry_loader[n]->hasKey(var);
-                else if (file_type[n] == FileType::ESMRY)
-                    hasVect = lodsmry_loader[n]->hasKey(var);
+            for (size_t n = 0; n < catalogue.number_of_cases(); n ++) {
 
-                if (hasVect)
+                if (catalogue.has_key(n, var))
                     vect_list.push_back(std::make_tuple (n, var, -1, false));
             }
         }
@@ -255,26 +347,65 @@ void QSum::pre_load_smry(const std::vector<std::filesystem::path>& smry_files,
                    const std::vector<FileType>& file_type,
                    std::unordered_map<int, std::unique_ptr<Opm::EclIO::ESmry>>& esmry_loader,
                    std::unordered_map<int, std::unique_ptr<Opm::EclIO::ExtESmry>>& lodsmry_loader,
-                   const size_t nthreads)
+                   const size_t nthreads,
+                   const SmryAppl::chart_props_list_type& chart_props,
+                   const std::vector<std::vector<std::string>>& preload_list,
+                   SmryStatsCache* stats_cache)
+{
+    auto sources = make_summary_sources(file_type, esmry_loader, lodsmry_loader);
+
+    pre_load_smry(smry_files, input_charts, sources, nthreads, chart_props, preload_list, stats_cache);
+}
+
+void QSum::pre_load_smry(const std::vector<std::filesystem::path>& smry_files,
+                   const SmryAppl::input_list_type& input_charts,
+                   const source_list_type& sources,
+                   const size_t nthreads,
+                   const SmryAppl::chart_props_list_type& chart_props,
+                   const std::vector<std::vector<std::string>>& preload_list,
+                   SmryStatsCache* stats_cache)
 {
     std::vector<std::vector<std::string>> smry_pre_load;
+    std::vector<std::unordered_set<std::string>> smry_pre_load_set;
+
+    smry_pre_load.resize(smry_files.size());
+    smry_pre_load_set.resize(smry_files.size());
+
+    auto add_vect = [&](size_t smry_ind, const std::string& vect_name) {
+        if (smry_pre_load_set[smry_ind].insert(vect_name).second)
+            smry_pre_load[smry_ind].push_back(vect_name);
+    };
 
     for (size_t n = 0; n < smry_files.size(); n++)
-        smry_pre_load.push_back({"TIME"});
+        add_vect(n, "TIME");
+
+    // vectors from PRELOAD directives, only if found in summary file
+
+    for (size_t n = 0; n < preload_list.size() && n < smry_files.size(); n++) {
+        for (auto& vect_name : preload_list[n]) {
+
+            if (sources[n]->has_key(vect_name))
+                add_vect(n, vect_name);
+            else
+                std::cout << "\n!Warning, PRELOAD vector " << vect_name << " not found in case " << n + 1;
+        }
+    }
+
+    // lazy charts are loaded when first shown
 
     for (size_t c = 0; c < input_charts.size(); c++) {
-        auto vect_input = std::get<0>(input_charts[c]);
+
+        if ((c < chart_props.size()) && (std::get<1>(chart_props[c])))
+            continue;
+
+        auto& vect_input = std::get<0>(input_charts[c]);
 
         for (size_t s = 0; s < vect_input.size(); s++) {
             auto smry_ind = std::get<0>(vect_input[s]);
-            auto vect_name = std::get<1>(vect_input[s]);
             auto is_derived = std::get<3>(vect_input[s]);
 
-            if (!is_derived){
-                if (std::count(smry_pre_load[smry_ind].begin(), smry_pre_load[smry_ind].end(), vect_name) == 0){
-                    smry_pre_load[smry_ind].push_back(vect_name);
-                }
-            }
+            if (!is_derived)
+                add_vect(smry_ind, std::get<1>(vect_input[s]));
         }
     }
 
@@ -282,14 +413,18 @@ void QSum::pre_load_smry(const std::vector<std::filesystem::path>& smry_files,
 
     auto start_load = std::chrono::system_clock::now();
 
+    if (stats_cache != nullptr)
+        stats_cache->resize(smry_files.size());
+
+    // stats computed while the loaded data is still in cache, one case for each thread
+
     #pragma omp parallel for
     for (size_t n = 0; n < smry_files.size(); n++){
-        if (smry_pre_load[n].size() > 0)
-            if (file_type[n] == FileType::SMSPEC){
-                esmry_loader[n]->loadData(smry_pre_load[n]);
-            } else if (file_type[n] == FileType::ESMRY){
-                lodsmry_loader[n]->loadData(smry_pre_load[n]);
-            }
+        sources[n]->load(smry_pre_load[n]);
+
+        if (stats_cache != nullptr)
+            for (auto& key : smry_pre_load[n])
+                stats_cache->get(n, key, sources[n]->get(key));
     }
 
     auto end_load = std::chrono::system_clock::now();
@@ -299,66 +434,135 @@ void QSum::pre_load_smry(const std::vector<std::filesystem::path>& smry_files,
     std::cout << ", loading: " <<  elapsed_seconds.count();
 }
 
-template <typename T>
-bool QSum::has_nonzero(std::unique_ptr<T>& smry, const std::string key)
+namespace {
+
+// true if any value is nonzero, blocks of values reduced with SIMD and early exit
+// after each block. NaN is treated as zero, as abs(v) > 0.0
+bool any_nonzero(const float* data, size_t size)
 {
-    if ((key == "TIMESTEP") && (smry->all_steps_available()))
-        return true;
+    const size_t block_size = 256;
 
-    if (!smry->hasKey(key))
-        return false;
+    for (size_t n0 = 0; n0 < size; n0 += block_size) {
 
-    auto vect = smry->get(key);
+        size_t n1 = std::min(n0 + block_size, size);
+        int nonzero = 0;
 
-    for (auto v : vect)
-        if (abs(v) > 0.0)
+        #pragma omp simd reduction(|:nonzero)
+        for (size_t n = n0; n < n1; n++)
+            nonzero |= (std::fabs(data[n]) > 0.0f);
+
+        if (nonzero)
             return true;
+    }
 
     return false;
 }
 
+}
+
+
+bool QSum::has_nonzero(const SummarySource& smry, const std::string key)
+{
+    if ((key == "TIMESTEP") && (smry.all_steps_available()))
+        return true;
+
+    if (!smry.has_key(key))
+        return false;
+
+    SmrySpan vect = smry.get_span(key);
+
+    return any_nonzero(vect.data, vect.size);
+}
 
 
 void QSum::remove_zero_vect(const std::vector<std::filesystem::path>& smry_files,
                             SmryAppl::input_list_type& input_charts,
                             const std::vector<FileType>& file_type,
                             std::unordered_map<int, std::unique_ptr<Opm::EclIO::ESmry>>& esmry_loader,
-                            std::unordered_map<int, std::unique_ptr<Opm::EclIO::ExtESmry>>& lodsmry_loader)
+                            std::unordered_map<int, std::unique_ptr<Opm::EclIO::ExtESmry>>& lodsmry_loader,
+                            const SmryStatsCache* stats_cache)
 {
+    auto sources = make_summary_sources(file_type, esmry_loader, lodsmry_loader);
 
-    int c = static_cast<int>(input_charts.size()) -1;
+    remove_zero_vect(smry_files, input_charts, sources, stats_cache);
+}
+
+void QSum::remove_zero_vect(const std::vector<std::filesystem::path>& smry_files,
+                            SmryAppl::input_list_type& input_charts,
+                            const source_list_type& sources,
+                            const SmryStatsCache* stats_cache)
+{
+    // unique (case, vector) pairs, a vector found in several charts is only checked once.
+    // Derived series are not in the summary files and are kept
+
+    std::vector<std::vector<std::string>> case_vectors(sources.size());
+    std::vector<std::unordered_map<std::string, size_t>> pair_index(sources.size());
+
+    size_t num_pairs = 0;
+
+    for (auto& chart : input_charts)
+        for (auto& vect : std::get<0>(chart))
+            if (!std::get<3>(vect)) {
+                auto smry_ind = std::get<0>(vect);
 
-    while (c > -1) {
+                if (pair_index[smry_ind].emplace(std::get<1>(vect), num_pairs).second) {
+                    case_vectors[smry_ind].push_back(std::get<1>(vect));
+                    num_pairs++;
+                }
+            }
 
-        auto vect_input = std::get<0>(input_charts[c]);
-        auto xrange_str = std::get<1>(input_charts[c]);
+    // data referenced from the loaders, one thread for each case since a loader is not
+    // thread safe when vectors not already loaded are requested. Pairs are then scanned
+    // in parallel, reading data only
 
-        int n = static_cast<int>(vect_input.size()) -1 ;
+    std::vector<const std::vector<float>*> pair_data(num_pairs, nullptr);
+    std::vector<char> nonzero(num_pairs, 0);
 
-        while (n > -1) {
-            auto smry_ind = std::get<0>(vect_input[n]);
-            auto vect_name = std::get<1>(vect_input[n]);
+    #pragma omp parallel for schedule(dynamic)
+    for (size_t smry_ind = 0; smry_ind < sources.size(); smry_ind++) {
+        for (auto& vect_name : case_vectors[smry_ind]) {
 
-            bool nonzero;
+            size_t ind = pair_index[smry_ind][vect_name];
 
-            if (file_type[n] == FileType::SMSPEC)
-                nonzero = has_nonzero(esmry_loader[n], vect_name);
-            else if (file_type[n] == FileType::ESMRY)
-                nonzero = has_nonzero(lodsmry_loader[n], vect_name);
+            const SmryStats* stats = stats_cache != nullptr ? stats_cache->find(smry_ind, vect_name) : nullptr;
+
+            if ((stats != nullptr) && (vect_name != "TIMESTEP")) {
+                nonzero[ind] = !stats->all_zero;
+                continue;
+            }
 
-            if (!nonzero)
-                vect_input.erase( vect_input.begin() + n );
+            const SummarySource& smry = *sources[smry_ind];
 
-            n--;
+            if ((vect_name == "TIMESTEP") && (smry.all_steps_available()))
+                nonzero[ind] = 1;
+            else if (smry.has_key(vect_name))
+                pair_data[ind] = &smry.get(vect_name);
         }
+    }
 
-        if (vect_input.size() > 0)
-            input_charts[c] = std::make_tuple(vect_input, xrange_str);
-        else
-            input_charts.erase( input_charts.begin() + c );
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (size_t ind = 0; ind < num_pairs; ind++)
+        if ((!nonzero[ind]) && (pair_data[ind] != nullptr))
+            nonzero[ind] = any_nonzero(pair_data[ind]->data(), pair_data[ind]->size());
+
+    SmryAppl::input_list_type updated_input;
+
+    for (auto& chart : input_charts) {
 
-        c --;
+        std::vector<SmryAppl::vect_input_type> vect_input;
+
+        for (auto& vect : std::get<0>(chart)) {
+            auto smry_ind = std::get<0>(vect);
+
+            if ((std::get<3>(vect)) || (nonzero[pair_index[smry_ind][std::get<1>(vect)]]))
+                vect_input.push_back(vect);
+        }
+
+        if (vect_input.size() > 0)
+            updated_input.push_back(std::make_tuple(vect_input, std::get<1>(chart)));
     }
+
+    input_charts = std::move(updated_input);
 }
 
 SmryAppl::input_list_type QSum::charts_separate_folders(const std::vector<std::filesystem::path>& smry_files,
@@ -441,8 +645,7 @@ SmryAppl::input_list_type QSum::charts_separate_folders(const std::vector<std::f
 }
 
 
-template <typename T>
-bool QSum::double_check_well_vector(std::string& vect_name, std::unique_ptr<T>& smry)
+bool QSum::double_check_well_vector(std::string& vect_name, const SummarySource& smry)
 {
     auto p = vect_name.find(":");
     auto wname = vect_name.substr(p + 1);
@@ -452,7 +655,7 @@ bool QSum::double_check_well_vector(std::string& vect_name, std::unique_ptr<T>&
 
     std::string pattern = vect_name.substr(0, p + 1) + wname + "*";
 
-    auto vlist = smry->keywordList(pattern);
+    auto vlist = smry.keyword_list(pattern);
 
     if (vlist.size() == 1){
         vect_name = vlist[0];
@@ -470,7 +673,11 @@ void QSum::check_summary_vectors(SmryAppl::input_list_type& input_charts,
                    std::unordered_map<int, std::unique_ptr<Opm::EclIO::ESmry>>& esmry_loader,
                    std::unordered_map<int, std::unique_ptr<Opm::EclIO::ExtESmry>>& lodsmry_loader)
 {
+    check_summary_vectors(input_charts, make_summary_sources(file_type, esmry_loader, lodsmry_loader));
+}
 
+void QSum::check_summary_vectors(SmryAppl::input_list_type& input_charts, const source_list_type& sources)
+{
     for ( size_t c = 0; c < input_charts.size(); c++ ) {
 
         std::vector<SmryAppl::vect_input_type> vect_input;
@@ -482,41 +689,18 @@ void QSum::check_summary_vectors(SmryAppl::input_list_type& input_charts,
             int axis = std::get<2> ( vect_input[i] );
             bool is_derived = std::get<3> ( vect_input[i] );
 
-            if (!is_derived) {
-
-                if (file_type[n] == FileType::SMSPEC) {
-
-                    if (!esmry_loader[n]->hasKey(vect_name)) {
-                        if (vect_name.substr(0,1) == "W") {
-                            if (!double_check_well_vector(vect_name, esmry_loader[n]))
-                                throw std::invalid_argument("not able to load smry vector " + vect_name);
-                        } else {
-                            throw std::invalid_argument("not able to load smry vector " + vect_name);
-                        }
-
-                        vect_input[i] = std::make_tuple(n, vect_name, axis, false);
-                        auto xrange_str = std::get<1>(input_charts[c]);
-                        input_charts[c] = std::make_tuple(vect_input, xrange_str);
-                    }
+            if ((!is_derived) && (!sources[n]->has_key(vect_name))) {
 
-                } else if (file_type[n] == FileType::ESMRY) {
-
-                    if (!lodsmry_loader[n]->hasKey(vect_name)) {
-                        if (vect_name.substr(0,1) == "W") {
-                            if (!double_check_well_vector(vect_name, lodsmry_loader[n]))
-                                throw std::invalid_argument("not able to load smry vector " + vect_name);
-                        } else {
-                            throw std::invalid_argument("not able to load smry vector " + vect_name);
-                        }
-
-                        vect_input[i] = std::make_tuple(n, vect_name, axis, false);
-                        auto xrange_str = std::get<1>(input_charts[c]);
-                        input_charts[c] = std::make_tuple(vect_input, xrange_str);
-
-                    }
+                if (vect_name.substr(0,1) == "W") {
+                    if (!double_check_well_vector(vect_name, *sources[n]))
+                        throw std::invalid_argument("not able to load smry vector " + vect_name);
                 } else {
-                    throw std::invalid_argument("unknown file type");
+                    throw std::invalid_argument("not able to load smry vector " + vect_name);
                 }
+
+                vect_input[i] = std::make_tuple(n, vect_name, axis, false);
+                auto xrange_str = std::get<1>(input_charts[c]);
+                input_charts[c] = std::make_tuple(vect_input, xrange_str);
             }
         }
     }
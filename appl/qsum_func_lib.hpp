@@ -22,6 +22,8 @@
 #define QSUM_FUNCLIB_HPP
 
 #include <appl/smry_appl.hpp>
+#include <appl/keyword_catalogue.hpp>
+#include <appl/smry_stats.hpp>
 
 #include <opm/io/eclipse/ESmry.hpp>
 #include <opm/io/eclipse/ExtESmry.hpp>
@@ -29,6 +31,35 @@
 
 namespace QSum {
 
+// functions taking the loader maps build summary sources for the call, with a source
+// list (see SmryAppl::loader_list_type) the sources are built once by the caller
+
+KeywordCatalogue make_keyword_catalogue(const std::vector<FileType>& file_type,
+                                        std::unordered_map<int, std::unique_ptr<Opm::EclIO::ESmry>>& esmry_loader,
+                                        std::unordered_map<int, std::unique_ptr<Opm::EclIO::ExtESmry>>& lodsmry_loader);
+
+KeywordCatalogue make_keyword_catalogue(const source_list_type& sources);
+
+// patterns are expanded against all cases, result is union of keys found
+// in each case, or keys found in all cases if intersect = true
+std::vector<std::string> expand_pattern(const KeywordCatalogue& catalogue, const std::string& vect,
+                                        bool intersect = false);
+
+void chart_input_from_string(std::string& vect_string,
+                             SmryAppl::input_list_type& input_charts,
+                             const KeywordCatalogue& catalogue,
+                             const int max_number_of_charts,
+                             const std::string& xrange,
+                             bool intersect = false
+                            );
+
+void update_input(SmryAppl::input_list_type& input_charts,
+                  const std::vector<std::string>& keyw_list,
+                  const KeywordCatalogue& catalogue,
+                  const int max_number_of_charts,
+                  const std::string& xrange
+                 );
+
 void chart_input_from_string(std::string& vect_string,
                              SmryAppl::input_list_type& input_charts,
                              const std::vector<FileType>& file_type,
@@ -47,36 +78,57 @@ void update_input(SmryAppl::input_list_type& input_charts,
                   const std::string& xrange
                  );
 
+// preload_list holds vectors from PRELOAD directives for each case, charts
+// marked lazy in chart_props are not loaded here. With stats_cache, stats for the
+// loaded vectors are computed by the thread loading the case
 void pre_load_smry(const std::vector<std::filesystem::path>& smry_files,
                    const SmryAppl::input_list_type& input_charts,
                    const std::vector<FileType>& file_type,
                    std::unordered_map<int, std::unique_ptr<Opm::EclIO::ESmry>>& esmry_loader,
                    std::unordered_map<int, std::unique_ptr<Opm::EclIO::ExtESmry>>& lodsmry_loader,
-                   const size_t nthreads);
+                   const size_t nthreads,
+                   const SmryAppl::chart_props_list_type& chart_props = {},
+                   const std::vector<std::vector<std::string>>& preload_list = {},
+                   SmryStatsCache* stats_cache = nullptr);
 
+void pre_load_smry(const std::vector<std::filesystem::path>& smry_files,
+                   const SmryAppl::input_list_type& input_charts,
+                   const source_list_type& sources,
+                   const size_t nthreads,
+                   const SmryAppl::chart_props_list_type& chart_props = {},
+                   const std::vector<std::vector<std::string>>& preload_list = {},
+                   SmryStatsCache* stats_cache = nullptr);
+
+// vectors found in stats_cache are not scanned
 void remove_zero_vect(const std::vector<std::filesystem::path>& smry_files,
                       SmryAppl::input_list_type& input_charts,
                       const std::vector<FileType>& file_type,
                       std::unordered_map<int, std::unique_ptr<Opm::EclIO::ESmry>>& esmry_loader,
-                      std::unordered_map<int, std::unique_ptr<Opm::EclIO::ExtESmry>>& lodsmry_loader);
+                      std::unordered_map<int, std::unique_ptr<Opm::EclIO::ExtESmry>>& lodsmry_loader,
+                      const SmryStatsCache* stats_cache = nullptr);
+
+void remove_zero_vect(const std::vector<std::filesystem::path>& smry_files,
+                      SmryAppl::input_list_type& input_charts,
+                      const source_list_type& sources,
+                      const SmryStatsCache* stats_cache = nullptr);
 
 
 SmryAppl::input_list_type charts_separate_folders(const std::vector<std::filesystem::path>& smry_files,
         const SmryAppl::input_list_type& input_charts);
 
 
-template <typename T>
-bool double_check_well_vector(std::string& vect_name, std::unique_ptr<T>& smry);
+bool double_check_well_vector(std::string& vect_name, const SummarySource& smry);
 
 void check_summary_vectors(SmryAppl::input_list_type& input_charts,
                            const std::vector<FileType>& file_type,
                            std::unordered_map<int, std::unique_ptr<Opm::EclIO::ESmry>>& esmry_loader,
                            std::unordered_map<int, std::unique_ptr<Opm::EclIO::ExtESmry>>& lodsmry_loader);
 
+void check_summary_vectors(SmryAppl::input_list_type& input_charts, const source_list_type& sources);
+
 
 
-template <typename T>
-bool has_nonzero(std::unique_ptr<T>& smry, const std::string key);
+bool has_nonzero(const SummarySource& smry, const std::string key);
 
 void print_input_charts(const SmryAppl::input_list_type& input_charts);
 
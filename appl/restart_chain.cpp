@@ -0,0 +1,445 @@
+/*
+   Copyright 2022 Equinor ASA.
+
+   This file is part of the Open Porous Media project (OPM).
+
+   OPM is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   OPM is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#include <appl/restart_chain.hpp>
+
+#include <opm/io/eclipse/EclFile.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <set>
+#include <stdexcept>
+
+
+namespace {
+
+std::string trim(const std::string& str)
+{
+    auto p1 = str.find_first_not_of(' ');
+    auto p2 = str.find_last_not_of(' ');
+
+    return p1 == std::string::npos ? "" : str.substr(p1, p2 - p1 + 1);
+}
+
+// root name of base run, empty if not a restart case. RESTART holds the root name
+// split in items of 8 characters
+
+std::string restart_root(const std::filesystem::path& smry_file)
+{
+    Opm::EclIO::EclFile file(smry_file.string());
+
+    if (!file.hasKey("RESTART"))
+        return "";
+
+    file.loadData("RESTART");
+
+    std::string root;
+
+    for (auto& item : file.get<std::string>("RESTART"))
+        root += item.size() < 8 ? item + std::string(8 - item.size(), ' ') : item;
+
+    return trim(root);
+}
+
+} // anonymous namespace
+
+
+RestartSegment::RestartSegment(const std::filesystem::path& smry_file) :
+    file(smry_file)
+{
+    if (smry_file.extension() == ".ESMRY") {
+        ext_esmry = std::make_unique<Opm::EclIO::ExtESmry>(smry_file);
+        source = std::make_unique<ExtESmrySource>(ext_esmry, smry_file);
+    } else {
+        esmry = std::make_unique<Opm::EclIO::ESmry>(smry_file);
+        source = std::make_unique<ESmrySource>(esmry, smry_file);
+    }
+
+    this->update_info();
+}
+
+void RestartSegment::load(const std::vector<std::string>& keys)
+{
+    std::vector<std::string> load_list;
+
+    for (auto& key : keys)
+        if ((this->keys.count(key) > 0) && (loaded.count(key) == 0))
+            load_list.push_back(key);
+
+    if (load_list.empty())
+        return;
+
+    source->load(load_list);
+    loaded.insert(load_list.begin(), load_list.end());
+}
+
+void RestartSegment::update_info()
+{
+    auto keyword_list = source->keyword_list();
+
+    keys = std::unordered_set<std::string>(keyword_list.begin(), keyword_list.end());
+    time_unit = source->get_unit("TIME");
+    startdate = source->startdate();
+    start_date = source->start_date();
+
+    loaded.clear();
+}
+
+
+std::shared_ptr<RestartSegment> RestartSegmentPool::segment(const std::filesystem::path& smry_file)
+{
+    std::string key = std::filesystem::absolute(smry_file).lexically_normal().string();
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (auto segment = m_segments[key].lock())
+            return segment;
+    }
+
+    // opened outside the lock, segments in different chains are opened in parallel
+
+    auto segment = std::make_shared<RestartSegment>(smry_file);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (auto existing = m_segments[key].lock())
+        return existing;
+
+    m_segments[key] = segment;
+
+    return segment;
+}
+
+size_t RestartSegmentPool::size() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    size_t num_segments = 0;
+
+    for (auto& entry : m_segments)
+        if (!entry.second.expired())
+            num_segments++;
+
+    return num_segments;
+}
+
+
+std::vector<std::filesystem::path> RestartChainSource::restart_chain(const std::filesystem::path& smry_file)
+{
+    std::vector<std::filesystem::path> chain = { smry_file };
+    std::set<std::string> visited = { std::filesystem::absolute(smry_file).lexically_normal().string() };
+
+    std::filesystem::path current = smry_file;
+
+    while (true) {
+
+        std::string root = restart_root(current);
+
+        if (root.size() == 0)
+            break;
+
+        std::filesystem::path base_root(root);
+
+        if (base_root.is_relative())
+            base_root = current.parent_path() / base_root;
+
+        // same file type as the restart case first
+
+        std::vector<std::string> ext_list = { current.extension().string(), ".SMSPEC", ".ESMRY" };
+        std::filesystem::path base;
+
+        for (auto& ext : ext_list) {
+            std::filesystem::path candidate = base_root;
+            candidate += ext;
+
+            if (std::filesystem::exists(candidate)) {
+                base = candidate;
+                break;
+            }
+        }
+
+        if (base.empty()) {
+            std::cout << "\n!Warning, base run " << root << " for restart case " << current.string() << " not found";
+            break;
+        }
+
+        if (!visited.insert(std::filesystem::absolute(base).lexically_normal().string()).second)
+            break;
+
+        chain.insert(chain.begin(), base);
+        current = base;
+    }
+
+    return chain;
+}
+
+
+RestartChainSource::RestartChainSource(const std::vector<std::filesystem::path>& chain, RestartSegmentPool& pool) :
+    SummarySource(chain.empty() ? std::filesystem::path() : chain.back())
+{
+    if (chain.empty())
+        throw std::invalid_argument("empty restart chain");
+
+    m_segments.resize(chain.size());
+
+    std::vector<std::string> errors(chain.size());
+
+    // the restart case is not shared, it is reopened while the simulation is running
+
+    #pragma omp parallel for
+    for (size_t n = 0; n < chain.size(); n++) {
+        try {
+            if (n + 1 < chain.size())
+                m_segments[n] = pool.segment(chain[n]);
+            else
+                m_segments[n] = std::make_shared<RestartSegment>(chain[n]);
+        } catch (const std::exception& e) {
+            errors[n] = "Error opening " + chain[n].string() + " in restart chain: " + e.what();
+        }
+    }
+
+    for (auto& error : errors)
+        if (error.size() > 0)
+            throw std::runtime_error(error);
+
+    this->update_ranges();
+}
+
+bool RestartChainSource::all_steps_available() const
+{
+    for (auto& segment : m_segments) {
+        std::lock_guard<std::mutex> lock(segment->mutex);
+
+        if (!segment->source->all_steps_available())
+            return false;
+    }
+
+    return true;
+}
+
+int RestartChainSource::number_of_time_steps() const
+{
+    size_t num_steps = 0;
+
+    for (auto n : m_num_steps)
+        num_steps += n;
+
+    return static_cast<int>(num_steps);
+}
+
+std::tuple<double, double> RestartChainSource::io_elapsed() const
+{
+    double opening = 0.0;
+    double loading = 0.0;
+
+    for (auto& segment : m_segments) {
+        std::lock_guard<std::mutex> lock(segment->mutex);
+
+        auto elapsed = segment->source->io_elapsed();
+        opening += std::get<0>(elapsed);
+        loading += std::get<1>(elapsed);
+    }
+
+    return { opening, loading };
+}
+
+void RestartChainSource::load_segments(const std::vector<std::string>& keys) const
+{
+    std::vector<std::string> errors(m_segments.size());
+
+    #pragma omp parallel for
+    for (size_t n = 0; n < m_segments.size(); n++) {
+
+        RestartSegment& segment = *m_segments[n];
+
+        try {
+            std::lock_guard<std::mutex> lock(segment.mutex);
+            segment.load(keys);
+        } catch (const std::exception& e) {
+            errors[n] = "Error loading from " + segment.file.string() + ": " + e.what();
+        }
+    }
+
+    for (auto& error : errors)
+        if (error.size() > 0)
+            throw std::runtime_error(error);
+}
+
+void RestartChainSource::update_ranges()
+{
+    this->load_segments({ "TIME" });
+
+    double time_fact = m_segments.front()->time_unit == "HOURS" ? 3600.0 * 1000.0 : 24.0 * 3600.0 * 1000.0;
+
+    size_t num_segments = m_segments.size();
+
+    m_time_offset.resize(num_segments);
+    m_num_steps.resize(num_segments);
+
+    for (size_t n = 0; n < num_segments; n++) {
+        auto start_diff = m_segments[n]->startdate - m_segments.front()->startdate;
+        m_time_offset[n] = static_cast<double>(start_diff.count()) / time_fact;
+    }
+
+    // a base run is used up to the first time step of the next segment
+
+    for (size_t n = 0; n < num_segments; n++) {
+
+        std::lock_guard<std::mutex> lock(m_segments[n]->mutex);
+
+        const std::vector<float>& time = m_segments[n]->source->get("TIME");
+
+        double next_time = std::numeric_limits<double>::max();
+
+        if (n + 1 < num_segments) {
+            std::lock_guard<std::mutex> next_lock(m_segments[n + 1]->mutex);
+            const std::vector<float>& next = m_segments[n + 1]->source->get("TIME");
+
+            if (next.size() > 0)
+                next_time = next[0] + m_time_offset[n + 1];
+        }
+
+        size_t num_steps = 0;
+
+        while ((num_steps < time.size()) && (time[num_steps] + m_time_offset[n] < next_time))
+            num_steps++;
+
+        m_num_steps[n] = num_steps;
+    }
+}
+
+void RestartChainSource::join_segments(const std::vector<std::string>& keys) const
+{
+    this->load_segments(keys);
+
+    for (auto& key : keys) {
+
+        std::vector<float> data;
+        data.reserve(this->number_of_time_steps());
+
+        for (size_t n = 0; n < m_segments.size(); n++) {
+
+            RestartSegment& segment = *m_segments[n];
+            size_t num_steps = m_num_steps[n];
+
+            if (segment.keys.count(key) == 0) {
+                data.insert(data.end(), num_steps, std::numeric_limits<float>::quiet_NaN());
+                continue;
+            }
+
+            std::lock_guard<std::mutex> lock(segment.mutex);
+            const std::vector<float>& values = segment.source->get(key);
+
+            if (key == "TIME") {
+                for (size_t t = 0; t < num_steps; t++)
+                    data.push_back(static_cast<float>(values[t] + m_time_offset[n]));
+            } else {
+                data.insert(data.end(), values.begin(), values.begin() + num_steps);
+            }
+        }
+
+        m_data[key] = std::move(data);
+    }
+}
+
+void RestartChainSource::load(const std::vector<std::string>& keys)
+{
+    std::vector<std::string> load_list;
+
+    for (auto& key : keys)
+        if ((m_data.count(key) == 0) && this->has_key(key))
+            load_list.push_back(key);
+
+    if (load_list.empty())
+        return;
+
+    this->join_segments(load_list);
+}
+
+const std::vector<float>& RestartChainSource::get(const std::string& key) const
+{
+    auto it = m_data.find(key);
+
+    if (it != m_data.end())
+        return it->second;
+
+    if (!this->has_key(key))
+        throw std::invalid_argument("key " + key + " not found in restart case " + this->rootname());
+
+    this->join_segments({ key });
+
+    return m_data.at(key);
+}
+
+std::vector<size_t> RestartChainSource::make_report_step_index() const
+{
+    this->load_segments({ "TIME" });
+
+    std::vector<size_t> index;
+    size_t first_step = 0;
+
+    for (size_t n = 0; n < m_segments.size(); n++) {
+
+        RestartSegment& segment = *m_segments[n];
+        std::vector<size_t> segment_index;
+
+        {
+            std::lock_guard<std::mutex> lock(segment.mutex);
+            segment_index = segment.source->report_step_index();
+        }
+
+        for (auto t : segment_index)
+            if (t < m_num_steps[n])
+                index.push_back(first_step + t);
+
+        first_step += m_num_steps[n];
+    }
+
+    return index;
+}
+
+bool RestartChainSource::reopen()
+{
+    RestartSegment& restart = *m_segments.back();
+
+    bool updated;
+
+    // more time steps than used by the chain is also an update
+
+    {
+        std::lock_guard<std::mutex> lock(restart.mutex);
+        updated = restart.source->reopen();
+        updated = updated || (static_cast<size_t>(restart.source->number_of_time_steps()) > m_num_steps.back());
+
+        if (updated)
+            restart.update_info();
+    }
+
+    if (!updated)
+        return false;
+
+    m_data.clear();
+
+    this->update_ranges();
+    this->update_file_stamp();
+
+    return true;
+}
@@ -0,0 +1,157 @@
+/*
+   Copyright 2022 Equinor ASA.
+
+   This file is part of the Open Porous Media project (OPM).
+
+   OPM is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   OPM is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#ifndef SMRY_APPL_RESTART_CHAIN_HPP
+#define SMRY_APPL_RESTART_CHAIN_HPP
+
+#include <appl/summary_source.hpp>
+
+#include <array>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+
+// One segment of a restart chain, a SMSPEC or ESMRY case with its own loader. Base runs
+// are shared by the chains opened with the same RestartSegmentPool, a base run used by
+// several restart cases is opened once and each vector is read once. Loaded vectors
+// are not changed while the segment is shared, all chains copy from the same data.
+
+struct RestartSegment {
+
+    explicit RestartSegment(const std::filesystem::path& smry_file);
+
+    // loads keys not loaded before, keys not in the segment are skipped. Called with mutex locked
+    void load(const std::vector<std::string>& keys);
+
+    // reads keys, TIME unit and start date from source, after opening and reopening.
+    // Called with mutex locked
+    void update_info();
+
+    std::filesystem::path file;
+
+    std::unique_ptr<Opm::EclIO::ESmry> esmry;
+    std::unique_ptr<Opm::EclIO::ExtESmry> ext_esmry;
+    std::unique_ptr<SummarySource> source;
+
+    // copied from source by update_info, chains use these without locking the mutex
+    std::unordered_set<std::string> keys;
+    std::string time_unit;
+    SummarySource::time_point startdate;
+    std::array<int, 7> start_date;
+
+    std::unordered_set<std::string> loaded;
+
+    // segments are loaded from several threads when shared, source and loaded are
+    // only used with the mutex locked
+    std::mutex mutex;
+};
+
+
+// Base runs in use by restart chains, owned by the application. Segments are kept while
+// used by a chain, the pool only holds weak references. The loaded vectors of a base
+// run are released with the last chain using it.
+
+class RestartSegmentPool {
+
+public:
+
+    // segment for smry_file, opened if not used by any chain. Thread safe
+    std::shared_ptr<RestartSegment> segment(const std::filesystem::path& smry_file);
+
+    // segments used by at least one chain
+    size_t size() const;
+
+private:
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::string, std::weak_ptr<RestartSegment>> m_segments;
+};
+
+
+// Restart case and its base runs as one case. Vectors are joined in time, the base run
+// is used up to the first time step of the restart run. Keys are taken from the last
+// segment, values are NaN for time steps in segments without the key. TIME is
+// relative to the start date of the first base run. Segments are opened and loaded in
+// parallel. The joined vectors are copied from the segments, get returns contiguous
+// vectors, while the segment data is shared with other chains using the same base runs.
+
+class RestartChainSource : public SummarySource {
+
+public:
+
+    // chain from restart_chain, first base run first. Base runs are taken from pool
+    RestartChainSource(const std::vector<std::filesystem::path>& chain, RestartSegmentPool& pool);
+
+    // the case followed by base runs from RESTART in SMSPEC or ESMRY, first base run first.
+    // Base runs not found are reported and the chain is cut
+    static std::vector<std::filesystem::path> restart_chain(const std::filesystem::path& smry_file);
+
+    FileType file_type() const override { return FileType::RESTART; }
+    std::string rootname() const override { return last().rootname(); }
+
+    bool has_key(const std::string& key) const override { return last().has_key(key); }
+    std::vector<std::string> keyword_list() const override { return last().keyword_list(); }
+    std::vector<std::string> keyword_list(const std::string& pattern) const override { return last().keyword_list(pattern); }
+    std::string get_unit(const std::string& key) const override { return last().get_unit(key); }
+    bool all_steps_available() const override;
+    int number_of_time_steps() const override;
+
+    time_point startdate() const override { return m_segments.front()->startdate; }
+    std::array<int, 7> start_date() const override { return m_segments.front()->start_date; }
+
+    std::tuple<double, double> io_elapsed() const override;
+
+    void load(const std::vector<std::string>& keys) override;
+    const std::vector<float>& get(const std::string& key) const override;
+
+    // the restart case is reopened, base runs are not expected to change
+    bool reopen() override;
+
+    size_t number_of_segments() const { return m_segments.size(); }
+
+protected:
+
+    // report steps of each segment in the time steps used from the segment
+    std::vector<size_t> make_report_step_index() const override;
+
+private:
+
+    std::vector<std::shared_ptr<RestartSegment>> m_segments;
+
+    // number of time steps used from each segment, from first time step
+    std::vector<size_t> m_num_steps;
+
+    // TIME offset of each segment, start date relative to first segment
+    std::vector<double> m_time_offset;
+
+    mutable std::unordered_map<std::string, std::vector<float>> m_data;
+
+    // the restart case is only used by this chain, used without locking the mutex
+    const SummarySource& last() const { return *m_segments.back()->source; }
+
+    void load_segments(const std::vector<std::string>& keys) const;
+    void join_segments(const std::vector<std::string>& keys) const;
+    void update_ranges();
+};
+
+#endif // SMRY_APPL_RESTART_CHAIN_HPP
@@ -0,0 +1,267 @@
+/*
+   Copyright 2022 Equinor ASA.
+
+   This file is part of the Open Porous Media project (OPM).
+
+   OPM is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   OPM is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#include <appl/series_data.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+
+void SeriesData::assign(std::vector<int64_t>&& time_ms, std::vector<double>&& values)
+{
+    m_time = std::move(time_ms);
+    m_values = std::move(values);
+
+    reset_stats();
+    update_stats(0, m_values.size());
+}
+
+void SeriesData::assign(std::vector<int64_t>&& time_ms, std::vector<double>&& values, const SmryStats& stats,
+                        float factor)
+{
+    m_time = std::move(time_ms);
+    m_values = std::move(values);
+
+    reset_stats();
+
+    if (m_values.empty())
+        return;
+
+    // same float product as used for the values
+
+    m_min = stats.min * factor;
+    m_max = stats.max * factor;
+    m_min_nonzero = stats.min_nonzero * factor;
+    m_max_nonzero = stats.max_nonzero * factor;
+
+    if (factor < 0.0f) {
+        std::swap(m_min, m_max);
+        std::swap(m_min_nonzero, m_max_nonzero);
+    } else {
+        m_p90 = stats.p90 * factor;
+        m_p90_valid = true;
+    }
+
+    m_first_nonzero = stats.first_nonzero;
+    m_last_nonzero = stats.last_nonzero;
+
+    m_all_zero = stats.all_zero;
+    m_all_nonzero = stats.all_nonzero;
+
+    m_min_time = m_time.front();
+    m_max_time = m_time.back();
+}
+
+void SeriesData::append(const std::vector<int64_t>& time_ms, const std::vector<double>& values)
+{
+    size_t n0 = m_values.size();
+
+    m_time.insert(m_time.end(), time_ms.begin(), time_ms.end());
+    m_values.insert(m_values.end(), values.begin(), values.end());
+
+    // only the new points are visited
+
+    update_stats(n0, m_values.size());
+}
+
+void SeriesData::scale(double factor)
+{
+    for (auto& v : m_values)
+        v = v * factor;
+
+    // order and zero values are kept for positive factors, no need for a new pass
+
+    if ((factor > 0.0) && (m_values.size() > 0)) {
+        m_min *= factor;
+        m_max *= factor;
+        m_min_nonzero *= factor;
+        m_max_nonzero *= factor;
+        m_p90 *= factor;
+    } else {
+        reset_stats();
+        update_stats(0, m_values.size());
+    }
+}
+
+void SeriesData::clear()
+{
+    m_time.clear();
+    m_values.clear();
+
+    reset_stats();
+}
+
+double SeriesData::p90() const
+{
+    if ((!m_p90_valid) && (m_values.size() > 0)) {
+        std::vector<double> tmp(m_values);
+
+        size_t p = static_cast<size_t>(tmp.size() * 0.9);
+        std::nth_element(tmp.begin(), tmp.begin() + p, tmp.end());
+
+        m_p90 = tmp[p];
+        m_p90_valid = true;
+    }
+
+    return m_p90;
+}
+
+void SeriesData::reset_stats()
+{
+    m_min = std::numeric_limits<double>::max();
+    m_max = std::numeric_limits<double>::lowest();
+
+    m_min_time = std::numeric_limits<int64_t>::max();
+    m_max_time = std::numeric_limits<int64_t>::min();
+
+    m_min_nonzero = std::numeric_limits<double>::max();
+    m_max_nonzero = std::numeric_limits<double>::lowest();
+
+    m_first_nonzero = -1;
+    m_last_nonzero = -1;
+
+    m_all_zero = true;
+    m_all_nonzero = true;
+
+    m_p90 = 0.0;
+    m_p90_valid = false;
+}
+
+void SeriesData::update_stats(size_t n0, size_t n1)
+{
+    // stats for values [n0, n1) merged into the current stats
+
+    for (size_t n = n0; n < n1; n++) {
+
+        const double v = m_values[n];
+
+        if (v < m_min)
+            m_min = v;
+
+        if (v > m_max)
+            m_max = v;
+
+        if (v != 0.0) {
+            if (m_first_nonzero < 0)
+                m_first_nonzero = static_cast<long>(n);
+
+            m_last_nonzero = static_cast<long>(n);
+
+            if (v < m_min_nonzero)
+                m_min_nonzero = v;
+
+            if (v > m_max_nonzero)
+                m_max_nonzero = v;
+
+        } else {
+            m_all_nonzero = false;
+        }
+    }
+
+    if (m_time.size() > 0) {
+        m_min_time = m_time.front();
+        m_max_time = m_time.back();
+    }
+
+    m_all_zero = m_first_nonzero < 0;
+
+    if (n1 > n0)
+        m_p90_valid = false;
+}
+
+
+std::tuple<double, double> SeriesData::min_max_index_range(size_t n0, size_t n1, bool ignore_zero) const
+{
+    double min_y = std::numeric_limits<double>::max();
+    double max_y = std::numeric_limits<double>::lowest();
+
+    for (size_t n = n0; n < n1; n++) {
+
+        const double v = m_values[n];
+
+        if ((!ignore_zero) || (v != 0.0)) {
+
+            if (v < min_y)
+                min_y = v;
+
+            if (v > max_y)
+                max_y = v;
+        }
+    }
+
+    if (std::abs(min_y) < 1e-100)
+        min_y = 0.0;
+
+    if (std::abs(max_y) < 1e-100)
+        max_y = 0.0;
+
+    return std::make_tuple(min_y, max_y);
+}
+
+std::tuple<double, double> SeriesData::min_max_value(double xfrom, double xto, bool ignore_zero) const
+{
+    // time is sorted, only the values inside [xfrom, xto] are visited
+
+    auto first = std::lower_bound(m_time.begin(), m_time.end(), xfrom,
+                                  [](int64_t t, double x) { return static_cast<double>(t) < x; });
+
+    auto last = std::upper_bound(first, m_time.end(), xto,
+                                 [](double x, int64_t t) { return x < static_cast<double>(t); });
+
+    return min_max_index_range(std::distance(m_time.begin(), first), std::distance(m_time.begin(), last), ignore_zero);
+}
+
+std::tuple<double, double> SeriesData::min_max_value(bool ignore_zero) const
+{
+    if (!ignore_zero)
+        return std::make_tuple(m_min, m_max);
+
+    // no nonzero values, same result as an empty index range
+
+    if (m_all_zero)
+        return std::make_tuple(std::numeric_limits<double>::max(), std::numeric_limits<double>::lowest());
+
+    // same limits for values close to zero as min_max_index_range
+
+    double min_y = std::abs(m_min_nonzero) < 1e-100 ? 0.0 : m_min_nonzero;
+    double max_y = std::abs(m_max_nonzero) < 1e-100 ? 0.0 : m_max_nonzero;
+
+    return std::make_tuple(min_y, max_y);
+}
+
+
+size_t SeriesData::closest(double x, double y) const
+{
+    size_t ind = 0;
+    double dist = std::numeric_limits<double>::max();
+
+    for (size_t n = 0; n < m_values.size(); n++) {
+
+        const double dx = static_cast<double>(m_time[n]) - x;
+        const double dy = m_values[n] - y;
+        const double dist_test = dx * dx + dy * dy;
+
+        if (dist_test < dist) {
+            dist = dist_test;
+            ind = n;
+        }
+    }
+
+    return ind;
+}
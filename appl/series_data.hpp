@@ -0,0 +1,106 @@
+/*
+   Copyright 2022 Equinor ASA.
+
+   This file is part of the Open Porous Media project (OPM).
+
+   OPM is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   OPM is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#ifndef SMRY_APPL_SERIES_DATA_HPP
+#define SMRY_APPL_SERIES_DATA_HPP
+
+#include <appl/smry_stats.hpp>
+
+#include <cstdint>
+#include <cstddef>
+#include <tuple>
+#include <vector>
+
+
+// Columnar storage for one summary series. Time is milliseconds since epoch
+// (UTC) and must be increasing, values are stored as plotted (multiplier applied).
+// Statistics are computed once when data is assigned, updated from the new points
+// when data is appended and scaled with the values. P90 is computed when first used.
+
+class SeriesData {
+
+public:
+
+    void assign(std::vector<int64_t>&& time_ms, std::vector<double>&& values);
+
+    // values are the loaded vector times factor, stats taken from the vector without a pass
+    void assign(std::vector<int64_t>&& time_ms, std::vector<double>&& values, const SmryStats& stats, float factor);
+
+    void scale(double factor);
+    void clear();
+
+    // points after the last time, used for live cases
+    void append(const std::vector<int64_t>& time_ms, const std::vector<double>& values);
+
+    size_t size() const { return m_values.size(); }
+    bool empty() const { return m_values.empty(); }
+
+    const std::vector<int64_t>& time() const { return m_time; }
+    const std::vector<double>& values() const { return m_values; }
+
+    double min_value() const { return m_min; }
+    double max_value() const { return m_max; }
+
+    // value at index size * 0.9 in sorted values
+    double p90() const;
+
+    int64_t min_time() const { return m_min_time; }
+    int64_t max_time() const { return m_max_time; }
+
+    bool all_zero() const { return m_all_zero; }
+    bool all_nonzero() const { return m_all_nonzero; }
+
+    // index of first and last nonzero value, -1 if all values are zero
+    long first_nonzero() const { return m_first_nonzero; }
+    long last_nonzero() const { return m_last_nonzero; }
+
+    std::tuple<double, double> min_max_value(double xfrom, double xto, bool ignore_zero) const;
+    std::tuple<double, double> min_max_value(bool ignore_zero) const;
+
+    size_t closest(double x, double y) const;
+
+private:
+
+    std::vector<int64_t> m_time;
+    std::vector<double> m_values;
+
+    double m_min;
+    double m_max;
+
+    // min and max of nonzero values
+    double m_min_nonzero;
+    double m_max_nonzero;
+
+    mutable double m_p90 = 0.0;
+    mutable bool m_p90_valid = false;
+
+    int64_t m_min_time;
+    int64_t m_max_time;
+
+    long m_first_nonzero = -1;
+    long m_last_nonzero = -1;
+
+    bool m_all_zero = true;
+    bool m_all_nonzero = true;
+
+    void reset_stats();
+    void update_stats(size_t n0, size_t n1);
+    std::tuple<double, double> min_max_index_range(size_t n0, size_t n1, bool ignore_zero) const;
+};
+
+#endif // SMRY_APPL_SERIES_DATA_HPP
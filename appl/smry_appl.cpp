@@ -17,6 +17,8 @@
    */
 
 #include <appl/smry_appl.hpp>
+#include <appl/esmry_cache.hpp>
+#include <appl/live_source.hpp>
 
 
 #include <iostream>
@@ -25,12 +27,98 @@
 #include <omp.h>
 #include <limits>
 #include <algorithm>
+#include <numeric>
+#include <cmath>
+
+
+namespace {
+
+const SmryAppl::time_window_type full_time_window { std::numeric_limits<qint64>::min(),
+                                                    std::numeric_limits<qint64>::max() };
+
+// narrows steps n0 .. n1 to the time window, keeping one step on each side of the
+// window so that lines reach the axis edges. TIME is increasing, binary search
+
+void window_steps ( SmrySpan timev, qint64 start_msec, double time_fact,
+                    const SmryAppl::time_window_type& window, size_t& n0, size_t& n1 )
+{
+    auto first = timev.begin() + n0;
+    auto last = timev.begin() + n1 + 1;
+
+    if ( window.first != full_time_window.first ) {
+        float t0 = static_cast<float> ( static_cast<double> ( window.first - start_msec ) / time_fact );
+        auto it = std::lower_bound ( first, last, t0 );
+
+        if ( it != first )
+            --it;
+
+        n0 = static_cast<size_t> ( it - timev.begin() );
+    }
+
+    if ( window.second != full_time_window.second ) {
+        float t1 = static_cast<float> ( static_cast<double> ( window.second - start_msec ) / time_fact );
+        auto it = std::upper_bound ( first, last, t1 );
+
+        if ( it != last )
+            n1 = static_cast<size_t> ( it - timev.begin() );
+    }
+}
+
+void window_steps ( const std::vector<float>& timev, qint64 start_msec, double time_fact,
+                    const SmryAppl::time_window_type& window, size_t& n0, size_t& n1 )
+{
+    window_steps ( SmrySpan { timev.data(), timev.size() }, start_msec, time_fact, window, n0, n1 );
+}
+
+// values at report steps only, returns false if the source has no report steps
+
+bool report_step_values ( const SummarySource& source, SmrySpan timev, SmrySpan datav,
+                          std::vector<float>& rstep_time, std::vector<float>& rstep_data )
+{
+    const std::vector<size_t>& steps = source.report_step_index();
+
+    if ( steps.size() == 0 )
+        return false;
+
+    rstep_time.clear();
+    rstep_data.clear();
+
+    rstep_time.reserve ( steps.size() );
+    rstep_data.reserve ( steps.size() );
+
+    for ( auto t : steps ) {
+        rstep_time.push_back ( timev[t] );
+        rstep_data.push_back ( datav[t] );
+    }
+
+    return true;
+}
+
+// keeps report steps only, all time steps kept if the source has no report steps
+
+void keep_report_steps ( const SummarySource& source, std::vector<float>& timev, std::vector<float>& datav )
+{
+    std::vector<float> rstep_time;
+    std::vector<float> rstep_data;
+
+    if ( !report_step_values ( source, SmrySpan { timev.data(), timev.size() },
+                               SmrySpan { datav.data(), datav.size() }, rstep_time, rstep_data ) )
+        return;
+
+    timev = std::move ( rstep_time );
+    datav = std::move ( rstep_data );
+}
+
+} // anonymous namespace
 
 
 SmryAppl::SmryAppl(std::vector<std::string> arg_vect, loader_list_type& loaders,
-                   input_list_type chart_input, std::unique_ptr<DerivedSmry>& derived_smry, QWidget *parent)
+                   input_list_type chart_input, std::unique_ptr<DerivedSmry>& derived_smry,
+                   const chart_props_list_type& chart_props, SmryStatsCache stats_cache,
+                   bool report_steps, QWidget *parent)
     : QGraphicsView(new QGraphicsScene, parent)
 {
+    m_report_steps_default = report_steps;
 
     if (derived_smry != nullptr)
         m_derived_smry = std::move(derived_smry);
@@ -48,24 +136,18 @@ SmryAppl::SmryAppl(std::vector<std::string> arg_vect, loader_list_type& loaders,
         m_esmry_loader = std::move(std::get<2>(loaders));
         m_ext_esmry_loader = std::move(std::get<3>(loaders));
 
-        for (size_t smry_ind = 0; smry_ind < m_smry_files.size(); smry_ind++){
-            auto ftime = std::filesystem::last_write_time ( m_smry_files[smry_ind] );
-            file_stamp_vector.push_back ( ftime );
-
-            if (m_file_type[smry_ind] == FileType::SMSPEC) {
-                root_name_list.push_back ( m_esmry_loader[smry_ind]->rootname() );
-                vect_list.push_back ( m_esmry_loader[smry_ind]->keywordList() );
+        // stats from pre loading, if any
+        m_stats = std::move(stats_cache);
+        m_stats.resize(m_smry_files.size());
 
-                if ((!m_esmry_loader[smry_ind]->hasKey("TIMESTEP") && (m_esmry_loader[smry_ind]->all_steps_available())))
-                    vect_list.back().push_back("TIMESTEP");
+        m_sources = std::move(std::get<4>(loaders));
 
-            } else if (m_file_type[smry_ind] == FileType::ESMRY) {
-                root_name_list.push_back ( m_ext_esmry_loader[smry_ind]->rootname() );
-                vect_list.push_back ( m_ext_esmry_loader[smry_ind]->keywordList() );
+        if (m_sources.empty())
+            m_sources = make_summary_sources ( m_file_type, m_esmry_loader, m_ext_esmry_loader, m_smry_files );
 
-                if ((!m_ext_esmry_loader[smry_ind]->hasKey("TIMESTEP") && (m_ext_esmry_loader[smry_ind]->all_steps_available())))
-                    vect_list.back().push_back("TIMESTEP");
-            }
+        for (size_t smry_ind = 0; smry_ind < m_smry_files.size(); smry_ind++){
+            root_name_list.push_back ( m_sources[smry_ind]->rootname() );
+            this->update_keyword_index ( smry_ind );
         }
     }
 
@@ -139,21 +221,17 @@ SmryAppl::SmryAppl(std::vector<std::string> arg_vect, loader_list_type& loaders,
     lbl_num->setText ( QString::fromStdString ( "" ) );
 
     if ( chart_input.size() > 0 )
-        this->create_charts_from_input ( chart_input );
+        this->create_charts_from_input ( chart_input, chart_props );
+
+    connect ( stackedWidget, &QStackedWidget::currentChanged, this, &SmryAppl::materialize_chart );
 
     double total_opening = 0.0;
     double total_loading = 0.0;
 
-    for (size_t n = 0; n < m_file_type.size(); n++){
-        if (m_file_type[n] == FileType::SMSPEC){
-            auto elapsed = m_esmry_loader[n]->get_io_elapsed();
-            total_opening += std::get<0>(elapsed);
-            total_loading += std::get<1>(elapsed);
-        } else if (m_file_type[n] == FileType::ESMRY){
-            auto elapsed = m_ext_esmry_loader[n]->get_io_elapsed();
-            total_opening += std::get<0>(elapsed);
-            total_loading += std::get<1>(elapsed);
-        }
+    for (auto& source : m_sources){
+        auto elapsed = source->io_elapsed();
+        total_opening += std::get<0>(elapsed);
+        total_loading += std::get<1>(elapsed);
     }
 
     if (fileList.size() > 0) {
@@ -200,52 +278,100 @@ void SmryAppl::init_new_chart()
     axisY.push_back ( {} );
     series.push_back ( {} );
     ens_series.push_back ( {} );
+
+    m_chart_props.push_back ( {} );
+    m_lazy_input.push_back ( {} );
+    m_time_window.push_back ( full_time_window );
+    m_report_steps.push_back ( m_report_steps_default );
+
+    m_ens_vect.push_back ( {} );
+    m_ens_members.push_back ( {} );
+    m_ens_data.push_back ( nullptr );
+    m_ens_band.push_back ( nullptr );
 }
 
 
-void SmryAppl::create_charts_from_input ( const input_list_type& chart_input )
+void SmryAppl::create_charts_from_input ( const input_list_type& chart_input, const chart_props_list_type& chart_props )
 {
 
-    if (ens_mode) {
+    for ( size_t c = 0; c < chart_input.size(); c++ ) {
 
-        for ( size_t c = 0; c < chart_input.size(); c++ ) {
-            auto vect_input = std::get<0>(chart_input[c]);
+        chart_ind = c;
 
-            std::cout << "size: " << vect_input.size() << std::endl;
-            std::string xrange_str = std::get<1>(chart_input[c]);
+        if ( chart_ind > 0 )
+            this->init_new_chart();
 
-            std::cout << "xrange_str: " << xrange_str << std::endl;
-            // bool SmryAppl::add_new_ens_series ( int chart_ind, std::string vect_name, int vaxis_ind )
+        if ( c < chart_props.size() )
+            m_chart_props[c] = chart_props[c];
 
-            for (size_t n = 0; n < vect_input.size(); n++){
+        // in ensemble mode, charts with many cases of one vector are shown as ensemble
 
-                int smryind = std::get<0> ( vect_input[n] );
-                std::string vect_name = std::get<1> ( vect_input[n] );
+        const auto& vect_input = std::get<0> ( chart_input[c] );
 
-                std::cout << n;
-                std::cout << " smry index: " << smryind;
-                std::cout << " vect_name: " << vect_name;
+        if ( ( ens_mode ) && ( vect_input.size() > 9 ) ) {
 
-                std::cout << std::endl;
-            }
+            bool same_vect = std::all_of ( vect_input.begin(), vect_input.end(), [&] ( const auto& v ) {
+                return std::get<1> ( v ) == std::get<1> ( vect_input[0] );
+            } );
 
+            if ( same_vect )
+                std::get<3> ( m_chart_props[c] ) = true;
         }
 
-        std::cout << "ensemble chart from cmd line under construction \n";
-        exit(1);
+        // series in lazy charts added when chart is shown, see materialize_chart
 
-    } else {
+        if ( std::get<1> ( m_chart_props[c] ) && ( c > 0 ) )
+            m_lazy_input[c] = chart_input[c];
+        else
+            this->add_chart_series ( c, chart_input[c] );
+    }
 
-        for ( size_t c = 0; c < chart_input.size(); c++ ) {
+    chart_ind = 0;
+    stackedWidget->setCurrentIndex(chart_ind);
 
-            chart_ind = c;
+    this->update_chart_labels();
+}
 
-            if ( chart_ind > 0 )
-                this->init_new_chart();
 
-            std::vector<SmryAppl::vect_input_type> vect_input;
-            vect_input = std::get<0>(chart_input[c]);
-            std::string xrange_str = std::get<1>(chart_input[c]);
+void SmryAppl::add_chart_series ( int c, const char_input_type& chart_input )
+{
+    const std::vector<SmryAppl::vect_input_type>& vect_input = std::get<0>(chart_input);
+    const std::string& xrange_str = std::get<1>(chart_input);
+
+    // only the time window around the x-range is converted and plotted, the
+    // window is extended when zooming or panning out of it
+
+    if (xrange_str.size() > 0) {
+        QDateTime dt_from;
+        QDateTime dt_to;
+
+        if (SmryXaxis::parse_range ( xrange_str, dt_from, dt_to ))
+            this->set_time_window ( c, dt_from.toMSecsSinceEpoch(), dt_to.toMSecsSinceEpoch() );
+    }
+
+    {
+        UpdateScope update ( *this );
+
+        if ( std::get<3> ( m_chart_props[c] ) ) {
+
+            // ensemble chart, members are the cases of the first vector in chart
+
+            std::string vect_name = std::get<1> ( vect_input[0] );
+            std::vector<int> members;
+
+            for ( size_t i = 0; i < vect_input.size(); i++ ) {
+                if ( std::get<3> ( vect_input[i] ) )
+                    std::cout << "!warning, derived series '" << std::get<1> ( vect_input[i] ) << "' not supported in ensemble chart\n";
+                else if ( std::get<1> ( vect_input[i] ) != vect_name )
+                    std::cout << "!warning, ensemble chart " << c + 1 << " holds " << vect_name << ", '" << std::get<1> ( vect_input[i] ) << "' ignored\n";
+                else
+                    members.push_back ( std::get<0> ( vect_input[i] ) );
+            }
+
+            if ( members.size() > 0 )
+                this->add_new_ens_series ( c, vect_name, std::get<2> ( vect_input[0] ), members );
+
+        } else {
 
             for ( size_t i = 0; i < vect_input.size(); i++ ) {
                 int n = std::get<0> ( vect_input[i] );
@@ -253,43 +379,58 @@ void SmryAppl::create_charts_from_input ( const input_list_type& chart_input )
                 int axis_ind = std::get<2> ( vect_input[i] );
                 bool is_derived = std::get<3> ( vect_input[i] );
 
-                if (this->add_new_series ( chart_ind, n, vect_name, axis_ind, is_derived) == false) {
+                if (this->add_new_series ( c, n, vect_name, axis_ind, is_derived) == false) {
                     std::cout << "!warning, not able to add series '" << vect_name <<"' for case ";
                     std::cout << root_name_list[n]  << "\n";
                 }
-
             }
+        }
+    }
 
-            if (series[c].size() > 0)
-                update_full_xrange(c);
+    if (series[c].size() == 0)
+        return;
 
-            if (xrange_str.size() > 0) {
+    m_window_update = true;
 
-                if (!axisX[c]->set_range ( xrange_str ))
-                    std::cout << "!Warning, fail to set x-range for chart index: " << chart_ind << "\n";
-                else {
-                    auto min_max_range = axisX[c]->get_xrange();
-                    update_all_yaxis(min_max_range, c);  // should this be false ?
-                }
+    update_full_xrange(c);
 
-            } else {
+    if (xrange_str.size() > 0) {
 
-                auto min_max_range = axisX[c]->get_xrange();
-                //axisX[c]->resetAxisRange();
-                update_all_yaxis(min_max_range, c);
-            }
+        bool range_ok = axisX[c]->set_range ( xrange_str );
+        m_window_update = false;
+
+        if (!range_ok)
+            std::cout << "!Warning, fail to set x-range for chart index: " << c << "\n";
+        else {
+            auto min_max_range = axisX[c]->get_xrange();
+            update_all_yaxis(min_max_range, c);  // should this be false ?
         }
+
+    } else {
+        m_window_update = false;
+
+        auto min_max_range = axisX[c]->get_xrange();
+        update_all_yaxis(min_max_range, c);
     }
+}
 
-    chart_ind = 0;
-    stackedWidget->setCurrentIndex(chart_ind);
 
-    this->update_chart_labels();
+void SmryAppl::materialize_chart ( int c )
+{
+    if ( ( c < 0 ) || ( c >= static_cast<int>(m_lazy_input.size()) ) || ( !is_lazy_pending ( c ) ) )
+        return;
+
+    char_input_type chart_input = std::move ( m_lazy_input[c] );
+    m_lazy_input[c] = {};
+
+    this->add_chart_series ( c, chart_input );
+
+    if ( c == chart_ind )
+        this->update_chart_labels();
 }
 
 
-template <typename T>
-bool SmryAppl::double_check_well_vector(std::string& vect_name, std::unique_ptr<T>& smry)
+bool SmryAppl::double_check_well_vector(std::string& vect_name, const SummarySource& smry)
 {
     auto p = vect_name.find(":");
     auto wname = vect_name.substr(p + 1);
@@ -299,7 +440,7 @@ bool SmryAppl::double_check_well_vector(std::string& vect_name, std::unique_ptr<
 
     std::string pattern = vect_name.substr(0, p + 1) + wname + "*";
 
-    auto vlist = smry->keywordList(pattern);
+    auto vlist = smry.keyword_list(pattern);
 
     if (vlist.size() == 1){
         vect_name = vlist[0];
@@ -321,10 +462,15 @@ bool SmryAppl::add_new_series ( int chart_ind, int smry_ind, std::string vect_na
 
     if ((is_derived) && (smry_ind < 0)){
         timev = m_derived_smry->get(smry_ind, "TIME" );
-    } else if (m_file_type[smry_ind] == FileType::SMSPEC)
-        timev = m_esmry_loader[smry_ind]->get("TIME");
-    else if (m_file_type[smry_ind] == FileType::ESMRY)
-        timev = m_ext_esmry_loader[smry_ind]->get("TIME");
+    } else
+        timev = m_sources[smry_ind]->get("TIME");
+
+    // live case connected before the first time step is received
+
+    if (timev.size() == 0) {
+        std::cout << "\n!Warning, no time steps for " << vect_name << ", series not added\n";
+        return false;
+    }
 
     std::string smry_unit;
 
@@ -337,10 +483,8 @@ bool SmryAppl::add_new_series ( int chart_ind, int smry_ind, std::string vect_na
         if (!hasVect)
             throw std::runtime_error("derived smry vector " + std::to_string(smry_ind) + ":" + vect_name + " not found in m_derived_smry");
 
-    } else if (m_file_type[smry_ind] == FileType::SMSPEC){
-        hasVect = m_esmry_loader[smry_ind]->hasKey(vect_name);
-    } else if (m_file_type[smry_ind] == FileType::ESMRY) {
-        hasVect = m_ext_esmry_loader[smry_ind]->hasKey(vect_name);
+    } else {
+        hasVect = m_sources[smry_ind]->has_key(vect_name);
     }
 
     // well name in Flow and Eclipse (input data file) can be longer than 8 characters
@@ -350,13 +494,8 @@ bool SmryAppl::add_new_series ( int chart_ind, int smry_ind, std::string vect_na
     //  b) ESMRY files post simulation converted from SMSPEC/UNSMRY -> ESMRY will har truncated well names
 
 
-    if ((!hasVect) && (vect_name.substr(0,1) == "W")){
-
-        if (m_file_type[smry_ind] == FileType::SMSPEC)
-            hasVect = this->double_check_well_vector(vect_name, m_esmry_loader[smry_ind]);
-        else if (m_file_type[smry_ind] == FileType::ESMRY)
-            hasVect = this->double_check_well_vector(vect_name, m_ext_esmry_loader[smry_ind]);
-    }
+    if ((!hasVect) && (vect_name.substr(0,1) == "W"))
+        hasVect = this->double_check_well_vector(vect_name, *m_sources[smry_ind]);
 
 
     if (!hasVect){
@@ -384,31 +523,23 @@ bool SmryAppl::add_new_series ( int chart_ind, int smry_ind, std::string vect_na
             datav = m_derived_smry->get(smry_ind, vect_name );
             smry_unit = m_derived_smry->get_unit ( smry_ind, vect_name );
 
-        } else if (m_file_type[smry_ind] == FileType::SMSPEC){
-            hasVect = m_esmry_loader[smry_ind]->hasKey(vect_name);
-
-            try {
-                datav = m_esmry_loader[smry_ind]->get ( vect_name );
-            } catch (...){
-                std::string message;
-                message = "Error loading " + vect_name + " from SMSPEC/UNSMRY " + m_esmry_loader[smry_ind]->rootname();
-                throw std::runtime_error(message);
-            }
-
-            smry_unit = m_esmry_loader[smry_ind]->get_unit ( vect_name );
+        } else {
+            const SummarySource& source = *m_sources[smry_ind];
 
-        } else if (m_file_type[smry_ind] == FileType::ESMRY){
-            hasVect = m_ext_esmry_loader[smry_ind]->hasKey(vect_name);
+            hasVect = source.has_key(vect_name);
 
             try {
-                datav = m_ext_esmry_loader[smry_ind]->get ( vect_name );
-            } catch (...) {
+                datav = source.get ( vect_name );
+            } catch (...){
+                std::string file_format = source.file_type() == FileType::SMSPEC ? "SMSPEC/UNSMRY" :
+                                          source.file_type() == FileType::FORMATTED ? "FSMSPEC/FUNSMRY" :
+                                          source.file_type() == FileType::LIVE ? "live case" : "ESMRY";
                 std::string message;
-                message = "Error loading " + vect_name + " from ESMRY " + m_ext_esmry_loader[smry_ind]->rootname();
+                message = "Error loading " + vect_name + " from " + file_format + " " + source.rootname();
                 throw std::runtime_error(message);
             }
 
-            smry_unit = m_ext_esmry_loader[smry_ind]->get_unit ( vect_name );
+            smry_unit = source.get_unit ( vect_name );
         }
 
         if (!hasVect)
@@ -427,27 +558,16 @@ bool SmryAppl::add_new_series ( int chart_ind, int smry_ind, std::string vect_na
     }
 
     std::chrono::system_clock::time_point startd; // = esmry_list[smry_ind]->startdate();
-    std::vector<int> start_vect;
 
     QDate d1;
     QTime tm1;
 
     if (smry_ind < 0){
         startd = m_derived_smry->startdate();
-    } else if (m_file_type[smry_ind] == FileType::SMSPEC){
-        startd = m_esmry_loader[smry_ind]->startdate();
-        start_vect = m_esmry_loader[smry_ind]->start_v();
-
-        int sec = start_vect[5] / 1000000;
-        int millisec = (start_vect[5] % 1000000) / 1000;
-
-        d1.setDate(start_vect[2], start_vect[1], start_vect[0]);
-        tm1.setHMS(start_vect[3], start_vect[4], sec, millisec);
-
-    } else if (m_file_type[smry_ind] == FileType::ESMRY){
+    } else {
+        startd = m_sources[smry_ind]->startdate();
+        auto start_vect = m_sources[smry_ind]->start_date();
 
-        startd = m_ext_esmry_loader[smry_ind]->startdate();
-        start_vect = m_ext_esmry_loader[smry_ind]->start_v();
         d1.setDate(start_vect[2], start_vect[1], start_vect[0]);
         tm1.setHMS(start_vect[3], start_vect[4], start_vect[5], start_vect[6]);
     }
@@ -467,7 +587,17 @@ bool SmryAppl::add_new_series ( int chart_ind, int smry_ind, std::string vect_na
     AxisMultiplierType mult_type;
     float multiplier = 1.0;
 
-    float val_p90 = calc_p90 ( datav );
+    // P90 from stats cache, computed once for each vector in summary files
+
+    const SmryStats* vect_stats = nullptr;
+    float val_p90;
+
+    if ( is_derived ) {
+        val_p90 = make_smry_stats ( datav ).p90;
+    } else {
+        vect_stats = &m_stats.get ( smry_ind, vect_name, datav );
+        val_p90 = vect_stats->p90;
+    }
 
     if ( val_p90 > 1.0e9 ) {
         mult_type = AxisMultiplierType::billion;
@@ -574,6 +704,16 @@ bool SmryAppl::add_new_series ( int chart_ind, int smry_ind, std::string vect_na
 
     series[chart_ind].back()->setObjectName ( QString::fromStdString ( objName ) );
 
+    // extent of the full vector, series may hold a time window or report steps only
+
+    const float full_t0 = timev.front();
+    const float full_t1 = timev.back();
+
+    bool rstep = this->has_report_steps ( chart_ind, smry_ind );
+
+    if ( rstep )
+        keep_report_steps ( *m_sources[smry_ind], timev, datav );
+
     size_t n0 = 0;
     size_t n1 = datav.size() - 1;
 
@@ -588,12 +728,7 @@ bool SmryAppl::add_new_series ( int chart_ind, int smry_ind, std::string vect_na
 
         if ( has_smry_vect(smry_ind, wbhp_name ) ) {
 
-            std::vector<float> wbhp;
-
-            if (m_file_type[smry_ind] == FileType::SMSPEC)
-                wbhp = m_esmry_loader[smry_ind]->get ( wbhp_name );
-            else if (m_file_type[smry_ind] == FileType::ESMRY)
-                wbhp = m_ext_esmry_loader[smry_ind]->get ( wbhp_name );
+            SmrySpan wbhp = m_sources[smry_ind]->get_span ( wbhp_name );
 
             while ( ( n0 < wbhp.size() ) && ( wbhp[n0] == 0.0 ) )
                 n0++;
@@ -606,48 +741,60 @@ bool SmryAppl::add_new_series ( int chart_ind, int smry_ind, std::string vect_na
     if ( n0 == timev.size() )
         n0 = 0;
 
-    std::string time_unit;
+    std::string time_unit = m_sources[smry_ind]->get_unit ( "TIME" );
 
-    if (m_file_type[smry_ind] == FileType::SMSPEC)
-        time_unit = m_esmry_loader[smry_ind]->get_unit ( "TIME" );
-    else if (m_file_type[smry_ind] == FileType::ESMRY)
-        time_unit = m_ext_esmry_loader[smry_ind]->get_unit ( "TIME" );
+    double time_fact;
 
-    for ( size_t n = n0; n <  n1 + 1; n++ ) {
+    if (time_unit.find("DAYS") != std::string::npos)
+        time_fact = 24.0 * 3600.0 * 1000.0;
+    else if (time_unit == "HOURS")
+        time_fact = 3600.0 * 1000.0;
+    else {
+        std::cout << "unknown time vector unit |" << time_unit << "| \n\n";
+        exit(1);
+    }
 
-        if (!isnan(datav[n])) {
+    const qint64 start_msec = dt_start_sim.toMSecsSinceEpoch();
 
-            double d_msec;
+    bool sliced = this->has_time_window ( chart_ind, smry_ind );
 
-            if (time_unit.find("DAYS") != std::string::npos)
-                d_msec = static_cast<double>(timev[n])* 24.0 * 3600.0 * 1000.0;
-            else if (time_unit == "HOURS")
-                d_msec = static_cast<double>(timev[n])* 3600.0 * 1000.0;
-            else {
-                std::cout << "unknown time vector unit |" << time_unit << "| \n\n";
-                exit(1);
-            }
+    if ( sliced )
+        window_steps ( timev, start_msec, time_fact, m_time_window[chart_ind], n0, n1 );
 
-            d_msec = round(d_msec);
+    std::vector<int64_t> time_ms;
+    std::vector<double> values;
 
-            QDateTime dtime = dt_start_sim;
-            QTimeZone  tz(0);
+    time_ms.reserve ( n1 - n0 + 1 );
+    values.reserve ( n1 - n0 + 1 );
 
-            dtime.setTimeZone(tz);      // improves runtime significantly
+    for ( size_t n = n0; n <  n1 + 1; n++ ) {
 
-            dtime = dtime.addMSecs(static_cast<qint64>(d_msec));
+        if (!isnan(datav[n])) {
 
-            //QString dt1_qstr = dtime.toString("yyyy-MM-dd HH:mm:ss.zzz");
-            //std::cout << "serie data time : " << dt1_qstr.toStdString() << std::endl;
+            double d_msec = round(static_cast<double>(timev[n]) * time_fact);
 
-            series[chart_ind].back()->append ( dtime.toMSecsSinceEpoch(), datav[n] * multiplier );
+            time_ms.push_back ( start_msec + static_cast<qint64>(d_msec) );
+            values.push_back ( datav[n] * multiplier );
         }
     }
 
+    // series with all values of the vector use the cached stats, no pass over the values
+
+    bool full_vector = ( vect_stats != nullptr ) && ( !vect_stats->has_nan ) && ( !sliced ) && ( !rstep ) &&
+                       ( n0 == 0 ) && ( values.size() == datav.size() );
+
+    if ( full_vector )
+        series[chart_ind].back()->set_data ( std::move(time_ms), std::move(values), *vect_stats, multiplier );
+    else
+        series[chart_ind].back()->set_data ( std::move(time_ms), std::move(values) );
+
+    if ( sliced || rstep )
+        series[chart_ind].back()->set_time_extent ( start_msec + round ( full_t0 * time_fact ),
+                                                    start_msec + round ( full_t1 * time_fact ) );
+
     // ->  4.0e-3
 
     series[chart_ind].back()->setPointsVisible ( false );
-    series[chart_ind].back()->calcMinAndMax();
 
     // ->  4.7e-3
 
@@ -666,10 +813,9 @@ bool SmryAppl::add_new_series ( int chart_ind, int smry_ind, std::string vect_na
 
         axisX[chart_ind] = new SmryXaxis(chart_view_list[chart_ind]);
 
-        auto vect_x1 = series[chart_ind].back()->points();
-        //axisX[chart_ind]->set_min_value ( vect_x1[0].x() );
-
         chartList[chart_ind]->addAxis ( axisX[chart_ind], Qt::AlignBottom );
+
+        connect ( axisX[chart_ind], &QDateTimeAxis::rangeChanged, this, &SmryAppl::xaxis_range_changed );
     }
 
     // ->  5.2e-3
@@ -682,10 +828,12 @@ bool SmryAppl::add_new_series ( int chart_ind, int smry_ind, std::string vect_na
 
     yaxis_map[series[chart_ind].back()] = axisY[chart_ind][yaxsis_ind];
 
-    this->update_xaxis_range ( axisX[chart_ind] );
-    this->update_axis_range ( axisY[chart_ind][yaxsis_ind] );
+    if ( m_update_depth == 0 ) {
+        this->update_xaxis_range ( axisX[chart_ind] );
+        this->update_axis_range ( axisY[chart_ind][yaxsis_ind] );
 
-    this->update_chart_title_and_legend ( chart_ind );
+        this->update_chart_title_and_legend ( chart_ind );
+    }
 
     // Click to highlight, legend tooltip and legend reflecting series style
     QLegend* legend = chartList[chart_ind]->legend();
@@ -719,10 +867,19 @@ bool SmryAppl::add_new_series ( int chart_ind, int smry_ind, std::string vect_na
         marker->setShape(QLegend::MarkerShapeFromSeries);
     }
 
-    // tskille: need something here to repaint the chart view.
-    // this is not a good fix, but works for now
-    // this is causing an segmentation fault when used with delete series
-    chart_view_list[chart_ind]->update_graphics();
+    if ( m_update_depth > 0 ) {
+
+        m_pending_update.insert ( chart_ind );
+
+    } else {
+
+        this->update_render_mode ( chart_ind );
+
+        // tskille: need something here to repaint the chart view.
+        // this is not a good fix, but works for now
+        // this is causing an segmentation fault when used with delete series
+        chart_view_list[chart_ind]->update_graphics();
+    }
 
 
     std::string lbl_str = std::to_string ( chart_ind + 1 ) + "/" + std::to_string ( chartList.size() );
@@ -733,199 +890,525 @@ bool SmryAppl::add_new_series ( int chart_ind, int smry_ind, std::string vect_na
 
 
 
-bool SmryAppl::add_new_ens_series ( int chart_ind, std::string vect_name, int vaxis_ind )
+qint64 SmryAppl::start_date_msec ( int smry_ind )
 {
-    auto start_open_add_series = std::chrono::system_clock::now();
+    auto start_vect = m_sources[smry_ind]->start_date();
 
-    size_t nthreads = omp_get_max_threads();
+    QDate d1;
+    QTime tm1;
 
-    std::cout << "\nNumber of threads: " << nthreads;
+    d1.setDate(start_vect[2], start_vect[1], start_vect[0]);
+    tm1.setHMS(start_vect[3], start_vect[4], start_vect[5], start_vect[6]);
 
-    omp_set_num_threads(nthreads);
+    QTimeZone  tz(0);
+    QDateTime dt_start_sim(d1, tm1, tz);
 
-    double before_loading = 0.0;
+    return dt_start_sim.toMSecsSinceEpoch();
+}
+
+bool SmryAppl::full_series_only ( int chart_ind, int smry_ind )
+{
+    // series from derived summary and live cases hold all time steps, new time
+    // steps from live cases are appended to the full series. Ensemble charts are
+    // not sliced
+
+    if ( ( smry_ind < 0 ) || ( is_ensemble_chart ( chart_ind ) ) )
+        return true;
+
+    return m_sources[smry_ind]->file_type() == FileType::LIVE;
+}
+
+bool SmryAppl::has_time_window ( int chart_ind, int smry_ind )
+{
+    return ( m_time_window[chart_ind] != full_time_window ) && ( !full_series_only ( chart_ind, smry_ind ) );
+}
+
+bool SmryAppl::has_report_steps ( int chart_ind, int smry_ind )
+{
+    return m_report_steps[chart_ind] && ( !full_series_only ( chart_ind, smry_ind ) );
+}
+
+void SmryAppl::set_time_window ( int chart_ind, qint64 from, qint64 to )
+{
+    // one window width added on each side, panning and moderate zoom out
+    // stays within converted data
+
+    qint64 width = to - from;
+
+    m_time_window[chart_ind] = { from - width, to + width };
+
+    this->rebuild_series_data ( chart_ind );
+}
+
+void SmryAppl::set_report_steps ( int chart_ind, bool value )
+{
+    if ( m_report_steps[chart_ind] == value )
+        return;
+
+    m_report_steps[chart_ind] = value;
+
+    if ( !is_ensemble_chart ( chart_ind ) ) {
+        this->rebuild_series_data ( chart_ind );
+        return;
+    }
+
+    // ensemble rebuilt, members sampled on the new time steps
+
+    std::vector<std::vector<QDateTime>> xrange_state ( chartList.size() );
+    xrange_state[chart_ind] = axisX[chart_ind]->get_xrange_state();
+
+    std::string vect_name = m_ens_vect[chart_ind];
+    std::vector<int> members = m_ens_members[chart_ind];
+
+    int current_chart_ind = this->chart_ind;
+    this->chart_ind = chart_ind;
+
+    this->delete_ens_series ( chart_ind );
+    this->add_new_ens_series ( chart_ind, vect_name, -1, members );
+
+    if ( series[chart_ind].size() > 0 )
+        this->reset_axis_state ( chart_ind, xrange_state );
+
+    this->chart_ind = current_chart_ind;
+}
 
-    for (size_t n = 0; n < m_file_type.size(); n++){
-        if (m_file_type[n] == FileType::SMSPEC){
-            auto elapsed = m_esmry_loader[n]->get_io_elapsed();
-            before_loading += std::get<1>(elapsed);
-        } else if (m_file_type[n] == FileType::ESMRY){
-            auto elapsed = m_ext_esmry_loader[n]->get_io_elapsed();
-            before_loading += std::get<1>(elapsed);
+void SmryAppl::set_report_steps ( bool value )
+{
+    m_report_steps_default = value;
+
+    for ( size_t c = 0; c < chartList.size(); c++ )
+        this->set_report_steps ( c, value );
+}
+
+void SmryAppl::rebuild_series_data ( int chart_ind )
+{
+    // series data converted again from the loaded vectors, for the
+    // current time window and report step mode of the chart
+
+    if ( is_ensemble_chart ( chart_ind ) || ( series[chart_ind].size() == 0 ) )
+        return;
+
+    m_window_update = true;
+
+    for ( size_t e = 0; e < series[chart_ind].size(); e++ ) {
+
+        const SeriesEntry& entry = charts_list[chart_ind][e];
+
+        int smry_ind = std::get<0> ( entry );
+        const std::string& vect_name = std::get<1> ( entry );
+        bool is_derived = std::get<5> ( entry );
+
+        if ( full_series_only ( chart_ind, smry_ind ) )
+            continue;
+
+        const SummarySource& source = *m_sources[smry_ind];
+
+        if ( ( !is_derived ) && ( !source.has_key ( vect_name ) ) )
+            continue;
+
+        // loaded vectors used in place, only the window is converted
+
+        SmrySpan timev = source.get_span ( "TIME" );
+        SmrySpan datav;
+
+        if ( is_derived ) {
+            const std::vector<float>& derived = m_derived_smry->get ( smry_ind, vect_name );
+            datav = SmrySpan { derived.data(), derived.size() };
+        } else {
+            datav = source.get_span ( vect_name );
+        }
+
+        if ( ( timev.size == 0 ) || ( datav.size != timev.size ) )
+            continue;
+
+        const float full_t0 = timev[0];
+        const float full_t1 = timev[timev.size - 1];
+
+        bool rstep = m_report_steps[chart_ind];
+
+        std::vector<float> rstep_time;
+        std::vector<float> rstep_data;
+
+        if ( ( rstep ) && ( report_step_values ( source, timev, datav, rstep_time, rstep_data ) ) ) {
+            timev = SmrySpan { rstep_time.data(), rstep_time.size() };
+            datav = SmrySpan { rstep_data.data(), rstep_data.size() };
+        }
+
+        double time_fact = ( source.get_unit ( "TIME" ) == "HOURS" ) ? 3600.0 * 1000.0 : 24.0 * 3600.0 * 1000.0;
+        const qint64 start_msec = start_date_msec ( smry_ind );
+        double multiplier = yaxis_map[series[chart_ind][e]]->multiplier();
+
+        size_t n0 = 0;
+        size_t n1 = timev.size - 1;
+
+        window_steps ( timev, start_msec, time_fact, m_time_window[chart_ind], n0, n1 );
+
+        std::vector<int64_t> time_ms;
+        std::vector<double> values;
+
+        time_ms.reserve ( n1 - n0 + 1 );
+        values.reserve ( n1 - n0 + 1 );
+
+        for ( size_t n = n0; n < n1 + 1; n++ ) {
+
+            if (!isnan(datav[n])) {
+                time_ms.push_back ( start_msec + static_cast<int64_t> ( round ( timev[n] * time_fact ) ) );
+                values.push_back ( datav[n] * multiplier );
+            }
         }
+
+        series[chart_ind][e]->set_data ( std::move ( time_ms ), std::move ( values ) );
+
+        if ( rstep || ( m_time_window[chart_ind] != full_time_window ) )
+            series[chart_ind][e]->set_time_extent ( start_msec + round ( full_t0 * time_fact ),
+                                                    start_msec + round ( full_t1 * time_fact ) );
     }
 
+    m_window_update = false;
+
+    this->update_render_mode ( chart_ind );
+    chart_view_list[chart_ind]->update_graphics();
+}
+
+void SmryAppl::xaxis_range_changed ( QDateTime min, QDateTime max )
+{
+    // zoom or pan out of the time window, data for the new visible range is
+    // converted from the loaded vectors
+
+    if ( m_window_update )
+        return;
+
+    auto it = std::find ( axisX.begin(), axisX.end(), sender() );
+
+    if ( it == axisX.end() )
+        return;
+
+    int c = static_cast<int> ( it - axisX.begin() );
+
+    if ( m_time_window[c] == full_time_window )
+        return;
+
+    qint64 from = min.toMSecsSinceEpoch();
+    qint64 to = max.toMSecsSinceEpoch();
 
-    size_t num_files = m_file_type.size();
+    if ( ( from >= m_time_window[c].first ) && ( to <= m_time_window[c].second ) )
+        return;
 
-    std::vector<std::vector<float>> datav;
-    std::vector<std::vector<float>> timev;
+    this->set_time_window ( c, from, to );
+}
+
+
+bool SmryAppl::add_new_ens_series ( int chart_ind, std::string vect_name, int vaxis_ind, std::vector<int> members )
+{
+    auto start_open_add_series = std::chrono::system_clock::now();
 
-    for (size_t n = 0; n < num_files; n++){
-        datav.push_back({});
-        timev.push_back({});
+    if ( members.size() == 0 ) {
+        members.resize ( m_file_type.size() );
+        std::iota ( members.begin(), members.end(), 0 );
     }
 
-    auto start_loading = std::chrono::system_clock::now();
+    // one ensemble in each chart
+
+    if ( ( series[chart_ind].size() > 0 ) || ( ens_series[chart_ind].size() > 0 ) ) {
+        std::cout << "\n!Warning, chart " << chart_ind + 1 << " not empty, ensemble " << vect_name << " not added \n";
+        return false;
+    }
+
+    double before_loading = 0.0;
+
+    for (auto& source : m_sources)
+        before_loading += std::get<1>(source->io_elapsed());
+
+    size_t num_members = members.size();
+
+    std::vector<qint64> start_msec ( num_members );
+
+    for ( size_t m = 0; m < num_members; m++ )
+        start_msec[m] = start_date_msec ( members[m] );
+
+    std::vector<std::vector<int64_t>> time_ms ( num_members );
+    std::vector<std::vector<double>> values ( num_members );
+    std::vector<std::string> units ( num_members );
+    std::vector<char> found ( num_members, 0 );
 
-    #pragma omp parallel for
-    for (size_t ind = 0; ind < m_file_type.size(); ind ++){
-        if (m_file_type[ind] == FileType::SMSPEC){
-            timev[ind] = m_esmry_loader[ind]->get("TIME");
-            datav[ind] = m_esmry_loader[ind]->get ( vect_name );
-        } else if (m_file_type[ind] == FileType::ESMRY) {
-            timev[ind] = m_ext_esmry_loader[ind]->get("TIME");
-            datav[ind] = m_ext_esmry_loader[ind]->get ( vect_name );
+    // members loaded and time converted in parallel, one loader for each member
+
+    #pragma omp parallel for schedule(dynamic)
+    for ( size_t m = 0; m < num_members; m++ ) {
+
+        int ind = members[m];
+
+        const SummarySource& source = *m_sources[ind];
+
+        if ( !source.has_key ( vect_name ) )
+            continue;
+
+        SmrySpan timev = source.get_span ( "TIME" );
+        SmrySpan datav = source.get_span ( vect_name );
+        std::string time_unit = source.get_unit ( "TIME" );
+        units[m] = source.get_unit ( vect_name );
+
+        double time_fact = ( time_unit == "HOURS" ) ? 3600.0 * 1000.0 : 24.0 * 3600.0 * 1000.0;
+
+        // members sampled at report steps in report step mode
+
+        std::vector<size_t> steps;
+
+        if ( m_report_steps[chart_ind] )
+            steps = source.report_step_index();
+
+        if ( steps.size() == 0 ) {
+            steps.resize ( datav.size() );
+            std::iota ( steps.begin(), steps.end(), 0 );
         }
+
+        time_ms[m].reserve ( steps.size() );
+        values[m].reserve ( steps.size() );
+
+        for ( auto n : steps ) {
+            if ( !std::isnan ( datav[n] ) ) {
+                time_ms[m].push_back ( start_msec[m] + static_cast<int64_t> ( std::round ( timev[n] * time_fact ) ) );
+                values[m].push_back ( datav[n] );
+            }
+        }
+
+        found[m] = 1;
     }
 
-    auto end_loading = std::chrono::system_clock::now();
+    std::vector<int> ens_members;
 
-    std::chrono::duration<double> elapsed_loading = end_loading-start_loading;
+    for ( size_t m = 0; m < num_members; m++ )
+        if ( found[m] )
+            ens_members.push_back ( m );
 
-    std::cout << " , elapsed loading: " <<  elapsed_loading.count() << std::endl;
+    if ( ens_members.size() == 0 ) {
+        std::cout << "\n!Warning, vector " << vect_name << " not found in any of the ensemble members \n";
+        return false;
+    }
 
-    std::string smry_unit;
+    if ( ens_members.size() < num_members )
+        std::cout << "\n!Warning, vector " << vect_name << " not found in " << num_members - ens_members.size()
+                  << " of " << num_members << " ensemble members \n";
+
+    m_ens_data[chart_ind] = std::make_shared<EnsembleData>();
+
+    EnsembleData& ens_data = *m_ens_data[chart_ind];
+
+    ens_data.resize ( ens_members.size() );
+
+    for ( size_t n = 0; n < ens_members.size(); n++ )
+        ens_data.set_member ( n, std::move ( time_ms[ens_members[n]] ), std::move ( values[ens_members[n]] ) );
+
+    ens_data.make_time_grid();
 
-    if (m_file_type[0] == FileType::SMSPEC)
-        smry_unit = m_esmry_loader[0]->get_unit ( vect_name );
+    // min, P10, P50, P90 and max on time grid
+    const std::vector<double> p_list = { 0.0, 10.0, 50.0, 90.0, 100.0 };
+    const std::vector<std::string> p_names = { "min", "P10", "P50", "P90", "max" };
 
-    else if (m_file_type[smry_ind] == FileType::ESMRY)
-        smry_unit = m_ext_esmry_loader[0]->get_unit ( vect_name );
+    auto p_values = ens_data.percentiles ( p_list );
+
+    std::string smry_unit = units[ens_members[0]];
 
     if ( vect_name == "TCPU" )
         smry_unit = "SECONDS";
 
-    size_t yaxsis_ind = 0;
+    if ( smry_unit.size() > 0 ) {
+        auto p1 = smry_unit.find_first_not_of ( " " );
+        smry_unit = ( p1 == std::string::npos ) ? "" : smry_unit.substr ( p1 );
+    }
+
+    std::vector<float> p50_values;
+
+    for ( auto v : p_values[2] )
+        if ( !std::isnan ( v ) )
+            p50_values.push_back ( v );
+
+    AxisMultiplierType mult_type = AxisMultiplierType::one;
+    float multiplier = 1.0;
+
+    float val_p90 = make_smry_stats ( p50_values ).p90;
 
-    axisY[chart_ind].push_back ( new SmryYaxis ( AxisMultiplierType::one, 1.0 ) );
+    if ( val_p90 > 1.0e9 ) {
+        mult_type = AxisMultiplierType::billion;
+        multiplier = 1e-9;
+    } else if ( val_p90 > 1.0e6 ) {
+        mult_type = AxisMultiplierType::million;
+        multiplier = 1e-6;
+    } else if ( val_p90 > 1.0e3 ) {
+        mult_type = AxisMultiplierType::thousand;
+        multiplier = 1e-3;
+    }
 
-    chartList[chart_ind]->addAxis ( axisY[chart_ind][yaxsis_ind], Qt::AlignLeft );
+    m_ens_vect[chart_ind] = vect_name;
+    m_ens_members[chart_ind].clear();
 
-    axisY[chart_ind][yaxsis_ind]->add_title ( smry_unit );
-    axisY[chart_ind][yaxsis_ind]->view_title();
+    for ( auto m : ens_members )
+        m_ens_members[chart_ind].push_back ( members[m] );
 
-    axisX[chart_ind] = new SmryXaxis(chart_view_list[chart_ind]);
+    yaxis_units[chart_ind].push_back ( smry_unit );
+    num_yaxis[chart_ind]++;
 
-    chartList[chart_ind]->addAxis ( axisX[chart_ind], Qt::AlignBottom );
+    axisY[chart_ind].push_back ( new SmryYaxis ( mult_type, multiplier ) );
 
-    float minValue = std::numeric_limits<float>::max();
-    float maxValue = std::numeric_limits<float>::min();
+    SmryYaxis* y_axis = axisY[chart_ind].back();
 
-    std::vector<float>::const_iterator it;
+    chartList[chart_ind]->addAxis ( y_axis, Qt::AlignLeft );
 
-    for (size_t ind = 0; ind < m_file_type.size(); ind ++){
-        it = std::max_element(datav[ind].begin(), datav[ind].end());
-        maxValue = std::max(maxValue, *it);
+    if ( axisX[chart_ind] == nullptr ) {
 
-        it = std::min_element(datav[ind].begin(), datav[ind].end());
-        minValue = std::min(minValue, *it);
+        axisX[chart_ind] = new SmryXaxis(chart_view_list[chart_ind]);
+
+        chartList[chart_ind]->addAxis ( axisX[chart_ind], Qt::AlignBottom );
     }
 
-    for (size_t ind = 0; ind < m_file_type.size(); ind ++){
+    if ( m_ens_mode == EnsembleMode::lines ) {
 
-        std::chrono::system_clock::time_point startd;
-        std::vector<int> start_vect;
+        // member series, points for all members prepared in parallel and added in bulk
 
-        if (m_file_type[ind] == FileType::SMSPEC)
-            startd = m_esmry_loader[ind]->startdate();
-        else if (m_file_type[ind] == FileType::ESMRY){
-            startd = m_ext_esmry_loader[ind]->startdate();
-            start_vect = m_ext_esmry_loader[ind]->start_v();
-        }
+        std::vector<QList<QPointF>> member_points ( ens_data.number_of_members() );
 
-        for (auto& v : start_vect)
-            std::cout << v << std::endl;
+        #pragma omp parallel for schedule(dynamic)
+        for ( size_t n = 0; n < ens_data.number_of_members(); n++ ) {
 
-        exit(1);
+            const auto& time = ens_data.member ( n ).time();
+            const auto& data = ens_data.member ( n ).values();
 
-        std::chrono::milliseconds ms = std::chrono::duration_cast<std::chrono::milliseconds> ( startd.time_since_epoch() );
-        std::chrono::seconds s = std::chrono::duration_cast<std::chrono::seconds> ( ms );
+            member_points[n].reserve ( time.size() );
 
-        std::time_t t = s.count();
+            for ( size_t i = 0; i < time.size(); i++ )
+                member_points[n].append ( QPointF ( static_cast<qreal> ( time[i] ), data[i] * multiplier ) );
+        }
 
-        int fractional_seconds = ms.count() % 1000;
+        QPen member_pen;
+        member_pen.setColor ( QColor ( 160, 160, 160, 120 ) );
+        member_pen.setWidth ( 1 );
 
-        std::tm *ltm = localtime(&t);
-        //std::tm *ltm = gmtime ( &t );
+        for ( size_t n = 0; n < ens_data.number_of_members(); n++ ) {
 
-        QDate d1 {1900 + ltm->tm_year, 1 + ltm->tm_mon, ltm->tm_mday};
+            QLineSeries* member = new QLineSeries();
 
-        QTime tm1 { ltm->tm_hour, ltm->tm_min, ltm->tm_sec, fractional_seconds };
-        QDateTime dt_start_sim;
+            std::string objName = root_name_list[m_ens_members[chart_ind][n]] + " " + vect_name;
+            member->setObjectName ( QString::fromStdString ( objName ) );
 
-        dt_start_sim.setDate ( d1 );
-        dt_start_sim.setTime ( tm1 );
+            member->replace ( member_points[n] );
+            member->setPointsVisible ( false );
+            member->setPen ( member_pen );
 
-        QTimeZone  tz(0);
+            chartList[chart_ind]->addSeries ( member );
 
-        dt_start_sim.setTimeZone(tz);
+            member->attachAxis ( axisX[chart_ind] );
+            member->attachAxis ( y_axis );
 
-        vectorEntry ve = make_vector_entry ( vect_name );
+            for ( auto marker : chartList[chart_ind]->legend()->markers ( member ) )
+                marker->setVisible ( false );
 
-        SeriesEntry serie_data = std::make_tuple ( ind, vect_name, ve, smry_unit, -1, false );
+            ens_series[chart_ind].push_back ( member );
+        }
 
-        charts_list[chart_ind].push_back ( serie_data );
+    } else {
 
-        ens_series[chart_ind].push_back ( new QLineSeries() );
+        // all members drawn as one item, band or density image
 
-        std::string objName = root_name_list[ind] + " " + vect_name;
-        ens_series[chart_ind].back()->setObjectName ( QString::fromStdString ( objName ) );
+        m_ens_band[chart_ind] = new EnsembleBand ( chartList[chart_ind], m_ens_data[chart_ind], m_ens_mode,
+                                                   multiplier, color_tab[0] );
 
-        size_t n1 = datav[ind].size() - 1;
+        m_ens_band[chart_ind]->set_axes ( axisX[chart_ind], y_axis );
+    }
 
-        QDateTime dtime = dt_start_sim;
-        double d_msec = static_cast<double>(timev[ind][0])* 24.0 * 3600.0 * 1000.0;
-        d_msec = round(d_msec);
+    // statistics as series in chart, used for axis ranges and legend
 
-        dtime = dtime.addMSecs(static_cast<qint64>(d_msec));
+    vectorEntry ve = make_vector_entry ( vect_name );
 
-        ens_series[chart_ind].back()->append ( dtime.toMSecsSinceEpoch(), datav[ind][0] );
+    const auto& time_grid = ens_data.time_grid();
 
-        for ( size_t n = 1; n <  n1 + 1; n++ ) {
+    for ( size_t p = 0; p < p_list.size(); p++ ) {
 
-            double d_msec = static_cast<double>(timev[ind][n] - timev[ind][n-1])* 24.0 * 3600.0 * 1000.0;
-            d_msec = round(d_msec);
+        std::vector<int64_t> p_time;
+        std::vector<double> p_data;
 
-            dtime = dtime.addMSecs(static_cast<qint64>(d_msec));
+        p_time.reserve ( time_grid.size() );
+        p_data.reserve ( time_grid.size() );
 
-            ens_series[chart_ind].back()->append ( dtime.toMSecsSinceEpoch(), datav[ind][n] );
+        for ( size_t t = 0; t < time_grid.size(); t++ ) {
+            if ( !std::isnan ( p_values[p][t] ) ) {
+                p_time.push_back ( time_grid[t] );
+                p_data.push_back ( p_values[p][t] * multiplier );
+            }
         }
 
-        ens_series[chart_ind].back()->setPointsVisible ( false );
+        SeriesEntry serie_data = std::make_tuple ( members[ens_members[0]], vect_name, ve, smry_unit, vaxis_ind, false );
+        charts_list[chart_ind].push_back ( serie_data );
+
+        series[chart_ind].push_back ( new SmrySeries(chartList[chart_ind]) );
 
-        chartList[chart_ind]->addSeries (ens_series[chart_ind].back() );
+        SmrySeries* stat_series = series[chart_ind].back();
 
-        ens_series[chart_ind].back()->attachAxis ( axisY[chart_ind][yaxsis_ind] );
-        ens_series[chart_ind].back()->attachAxis ( axisX[chart_ind] );
+        stat_series->setObjectName ( QString::fromStdString ( p_names[p] + " " + vect_name ) );
+        stat_series->setName ( QString::fromStdString ( p_names[p] ) );
+        stat_series->set_data ( std::move ( p_time ), std::move ( p_data ) );
+        stat_series->setPointsVisible ( false );
+
+        chartList[chart_ind]->addSeries ( stat_series );
 
         QPen pen;
-        pen.setColor (  QColor ( "gray" ) );
-        pen.setWidth ( linew );
-        pen.setStyle ( style_tab[1] );
-        ens_series[chart_ind].back()->setPen ( pen );
 
+        if ( p_names[p] == "P50" ) {
+            pen.setColor ( color_tab[0] );
+            pen.setWidth ( linew + 1 );
+        } else if ( ( p_names[p] == "P10" ) || ( p_names[p] == "P90" ) ) {
+            pen.setColor ( color_tab[1] );
+            pen.setWidth ( linew );
+        } else {
+            // solid, other pen styles not supported with OpenGL
+            pen.setColor ( QColor ( 90, 90, 90 ) );
+            pen.setWidth ( linew );
+        }
+
+        stat_series->setPen ( pen );
+
+        stat_series->attachAxis ( axisX[chart_ind] );
+        stat_series->attachAxis ( y_axis );
+
+        yaxis_map[stat_series] = y_axis;
+
+        // one title for each series, removed one by one in delete_last_series
+        y_axis->add_title ( smry_unit );
     }
 
-    chartList[chart_ind]->legend()->hide();
-    chartList[chart_ind]->setTitle ( QString::fromStdString ( vect_name ) );
+    y_axis->view_title();
 
-    double after_loading = 0.0;
+    if ( m_update_depth > 0 ) {
 
-    for (size_t n = 0; n < m_file_type.size(); n++){
-        if (m_file_type[n] == FileType::SMSPEC){
-            auto elapsed = m_esmry_loader[n]->get_io_elapsed();
-            after_loading += std::get<1>(elapsed);
-        } else if (m_file_type[n] == FileType::ESMRY){
-            auto elapsed = m_ext_esmry_loader[n]->get_io_elapsed();
-            after_loading += std::get<1>(elapsed);
-        }
+        m_pending_update.insert ( chart_ind );
+
+    } else {
+
+        int current_chart_ind = this->chart_ind;
+        this->chart_ind = chart_ind;
+
+        update_full_xrange ( chart_ind );
+        this->update_axis_range ( y_axis );
+
+        auto min_max_range = axisX[chart_ind]->get_xrange();
+        update_all_yaxis ( min_max_range, chart_ind );
+
+        this->chart_ind = current_chart_ind;
+
+        this->update_chart_title_and_legend ( chart_ind );
+        this->update_render_mode ( chart_ind );
+
+        chart_view_list[chart_ind]->update_graphics();
     }
 
+    double after_loading = 0.0;
+
+    for (auto& source : m_sources)
+        after_loading += std::get<1>(source->io_elapsed());
+
     double total_loading = after_loading - before_loading;
     std::ostringstream ss;
 
-    ss << "I/O  loading: " << std::fixed << std::setprecision(5) << total_loading << " sec\n";
+    ss << "I/O  loading: " << std::fixed << std::setprecision(5) << total_loading << " sec";
 
     std::cout << ss.str() << std::endl;
 
@@ -933,12 +1416,42 @@ bool SmryAppl::add_new_ens_series ( int chart_ind, std::string vect_name, int va
 
     std::chrono::duration<double> elapsed_seconds = end_open_add_series-start_open_add_series;
 
-    std::cout << "\n -> duration adding ensemble series " <<  elapsed_seconds.count() << std::endl;
+    std::cout << " -> duration adding ensemble " << vect_name << " (" << ens_members.size() << " members) ";
+    std::cout << elapsed_seconds.count() << std::endl;
 
     return true;
 }
 
 
+void SmryAppl::delete_ens_series ( int chart_ind )
+{
+    // members first, the axes are deleted with the last statistics series
+
+    for ( auto member : ens_series[chart_ind] ) {
+        chartList[chart_ind]->removeSeries ( member );
+        delete member;
+    }
+
+    ens_series[chart_ind].clear();
+
+    delete m_ens_band[chart_ind];
+    m_ens_band[chart_ind] = nullptr;
+
+    int current_chart_ind = this->chart_ind;
+    this->chart_ind = chart_ind;
+
+    while ( series[chart_ind].size() > 0 )
+        this->delete_last_series();
+
+    this->chart_ind = current_chart_ind;
+
+    num_yaxis[chart_ind] = 0;
+
+    m_ens_vect[chart_ind].clear();
+    m_ens_members[chart_ind].clear();
+    m_ens_data[chart_ind] = nullptr;
+}
+
 SmryAppl::vectorEntry SmryAppl::make_vector_entry ( std::string vect_name )
 {
     SmryAppl::vectorEntry res;
@@ -1006,7 +1519,7 @@ void SmryAppl::update_chart_labels()
 {
     std::string lbl_str = std::to_string ( chart_ind + 1 );
 
-    if ( series.back().size() == 0 )
+    if ( ( series.back().size() == 0 ) && ( !is_lazy_pending ( chartList.size() - 1 ) ) )
         lbl_str = lbl_str + "/" + std::to_string ( chartList.size() - 1 );
     else
         lbl_str = lbl_str + "/" + std::to_string ( chartList.size() );
@@ -1029,15 +1542,16 @@ void SmryAppl::update_xaxis_range ( SmryXaxis* axis )
 
         if ( x_axis[0] == axis ) {
 
-            auto values = series[chart_ind][n]->points();
+            const auto& data = series[chart_ind][n]->data();
 
-            for ( size_t m = 0; m < values.size(); m++ ) {
-                if ( values[m].x() < min_val )
-                    min_val = values[m].x();
+            if ( data.empty() )
+                continue;
 
-                if ( values[m].x() > max_val )
-                    max_val = values[m].x();
-            }
+            if ( data.min_time() < min_val )
+                min_val = data.min_time();
+
+            if ( data.max_time() > max_val )
+                max_val = data.max_time();
         }
     }
 
@@ -1142,40 +1656,25 @@ void SmryAppl::adjust_yaxis_props(SmryYaxis* axis, double& min_data, double& max
 }
 
 
-template <typename T>
-bool SmryAppl::reopen_loader(int n, std::unique_ptr<T>& smry)
+void SmryAppl::update_keyword_index ( size_t smry_ind )
 {
-    std::unique_ptr<T> smry_tmp;
-
-    try {
-        smry_tmp = std::make_unique<T> ( m_smry_files[n] );
-    } catch (...) {
-        std::string message = "Error with reopen loader, failed when opening summary file " + m_smry_files[n].string();
-        throw std::runtime_error(message);
-    }
+    const SummarySource& source = *m_sources[smry_ind];
 
-    auto nstep_tmp = smry_tmp->numberOfTimeSteps();
-    auto nstep = smry->numberOfTimeSteps();
+    std::vector<std::string> keyw_list = source.keyword_list();
+    bool add_timestep = (!source.has_key("TIMESTEP")) && (source.all_steps_available());
 
-    auto ftime = std::filesystem::last_write_time ( m_smry_files[n] );
-    bool updated = false;
+    if (add_timestep)
+        keyw_list.push_back("TIMESTEP");
 
-    if ( ftime > file_stamp_vector[n] ){
-        smry = std::move ( smry_tmp );
-        updated = true;
-    } else if ( nstep_tmp > nstep ){
-        smry = std::move ( smry_tmp );
-        updated = true;
-    }
-
-    if (updated) {
-        auto ftime = std::filesystem::last_write_time ( m_smry_files[n] );
-        file_stamp_vector[n] = ftime;
-    }
-
-    vect_list.push_back ( smry->keywordList() );
+    if (smry_ind < m_catalogue.number_of_cases())
+        m_catalogue.update_case ( smry_ind, keyw_list );
+    else
+        m_catalogue.add_case ( keyw_list );
 
-    return updated;
+    // autocomplete range refers to the previous index
+    m_lookup_prefix.clear();
+    m_lookup_range = std::make_pair ( 0, 0 );
+    m_fuzzy_lookup.clear();
 }
 
 void SmryAppl::reset_axis_state(int chart_index, const std::vector<std::vector<QDateTime>>& xrange_state)
@@ -1214,7 +1713,6 @@ bool SmryAppl::reload_and_update_charts()
 {
     // check if some of the files are updated and re-load if this is the case
 
-    vect_list.clear();
     bool need_update = false;
     int n_smry = static_cast<int>(m_smry_files.size());
     std::vector<bool> updated_list;
@@ -1222,15 +1720,19 @@ bool SmryAppl::reload_and_update_charts()
 
     for (size_t n = 0; n < m_smry_files.size(); n++){
 
-        if (std::filesystem::exists(m_smry_files[n] )) {
+        // live cases have no file, reopen is true when a new header is received
+
+        if ((m_file_type[n] == FileType::LIVE) || (std::filesystem::exists(m_smry_files[n] ))) {
 
-            if (m_file_type[n] == FileType::SMSPEC)
-                updated_list[n] = reopen_loader( n, m_esmry_loader[n] );
-            else if (m_file_type[n] == FileType::ESMRY)
-                updated_list[n] = reopen_loader( n, m_ext_esmry_loader[n] );
+            updated_list[n] = m_sources[n]->reopen();
 
-            if (updated_list[n])
+            if (updated_list[n]) {
+                // cached cases switch between ESMRY cache and SMSPEC on reload
+                m_file_type[n] = m_sources[n]->file_type();
+                this->update_keyword_index ( n );
+                m_stats.invalidate ( n );
                 need_update = true;
+            }
 
         } else {
 
@@ -1243,40 +1745,55 @@ bool SmryAppl::reload_and_update_charts()
         return false;
 
     if (m_derived_smry != nullptr)
-        m_derived_smry->recalc(m_file_type, m_esmry_loader, m_ext_esmry_loader);
+        m_derived_smry->recalc(m_sources);
+
+    // only charts with series from updated cases are rebuilt. Charts in groups with NORELOAD and
+    // lazy charts not yet shown are left as is, derived series are rebuilt since these can
+    // depend on any case
+
+    int num_charts = chartList.size();
 
     std::vector<std::vector<std::tuple<int, std::string, int, bool>>> series_properties;
     std::vector<std::vector<QDateTime>> xrange_state;
+    std::vector<bool> update_chart;
 
-    for ( int ind = 0; ind < chartList.size(); ind++ )
-        if (charts_list[ind].size() > 0)
-            xrange_state.push_back(axisX[ind]->get_xrange_state());
+    series_properties.resize(num_charts);
+    xrange_state.resize(num_charts);
+    update_chart.resize(num_charts, false);
 
-    for ( int ind = 0; ind < chartList.size(); ind++ ) {
+    for ( int ind = 0; ind < num_charts; ind++ ) {
 
-        series_properties.push_back ( {} );
+        if ( ( charts_list[ind].size() == 0 ) || ( std::get<2> ( m_chart_props[ind] ) ) )
+            continue;
 
-        for ( size_t n = 0; n < charts_list[ind].size(); n++ ) {
+        // ensemble charts rebuilt from vector and members, statistics series not reloaded
 
-            std::tuple<int, std::string, int, bool> props;
-            props = std::make_tuple ( std::get<0> ( charts_list[ind][n] ), std::get<1> ( charts_list[ind][n] ),
-                                     std::get<4> ( charts_list[ind][n]), std::get<5> (charts_list[ind][n] ));
+        if ( is_ensemble_chart ( ind ) ) {
 
-            series_properties.back().push_back ( props );
+            for ( auto m : m_ens_members[ind] )
+                if ( updated_list[m] )
+                    update_chart[ind] = true;
+
+            if ( update_chart[ind] )
+                xrange_state[ind] = axisX[ind]->get_xrange_state();
+
+            continue;
         }
-    }
 
-    int current_chart_ind = chart_ind;
+        for ( size_t n = 0; n < charts_list[ind].size(); n++ ) {
 
-    // updating existing plots
+            std::tuple<int, std::string, int, bool> props;
+            props = std::make_tuple ( std::get<0> ( charts_list[ind][n] ), std::get<1> ( charts_list[ind][n] ),
+                                     std::get<4> ( charts_list[ind][n]), std::get<5> (charts_list[ind][n] ));
 
-    int num_charts = chartList.size();
+            if ( std::get<3> ( props ) || updated_list[std::get<0> ( props )] )
+                update_chart[ind] = true;
 
-    int n = num_charts - 1;
+            series_properties[ind].push_back ( props );
+        }
 
-    while (n > -1){
-        this->delete_chart(n);
-        n--;
+        if ( update_chart[ind] )
+            xrange_state[ind] = axisX[ind]->get_xrange_state();
     }
 
     // make_preload_list and load data if smry file is updated
@@ -1285,38 +1802,68 @@ bool SmryAppl::reload_and_update_charts()
         if (updated_list[n]) {
             std::vector<std::string> pre_load_list = {"TIME"};
 
-            for ( int c = 0; c < num_charts; c++ )
-                for ( size_t m = 0; m < series_properties[c].size(); m++ )
-                    if (std::get<0> ( series_properties[c][m] ) == n)
-                        if (!std::get<3> ( series_properties[c][m] ))
-                            pre_load_list.push_back(std::get<1> ( series_properties[c][m] ));
+            for ( int c = 0; c < num_charts; c++ ) {
+                if ( ( update_chart[c] ) && ( is_ensemble_chart ( c ) ) ) {
+                    if ( has_smry_vect ( n, m_ens_vect[c] ) )
+                        pre_load_list.push_back ( m_ens_vect[c] );
+                } else if ( update_chart[c] )
+                    for ( size_t m = 0; m < series_properties[c].size(); m++ )
+                        if (std::get<0> ( series_properties[c][m] ) == n)
+                            if (!std::get<3> ( series_properties[c][m] ))
+                                pre_load_list.push_back(std::get<1> ( series_properties[c][m] ));
+            }
 
-            if (m_file_type[n] == FileType::SMSPEC)
-                m_esmry_loader[n]->loadData(pre_load_list);
-            else if (m_file_type[n] == FileType::ESMRY)
-                m_ext_esmry_loader[n]->loadData(pre_load_list);
+            m_sources[n]->load(pre_load_list);
         }
     }
 
-    if (series_properties[num_charts - 1].size() == 0)
-        num_charts --;
+    int current_chart_ind = chart_ind;
 
     for ( int ind = 0; ind < num_charts; ind++ ) {
 
-        this->init_new_chart();
+        if ( !update_chart[ind] )
+            continue;
 
         chart_ind = ind;
 
-        for ( size_t m = 0; m < series_properties[ind].size(); m++ ) {
+        if ( is_ensemble_chart ( ind ) ) {
+
+            std::string vect_name = m_ens_vect[ind];
+            std::vector<int> members = m_ens_members[ind];
+
+            this->delete_ens_series ( ind );
+
+            {
+                UpdateScope update ( *this );
+                this->add_new_ens_series ( ind, vect_name, -1, members );
+            }
+
+            if ( series[ind].size() > 0 )
+                this->reset_axis_state(ind, xrange_state);
+
+            continue;
+        }
+
+        while ( series[ind].size() > 0 )
+            this->delete_last_series();
+
+        {
+            UpdateScope update ( *this );
+
+            for ( size_t m = 0; m < series_properties[ind].size(); m++ ) {
 
-            auto smry_ind = std::get<0> ( series_properties[ind][m] );
-            auto vect_name = std::get<1> ( series_properties[ind][m] );
-            auto vaxis_ind = std::get<2> ( series_properties[ind][m] );
-            auto is_derived = std::get<3> ( series_properties[ind][m] );
+                auto smry_ind = std::get<0> ( series_properties[ind][m] );
+                auto vect_name = std::get<1> ( series_properties[ind][m] );
+                auto vaxis_ind = std::get<2> ( series_properties[ind][m] );
+                auto is_derived = std::get<3> ( series_properties[ind][m] );
 
-            add_new_series ( ind, smry_ind, vect_name, vaxis_ind, is_derived);
+                add_new_series ( ind, smry_ind, vect_name, vaxis_ind, is_derived);
+            }
         }
 
+        if ( series[ind].size() == 0 )
+            continue;
+
         this->reset_axis_state(ind, xrange_state);
 
         auto min_max_range = axisX[ind]->get_xrange();
@@ -1327,6 +1874,8 @@ bool SmryAppl::reload_and_update_charts()
 
     stackedWidget->setCurrentIndex(chart_ind);
 
+    this->update_chart_labels();
+
     return true;
 }
 
@@ -1425,6 +1974,9 @@ void  SmryAppl::delete_chart ( int ind )
 {
     chart_ind = ind;
 
+    if ( is_ensemble_chart ( chart_ind ) )
+        this->delete_ens_series ( chart_ind );
+
     while ( series[chart_ind].size() > 0 )
         this->delete_last_series();
 
@@ -1433,11 +1985,23 @@ void  SmryAppl::delete_chart ( int ind )
     axisX.erase ( axisX.begin() + ind );
     axisY.erase ( axisY.begin() + ind );
     series.erase ( series.begin() + ind );
+    ens_series.erase ( ens_series.begin() + ind );
 
+    num_yaxis.erase ( num_yaxis.begin() + ind );
     yaxis_units.erase ( yaxis_units.begin() + ind );
 
+    m_ens_vect.erase ( m_ens_vect.begin() + ind );
+    m_ens_members.erase ( m_ens_members.begin() + ind );
+    m_ens_data.erase ( m_ens_data.begin() + ind );
+    m_ens_band.erase ( m_ens_band.begin() + ind );
+
     charts_list.erase ( charts_list.begin() + ind );
 
+    m_chart_props.erase ( m_chart_props.begin() + ind );
+    m_lazy_input.erase ( m_lazy_input.begin() + ind );
+    m_time_window.erase ( m_time_window.begin() + ind );
+    m_report_steps.erase ( m_report_steps.begin() + ind );
+
     stackedWidget->removeWidget(chart_view_list[chart_ind]);
 
     ChartView* p_chart_view = chart_view_list[chart_ind];
@@ -1455,6 +2019,19 @@ void  SmryAppl::delete_chart ( int ind )
 
 void SmryAppl::update_chart_title_and_legend ( int chart_ind )
 {
+    if ( is_ensemble_chart ( chart_ind ) ) {
+
+        // legend shows the statistics series, named when added
+
+        std::string title = m_ens_vect[chart_ind] + " (" + std::to_string ( m_ens_members[chart_ind].size() ) + " members)";
+
+        chartList[chart_ind]->setTitle ( QString::fromStdString ( title ) );
+        chartList[chart_ind]->legend()->show();
+        chartList[chart_ind]->legend()->setAlignment ( Qt::AlignBottom );
+
+        return;
+    }
+
     auto series_props = charts_list[chart_ind];
 
     std::set<int> smry_ind_set;
@@ -1486,10 +2063,8 @@ void SmryAppl::update_chart_title_and_legend ( int chart_ind )
 
         if (smry_index < 0)
             title = "Derives Smry";
-        else if (m_file_type[smry_index] == FileType::SMSPEC)
-            title = m_esmry_loader[smry_index]->rootname();
-        else if (m_file_type[smry_index] == FileType::ESMRY)
-            title = m_ext_esmry_loader[smry_index]->rootname();
+        else
+            title = m_sources[smry_index]->rootname();
 
         legende_rootn = false;
     }
@@ -1530,10 +2105,8 @@ void SmryAppl::update_chart_title_and_legend ( int chart_ind )
         if ( legende_rootn ) {
             if (smry_ind < 0)
                legende_string = "Derived";
-            else if (m_file_type[smry_ind] == FileType::SMSPEC)
-               legende_string = m_esmry_loader[smry_ind]->rootname();
-            else if (m_file_type[smry_ind] == FileType::ESMRY)
-               legende_string = m_ext_esmry_loader[smry_ind]->rootname();
+            else
+               legende_string = m_sources[smry_ind]->rootname();
 
         }
 
@@ -1543,33 +2116,167 @@ void SmryAppl::update_chart_title_and_legend ( int chart_ind )
             else
                 legende_string = legende_string + " - " + std::get<0> ( ve );
 
-        if ( legende_item1 )
-            if ( legende_string.size() == 0 )
-                legende_string = std::get<1> ( ve );
-            else
-                legende_string = legende_string + " - " + std::get<1> ( ve );
+        if ( legende_item1 )
+            if ( legende_string.size() == 0 )
+                legende_string = std::get<1> ( ve );
+            else
+                legende_string = legende_string + " - " + std::get<1> ( ve );
+
+        if ( legende_item2 )
+            if ( legende_string.size() == 0 )
+                legende_string = std::get<2> ( ve );
+            else
+                legende_string = legende_string + " - " + std::get<2> ( ve );
+
+        series[chart_ind][n]->setName ( QString::fromStdString ( legende_string ) );
+    }
+
+    while ( title.back() == ':' ) {
+        title = title.substr ( 0, title.size() - 1 );
+    }
+
+    chartList[chart_ind]->setTitle ( QString::fromStdString ( title ) );
+
+    if ( ( not legende_rootn ) and ( not legende_name ) and ( not legende_item1 ) and ( not legende_item2 ) ) {
+        chartList[chart_ind]->legend()->hide();
+    } else {
+        chartList[chart_ind]->legend()->show();
+        chartList[chart_ind]->legend()->setAlignment ( Qt::AlignBottom );
+    }
+}
+
+
+void SmryAppl::begin_update()
+{
+    m_update_depth++;
+}
+
+
+void SmryAppl::end_update()
+{
+    if ( m_update_depth == 0 )
+        throw std::runtime_error ( "end_update called without matching begin_update" );
+
+    m_update_depth--;
+
+    if ( m_update_depth > 0 )
+        return;
+
+    // update_axis_range works on member chart_ind
+
+    int current_chart_ind = chart_ind;
+
+    for ( auto c : m_pending_update ) {
+
+        if ( c >= static_cast<int> ( chartList.size() ) )
+            continue;
+
+        chart_ind = c;
+
+        for ( auto axis : axisY[c] )
+            this->update_axis_range ( axis );
+
+        this->update_chart_title_and_legend ( c );
+        this->update_render_mode ( c );
+
+        chart_view_list[c]->update_graphics();
+    }
+
+    chart_ind = current_chart_ind;
+
+    m_pending_update.clear();
+}
+
+SmryAppl::UpdateScope::~UpdateScope() noexcept(false)
+{
+    if ( std::uncaught_exceptions() > m_exceptions ) {
+
+        if ( --m_appl.m_update_depth == 0 )
+            m_appl.m_pending_update.clear();
+
+        return;
+    }
+
+    m_appl.end_update();
+}
+
+
+void SmryAppl::update_render_mode ( int chart_ind )
+{
+    // Qt Charts draws OpenGL series in an overlay widget, point labels and pen styles
+    // other than solid lines are not supported in this mode.
+
+    bool use_opengl = opengl_active ( chart_ind );
+
+    for ( auto s : series[chart_ind] )
+        if ( s->useOpenGL() != use_opengl )
+            s->setUseOpenGL ( use_opengl );
+
+    for ( auto s : ens_series[chart_ind] )
+        if ( s->useOpenGL() != use_opengl )
+            s->setUseOpenGL ( use_opengl );
+}
+
+
+bool SmryAppl::opengl_active ( int chart_ind )
+{
+    if ( m_render_mode == RenderMode::raster )
+        return false;
+
+    if ( m_render_mode == RenderMode::opengl )
+        return true;
+
+    if ( ens_series[chart_ind].size() > 0 )
+        return true;
+
+    size_t num_points = 0;
+
+    for ( auto s : series[chart_ind] )
+        num_points += s->count();
+
+    return num_points > opengl_point_limit;
+}
+
+
+void SmryAppl::set_ensemble_mode ( EnsembleMode mode )
+{
+    if ( mode == m_ens_mode )
+        return;
+
+    m_ens_mode = mode;
+
+    int current_chart_ind = chart_ind;
+
+    for ( size_t c = 0; c < chartList.size(); c++ ) {
+
+        if ( !is_ensemble_chart ( c ) )
+            continue;
+
+        std::vector<std::vector<QDateTime>> xrange_state ( chartList.size() );
+        xrange_state[c] = axisX[c]->get_xrange_state();
 
-        if ( legende_item2 )
-            if ( legende_string.size() == 0 )
-                legende_string = std::get<2> ( ve );
-            else
-                legende_string = legende_string + " - " + std::get<2> ( ve );
+        std::string vect_name = m_ens_vect[c];
+        std::vector<int> members = m_ens_members[c];
 
-        series[chart_ind][n]->setName ( QString::fromStdString ( legende_string ) );
-    }
+        chart_ind = c;
 
-    while ( title.back() == ':' ) {
-        title = title.substr ( 0, title.size() - 1 );
+        this->delete_ens_series ( c );
+        this->add_new_ens_series ( c, vect_name, -1, members );
+
+        if ( series[c].size() > 0 )
+            this->reset_axis_state ( c, xrange_state );
     }
 
-    chartList[chart_ind]->setTitle ( QString::fromStdString ( title ) );
+    chart_ind = current_chart_ind;
+}
 
-    if ( ( not legende_rootn ) and ( not legende_name ) and ( not legende_item1 ) and ( not legende_item2 ) ) {
-        chartList[chart_ind]->legend()->hide();
-    } else {
-        chartList[chart_ind]->legend()->show();
-        chartList[chart_ind]->legend()->setAlignment ( Qt::AlignBottom );
-    }
+
+void SmryAppl::set_render_mode ( RenderMode mode )
+{
+    m_render_mode = mode;
+
+    for ( size_t c = 0; c < chartList.size(); c++ )
+        this->update_render_mode ( c );
 }
 
 
@@ -1625,32 +2332,13 @@ std::vector<std::string> SmryAppl::get_item_list(std::string filt, const std::ve
                                     const std::vector<int>& id_list)
 {
     std::vector<std::string> item_list;
-    std::vector<std::string>::iterator it;
+    std::set<std::string> item_set;
 
     for ( size_t n = 0; n < id_list.size(); n ++ ) {
 
-        std::vector<std::string> wlist;
-        int case_ind = id_list[n];
-
-        switch (m_file_type[case_ind]) {
-        case FileType::SMSPEC:
-            wlist = m_esmry_loader[case_ind]->keywordList ( vect_name_list[n] + ":" + filt );
-            break;
-        case FileType::ESMRY:
-            wlist = m_ext_esmry_loader[case_ind]->keywordList ( vect_name_list[n] + ":" + filt );
-            break;
-        default:
-          throw std::runtime_error("invalied file type, can't be loaded");
-        break;
-    }
-
-
-        for ( auto val : wlist ) {
-            int p = val.find_last_of ( ":" );
-            it = std::find(item_list.begin(), item_list.end(), val.substr ( p + 1) );
-
-            if (it == item_list.end())
-                item_list.push_back(val.substr ( p + 1));
+        for ( auto& val : m_catalogue.item_names ( id_list[n], vect_name_list[n], filt ) ) {
+            if ( item_set.insert ( val ).second )
+                item_list.push_back ( val );
         }
     }
 
@@ -1811,24 +2499,28 @@ void SmryAppl::make_well_charts ( std::string filt )
 
     int prev_chart_ind = chart_ind;
 
-    for ( auto val : well_list ) {
+    {
+        UpdateScope update ( *this );
+
+        for ( auto val : well_list ) {
 
-        chart_ind ++;
-        this->init_new_chart();
+            chart_ind ++;
+            this->init_new_chart();
 
-        for ( size_t n = 0; n < charts_list[prev_chart_ind].size(); n++ ) {
+            for ( size_t n = 0; n < charts_list[prev_chart_ind].size(); n++ ) {
 
-            int id = std::get<0> ( charts_list[prev_chart_ind][n] );
-            std::string name = std::get<1> ( charts_list[prev_chart_ind][n] );
+                int id = std::get<0> ( charts_list[prev_chart_ind][n] );
+                std::string name = std::get<1> ( charts_list[prev_chart_ind][n] );
 
-            auto vect = std::get<2> ( charts_list[prev_chart_ind][n] );
+                auto vect = std::get<2> ( charts_list[prev_chart_ind][n] );
 
-            if ( name.substr ( 0,1 ) == "W" ) {
-                int p = name.find_last_of ( ":" );
-                name = name.substr ( 0, p + 1 ) + val;
-            }
+                if ( name.substr ( 0,1 ) == "W" ) {
+                    int p = name.find_last_of ( ":" );
+                    name = name.substr ( 0, p + 1 ) + val;
+                }
 
-            this->add_new_series ( chart_ind, id, name );
+                this->add_new_series ( chart_ind, id, name );
+            }
         }
     }
 
@@ -1846,24 +2538,28 @@ void SmryAppl::make_group_charts ( std::string filt )
 
     int prev_chart_ind = chart_ind;
 
-    for ( auto val : group_list ) {
+    {
+        UpdateScope update ( *this );
 
-        chart_ind ++;
-        this->init_new_chart();
+        for ( auto val : group_list ) {
 
-        for ( size_t n = 0; n < charts_list[prev_chart_ind].size(); n++ ) {
+            chart_ind ++;
+            this->init_new_chart();
 
-            int id = std::get<0> ( charts_list[prev_chart_ind][n] );
-            std::string name = std::get<1> ( charts_list[prev_chart_ind][n] );
+            for ( size_t n = 0; n < charts_list[prev_chart_ind].size(); n++ ) {
 
-            auto vect = std::get<2> ( charts_list[prev_chart_ind][n] );
+                int id = std::get<0> ( charts_list[prev_chart_ind][n] );
+                std::string name = std::get<1> ( charts_list[prev_chart_ind][n] );
 
-            if ( name.substr ( 0,1 ) == "G" ) {
-                int p = name.find_last_of ( ":" );
-                name = name.substr ( 0, p + 1 ) + val;
-            }
+                auto vect = std::get<2> ( charts_list[prev_chart_ind][n] );
+
+                if ( name.substr ( 0,1 ) == "G" ) {
+                    int p = name.find_last_of ( ":" );
+                    name = name.substr ( 0, p + 1 ) + val;
+                }
 
-            this->add_new_series ( chart_ind, id, name );
+                this->add_new_series ( chart_ind, id, name );
+            }
         }
     }
 
@@ -1881,24 +2577,28 @@ void SmryAppl::make_aquifer_charts ( std::string filt )
 
     int prev_chart_ind = chart_ind;
 
-    for ( auto val : aquifer_list ) {
+    {
+        UpdateScope update ( *this );
+
+        for ( auto val : aquifer_list ) {
 
-        chart_ind ++;
-        this->init_new_chart();
+            chart_ind ++;
+            this->init_new_chart();
 
-        for ( size_t n = 0; n < charts_list[prev_chart_ind].size(); n++ ) {
+            for ( size_t n = 0; n < charts_list[prev_chart_ind].size(); n++ ) {
 
-            int id = std::get<0> ( charts_list[prev_chart_ind][n] );
-            std::string name = std::get<1> ( charts_list[prev_chart_ind][n] );
+                int id = std::get<0> ( charts_list[prev_chart_ind][n] );
+                std::string name = std::get<1> ( charts_list[prev_chart_ind][n] );
 
-            auto vect = std::get<2> ( charts_list[prev_chart_ind][n] );
+                auto vect = std::get<2> ( charts_list[prev_chart_ind][n] );
 
-            if ( name.substr ( 0,1 ) == "A" ) {
-                int p = name.find_last_of ( ":" );
-                name = name.substr ( 0, p + 1 ) + val;
-            }
+                if ( name.substr ( 0,1 ) == "A" ) {
+                    int p = name.find_last_of ( ":" );
+                    name = name.substr ( 0, p + 1 ) + val;
+                }
 
-            this->add_new_series ( chart_ind, id, name );
+                this->add_new_series ( chart_ind, id, name );
+            }
         }
     }
 
@@ -1959,17 +2659,6 @@ bool SmryAppl::update_yrange ( const std::string& cmd_str )
 }
 
 
-float SmryAppl::calc_p90 ( const std::vector<float>& data )
-{
-    auto tmp = data;
-
-    std::sort ( tmp.begin(), tmp.end() );
-    size_t  p = static_cast<size_t> ( tmp.size() * 0.9 ) ;
-
-    return tmp[p];
-}
-
-
 void SmryAppl::initColorAndStyle()
 {
     linew = 2;
@@ -2051,6 +2740,136 @@ void SmryAppl::reset_cmdline()
     lbl_rootn->setText ( QString::fromStdString ( root_name_list[smry_ind] ) );
 }
 
+void SmryAppl::enable_cmdline()
+{
+    if (m_smry_loaded)
+        return;
+
+    m_smry_loaded = true;
+    lbl_plot->setText("new chart");
+
+    le_commands->setEnabled(1);
+
+    QPalette *palette = new QPalette();
+    palette->setColor ( QPalette::Text,Qt::black );
+    lbl_cmd->setPalette ( *palette );
+}
+
+bool SmryAppl::add_live_source ( const std::string& server_name, int wait_msecs )
+{
+    int smry_ind = static_cast<int> ( m_sources.size() );
+
+    auto source = std::make_unique<LiveSource> ( server_name );
+    LiveSource& live_source = *source;
+
+    m_smry_files.push_back ( std::filesystem::path ( server_name ) );
+    m_file_type.push_back ( FileType::LIVE );
+    m_sources.push_back ( std::move ( source ) );
+    root_name_list.push_back ( server_name );
+
+    m_stats.resize ( m_smry_files.size() );
+
+    auto feed = new LiveFeed ( QString::fromStdString ( server_name ), smry_ind, live_source, this );
+
+    connect ( feed, &LiveFeed::header_received, this, &SmryAppl::live_header_received );
+    connect ( feed, &LiveFeed::steps_received, this, &SmryAppl::append_live_steps );
+
+    if ( !feed->listen() )
+        return false;
+
+    if ( ( wait_msecs > 0 ) && ( !feed->wait_for_data ( wait_msecs ) ) )
+        std::cout << "\n!Warning, no data received from live case " << server_name << std::endl;
+
+    this->update_keyword_index ( smry_ind );
+    this->enable_cmdline();
+
+    return true;
+}
+
+void SmryAppl::live_header_received ( int smry_ind )
+{
+    // new keys, charts with series from the case are rebuilt
+
+    this->update_keyword_index ( smry_ind );
+
+    this->reload_and_update_charts();
+}
+
+void SmryAppl::append_live_steps ( int smry_ind, int first_step )
+{
+    // only new time steps are added to series from the live case. Derived series and ensemble
+    // charts are updated on next reload
+
+    m_stats.invalidate ( smry_ind );
+
+    const SummarySource& source = *m_sources[smry_ind];
+    const std::vector<float>& timev = source.get ( "TIME" );
+
+    double time_fact = ( source.get_unit ( "TIME" ) == "HOURS" ) ? 3600.0 * 1000.0 : 24.0 * 3600.0 * 1000.0;
+    const qint64 start_msec = start_date_msec ( smry_ind );
+
+    int num_charts = chartList.size();
+    int current_chart_ind = chart_ind;
+
+    std::vector<std::vector<QDateTime>> xrange_state;
+    xrange_state.resize ( num_charts );
+
+    for ( int c = 0; c < num_charts; c++ ) {
+
+        if ( is_ensemble_chart ( c ) )
+            continue;
+
+        bool updated = false;
+
+        for ( size_t e = 0; e < series[c].size(); e++ ) {
+
+            const SeriesEntry& entry = charts_list[c][e];
+
+            if ( ( std::get<0> ( entry ) != smry_ind ) || ( std::get<5> ( entry ) ) )
+                continue;
+
+            if ( !source.has_key ( std::get<1> ( entry ) ) )
+                continue;
+
+            if ( !updated )
+                xrange_state[c] = axisX[c]->get_xrange_state();
+
+            const std::vector<float>& datav = source.get ( std::get<1> ( entry ) );
+            double multiplier = yaxis_map[series[c][e]]->multiplier();
+
+            std::vector<int64_t> time_ms;
+            std::vector<double> values;
+
+            for ( size_t n = first_step; n < timev.size(); n++ ) {
+
+                if (!isnan(datav[n])) {
+                    time_ms.push_back ( start_msec + static_cast<int64_t> ( round ( timev[n] * time_fact ) ) );
+                    values.push_back ( datav[n] * multiplier );
+                }
+            }
+
+            series[c][e]->append_data ( time_ms, values );
+            updated = true;
+        }
+
+        if ( !updated )
+            continue;
+
+        // update_axis_range works on member chart_ind
+
+        chart_ind = c;
+
+        this->reset_axis_state ( c, xrange_state );
+
+        for ( auto axis : axisY[c] )
+            this->update_axis_range ( axis );
+
+        chart_view_list[c]->update_graphics();
+    }
+
+    chart_ind = current_chart_ind;
+}
+
 void SmryAppl::copy_to_clipboard()
 {
     QClipboard *clipboard = QGuiApplication::clipboard();
@@ -2371,7 +3190,7 @@ bool SmryAppl::eventFilter ( QObject *object, QEvent *event )
 
                 vect_ind++;
 
-                if ( vect_ind == vect_lookup_list.size() )
+                if ( vect_ind >= lookup_size() )
                     vect_ind--;
 
                 modifiy_vect_lookup();
@@ -2414,7 +3233,7 @@ void SmryAppl::calc_min_xrange()
 
         for (size_t n = 1; n < chart_series.size(); n++) {
 
-            min_max_dt = chart_series[0]->get_nonzero_range();
+            min_max_dt = chart_series[n]->get_nonzero_range();
 
             if (std::get<0>(min_max_dt) < dt_min_x)
                 dt_min_x =  std::get<0>(min_max_dt);
@@ -2485,23 +3304,35 @@ void SmryAppl::keyPressEvent ( QKeyEvent *event )
 
             } else if ( cmd_var.substr ( 0,4 ) == ":pdf" ) {
 
-                std::string current_path = QDir::currentPath().toStdString();
-                std::string fileName = cmd_var.substr ( 4 );
+                QString qfile_name;
+                int first_chart, last_chart;
+                bool raster;
 
-                int p = fileName.find_first_not_of ( " " );
-                fileName = current_path + "/" + fileName.substr ( p );
+                if ( this->parse_pdf_command ( cmd_var, qfile_name, first_chart, last_chart, raster ) ) {
 
-                QString qfile_name = QString::fromStdString ( fileName );
+                    this->print_pdf ( qfile_name, first_chart, last_chart, raster );
 
-                this->print_pdf ( qfile_name );
+                    this->add_cmd_to_hist(cmd_var);
+                    this->reset_cmdline();
 
-                this->add_cmd_to_hist(cmd_var);
-                this->reset_cmdline();
+                } else {
+                    lbl_rootn->setText ( "!Error, pdf command" );
+                }
 
             } else if (( cmd_var.substr ( 0,7 ) == ":xrange" ) ||
                        ( cmd_var.substr ( 0,2 ) == ":x" ))   {
 
-                if ( axisX[chart_ind]->set_range ( cmd_var ) ) {
+                QDateTime dt_from;
+                QDateTime dt_to;
+
+                m_window_update = true;
+                bool range_ok = axisX[chart_ind]->set_range ( cmd_var );
+                m_window_update = false;
+
+                if ( range_ok ) {
+
+                    SmryXaxis::parse_range ( cmd_var, dt_from, dt_to );
+                    this->set_time_window ( chart_ind, dt_from.toMSecsSinceEpoch(), dt_to.toMSecsSinceEpoch() );
 
                     auto min_max_range = axisX[chart_ind]->get_xrange();
 
@@ -2593,12 +3424,88 @@ void SmryAppl::keyPressEvent ( QKeyEvent *event )
                 this->add_cmd_to_hist(cmd_var);
                 this->reset_cmdline();
 
-            } else if ( ( cmd_var == ":ens" ) || ( cmd_var == ":ENS" ) ) {
+            } else if ( cmd_var.substr ( 0,3 ) == ":gl" ) {
 
-                ens_mode = true;
+                std::vector<std::string> str_tokens = split_string ( cmd_var );
+
+                if ( ( str_tokens.size() > 1 ) && ( str_tokens[1] == "auto" ) )
+                    this->set_render_mode ( RenderMode::automatic );
+                else if ( this->opengl_active ( chart_ind ) )
+                    this->set_render_mode ( RenderMode::raster );
+                else
+                    this->set_render_mode ( RenderMode::opengl );
+
+                this->add_cmd_to_hist(cmd_var);
+                this->reset_cmdline();
+
+                if ( m_render_mode == RenderMode::opengl )
+                    lbl_rootn->setText ( "OpenGL rendering on" );
+                else if ( m_render_mode == RenderMode::raster )
+                    lbl_rootn->setText ( "OpenGL rendering off" );
+                else
+                    lbl_rootn->setText ( "OpenGL rendering auto" );
+
+            } else if ( ( cmd_var.substr ( 0,4 ) == ":ens" ) || ( cmd_var.substr ( 0,4 ) == ":ENS" ) ) {
+
+                std::vector<std::string> str_tokens = split_string ( cmd_var );
+
+                if ( str_tokens.size() == 1 ) {
+
+                    ens_mode = !ens_mode;
+                    lbl_rootn->setText ( ens_mode ? "Ensemble mode on" : "Ensemble mode off" );
+
+                } else if ( ( str_tokens[1] == "band" ) || ( str_tokens[1] == "BAND" ) ) {
+
+                    this->set_ensemble_mode ( EnsembleMode::band );
+                    lbl_rootn->setText ( "Ensemble members as P10-P90 and min-max bands" );
+
+                } else if ( ( str_tokens[1] == "density" ) || ( str_tokens[1] == "DENSITY" ) ) {
+
+                    this->set_ensemble_mode ( EnsembleMode::density );
+                    lbl_rootn->setText ( "Ensemble members as density" );
+
+                } else if ( ( str_tokens[1] == "lines" ) || ( str_tokens[1] == "LINES" ) ) {
+
+                    this->set_ensemble_mode ( EnsembleMode::lines );
+                    lbl_rootn->setText ( "Ensemble members as lines" );
+
+                } else {
+                    std::cout << "invalid command, example :ens band, :ens density or :ens lines \n";
+                }
+
+                this->add_cmd_to_hist(cmd_var);
                 this->reset_cmdline();
 
-                lbl_rootn->setText ( "Ensemble mode" );
+            } else if ( cmd_var.substr ( 0,6 ) == ":rstep" ) {
+
+                std::vector<std::string> str_tokens = split_string ( cmd_var );
+
+                if ( str_tokens.size() == 1 ) {
+
+                    this->set_report_steps ( chart_ind, !m_report_steps[chart_ind] );
+                    lbl_rootn->setText ( m_report_steps[chart_ind] ? "Report steps only, active chart" : "All time steps, active chart" );
+
+                } else if ( str_tokens[1] == "on" ) {
+
+                    this->set_report_steps ( true );
+                    lbl_rootn->setText ( "Report steps only, all charts" );
+
+                } else if ( str_tokens[1] == "off" ) {
+
+                    this->set_report_steps ( false );
+                    lbl_rootn->setText ( "All time steps, all charts" );
+
+                } else {
+                    std::cout << "invalid command, example :rstep, :rstep on or :rstep off \n";
+                }
+
+                if ( ( series[chart_ind].size() > 0 ) && ( axisX[chart_ind] != nullptr ) ) {
+                    auto min_max_range = axisX[chart_ind]->get_xrange();
+                    update_all_yaxis ( min_max_range, chart_ind );
+                }
+
+                this->add_cmd_to_hist(cmd_var);
+                this->reset_cmdline();
 
             } else if ( ( cmd_var == ":e" ) || ( cmd_var == ":E" ) ) {
 
@@ -2683,7 +3590,7 @@ void SmryAppl::keyPressEvent ( QKeyEvent *event )
     else if ( event->key() == Qt::Key_O  &&  m_ctrl_key  && !m_shift_key && !m_alt_key ) {
 
         QString fileName = QFileDialog::getOpenFileName ( this, tr ( "Open Summary" ),
-                           QDir::currentPath(), tr ( "Summary Files (*.SMSPEC *.ESMRY);;SMSPEC Files (*.SMSPEC);;ESMRY Files (*.ESMRY)" ) );
+                           QDir::currentPath(), tr ( "Summary Files (*.SMSPEC *.ESMRY *.FSMSPEC);;SMSPEC Files (*.SMSPEC);;ESMRY Files (*.ESMRY);;Formatted Files (*.FSMSPEC)" ) );
 
         if ( fileName.toStdString().size() > 0 ) {
 
@@ -2693,10 +3600,23 @@ void SmryAppl::keyPressEvent ( QKeyEvent *event )
 
             size_t smry_ind = m_file_type.size();
 
-            auto ftime = std::filesystem::last_write_time ( m_smry_files[smry_ind] );
-            file_stamp_vector.push_back ( ftime );
+            // formatted cases are opened from the ESMRY cache when already converted, and
+            // read with FormattedSource otherwise
+
+            if ((ext == ".FSMSPEC") && EsmryCache::is_valid(filename)) {
+                m_file_type.push_back(FileType::ESMRY);
+
+                try {
+                    m_ext_esmry_loader[smry_ind] = std::make_unique<Opm::EclIO::ExtESmry>(EsmryCache::cached_file(filename));
+                } catch (...) {
+                    std::string message = "Error with opening cached ESMRY file for " + filename.string();
+                    throw std::runtime_error(message);
+                }
+
+            } else if (ext == ".FSMSPEC") {
+                m_file_type.push_back(FileType::FORMATTED);
 
-            if (ext == ".SMSPEC") {
+            } else if (ext == ".SMSPEC") {
                 m_file_type.push_back(FileType::SMSPEC);
 
                 try {
@@ -2706,9 +3626,6 @@ void SmryAppl::keyPressEvent ( QKeyEvent *event )
                     throw std::runtime_error(message);
                 }
 
-                root_name_list.push_back ( m_esmry_loader[smry_ind]->rootname() );
-                vect_list.push_back ( m_esmry_loader[smry_ind]->keywordList() );
-
             }  else if (ext == ".ESMRY") {
                 m_file_type.push_back(FileType::ESMRY);
 
@@ -2719,23 +3636,17 @@ void SmryAppl::keyPressEvent ( QKeyEvent *event )
                     throw std::runtime_error(message);
                 }
 
-                root_name_list.push_back ( m_ext_esmry_loader[smry_ind]->rootname() );
-                vect_list.push_back ( m_ext_esmry_loader[smry_ind]->keywordList() );
             }
 
-            if (!m_smry_loaded) {
-
-                m_smry_loaded = true;
-                lbl_plot->setText("new chart");
-
-                le_commands->setEnabled(1);
+            m_sources.push_back ( make_summary_source ( m_file_type.back(), smry_ind, m_esmry_loader,
+                                                        m_ext_esmry_loader, filename ) );
 
-                QPalette *palette = new QPalette();
-                palette->setColor ( QPalette::Text,Qt::black );
-                lbl_cmd->setPalette ( *palette );
-            }
+            root_name_list.push_back ( m_sources[smry_ind]->rootname() );
 
+            this->update_keyword_index ( smry_ind );
+            m_stats.resize ( m_smry_files.size() );
 
+            this->enable_cmdline();
         }
     }
 
@@ -2902,7 +3813,13 @@ void SmryAppl::keyPressEvent ( QKeyEvent *event )
 
 void SmryAppl::handle_delete_series()
 {
-    if ( series[chart_ind].size() > 0 ) {
+    if ( is_ensemble_chart ( chart_ind ) ) {
+
+        this->delete_ens_series ( chart_ind );
+
+        chartList[chart_ind]->setTitle ( "" );
+
+    } else if ( series[chart_ind].size() > 0 ) {
 
         delete_last_series();
 
@@ -2965,18 +3882,18 @@ void SmryAppl::command_modified ( const QString & txt )
 
         if ( p2 > 0 ) {
 
-            vect_lookup_list.clear();
-
-            for ( size_t n=0; n < vect_list[smry_ind].size(); n++ )
-                if ( vect_list[smry_ind][n].substr ( 0, p2-p1 ) == str1 )
-                    vect_lookup_list.push_back ( vect_list[smry_ind][n] );
+            this->update_vect_lookup ( str1 );
 
             vect_ind = 0;
 
-            std::string lbl_str = std::to_string ( vect_lookup_list.size() ) + " matches";
+            std::string lbl_str = std::to_string ( lookup_size() ) + " matches";
+
+            if ( m_fuzzy_lookup.size() > 0 )
+                lbl_str = lbl_str + " (fuzzy)";
+
             lbl_num->setText ( QString::fromStdString ( lbl_str ) );
 
-            if ( vect_lookup_list.size() > 0 ) {
+            if ( lookup_size() > 0 ) {
 
                 modifiy_vect_lookup();
                 vect_ok = true;
@@ -3001,15 +3918,19 @@ void SmryAppl::command_modified ( const QString & txt )
         if ( cmd_var == ":r" )
             lbl_rootn->setText ( "re-load and update all series" );
         else if ( cmd_var.substr ( 0, 4 ) == ":pdf" )
-            lbl_rootn->setText ( "export to pdf document" );
+            lbl_rootn->setText ( "export to pdf document >  [file_name] [from-to] [raster]" );
         else if ( cmd_var.substr ( 0, 7 ) == ":xrange" )
             lbl_rootn->setText ( "set range for xaxis" );
         else if ( cmd_var.substr ( 0, 7 ) == ":yrange" )
             lbl_rootn->setText ( "set range for yaxis >  axis min max [n_tick]" );
-        else if ( cmd_var == ":e" )
-            lbl_rootn->setText ( "set ensemble mode" );
+        else if ( cmd_var.substr ( 0, 4 ) == ":ens" )
+            lbl_rootn->setText ( "ensemble mode on/off [band|density|lines]" );
         else if ( cmd_var == ":m" )
             lbl_rootn->setText ( "markers on/off" );
+        else if ( cmd_var.substr ( 0, 3 ) == ":gl" )
+            lbl_rootn->setText ( "OpenGL rendering on/off [auto]" );
+        else if ( cmd_var.substr ( 0, 6 ) == ":rstep" )
+            lbl_rootn->setText ( "report steps only on/off, active chart [on|off for all charts]" );
         else
             lbl_rootn->setText ( "??" );
 
@@ -3023,11 +3944,62 @@ void SmryAppl::command_modified ( const QString & txt )
 }
 
 
+void SmryAppl::update_vect_lookup ( const std::string& prefix )
+{
+    m_fuzzy_lookup.clear();
+
+    if ( smry_ind >= m_catalogue.number_of_cases() ) {
+        m_lookup_range = std::make_pair ( 0, 0 );
+        m_lookup_prefix.clear();
+        return;
+    }
+
+    // when a character is added, the new range is inside the previous range
+
+    bool narrow = ( m_lookup_case == static_cast<int>(smry_ind) ) && ( m_lookup_prefix.size() > 0 ) &&
+                  ( prefix.size() > m_lookup_prefix.size() ) &&
+                  ( prefix.compare ( 0, m_lookup_prefix.size(), m_lookup_prefix ) == 0 );
+
+    if ( narrow )
+        m_lookup_range = m_catalogue.prefix_range ( smry_ind, prefix, m_lookup_range );
+    else
+        m_lookup_range = m_catalogue.prefix_range ( smry_ind, prefix );
+
+    m_lookup_prefix = prefix;
+    m_lookup_case = smry_ind;
+
+    // no exact prefix match, fuzzy match on well/group name, ex WOPR:P1 -> WOPR:PROD-1
+
+    auto p = prefix.find ( ":" );
+
+    if ( ( m_lookup_range.first == m_lookup_range.second ) && ( p != std::string::npos ) && ( p + 1 < prefix.size() ) )
+        m_fuzzy_lookup = m_catalogue.fuzzy_item_match ( smry_ind, prefix.substr ( 0, p ), prefix.substr ( p + 1 ) );
+}
+
+
+size_t SmryAppl::lookup_size() const
+{
+    if ( m_fuzzy_lookup.size() > 0 )
+        return m_fuzzy_lookup.size();
+
+    return m_lookup_range.second - m_lookup_range.first;
+}
+
+
+const std::string& SmryAppl::lookup_key ( size_t n ) const
+{
+    if ( m_fuzzy_lookup.size() > 0 )
+        return m_fuzzy_lookup[n];
+
+    return m_catalogue.sorted_key ( m_lookup_case, m_lookup_range.first + n );
+}
+
+
 void SmryAppl::modifiy_vect_lookup()
 {
     size_t lstr = str_var.size();
     std::string pre = str_var.substr ( 0,p1 );
-    le_commands->setText ( QString::fromStdString ( pre + vect_lookup_list[vect_ind] ) );
+    le_commands->setText ( QString::fromStdString ( pre + lookup_key ( vect_ind ) ) );
 
     le_commands->setSelection ( p1, lstr-p1 );
 
@@ -3039,29 +4011,19 @@ void SmryAppl::modifiy_vect_lookup()
 
 bool SmryAppl::has_smry_vect(int smry_ind, const std::string& keystr)
 {
-    if (m_file_type[smry_ind] == FileType::SMSPEC)
-        return m_esmry_loader[smry_ind]->hasKey ( keystr );
+    // TIMESTEP is added to the catalogue for autocomplete (see update_keyword_index),
+    // only present if the summary file has the vector
 
-    else if (m_file_type[smry_ind] == FileType::ESMRY)
-        return m_ext_esmry_loader[smry_ind]->hasKey ( keystr );
-
-    throw std::runtime_error("unknown file type, can't be loaded");
+    if ( keystr == "TIMESTEP" )
+        return m_sources[smry_ind]->has_key ( keystr );
 
+    return m_catalogue.has_key ( smry_ind, keystr );
 }
 
 
 const std::vector<float>& SmryAppl::get_smry_vect(int case_ind, std::string& keystr)
 {
-    switch( m_file_type[case_ind] ) {
-    case FileType::SMSPEC:
-        return m_esmry_loader[case_ind]->get(keystr);
-        break;
-    case FileType::ESMRY:
-        return m_ext_esmry_loader[case_ind]->get(keystr);
-        break;
-    default:
-        throw std::invalid_argument ( "invalid file type" );
-    }
+    return m_sources[case_ind]->get(keystr);
 }
 
 
@@ -3101,47 +4063,117 @@ int SmryAppl::max_vect_chart(input_list_type chart_input)
 }
 
 
-void SmryAppl::print_pdf ( QString& fileName )
+void SmryAppl::print_pdf ( const QString& fileName, int first_chart, int last_chart, bool raster )
 {
-    QPdfWriter writer ( fileName );
+    if ( fileName.isEmpty() )
+        return;
 
-    int current_chart_ind = chart_ind;
+    if ( last_chart < 0 || last_chart > static_cast<int>(chartList.size()) )
+        last_chart = chartList.size();
 
-    //QFont m_font;
-    //QFontMetrics metrics(m_font);
+    first_chart = std::max(first_chart, 1);
 
-    //1400, 600
+    PdfExport pdf_export ( fileName, raster );
 
-    // original QSizeF size1 ( 700, 1400 );
-    QSizeF size1 ( 600, 1400 );
-    QPageSize page1 ( size1, QPageSize::Unit::Point, "Custom" );
+    QSize chart_size = chart_view_list[chart_ind]->size();
 
-    writer.setPageSize ( page1 );
+    // charts are recorded without switching the stacked widget
 
-    writer.setPageOrientation ( QPageLayout::Landscape );
+    for ( int n = first_chart - 1; n < last_chart; n++ )
+        this->materialize_chart ( n );
 
-    QPainter painter ( &writer );
+    for ( int n = first_chart - 1; n < last_chart; n++ )
+        if ( series[n].size() > 0 )
+            pdf_export.add_chart ( chart_view_list[n], chart_size );
 
-    for ( size_t n = 0; n < chartList.size(); n++ ) {
-        if ( series[n].size() > 0 ) {
+    auto progress = [this] ( size_t page, size_t num_pages ) {
 
-            if ( n > 0 )
-                writer.newPage();
+        std::string lbl_str = "pdf export, page " + std::to_string ( page ) + "/" + std::to_string ( num_pages );
 
-            chart_ind = n;
+        lbl_rootn->setText ( QString::fromStdString ( lbl_str ) );
+        lbl_rootn->repaint();
 
-            stackedWidget->setCurrentIndex(chart_ind);
+        std::cout << "\r" << lbl_str << std::flush;
+    };
+
+    if ( pdf_export.write ( progress ) )
+        std::cout << " -> " << fileName.toStdString() << std::endl;
+    else
+        std::cout << "\n!Warning, pdf file " << fileName.toStdString() << " not written " << std::endl;
+}
 
-            chart_view_list[chart_ind]->render ( &painter );
 
-            this->update_chart_labels();
-        }
+bool SmryAppl::parse_pdf_command ( const std::string& cmd_str, QString& fileName, int& first_chart,
+                                   int& last_chart, bool& raster )
+{
+    // :pdf [file_name] [from-to] [raster]
+
+    std::vector<std::string> tokens;
+
+    for ( auto& token : split_string ( cmd_str.substr ( 4 ) ) )
+        if ( token.size() > 0 )
+            tokens.push_back ( token );
+
+    first_chart = 1;
+    last_chart = -1;
+    raster = false;
+
+    if ( ( tokens.size() > 0 ) && ( tokens.back() == "raster" ) ) {
+        raster = true;
+        tokens.pop_back();
     }
 
-    painter.end();
+    // chart range before or after the file name, :pdf 2-4, :pdf 2-4 file.pdf or :pdf file.pdf 2-4
 
-    chart_ind = current_chart_ind;
-    stackedWidget->setCurrentIndex(chart_ind);
+    auto is_range = [this] ( const std::string& token ) {
+        auto p = token.find ( "-" );
+        std::string from_str = token.substr ( 0, p );
+        std::string to_str = p == std::string::npos ? "" : token.substr ( p + 1 );
+
+        return ( from_str.size() > 0 ) && is_number ( from_str ) && ( ( to_str.size() == 0 ) || is_number ( to_str ) );
+    };
+
+    auto range_it = std::find_if ( tokens.begin(), tokens.end(), is_range );
+
+    if ( range_it != tokens.end() ) {
+
+        std::string range = *range_it;
+        tokens.erase ( range_it );
+
+        auto p = range.find ( "-" );
+
+        std::string from_str = range.substr ( 0, p );
+        std::string to_str = p == std::string::npos ? from_str : range.substr ( p + 1 );
+
+        first_chart = std::stoi ( from_str );
+
+        if ( to_str.size() > 0 )
+            last_chart = std::stoi ( to_str );
+
+        if ( ( last_chart > -1 ) && ( last_chart < first_chart ) )
+            return false;
+    }
+
+    if ( tokens.size() > 1 )
+        return false;
+
+    if ( tokens.size() == 0 ) {
+
+        fileName = QFileDialog::getSaveFileName ( this, tr ( "Save File" ),
+                   QDir::currentPath(),
+                   tr ( "Pdf (*.pdf)" ) ,0 , QFileDialog::DontUseNativeDialog );
+
+    } else {
+
+        std::filesystem::path pdf_file ( tokens[0] );
+
+        if ( pdf_file.is_relative() )
+            pdf_file = std::filesystem::path ( QDir::currentPath().toStdString() ) / pdf_file;
+
+        fileName = QString::fromStdString ( pdf_file.string() );
+    }
+
+    return true;
 }
 
 
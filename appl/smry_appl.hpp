@@ -31,19 +31,28 @@
 #include <appl/smry_xaxis.hpp>
 #include <appl/smry_yaxis.hpp>
 #include <appl/chartview.hpp>
+#include <appl/pdf_export.hpp>
+#include <appl/keyword_catalogue.hpp>
+#include <appl/ensemble_data.hpp>
+#include <appl/ensemble_band.hpp>
+#include <appl/smry_stats.hpp>
+#include <appl/summary_source.hpp>
 
 #include <QHBoxLayout>
 #include <QGridLayout>
 #include <QLineEdit>
 #include <QLabel>
 
+#include <exception>
 #include <set>
 
 #include <appl/derived_smry.hpp>
 
 class DerivedSmry;
 
-enum class FileType{ SMSPEC, ESMRY };
+// raster: QPainter on the graphics scene, opengl: all series in chart drawn with OpenGL,
+// automatic: OpenGL for ensemble charts with member lines and charts with many data points
+enum class RenderMode{ raster, opengl, automatic };
 
 
 class SmryAppl: public QGraphicsView
@@ -58,16 +67,29 @@ public:
 
     using input_list_type = std::vector<char_input_type>;
 
+    // summary files, file types, loader maps and the sources for all cases. Sources are
+    // built once by the caller (see make_summary_sources), if empty they are built from
+    // the loader maps. Node based maps keep the loader slots referenced by the sources
+    // when moved
     using loader_list_type =
                std::tuple< std::vector<std::filesystem::path>,
                            std::vector<FileType>,
                            std::unordered_map<int, std::unique_ptr<Opm::EclIO::ESmry>>,
-                           std::unordered_map<int, std::unique_ptr<Opm::EclIO::ExtESmry>>
+                           std::unordered_map<int, std::unique_ptr<Opm::EclIO::ExtESmry>>,
+                           source_list_type
                          >;
 
+    // group name, lazy, no reload, ensemble. One element for each chart in chart input,
+    // lazy charts are created when first shown, no reload charts are not updated on reload.
+    // Ensemble charts show all cases of a vector with P10, P50 and P90
+    using chart_props_type = std::tuple<std::string, bool, bool, bool>;
+    using chart_props_list_type = std::vector<chart_props_type>;
+
 // std::unique_ptr<DerivedSmry> derived_smry = nullptr ,
     SmryAppl(std::vector<std::string> arg_vect, loader_list_type& loaders,
-             input_list_type chart_input, std::unique_ptr<DerivedSmry>& derived_smry, QWidget *parent = 0);
+             input_list_type chart_input, std::unique_ptr<DerivedSmry>& derived_smry,
+             const chart_props_list_type& chart_props = {}, SmryStatsCache stats_cache = {},
+             bool report_steps = false, QWidget *parent = 0);
 
     void export_figure(const std::string& fname, int chart_ind);
 
@@ -83,6 +105,61 @@ public:
     size_t number_of_charts() { return chartList.size(); }
     size_t number_of_series(int chart_ind) { return series[chart_ind].size(); }
 
+    bool is_lazy_pending(int chart_ind) { return std::get<0>(m_lazy_input[chart_ind]).size() > 0; }
+    bool is_ensemble_chart(int chart_ind) { return m_ens_vect[chart_ind].size() > 0; }
+    size_t number_of_ens_members(int chart_ind) { return m_ens_members[chart_ind].size(); }
+    const EnsembleData& ensemble_data(int chart_ind) { return *m_ens_data[chart_ind]; }
+    EnsembleBand* ensemble_band(int chart_ind) { return m_ens_band[chart_ind]; }
+    const chart_props_type& chart_props(int chart_ind) { return m_chart_props[chart_ind]; }
+
+    // axis, legend, title and repaint updates are deferred until the
+    // outermost end_update when series are added inside an update scope
+    void begin_update();
+    void end_update();
+
+    // update scope ended on return or exception. Deferred updates are dropped
+    // when the scope is left by an exception
+    class UpdateScope {
+
+    public:
+
+        explicit UpdateScope(SmryAppl& appl) : m_appl(appl), m_exceptions(std::uncaught_exceptions()) { m_appl.begin_update(); }
+        ~UpdateScope() noexcept(false);
+
+        UpdateScope(const UpdateScope&) = delete;
+        UpdateScope& operator=(const UpdateScope&) = delete;
+
+    private:
+
+        SmryAppl& m_appl;
+        int m_exceptions;
+    };
+
+    void set_render_mode(RenderMode mode);
+    RenderMode render_mode() { return m_render_mode; }
+    bool opengl_active(int chart_ind);
+
+    // existing ensemble charts are rebuilt with the new mode
+    void set_ensemble_mode(EnsembleMode mode);
+    EnsembleMode ensemble_mode() { return m_ens_mode; }
+
+    // case fed from a running simulator over a local socket (see live_source.hpp). Waits up to
+    // wait_msecs for the first time step, returns false if the server could not be started
+    bool add_live_source(const std::string& server_name, int wait_msecs = 0);
+
+    // time window of chart in ms since epoch. Series only hold the time steps inside the
+    // window (and one step on each side), window is unbounded when no x-range is given
+    using time_window_type = std::pair<qint64, qint64>;
+
+    const time_window_type& time_window(int chart_ind) { return m_time_window[chart_ind]; }
+    void set_time_window(int chart_ind, qint64 from, qint64 to);
+
+    // series hold report steps only, see SummarySource::report_step_index. Without chart
+    // index for all charts and charts created later
+    void set_report_steps(int chart_ind, bool value);
+    void set_report_steps(bool value);
+    bool report_steps(int chart_ind) { return m_report_steps[chart_ind]; }
+
 
 protected:
 
@@ -94,11 +171,19 @@ protected:
 private slots:
     void command_modified(const QString & txt);
 
+    void live_header_received(int smry_ind);
+    void append_live_steps(int smry_ind, int first_step);
+
+    void xaxis_range_changed(QDateTime min, QDateTime max);
+
 private:
 
     std::unordered_map<int, std::unique_ptr<Opm::EclIO::ESmry>> m_esmry_loader;
     std::unordered_map<int, std::unique_ptr<Opm::EclIO::ExtESmry>> m_ext_esmry_loader;
 
+    // one source for each case, all access to summary data goes through m_sources
+    source_list_type m_sources;
+
     std::unique_ptr<DerivedSmry> m_derived_smry;
 
     std::vector<QColor> color_tab;
@@ -114,6 +199,15 @@ private:
     bool ens_mode = false;
     bool m_smry_loaded = false;
 
+    RenderMode m_render_mode = RenderMode::automatic;
+    EnsembleMode m_ens_mode = EnsembleMode::band;
+
+    int m_update_depth = 0;
+    std::set<int> m_pending_update;
+
+    // total number of data points in a chart before switching to OpenGL in automatic mode
+    const size_t opengl_point_limit = 100000;
+
     bool m_shift_key = false;
     bool m_ctrl_key = false;
     bool m_alt_key = false;
@@ -147,12 +241,19 @@ private:
     std::vector<std::vector<SmrySeries*>> series;
     std::vector<std::vector<QLineSeries*>> ens_series;
 
+    // ensemble charts, vector name (empty if not ensemble chart), members and data.
+    // min, P10, P50, P90 and max are series in chart. Members are drawn by m_ens_band,
+    // or as series in ens_series with EnsembleMode::lines
+    std::vector<std::string> m_ens_vect;
+    std::vector<std::vector<int>> m_ens_members;
+    std::vector<std::shared_ptr<EnsembleData>> m_ens_data;
+    std::vector<EnsembleBand*> m_ens_band;
+
     std::map<SmrySeries*, SmryYaxis*> yaxis_map;
 
     std::vector<std::string> command_hist;
     std::vector<std::string> root_name_list;
 
-    std::vector<std::filesystem::file_time_type> file_stamp_vector;
     std::vector<std::filesystem::path> m_smry_files;
     std::vector<FileType> m_file_type;
 
@@ -167,15 +268,44 @@ private:
 
     std::vector<ChartEntry> charts_list;
 
-    std::vector<std::string> vect_lookup_list;
+    std::vector<chart_props_type> m_chart_props;
+
+    // series input for lazy charts not yet shown
+    std::vector<char_input_type> m_lazy_input;
+
+    std::vector<time_window_type> m_time_window;
+    bool m_window_update = false;
+
+    std::vector<bool> m_report_steps;
+    bool m_report_steps_default = false;
 
-    std::vector<std::vector<std::string>> vect_list;
+    KeywordCatalogue m_catalogue;
+
+    // stats for loaded vectors, invalidated when a case is reloaded
+    SmryStatsCache m_stats;
+
+    // autocomplete matches, range in sorted key list of case m_lookup_case,
+    // or fuzzy matches if the prefix has no match
+    std::pair<size_t, size_t> m_lookup_range { 0, 0 };
+    std::string m_lookup_prefix;
+    int m_lookup_case = -1;
+    std::vector<std::string> m_fuzzy_lookup;
 
     void initColorAndStyle();
-    void create_charts_from_input ( const input_list_type& chart_input );
+    void create_charts_from_input ( const input_list_type& chart_input, const chart_props_list_type& chart_props );
+    void add_chart_series ( int chart_ind, const char_input_type& chart_input );
+    void materialize_chart ( int chart_ind );
     void init_new_chart();
     bool add_new_series ( int chart_ind, int smry_ind, std::string vect_name, int vaxis_ind = -1, bool is_derived = false);
-    bool add_new_ens_series ( int chart_ind, std::string vect_name, int vaxis_ind = -1);
+    // members empty: all cases
+    bool add_new_ens_series ( int chart_ind, std::string vect_name, int vaxis_ind = -1, std::vector<int> members = {} );
+    void delete_ens_series ( int chart_ind );
+    qint64 start_date_msec ( int smry_ind );
+
+    bool full_series_only ( int chart_ind, int smry_ind );
+    bool has_time_window ( int chart_ind, int smry_ind );
+    bool has_report_steps ( int chart_ind, int smry_ind );
+    void rebuild_series_data ( int chart_ind );
 
     void update_chart_labels();
 
@@ -192,6 +322,7 @@ private:
                           bool ignore_zero = false);
 
     void update_chart_title_and_legend(int chart_ind);
+    void update_render_mode(int chart_ind);
     bool reload_and_update_charts();
     void reset_axis_state(int chart_index, const std::vector<std::vector<QDateTime>>& xrange_state);
 
@@ -215,29 +346,33 @@ private:
                                     const std::vector<int>& id_list);
 
     vectorEntry make_vector_entry ( std::string vect_name );
-    float calc_p90(const std::vector<float>& data);
 
+    void update_vect_lookup(const std::string& prefix);
+    size_t lookup_size() const;
+    const std::string& lookup_key(size_t n) const;
     void modifiy_vect_lookup();
     bool is_number(const std::string &s);
     void acceptAutoComlete();
 
-    void print_pdf(QString& fileName);
+    // chart numbers from 1, last_chart = -1 exports to the last chart
+    void print_pdf(const QString& fileName, int first_chart = 1, int last_chart = -1, bool raster = false);
+    bool parse_pdf_command(const std::string& cmd_str, QString& fileName, int& first_chart,
+                           int& last_chart, bool& raster);
 
     void add_cmd_to_hist(std::string var);
     void reset_cmdline();
+    void enable_cmdline();
 
     void handle_delete_series();
 
-    template <typename T>
-    bool reopen_loader(int n, std::unique_ptr<T>& smry);
+    void update_keyword_index(size_t smry_ind);
 
     bool has_smry_vect(int smry_ind, const std::string& keystr);
     const std::vector<float>& get_smry_vect(int case_ind, std::string& keystr);
 
     int max_vect_chart(input_list_type chart_input);
 
-    template <typename T>
-    bool double_check_well_vector(std::string& vect_name, std::unique_ptr<T>& smry);
+    bool double_check_well_vector(std::string& vect_name, const SummarySource& smry);
 
     void copy_to_clipboard();
     void switch_markes();
@@ -0,0 +1,318 @@
+/*
+   Copyright 2022 Equinor ASA.
+
+   This file is part of the Open Porous Media project (OPM).
+
+   OPM is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   OPM is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#include <appl/smry_daemon.hpp>
+#include <appl/esmry_cache.hpp>
+
+#include <iostream>
+#include <stdexcept>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+
+namespace {
+
+// UNSMRY grows while SMSPEC is unchanged for a running simulation
+
+std::filesystem::path data_file(const std::filesystem::path& smry_file)
+{
+    std::filesystem::path data_file = smry_file;
+
+    if (smry_file.extension() == ".SMSPEC")
+        data_file.replace_extension(".UNSMRY");
+    else if (smry_file.extension() == ".FSMSPEC")
+        data_file.replace_extension(".FUNSMRY");
+
+    return data_file;
+}
+
+std::filesystem::file_time_type data_stamp(const std::filesystem::path& smry_file)
+{
+    std::error_code ec;
+    auto stamp = std::filesystem::last_write_time(data_file(smry_file), ec);
+
+    return ec ? std::filesystem::file_time_type() : stamp;
+}
+
+// files are opened with the permissions of the daemon user, only the same user may connect
+
+bool peer_is_daemon_user(const QLocalSocket* socket)
+{
+    ucred cred {};
+    socklen_t length = sizeof(cred);
+
+    if (::getsockopt(socket->socketDescriptor(), SOL_SOCKET, SO_PEERCRED, &cred, &length) != 0)
+        return false;
+
+    return cred.uid == ::getuid();
+}
+
+} // anonymous namespace
+
+
+SmryDaemon::SmryDaemon(const std::string& name, QObject* parent) :
+    QObject(parent), m_socket_path(daemon_socket_path(name))
+{
+    m_server = new QLocalServer(this);
+
+    connect(m_server, &QLocalServer::newConnection, this, &SmryDaemon::new_connection);
+}
+
+bool SmryDaemon::listen()
+{
+    QString server_name = QString::fromStdString(m_socket_path.string());
+
+    QLocalServer::removeServer(server_name);
+
+    m_server->setSocketOptions(QLocalServer::UserAccessOption);
+
+    if (!m_server->listen(server_name)) {
+        std::cout << "\n!Error, summary daemon failed to listen on " << m_socket_path.string() << ": "
+                  << m_server->errorString().toStdString() << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+void SmryDaemon::new_connection()
+{
+    while (m_server->hasPendingConnections()) {
+
+        QLocalSocket* socket = m_server->nextPendingConnection();
+
+        if (!peer_is_daemon_user(socket)) {
+            std::cout << "\n!Warning, summary daemon: connection from other user refused" << std::endl;
+            socket->abort();
+            socket->deleteLater();
+            continue;
+        }
+
+        m_buffer[socket] = "";
+
+        connect(socket, &QLocalSocket::readyRead, this, &SmryDaemon::read_request);
+
+        connect(socket, &QLocalSocket::disconnected, this, [this, socket]() {
+            m_buffer.erase(socket);
+            socket->deleteLater();
+        });
+    }
+}
+
+void SmryDaemon::read_request()
+{
+    auto socket = qobject_cast<QLocalSocket*>(sender());
+
+    if ((socket == nullptr) || (m_buffer.count(socket) == 0))
+        return;
+
+    std::string& buffer = m_buffer[socket];
+
+    QByteArray bytes = socket->readAll();
+    buffer.append(bytes.constData(), bytes.size());
+
+    try {
+
+        // one client waits for the reply before sending the next request
+
+        size_t length;
+
+        while ((length = DaemonProtocol::frame_length(buffer)) > 0) {
+
+            const char* frame = buffer.data() + sizeof(uint64_t);
+            std::string reply = this->handle_request(static_cast<uint8_t>(frame[0]), frame + 1,
+                                                     length - sizeof(uint64_t) - 1);
+
+            buffer.erase(0, length);
+
+            socket->write(reply.data(), reply.size());
+        }
+
+    } catch (const std::runtime_error& e) {
+        std::cout << "\n!Warning, summary daemon: " << e.what() << ", connection closed" << std::endl;
+        socket->abort();
+    }
+}
+
+std::string SmryDaemon::handle_request(uint8_t type, const char* payload, size_t size)
+{
+    DaemonProtocol::Reader reader(payload, size);
+    DaemonProtocol::Writer writer;
+
+    try {
+
+        if (type == DaemonProtocol::open) {
+
+            std::filesystem::path smry_file(reader.get_string());
+
+            uint32_t case_id = this->open_case(smry_file);
+
+            this->case_info(case_id, true).write(writer);
+
+            return writer.frame(DaemonProtocol::case_info);
+
+        } else if (type == DaemonProtocol::load) {
+
+            uint32_t case_id = reader.get<uint32_t>();
+            size_t num_keys = reader.get<uint32_t>();
+
+            if (case_id >= m_cases.size())
+                throw std::invalid_argument("unknown case id " + std::to_string(case_id));
+
+            SummarySource& source = *m_cases[case_id].source;
+
+            std::vector<std::string> keys;
+
+            for (size_t n = 0; n < num_keys; n++) {
+                keys.push_back(reader.get_string());
+
+                if (!source.has_key(keys.back()))
+                    throw std::invalid_argument("key " + keys.back() + " not found in " + source.rootname());
+            }
+
+            // vectors already loaded by earlier requests are kept in the loader
+
+            source.load(keys);
+
+            for (auto& key : keys)
+                writer.put_floats(source.get(key));
+
+            return writer.frame(DaemonProtocol::data);
+
+        } else if (type == DaemonProtocol::reopen) {
+
+            uint32_t case_id = reader.get<uint32_t>();
+            uint32_t generation = reader.get<uint32_t>();
+
+            if (case_id >= m_cases.size())
+                throw std::invalid_argument("unknown case id " + std::to_string(case_id));
+
+            this->reopen_case(m_cases[case_id]);
+
+            this->case_info(case_id, m_cases[case_id].generation != generation).write(writer);
+
+            return writer.frame(DaemonProtocol::case_info);
+        }
+
+        throw std::invalid_argument("unknown request type " + std::to_string(type));
+
+    } catch (const std::exception& e) {
+
+        DaemonProtocol::Writer error_writer;
+        error_writer.put_string(e.what());
+
+        return error_writer.frame(DaemonProtocol::error);
+    }
+}
+
+uint32_t SmryDaemon::open_case(const std::filesystem::path& smry_file)
+{
+    auto it = m_case_index.find(smry_file.string());
+
+    if (it != m_case_index.end()) {
+        this->reopen_case(m_cases[it->second]);
+        return it->second;
+    }
+
+    if (!std::filesystem::exists(smry_file))
+        throw std::invalid_argument("summary file " + smry_file.string() + " not found");
+
+    uint32_t case_id = static_cast<uint32_t>(m_cases.size());
+    std::string ext = smry_file.extension().string();
+
+    FileType file_type;
+
+    // same file types as when opened by qsummary, cached ESMRY used when valid
+
+    if (((ext == ".SMSPEC") || (ext == ".FSMSPEC")) && EsmryCache::is_valid(smry_file)) {
+
+        file_type = FileType::ESMRY;
+        m_ext_esmry_loader[case_id] = std::make_unique<Opm::EclIO::ExtESmry>(EsmryCache::cached_file(smry_file));
+
+    } else if (ext == ".FSMSPEC") {
+
+        file_type = FileType::FORMATTED;
+
+    } else if (ext == ".SMSPEC") {
+
+        file_type = FileType::SMSPEC;
+        m_esmry_loader[case_id] = std::make_unique<Opm::EclIO::ESmry>(smry_file);
+
+    } else if (ext == ".ESMRY") {
+
+        file_type = FileType::ESMRY;
+        m_ext_esmry_loader[case_id] = std::make_unique<Opm::EclIO::ExtESmry>(smry_file);
+
+    } else {
+
+        throw std::invalid_argument(smry_file.string() + " is not a summary file");
+    }
+
+    DaemonCase smry_case;
+
+    smry_case.file = smry_file;
+    smry_case.source = make_summary_source(file_type, case_id, m_esmry_loader, m_ext_esmry_loader, smry_file);
+    smry_case.stamp = data_stamp(smry_file);
+
+    m_cases.push_back(std::move(smry_case));
+    m_case_index[smry_file.string()] = case_id;
+
+    std::cout << "opened " << smry_file.string() << std::endl;
+
+    return case_id;
+}
+
+void SmryDaemon::reopen_case(DaemonCase& smry_case)
+{
+    auto stamp = data_stamp(smry_case.file);
+
+    if ((stamp == smry_case.stamp) && (!smry_case.source->has_changed()))
+        return;
+
+    if (smry_case.source->reopen())
+        smry_case.generation++;
+
+    smry_case.stamp = stamp;
+}
+
+DaemonProtocol::CaseInfo SmryDaemon::case_info(uint32_t case_id, bool updated)
+{
+    const SummarySource& source = *m_cases[case_id].source;
+
+    DaemonProtocol::CaseInfo info;
+
+    info.updated = updated;
+    info.case_id = case_id;
+    info.generation = m_cases[case_id].generation;
+    info.rootname = source.rootname();
+    info.startdate_msec = source.startdate().time_since_epoch().count();
+    info.start_date = source.start_date();
+    info.num_steps = source.number_of_time_steps();
+    info.all_steps_available = source.all_steps_available();
+    info.keys = source.keyword_list();
+
+    info.units.reserve(info.keys.size());
+
+    for (auto& key : info.keys)
+        info.units.push_back(source.get_unit(key));
+
+    info.report_step_index = source.report_step_index();
+
+    return info;
+}
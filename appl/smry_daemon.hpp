@@ -0,0 +1,92 @@
+/*
+   Copyright 2022 Equinor ASA.
+
+   This file is part of the Open Porous Media project (OPM).
+
+   OPM is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   OPM is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#ifndef SMRY_APPL_SMRY_DAEMON_HPP
+#define SMRY_APPL_SMRY_DAEMON_HPP
+
+#include <appl/summary_source.hpp>
+#include <appl/daemon_client.hpp>
+
+#include <QObject>
+#include <QLocalServer>
+#include <QLocalSocket>
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+// Resident process (qsummary --daemon) keeping summary cases open and loaded vectors in memory.
+// qsummary started with --use-daemon opens cases through the daemon (DaemonSource), so cases
+// already opened by another window are not opened and loaded again. Cases are kept until the
+// daemon is stopped, and reopened when a client opens or reloads a case changed on disk.
+// Files are read with the permissions of the user running the daemon, so the socket is
+// only accessible for this user and connections from other users are refused.
+
+class SmryDaemon : public QObject {
+
+    Q_OBJECT
+
+public:
+
+    explicit SmryDaemon(const std::string& name, QObject* parent = nullptr);
+
+    // removes a socket left by a daemon that was not stopped
+    bool listen();
+
+    size_t number_of_cases() const { return m_cases.size(); }
+
+    // reply frame for one request frame payload, errors are returned as ERROR frames
+    std::string handle_request(uint8_t type, const char* payload, size_t size);
+
+private slots:
+
+    void new_connection();
+    void read_request();
+
+private:
+
+    struct DaemonCase {
+        std::filesystem::path file;
+        std::unique_ptr<SummarySource> source;
+        uint32_t generation = 0;
+
+        // modification time of UNSMRY, ESMRY or FUNSMRY when opened or reopened
+        std::filesystem::file_time_type stamp;
+    };
+
+    std::filesystem::path m_socket_path;
+    QLocalServer* m_server;
+
+    std::unordered_map<int, std::unique_ptr<Opm::EclIO::ESmry>> m_esmry_loader;
+    std::unordered_map<int, std::unique_ptr<Opm::EclIO::ExtESmry>> m_ext_esmry_loader;
+
+    std::vector<DaemonCase> m_cases;
+    std::unordered_map<std::string, uint32_t> m_case_index;
+
+    // incomplete requests for each client
+    std::unordered_map<QLocalSocket*, std::string> m_buffer;
+
+    uint32_t open_case(const std::filesystem::path& smry_file);
+    void reopen_case(DaemonCase& smry_case);
+    DaemonProtocol::CaseInfo case_info(uint32_t case_id, bool updated);
+};
+
+#endif // SMRY_APPL_SMRY_DAEMON_HPP
@@ -109,154 +109,136 @@ void SmrySeries::onHovered(const QPointF &point, bool state)
 
 QPointF SmrySeries::calculate_closest(const QPointF point)
 {
-    auto vect = this->points();
+    if (m_data.empty())
+        return point;
 
-    qreal ref_x = vect[0].x();
-    qreal ref_y = vect[0].y();
+    size_t ind = m_data.closest(point.x(), point.y());
 
-    qreal dist = pow((ref_x - point.x()), 2.0) + pow((ref_y - point.y()), 2.0) ;
-    dist = pow(dist, 0.5);
-
-    for (size_t n = 1; n < vect.size(); n++) {
-
-        qreal dist_test = pow((vect[n].x() - point.x()), 2.0) + pow((vect[n].y() - point.y()), 2.0) ;
-        dist_test = pow(dist_test, 0.5);
-
-        if (dist_test < dist) {
-            dist = dist_test;
-            ref_x = vect[n].x();
-            ref_y = vect[n].y();
-        }
-    }
-
-    QPointF new_point;
-
-    new_point.setX(ref_x);
-    new_point.setY(ref_y);
-
-    return new_point;
+    return QPointF(static_cast<qreal>(m_data.time()[ind]), m_data.values()[ind]);
 }
 
 void SmrySeries::print_data()
 {
-    auto data = this->points();
+    const auto& time = m_data.time();
+    const auto& values = m_data.values();
 
-    for (size_t n = 0; n < data.size(); n++){
-        std::cout << std::fixed << std::setw(15) << std::setprecision(0) << data[n].x();
-        std::cout << "  " << std::scientific << std::setw(15) << std::setprecision(5) << data[n].y();
+    for (size_t n = 0; n < values.size(); n++){
+        std::cout << std::fixed << std::setw(15) << std::setprecision(0) << static_cast<double>(time[n]);
+        std::cout << "  " << std::scientific << std::setw(15) << std::setprecision(5) << values[n];
         std::cout << std::endl;
     }
 
-    std::cout << "\nsize: " << data.size() << "\n\n";
+    std::cout << "\nsize: " << values.size() << "\n\n";
 }
 
 
-std::tuple<double,double> SmrySeries::get_min_max_value(double xfrom, double xto, bool ignore_zero)
+void SmrySeries::set_data(std::vector<int64_t>&& time_ms, std::vector<double>&& values)
 {
-    // xto are from input yyyy-mm-dd. adding 12 hrs to stuff related to daylight time shift and stuff
+    m_data.assign(std::move(time_ms), std::move(values));
+    m_sliced = false;
 
-    xto = xto + 12.0*3600*1000;   // unit is milliseconds
-
-    double min_y = std::numeric_limits<double>::max();
-    double max_y = std::numeric_limits<double>::min();
+    update_points();
+    calcMinAndMax();
+}
 
-    auto data = this->points();
+void SmrySeries::set_data(std::vector<int64_t>&& time_ms, std::vector<double>&& values, const SmryStats& stats,
+                          float multiplier)
+{
+    m_data.assign(std::move(time_ms), std::move(values), stats, multiplier);
+    m_sliced = false;
 
-    for (size_t n = 0; n < data.size(); n++) {
-        if ((static_cast<double>(data[n].x()) >= xfrom) && (static_cast<double>(data[n].x()) <= xto)) {
-            if ((!ignore_zero) || (static_cast<double>(data[n].y()) != 0.0)) {
+    update_points();
+    calcMinAndMax();
+}
 
-                if ( static_cast<double>(data[n].y()) < min_y)
-                    min_y = static_cast<double>(data[n].y());
+void SmrySeries::append_data(const std::vector<int64_t>& time_ms, const std::vector<double>& values)
+{
+    m_data.append(time_ms, values);
 
-                if ( data[n].y() > max_y)
-                    max_y = static_cast<double>(data[n].y());
-            }
-        }
-    }
+    QList<QPointF> points;
+    points.reserve(values.size());
 
-    if (abs(min_y) < 1e-100)
-        min_y =0.0;
+    for (size_t n = 0; n < values.size(); n++)
+        points.append(QPointF(static_cast<qreal>(time_ms[n]), values[n]));
 
-    if (abs(max_y) < 1e-100)
-        max_y =0.0;
+    this->append(points);
 
-    return std::make_tuple(min_y, max_y);
+    calcMinAndMax();
 }
 
+void SmrySeries::set_time_extent(double min_x, double max_x)
+{
+    m_glob_min_x = min_x;
+    m_glob_max_x = max_x;
+    m_sliced = true;
+}
 
-std::tuple<double,double> SmrySeries::get_min_max_value(bool ignore_zero)
+void SmrySeries::scale_values(double factor)
 {
-    if (!ignore_zero)
-        return std::make_tuple(m_glob_min, m_glob_max);
+    m_data.scale(factor);
 
-    double min_y = std::numeric_limits<double>::max();
-    double max_y = std::numeric_limits<double>::min();
+    update_points();
+    calcMinAndMax();
+}
 
-    auto data = this->points();
+void SmrySeries::update_points()
+{
+    const auto& time = m_data.time();
+    const auto& values = m_data.values();
 
-    for (size_t n = 0; n < data.size(); n++) {
-        if (static_cast<double>(data[n].y()) != 0.0) {
+    QList<QPointF> points;
+    points.reserve(values.size());
 
-            if ( static_cast<double>(data[n].y()) < min_y)
-                min_y = static_cast<double>(data[n].y());
+    for (size_t n = 0; n < values.size(); n++)
+        points.append(QPointF(static_cast<qreal>(time[n]), values[n]));
 
-            if ( data[n].y() > max_y)
-                max_y = static_cast<double>(data[n].y());
-        }
-    }
+    // one replace call, appending point by point emits a signal for each point
+    this->replace(points);
+}
 
-    if (abs(min_y) < 1e-100)
-        min_y =0.0;
 
-    if (abs(max_y) < 1e-100)
-        max_y =0.0;
+std::tuple<double,double> SmrySeries::get_min_max_value(double xfrom, double xto, bool ignore_zero)
+{
+    // xto are from input yyyy-mm-dd. adding 12 hrs to stuff related to daylight time shift and stuff
 
-    return std::make_tuple(min_y, max_y);
+    xto = xto + 12.0*3600*1000;   // unit is milliseconds
+
+    return m_data.min_max_value(xfrom, xto, ignore_zero);
 }
 
 
+std::tuple<double,double> SmrySeries::get_min_max_value(bool ignore_zero)
+{
+    if (!ignore_zero)
+        return std::make_tuple(m_glob_min, m_glob_max);
 
-void SmrySeries::calcMinAndMax(){
+    return m_data.min_max_value(true);
+}
 
-    auto data = this->points();
 
-    for (size_t n = 0; n < data.size(); n++) {
+void SmrySeries::calcMinAndMax(){
 
-        if ( static_cast<double>(data[n].x()) <= m_glob_min_x)
-            m_glob_min_x = static_cast<double>(data[n].x());
+    if (m_data.empty())
+        return;
 
-        if ( static_cast<double>(data[n].y()) <= m_glob_min)
-            m_glob_min = static_cast<double>(data[n].y());
+    m_glob_min = m_data.min_value();
+    m_glob_max = m_data.max_value();
 
-        if ( static_cast<double>(data[n].x()) >= m_glob_max_x)
-            m_glob_max_x = static_cast<double>(data[n].x());
+    if (m_sliced)
+        return;
 
-        if ( static_cast<double>(data[n].y()) >= m_glob_max)
-            m_glob_max = static_cast<double>(data[n].y());
-    }
+    m_glob_min_x = static_cast<double>(m_data.min_time());
+    m_glob_max_x = static_cast<double>(m_data.max_time());
 }
 
 bool SmrySeries::all_values_zero()
 {
-    auto data = this->points();
-
-    for (size_t n = 0; n < data.size(); n++)
-        if (data[n].y() != 0.0)
-            return false;
-
-    return true;
+    return m_data.all_zero();
 }
 
 bool SmrySeries::all_values_nonzero()
 {
-    auto data = this->points();
-
-    for (size_t n = 0; n < data.size(); n++)
-        if (data[n].y() == 0.0)
-            return false;
-
-    return true;
+    return m_data.all_nonzero();
 }
 
 
@@ -297,25 +279,16 @@ std::tuple<QDateTime,QDateTime> SmrySeries::get_nonzero_range()
     dt_max_utc.setDate({1970, 1, 1});
     dt_max_utc.setTime({0, 0, 0});
 
-    if (this->all_values_nonzero()){
+    if (m_data.all_nonzero() || m_data.all_zero()){
         dt_min_utc = dt_min_utc.addMSecs(static_cast<qint64>(m_glob_min_x));
         dt_max_utc = dt_max_utc.addMSecs(static_cast<qint64>(m_glob_max_x));
 
     } else {
 
-        auto data = this->points();
-
-        int n_from = 0;
-        int n_to = data.size() - 1;
-
-        while (data[n_from].y() == 0.0)
-            n_from++;
-
-        while (data[n_to].y() == 0.0)
-            n_to--;
+        const auto& time = m_data.time();
 
-        dt_min_utc = dt_min_utc.addMSecs(static_cast<qint64>(data[n_from].x()));
-        dt_max_utc = dt_max_utc.addMSecs(static_cast<qint64>(data[n_to].x()));
+        dt_min_utc = dt_min_utc.addMSecs(time[m_data.first_nonzero()]);
+        dt_max_utc = dt_max_utc.addMSecs(time[m_data.last_nonzero()]);
     }
 
     return std::make_tuple(dt_min_utc, dt_max_utc);
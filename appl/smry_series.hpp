@@ -20,6 +20,7 @@
 #define SMRY_APPL_SERIES_HPP
 
 #include <appl/point_info.hpp>
+#include <appl/series_data.hpp>
 
 #include <QtCharts>
 #include <QtCharts/QLineSeries>
@@ -53,6 +54,25 @@ public:
 
     void calcMinAndMax();
 
+    // replaces all points, Qt points are derived from the columnar data
+    void set_data(std::vector<int64_t>&& time_ms, std::vector<double>&& values);
+
+    // all values of a loaded vector times multiplier, stats from the stats cache
+    void set_data(std::vector<int64_t>&& time_ms, std::vector<double>&& values, const SmryStats& stats,
+                  float multiplier);
+
+    void scale_values(double factor);
+
+    // adds points after existing points, only the new points are passed to QLineSeries
+    void append_data(const std::vector<int64_t>& time_ms, const std::vector<double>& values);
+
+    // data may hold a time window of the vector, the x-range reported for the
+    // series is then the extent of the full vector
+    void set_time_extent(double min_x, double max_x);
+    bool is_sliced() const { return m_sliced; }
+
+    const SeriesData& data() const { return m_data; }
+
     void setHighlighted(const bool value) {m_highlighted = value;}
     bool isHighlighted() const {return m_highlighted;}
 
@@ -66,13 +86,18 @@ private:
      PointInfo *m_tooltip;
      QChart *m_chart;
 
+     SeriesData m_data;
+
      QPointF calculate_closest(const QPointF point);
+     void update_points();
 
      double m_glob_min;
      double m_glob_max;
 
      double m_glob_min_x;
      double m_glob_max_x;
+
+     bool m_sliced = false;
      
      bool m_highlighted = false; 
 };
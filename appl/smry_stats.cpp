@@ -0,0 +1,126 @@
+/*
+   Copyright 2022 Equinor ASA.
+
+   This file is part of the Open Porous Media project (OPM).
+
+   OPM is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   OPM is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#include <appl/smry_stats.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+
+SmryStats make_smry_stats(const std::vector<float>& data)
+{
+    SmryStats stats;
+
+    stats.size = data.size();
+
+    if (data.empty())
+        return stats;
+
+    stats.min = std::numeric_limits<float>::max();
+    stats.max = std::numeric_limits<float>::lowest();
+
+    stats.min_nonzero = std::numeric_limits<float>::max();
+    stats.max_nonzero = std::numeric_limits<float>::lowest();
+
+    // values for P90, NaN is not ordered and can not be used with nth_element
+
+    std::vector<float> tmp;
+    tmp.reserve(data.size());
+
+    for (size_t n = 0; n < data.size(); n++) {
+
+        const float v = data[n];
+
+        if (std::isnan(v)) {
+            stats.has_nan = true;
+            continue;
+        }
+
+        tmp.push_back(v);
+
+        stats.min = std::min(stats.min, v);
+        stats.max = std::max(stats.max, v);
+
+        if (v != 0.0f) {
+            if (stats.first_nonzero < 0)
+                stats.first_nonzero = static_cast<long>(n);
+
+            stats.last_nonzero = static_cast<long>(n);
+
+            stats.min_nonzero = std::min(stats.min_nonzero, v);
+            stats.max_nonzero = std::max(stats.max_nonzero, v);
+        } else {
+            stats.all_nonzero = false;
+        }
+    }
+
+    stats.all_zero = stats.first_nonzero < 0;
+
+    if (stats.all_zero) {
+        stats.min_nonzero = 0.0;
+        stats.max_nonzero = 0.0;
+    }
+
+    if (tmp.empty()) {
+        stats.min = 0.0;
+        stats.max = 0.0;
+
+        return stats;
+    }
+
+    // same as sorted data at index size * 0.9
+
+    size_t p = static_cast<size_t>(tmp.size() * 0.9);
+    std::nth_element(tmp.begin(), tmp.begin() + p, tmp.end());
+
+    stats.p90 = tmp[p];
+
+    return stats;
+}
+
+
+const SmryStats& SmryStatsCache::get(size_t smry_ind, const std::string& key, const std::vector<float>& data)
+{
+    auto& case_stats = m_stats.at(smry_ind);
+
+    auto it = case_stats.find(key);
+
+    if (it != case_stats.end())
+        return it->second;
+
+    return case_stats.emplace(key, make_smry_stats(data)).first->second;
+}
+
+
+const SmryStats* SmryStatsCache::find(size_t smry_ind, const std::string& key) const
+{
+    if (smry_ind >= m_stats.size())
+        return nullptr;
+
+    auto it = m_stats[smry_ind].find(key);
+
+    return it != m_stats[smry_ind].end() ? &it->second : nullptr;
+}
+
+
+void SmryStatsCache::invalidate(size_t smry_ind)
+{
+    if (smry_ind < m_stats.size())
+        m_stats[smry_ind].clear();
+}
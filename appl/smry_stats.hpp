@@ -0,0 +1,83 @@
+/*
+   Copyright 2022 Equinor ASA.
+
+   This file is part of the Open Porous Media project (OPM).
+
+   OPM is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   OPM is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#ifndef SMRY_APPL_SMRY_STATS_HPP
+#define SMRY_APPL_SMRY_STATS_HPP
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+// Statistics for one summary vector as loaded from file. Computed once, min, max
+// and nonzero range in one pass over the data and P90 with a partial sort. NaN
+// values (time steps without data in restart chains) are not included.
+
+struct SmryStats {
+
+    float min = 0.0;
+    float max = 0.0;
+    float p90 = 0.0;
+
+    // min and max of nonzero values
+    float min_nonzero = 0.0;
+    float max_nonzero = 0.0;
+
+    // index of first and last nonzero value, -1 if all values are zero
+    long first_nonzero = -1;
+    long last_nonzero = -1;
+
+    bool all_zero = true;
+    bool all_nonzero = true;
+    bool has_nan = false;
+
+    size_t size = 0;
+};
+
+SmryStats make_smry_stats(const std::vector<float>& data);
+
+
+// Stats for each case and vector name. Entries for different cases can be added from
+// different threads, the number of cases must be set before this.
+
+class SmryStatsCache {
+
+public:
+
+    SmryStatsCache() = default;
+    explicit SmryStatsCache(size_t num_cases) : m_stats(num_cases) {}
+
+    void resize(size_t num_cases) { m_stats.resize(num_cases); }
+    size_t number_of_cases() const { return m_stats.size(); }
+
+    // stats computed from data if not already in cache
+    const SmryStats& get(size_t smry_ind, const std::string& key, const std::vector<float>& data);
+
+    // nullptr if not in cache
+    const SmryStats* find(size_t smry_ind, const std::string& key) const;
+
+    // all vectors for a case, when the case is reloaded
+    void invalidate(size_t smry_ind);
+
+private:
+
+    std::vector<std::unordered_map<std::string, SmryStats>> m_stats;
+};
+
+#endif // SMRY_APPL_SMRY_STATS_HPP
@@ -140,7 +140,7 @@ bool SmryXaxis::get_datetime_from_string(std::string str_arg, QDateTime& dt)
 }
 
 
-bool SmryXaxis::set_range(std::string argstr)
+bool SmryXaxis::parse_range(std::string argstr, QDateTime& from, QDateTime& to)
 {
     if (argstr.substr(0,7) == ":xrange")
         argstr = argstr.substr(8);
@@ -172,6 +172,20 @@ bool SmryXaxis::set_range(std::string argstr)
     if (dt1 > dt2)
         return false;
 
+    from = dt1;
+    to = dt2;
+
+    return true;
+}
+
+bool SmryXaxis::set_range(std::string argstr)
+{
+    QDateTime dt1;
+    QDateTime dt2;
+
+    if (not parse_range(argstr, dt1, dt2))
+        return false;
+
     xrange_from = dt1;
     xrange_to = dt2;
 
@@ -192,10 +206,10 @@ void SmryXaxis::print_time_string(qint64 ms)
 }
 
 
-std::string SmryXaxis::get_month_string(int ind)
+const char* SmryXaxis::get_month_string(int ind)
 {
-    std::vector<std::string> month_list;
-    month_list = {"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+    static const char* month_list[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+                                       "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
 
     if ((ind < 0) || (ind > 11))
         throw std::runtime_error("month index " + std::to_string(ind) + " out of range" );
@@ -204,9 +218,65 @@ std::string SmryXaxis::get_month_string(int ind)
 }
 
 
-SmryXaxis::tick_type SmryXaxis::make_raw_list(int nThick)
+QString SmryXaxis::tick_label(TickType type, const QDateTime& dt)
+{
+    // labels are cached on granularity and time stamp, when panning most of
+    // the ticks in the new range has already been formatted.
+
+    auto& cache = m_label_cache[static_cast<size_t>(type)];
+
+    qint64 ms = dt.toMSecsSinceEpoch();
+
+    auto it = cache.find(ms);
+
+    if (it != cache.end())
+        return it->second;
+
+    if (cache.size() > max_cached_labels)
+        cache.clear();
+
+    QDate d = dt.date();
+    QTime t = dt.time();
+
+    const char* month = get_month_string(d.month() - 1);
+
+    char buf[40];
+
+    switch (type) {
+    case TickType::year:
+        snprintf(buf, sizeof(buf), "%d", d.year());
+        break;
+    case TickType::month:
+        snprintf(buf, sizeof(buf), "%s %d", month, d.year());
+        break;
+    case TickType::day:
+        snprintf(buf, sizeof(buf), "%02d %s %d", d.day(), month, d.year());
+        break;
+    case TickType::hour:
+        snprintf(buf, sizeof(buf), "%02d %s %d %02d:00", d.day(), month, d.year(), t.hour());
+        break;
+    case TickType::minute:
+        snprintf(buf, sizeof(buf), "%02d %s %d %02d:%02d", d.day(), month, d.year(), t.hour(), t.minute());
+        break;
+    case TickType::second:
+        snprintf(buf, sizeof(buf), "%02d %s %d %02d:%02d:%02d", d.day(), month, d.year(),
+                 t.hour(), t.minute(), t.second());
+        break;
+    case TickType::raw:
+        snprintf(buf, sizeof(buf), "%02d %s %d %02d:%02d:%02d.%03d", d.day(), month, d.year(),
+                 t.hour(), t.minute(), t.second(), t.msec());
+        break;
+    }
+
+    QString lbl = QString::fromLatin1(buf);
+    cache.emplace(ms, lbl);
+
+    return lbl;
+}
+
+
+void SmryXaxis::make_raw_list(int nThick)
 {
-    SmryXaxis::tick_type tick_list;
     double ms1 = static_cast<double>(m_dt_min_utc.toMSecsSinceEpoch());
     double ms2 = static_cast<double>(m_dt_max_utc.toMSecsSinceEpoch());
 
@@ -214,24 +284,10 @@ SmryXaxis::tick_type SmryXaxis::make_raw_list(int nThick)
 
     double step_msecs = diff_msecs / nThick;
 
-    int y1 = m_dt_min_utc.date().year();
-    int m1 = m_dt_min_utc.date().month();
-    int d1 = m_dt_min_utc.date().day();
-    int h1 = m_dt_min_utc.time().hour();
-    int mm1 = m_dt_min_utc.time().minute();
-    int s1 = m_dt_min_utc.time().second();
-    int msec1 = m_dt_min_utc.time().msec();
-
-    QDate d;
-    d.setDate(y1, m1, d1);
-
-    QDateTime dt;
+    QDateTime dt = m_dt_min_utc;
 
     QTimeZone  tz(0);
 
-    dt.setDate(d);
-
-    dt.setTime({ h1, mm1, s1, msec1 });
     dt.setTimeZone(tz);
     dt = dt.addMSecs(step_msecs);
 
@@ -240,24 +296,8 @@ SmryXaxis::tick_type SmryXaxis::make_raw_list(int nThick)
     while (dt < m_dt_max_utc){
 
         double frac = (static_cast<double>(dt.toMSecsSinceEpoch()) - ms1) / ( ms2 - ms1);
-        int ms = dt.time().msec();
-        int s = dt.time().second();
-        int mi = dt.time().minute();
-        int h = dt.time().hour();
-        int d = dt.date().day();
-        int m = dt.date().month() - 1;
-        int y = dt.date().year();
-
-        std::ostringstream str;
-        str << std::setw(2) << std::setfill('0') << d << " " << get_month_string(m) << " " << y;
-        str << " " << std::setw(2) << std::setfill('0') << h << ":";
-        str << std::setw(2) << std::setfill('0') << mi << ":";
-        str << std::setw(2) << std::setfill('0') << s;
-        str << "." << std::setw(3) << std::setfill('0') << ms;
-
-        std::string lbl_str = str.str();
-
-        tick_list.push_back( {lbl_str, frac});
+
+        m_raw_ticks.emplace_back(tick_label(TickType::raw, dt), frac);
         dt = dt.addMSecs(step_msecs);
 
         n++;
@@ -267,18 +307,13 @@ SmryXaxis::tick_type SmryXaxis::make_raw_list(int nThick)
             exit(1);
         }
     }
-
-    return tick_list;
 }
 
-SmryXaxis::tick_type SmryXaxis::make_second_list()
+void SmryXaxis::make_second_list()
 {
-    SmryXaxis::tick_type tick_list;
-
     double ms1 = static_cast<double>(m_dt_min_utc.toMSecsSinceEpoch());
     double ms2 = static_cast<double>(m_dt_max_utc.toMSecsSinceEpoch());
 
-    double diff_hrs = (ms2 - ms1) / (1000*3600);
     double diff_second = (ms2 - ms1) / 1000;
 
     int y1 = m_dt_min_utc.date().year();
@@ -326,37 +361,18 @@ SmryXaxis::tick_type SmryXaxis::make_second_list()
     while (dt < m_dt_max_utc){
 
         double frac = (static_cast<double>(dt.toMSecsSinceEpoch()) - ms1) / ( ms2 - ms1);
-        int s = dt.time().second();
-        int mi = dt.time().minute();
-        int h = dt.time().hour();
-        int d = dt.date().day();
-        int m = dt.date().month() - 1;
-        int y = dt.date().year();
-
-        std::ostringstream str;
-        str << std::setw(2) << std::setfill('0') << d << " " << get_month_string(m) << " " << y;
-        str << " " << std::setw(2) << std::setfill('0') << h << ":";
-        str << std::setw(2) << std::setfill('0') << mi << ":";
-        str << std::setw(2) << std::setfill('0') << s;
-
-        std::string lbl_str = str.str();
-
-        tick_list.push_back( {lbl_str, frac});
+
+        m_raw_ticks.emplace_back(tick_label(TickType::second, dt), frac);
         dt = dt.addSecs(step_seconds);
     }
-
-    return tick_list;
 }
 
 
-SmryXaxis::tick_type SmryXaxis::make_minute_list()
+void SmryXaxis::make_minute_list()
 {
-    SmryXaxis::tick_type tick_list;
-
     double ms1 = static_cast<double>(m_dt_min_utc.toMSecsSinceEpoch());
     double ms2 = static_cast<double>(m_dt_max_utc.toMSecsSinceEpoch());
 
-    double diff_hrs = (ms2 - ms1) / (1000*3600);
     double diff_minute = (ms2 - ms1) / (1000*60);
 
     int y1 = m_dt_min_utc.date().year();
@@ -403,35 +419,17 @@ SmryXaxis::tick_type SmryXaxis::make_minute_list()
     while (dt < m_dt_max_utc){
 
         double frac = (static_cast<double>(dt.toMSecsSinceEpoch()) - ms1) / ( ms2 - ms1);
-        int mi = dt.time().minute();
-        int h = dt.time().hour();
-        int d = dt.date().day();
-        int m = dt.date().month() - 1;
-        int y = dt.date().year();
-
-        std::ostringstream str;
-        str << std::setw(2) << std::setfill('0') << d << " " << get_month_string(m) << " " << y;
-        str << " " << std::setw(2) << std::setfill('0') << h << ":";
-        str << std::setw(2) << std::setfill('0') << mi;
-
-        std::string lbl_str = str.str();
 
-        tick_list.push_back( {lbl_str, frac});
+        m_raw_ticks.emplace_back(tick_label(TickType::minute, dt), frac);
         dt = dt.addSecs(step_minutes*60);
     }
-
-    return tick_list;
 }
 
-SmryXaxis::tick_type SmryXaxis::make_hr_list()
+void SmryXaxis::make_hr_list()
 {
-    SmryXaxis::tick_type tick_list;
-
     double ms1 = static_cast<double>(m_dt_min_utc.toMSecsSinceEpoch());
     double ms2 = static_cast<double>(m_dt_max_utc.toMSecsSinceEpoch());
 
-    double diff_hrs = (ms2 - ms1) / (1000*3600);
-
     int y1 = m_dt_min_utc.date().year();
     int m1 = m_dt_min_utc.date().month();
     int d1 = m_dt_min_utc.date().day();
@@ -453,29 +451,15 @@ SmryXaxis::tick_type SmryXaxis::make_hr_list()
     while (dt < m_dt_max_utc){
 
         double frac = (static_cast<double>(dt.toMSecsSinceEpoch()) - ms1) / ( ms2 - ms1);
-        int h = dt.time().hour();
-        int d = dt.date().day();
-        int m = dt.date().month() - 1;
-        int y = dt.date().year();
-
-        std::ostringstream str;
-        str << std::setw(2) << std::setfill('0') << d << " " << get_month_string(m) << " " << y;
-        str << " " << std::setw(2) << std::setfill('0') << h << ":00";
 
-        std::string lbl_str = str.str();
-
-        tick_list.push_back( {lbl_str, frac});
+        m_raw_ticks.emplace_back(tick_label(TickType::hour, dt), frac);
         dt = dt.addSecs(3600);
     }
-
-    return tick_list;
 }
 
 
-SmryXaxis::tick_type SmryXaxis::make_day_list()
+void SmryXaxis::make_day_list()
 {
-    SmryXaxis::tick_type tick_list;
-
     double ms1 = static_cast<double>(m_dt_min_utc.toMSecsSinceEpoch());
     double ms2 = static_cast<double>(m_dt_max_utc.toMSecsSinceEpoch());
 
@@ -499,27 +483,15 @@ SmryXaxis::tick_type SmryXaxis::make_day_list()
     while (dt < m_dt_max_utc){
 
         double frac = (static_cast<double>(dt.toMSecsSinceEpoch()) - ms1) / ( ms2 - ms1);
-        int d = dt.date().day();
-        int m = dt.date().month() - 1;
-        int y = dt.date().year();
-
-        std::ostringstream str;
-        str << std::setw(2) << std::setfill('0') << d << " " << get_month_string(m) << " " << y;
 
-        std::string lbl_str = str.str();
-
-        tick_list.push_back( {lbl_str, frac});
+        m_raw_ticks.emplace_back(tick_label(TickType::day, dt), frac);
         dt = dt.addDays(1);
     }
-
-    return tick_list;
 }
 
 
-SmryXaxis::tick_type SmryXaxis::make_month_list()
+void SmryXaxis::make_month_list()
 {
-    SmryXaxis::tick_type tick_list;
-
     double ms1 = static_cast<double>(m_dt_min_utc.toMSecsSinceEpoch());
     double ms2 = static_cast<double>(m_dt_max_utc.toMSecsSinceEpoch());
 
@@ -544,20 +516,14 @@ SmryXaxis::tick_type SmryXaxis::make_month_list()
     while (dt < m_dt_max_utc){
 
         double frac = (static_cast<double>(dt.toMSecsSinceEpoch()) - ms1) / ( ms2 - ms1);
-        int m = dt.date().month() - 1;
-        int y = dt.date().year();
-        std::string lbl_str = get_month_string(m) + " " + std::to_string(y);
-        tick_list.push_back( {lbl_str, frac});
+
+        m_raw_ticks.emplace_back(tick_label(TickType::month, dt), frac);
         dt = dt.addMonths(1);
     }
-
-    return tick_list;
 }
 
-SmryXaxis::tick_type SmryXaxis::make_year_list()
+void SmryXaxis::make_year_list()
 {
-    SmryXaxis::tick_type tick_list;
-
     double ms1 = static_cast<double>(m_dt_min_utc.toMSecsSinceEpoch());
     double ms2 = static_cast<double>(m_dt_max_utc.toMSecsSinceEpoch());
 
@@ -576,13 +542,10 @@ SmryXaxis::tick_type SmryXaxis::make_year_list()
     while (dt < m_dt_max_utc){
 
         double frac = (static_cast<double>(dt.toMSecsSinceEpoch()) - ms1) / ( ms2 - ms1);
-        int y = dt.date().year();
-        std::string lbl_str = std::to_string(y);
-        tick_list.push_back( {lbl_str, frac});
+
+        m_raw_ticks.emplace_back(tick_label(TickType::year, dt), frac);
         dt = dt.addYears(1);
     }
-
-    return tick_list;
 }
 
 void SmryXaxis::rangeChanged(QDateTime min, QDateTime max)
@@ -613,67 +576,56 @@ void SmryXaxis::rangeChanged(QDateTime min, QDateTime max)
         this->setRange(m_dt_min_utc, m_dt_max_utc);
     }
 
-    double diff = static_cast<double>(ms_max - ms_min);
-    diff = diff / (1000*3600*24);
-
-
-    QString dt1_qstr = m_dt_min_utc.toString("yyyy-MM-dd HH:mm:ss.zzz");
-    QString dt2_qstr = m_dt_max_utc.toString("yyyy-MM-dd HH:mm:ss.zzz");
-
     double  diff_days = static_cast<double>(ms_max - ms_min) / static_cast<double>(1000*60*60*24);
 
-    std::vector<std::tuple<std::string, double>> raw_ticks_vect;
+    // m_raw_ticks and m_ticks keep their capacity between calls
+
+    m_raw_ticks.clear();
 
     int max_ticks;
 
     if (diff_days > 2000) {
-        raw_ticks_vect = make_year_list();
+        make_year_list();
         max_ticks = 20;
     } else if (diff_days > 60) {
-        raw_ticks_vect = make_month_list();
+        make_month_list();
         max_ticks = 10;
     } else if (diff_days > 3) {
-        raw_ticks_vect = make_day_list();
+        make_day_list();
         max_ticks = 8;
     } else if (diff_days > 0.1) {
-        raw_ticks_vect = make_hr_list();
+        make_hr_list();
         max_ticks = 8;
     } else if (diff_days > 0.0015) {
-        raw_ticks_vect = make_minute_list();
+        make_minute_list();
         max_ticks = 6;
 
     } else if (diff_days > 0.000035) {
-        raw_ticks_vect = make_second_list();
+        make_second_list();
         max_ticks = 6;
     } else {
         max_ticks = 4;
-        raw_ticks_vect = make_raw_list(max_ticks);
+        make_raw_list(max_ticks);
     }
 
-    std::vector<std::tuple<std::string, double>> ticks_vect;
+    m_ticks.clear();
 
-    if (raw_ticks_vect.size() >  max_ticks){
-        int num_ticks = static_cast<int>(raw_ticks_vect.size());
+    int num_ticks = static_cast<int>(m_raw_ticks.size());
+    int step = 1;
 
-        int step = static_cast<int>(num_ticks / max_ticks);
+    if (num_ticks >  max_ticks){
+
+        step = static_cast<int>(num_ticks / max_ticks);
         int rest = num_ticks % max_ticks;
 
         if (rest > 0)
             step++;
-
-        int i = 0;
-
-        while (i < num_ticks){
-            ticks_vect.push_back(raw_ticks_vect[i]);
-            i = i + step;
-        }
-
-    } else {
-
-        ticks_vect = raw_ticks_vect;
     }
 
-    m_chart_view->set_xaxis_ticks(ticks_vect);
+    for (int i = 0; i < num_ticks; i = i + step)
+        m_ticks.push_back(m_raw_ticks[i]);
+
+    m_chart_view->set_xaxis_ticks(m_ticks);
     m_chart_view->update_geometry();
 }
 
@@ -22,6 +22,8 @@
 #include <random>
 #include <iostream>
 #include <math.h>
+#include <array>
+#include <unordered_map>
 
 #include <appl/chartview.hpp>
 
@@ -29,10 +31,11 @@ class SmryXaxis: public QDateTimeAxis {
 
 public:
 
-    using tick_type = std::vector<std::tuple<std::string, double>>;
+    using tick_type = XaxisTicks::tick_list_type;
 
     SmryXaxis(ChartView *chart_view, QObject *parent = nullptr);
 
+    static bool parse_range(std::string argstr, QDateTime& from, QDateTime& to);
     bool set_range(std::string argstr);
     void set_full_range(double min, double max);
     bool has_xrange() { return xrange_set; }
@@ -58,18 +61,21 @@ private:
 
     void print_time_string(qint64 ms);
 
-    tick_type make_raw_list(int nThick);
+    enum class TickType { year, month, day, hour, minute, second, raw };
 
-    tick_type make_second_list();
-    tick_type make_minute_list();
-    tick_type make_hr_list();
-    tick_type make_day_list();
-    tick_type make_month_list();
-    tick_type make_year_list();
+    void make_raw_list(int nThick);
 
-    std::string get_month_string(int ind);
+    void make_second_list();
+    void make_minute_list();
+    void make_hr_list();
+    void make_day_list();
+    void make_month_list();
+    void make_year_list();
 
-    bool get_datetime_from_string(std::string str_arg, QDateTime& dt);
+    const char* get_month_string(int ind);
+    QString tick_label(TickType type, const QDateTime& dt);
+
+    static bool get_datetime_from_string(std::string str_arg, QDateTime& dt);
 
     QDateTime m_dt_min_utc;
     QDateTime m_dt_max_utc;
@@ -84,6 +90,12 @@ private:
 
     ChartView *m_chart_view;
 
+    tick_type m_raw_ticks;
+    tick_type m_ticks;
+
+    const size_t max_cached_labels = 5000;
+    std::array<std::unordered_map<qint64, QString>, 7> m_label_cache;
+
 };
 
 
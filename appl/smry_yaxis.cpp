@@ -44,11 +44,9 @@ void SmryYaxis::update_series_data(AxisMultiplierType mult_type, float mult, con
     for (size_t n = 0; n < series.size(); n++){
         if (series[n]->attachedAxes()[1] == this){
 
-            auto vect = series[n]->points();
             auto new_mult = mult / axis_multiplier;
 
-            for (size_t i = 0; i < vect.size(); i++)
-                series[n]->replace(i, vect[i].x(), vect[i].y() * new_mult );
+            series[n]->scale_values(new_mult);
         }
     }
 
@@ -59,19 +57,7 @@ void SmryYaxis::update_series_data(AxisMultiplierType mult_type, float mult, con
 
 void SmryYaxis::update_axis_multiplier(const std::vector<SmrySeries*>& series)
 {
-    std::vector<std::vector<float>> yvalues;
-
-    for (size_t n = 0; n < series.size(); n++){
-
-        yvalues.push_back({});
-
-        if (series[n]->attachedAxes()[1] == this){
-            auto vect = series[n]->points();
-
-            for (size_t i = 0; i < vect.size(); i++)
-                yvalues[n].push_back(static_cast<float>(vect[i].y()/multiplier()));
-        }
-    }
+    // P90 from series statistics, stored with current multiplier applied
 
     AxisMultiplierType updated_axis_multiplier_type = AxisMultiplierType::one;
 
@@ -79,7 +65,7 @@ void SmryYaxis::update_axis_multiplier(const std::vector<SmrySeries*>& series)
 
         if (series[n]->attachedAxes()[1] == this) {
 
-            float p90v = calc_p90(yvalues[n]);
+            float p90v = static_cast<float>(series[n]->data().p90() / multiplier());
 
             if (p90v > 1.0e9)
                 updated_axis_multiplier_type = AxisMultiplierType::billion;
@@ -107,12 +93,8 @@ void SmryYaxis::update_axis_multiplier(const std::vector<SmrySeries*>& series)
         }
 
         for (size_t n = 0; n < series.size(); n++){
-            if (series[n]->attachedAxes()[1] == this){
-                auto vect = series[n]->points();
-
-                for (size_t i = 0; i < vect.size(); i++)
-                    series[n]->replace(i, vect[i].x(), vect[i].y() / axis_multiplier * updated_multiplier );
-            }
+            if (series[n]->attachedAxes()[1] == this)
+                series[n]->scale_values(static_cast<double>(updated_multiplier) / axis_multiplier);
         }
 
         axis_multiplier = updated_multiplier;
@@ -171,17 +153,6 @@ void SmryYaxis::view_title()
 }
 
 
-float SmryYaxis::calc_p90(const std::vector<float>& data)
-{
-    auto tmp = data;
-
-    std::sort(tmp.begin(), tmp.end());
-    size_t  p = static_cast<size_t>(tmp.size() * 0.9) ;
-
-    return tmp[p];
-}
-
-
 void SmryYaxis::setMinAndMax(double min_val, double max_val)
 {
    m_min = min_val;
@@ -59,8 +59,6 @@ private:
 
    std::vector<std::string> m_titles;
 
-   float calc_p90(const std::vector<float>& data);
-
    float axis_multiplier;
 
    AxisMultiplierType axis_multiplier_type;
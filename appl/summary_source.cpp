@@ -0,0 +1,250 @@
+/*
+   Copyright 2022 Equinor ASA.
+
+   This file is part of the Open Porous Media project (OPM).
+
+   OPM is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   OPM is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#include <appl/summary_source.hpp>
+#include <appl/esmry_cache.hpp>
+#include <appl/unsmry_reader.hpp>
+#include <appl/formatted_smry.hpp>
+
+#include <ctime>
+#include <numeric>
+#include <stdexcept>
+
+
+SummarySource::SummarySource(const std::filesystem::path& file) :
+    m_file(file)
+{
+    this->update_file_stamp();
+}
+
+void SummarySource::update_file_stamp()
+{
+    std::error_code ec;
+
+    if (!m_file.empty())
+        m_file_stamp = std::filesystem::last_write_time(m_file, ec);
+
+    this->reset_report_step_index();
+}
+
+SmrySpan SummarySource::get_span(const std::string& key) const
+{
+    const std::vector<float>& data = this->get(key);
+
+    return { data.data(), data.size() };
+}
+
+const std::vector<size_t>& SummarySource::report_step_index() const
+{
+    int num_steps = this->number_of_time_steps();
+
+    if (num_steps != m_rstep_num_steps) {
+        m_rstep_index = this->make_report_step_index();
+        m_rstep_num_steps = num_steps;
+    }
+
+    return m_rstep_index;
+}
+
+std::vector<size_t> SummarySource::make_report_step_index() const
+{
+    std::vector<size_t> index(this->get("TIME").size());
+    std::iota(index.begin(), index.end(), 0);
+
+    return index;
+}
+
+SummarySource::time_point make_startdate(const std::array<int, 7>& start_date)
+{
+    std::tm tm_start {};
+
+    tm_start.tm_mday = start_date[0];
+    tm_start.tm_mon = start_date[1] - 1;
+    tm_start.tm_year = start_date[2] - 1900;
+    tm_start.tm_hour = start_date[3];
+    tm_start.tm_min = start_date[4];
+    tm_start.tm_sec = start_date[5];
+
+    int64_t msec = static_cast<int64_t>(timegm(&tm_start)) * 1000 + start_date[6];
+
+    return SummarySource::time_point(std::chrono::milliseconds(msec));
+}
+
+bool SummarySource::has_changed() const
+{
+    if (m_file.empty())
+        return false;
+
+    std::error_code ec;
+    auto ftime = std::filesystem::last_write_time(m_file, ec);
+
+    if (ec)
+        return false;
+
+    return ftime > m_file_stamp;
+}
+
+
+template <typename T>
+LoaderSource<T>::LoaderSource(std::unique_ptr<T>& loader, const std::filesystem::path& file) :
+    SummarySource(file), m_loader(loader)
+{
+}
+
+template <>
+FileType LoaderSource<Opm::EclIO::ESmry>::file_type() const
+{
+    return FileType::SMSPEC;
+}
+
+template <>
+FileType LoaderSource<Opm::EclIO::ExtESmry>::file_type() const
+{
+    return FileType::ESMRY;
+}
+
+template <typename T>
+std::vector<std::string> LoaderSource<T>::keyword_list() const
+{
+    return m_loader->keywordList();
+}
+
+template <typename T>
+std::vector<std::string> LoaderSource<T>::keyword_list(const std::string& pattern) const
+{
+    return m_loader->keywordList(pattern);
+}
+
+template <>
+std::array<int, 7> LoaderSource<Opm::EclIO::ESmry>::start_date() const
+{
+    // SMSPEC start date holds seconds and microseconds in one item
+
+    auto start_vect = m_loader->start_v();
+
+    int sec = start_vect[5] / 1000000;
+    int millisec = (start_vect[5] % 1000000) / 1000;
+
+    return { start_vect[0], start_vect[1], start_vect[2], start_vect[3], start_vect[4], sec, millisec };
+}
+
+template <>
+std::array<int, 7> LoaderSource<Opm::EclIO::ExtESmry>::start_date() const
+{
+    auto start_vect = m_loader->start_v();
+
+    return { start_vect[0], start_vect[1], start_vect[2], start_vect[3], start_vect[4], start_vect[5], start_vect[6] };
+}
+
+template <typename T>
+void LoaderSource<T>::load(const std::vector<std::string>& keys)
+{
+    if (keys.size() > 0)
+        m_loader->loadData(keys);
+}
+
+template <typename T>
+std::vector<size_t> LoaderSource<T>::make_report_step_index() const
+{
+    return rstep_time_index(m_loader->get("TIME"), m_loader->get_at_rstep("TIME"));
+}
+
+template <typename T>
+bool LoaderSource<T>::reopen()
+{
+    if (m_file.empty())
+        return false;
+
+    std::unique_ptr<T> smry_tmp;
+
+    try {
+        smry_tmp = std::make_unique<T> ( m_file );
+    } catch (...) {
+        std::string message = "Error with reopen loader, failed when opening summary file " + m_file.string();
+        throw std::runtime_error(message);
+    }
+
+    bool updated = this->has_changed() || (smry_tmp->numberOfTimeSteps() > m_loader->numberOfTimeSteps());
+
+    if (updated) {
+        m_loader = std::move ( smry_tmp );
+        this->update_file_stamp();
+    }
+
+    return updated;
+}
+
+template class LoaderSource<Opm::EclIO::ESmry>;
+template class LoaderSource<Opm::EclIO::ExtESmry>;
+
+
+std::vector<size_t> rstep_time_index(const std::vector<float>& time, const std::vector<float>& rstep_time)
+{
+    std::vector<size_t> index;
+    index.reserve(rstep_time.size());
+
+    for (size_t t = 0; (t < time.size()) && (index.size() < rstep_time.size()); t++)
+        if (time[t] == rstep_time[index.size()])
+            index.push_back(t);
+
+    return index;
+}
+
+
+std::unique_ptr<SummarySource> make_summary_source(FileType file_type, int smry_ind,
+                                      std::unordered_map<int, std::unique_ptr<Opm::EclIO::ESmry>>& esmry_loader,
+                                      std::unordered_map<int, std::unique_ptr<Opm::EclIO::ExtESmry>>& lodsmry_loader,
+                                      const std::filesystem::path& smry_file)
+{
+    if ((file_type == FileType::SMSPEC) && (smry_file.extension() == ".SMSPEC")
+            && std::filesystem::exists(std::filesystem::path(smry_file).replace_extension(".UNSMRY")))
+        return std::make_unique<UnsmrySource>(esmry_loader.at(smry_ind), smry_file);
+    else if (file_type == FileType::SMSPEC)
+        return std::make_unique<ESmrySource>(esmry_loader.at(smry_ind), smry_file);
+    else if ((file_type == FileType::ESMRY) && ((smry_file.extension() == ".SMSPEC") || (smry_file.extension() == ".FSMSPEC")))
+        return std::make_unique<CachedEsmrySource>(esmry_loader[smry_ind], lodsmry_loader.at(smry_ind), smry_file);
+    else if (file_type == FileType::ESMRY)
+        return std::make_unique<ExtESmrySource>(lodsmry_loader.at(smry_ind), smry_file);
+    else if (file_type == FileType::FORMATTED)
+        return std::make_unique<FormattedSource>(smry_file);
+    else if ((file_type == FileType::REMOTE) || (file_type == FileType::RESTART))
+        throw std::invalid_argument("source for case " + std::to_string(smry_ind + 1) + " must be opened by the caller");
+
+    throw std::invalid_argument("invalid summary file type");
+}
+
+source_list_type make_summary_sources(const std::vector<FileType>& file_type,
+                                      std::unordered_map<int, std::unique_ptr<Opm::EclIO::ESmry>>& esmry_loader,
+                                      std::unordered_map<int, std::unique_ptr<Opm::EclIO::ExtESmry>>& lodsmry_loader,
+                                      const std::vector<std::filesystem::path>& smry_files,
+                                      source_list_type opened_sources)
+{
+    source_list_type sources = std::move(opened_sources);
+    sources.resize(file_type.size());
+
+    for (size_t n = 0; n < file_type.size(); n++){
+
+        if (sources[n] != nullptr)
+            continue;
+
+        std::filesystem::path smry_file = n < smry_files.size() ? smry_files[n] : std::filesystem::path();
+        sources[n] = make_summary_source(file_type[n], n, esmry_loader, lodsmry_loader, smry_file);
+    }
+
+    return sources;
+}
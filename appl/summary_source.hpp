@@ -0,0 +1,209 @@
+/*
+   Copyright 2022 Equinor ASA.
+
+   This file is part of the Open Porous Media project (OPM).
+
+   OPM is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   OPM is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#ifndef SMRY_APPL_SUMMARY_SOURCE_HPP
+#define SMRY_APPL_SUMMARY_SOURCE_HPP
+
+#include <opm/io/eclipse/ESmry.hpp>
+#include <opm/io/eclipse/ExtESmry.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+
+// FORMATTED: FSMSPEC/FUNSMRY case parsed in memory, see formatted_smry.hpp
+// LIVE: data pushed from a running simulator, see live_source.hpp
+// REMOTE: case opened by a summary daemon, see daemon_client.hpp
+// RESTART: restart case joined with its base runs, see restart_chain.hpp
+enum class FileType{ SMSPEC, ESMRY, FORMATTED, LIVE, REMOTE, RESTART };
+
+
+// Read only view of vector data owned by a summary source. Valid until the source
+// is reopened.
+
+struct SmrySpan {
+
+    const float* data = nullptr;
+    size_t size = 0;
+
+    const float* begin() const { return data; }
+    const float* end() const { return data + size; }
+    bool empty() const { return size == 0; }
+    float operator[](size_t n) const { return data[n]; }
+};
+
+
+// One summary case independent of file format. Callers go through this interface instead
+// of branching on FileType, so loading strategies (batching, caching, prefetching)
+// and new file formats are added in one place.
+
+class SummarySource {
+
+public:
+
+    using time_point = std::chrono::time_point<std::chrono::system_clock, std::chrono::duration<int64_t, std::ratio<1,1000>>>;
+
+    virtual ~SummarySource() = default;
+
+    virtual FileType file_type() const = 0;
+    virtual std::string rootname() const = 0;
+
+    virtual bool has_key(const std::string& key) const = 0;
+    virtual std::vector<std::string> keyword_list() const = 0;
+    virtual std::vector<std::string> keyword_list(const std::string& pattern) const = 0;
+    virtual std::string get_unit(const std::string& key) const = 0;
+    virtual bool all_steps_available() const = 0;
+    virtual int number_of_time_steps() const = 0;
+
+    virtual time_point startdate() const = 0;
+
+    // day, month, year, hour, minute, second and millisecond for all file types
+    virtual std::array<int, 7> start_date() const = 0;
+
+    // accumulated time used for opening and loading data
+    virtual std::tuple<double, double> io_elapsed() const = 0;
+
+    // keys not already loaded are read in one pass over the data file. Not thread
+    // safe, load different sources from different threads
+    virtual void load(const std::vector<std::string>& keys) = 0;
+
+    // loads the vector if not already loaded
+    virtual const std::vector<float>& get(const std::string& key) const = 0;
+
+    // index of the last time step in each report step. All time steps for sources
+    // without report step information. Cached until the source is reopened or the
+    // number of time steps changes
+    const std::vector<size_t>& report_step_index() const;
+
+    SmrySpan get_span(const std::string& key) const;
+
+    // file modified after the source was opened or last reopened
+    bool has_changed() const;
+
+    // opens the file again if modified or more time steps are available,
+    // returns true if the source was updated
+    virtual bool reopen() = 0;
+
+    const std::filesystem::path& file() const { return m_file; }
+
+protected:
+
+    explicit SummarySource(const std::filesystem::path& file);
+
+    // also resets the report step index
+    void update_file_stamp();
+    void reset_report_step_index() { m_rstep_num_steps = -1; }
+
+    // report step index for report_step_index, all time steps by default
+    virtual std::vector<size_t> make_report_step_index() const;
+
+    std::filesystem::path m_file;
+    std::filesystem::file_time_type m_file_stamp;
+
+private:
+
+    mutable std::vector<size_t> m_rstep_index;
+    mutable int m_rstep_num_steps = -1;
+};
+
+
+// start date as day, month, year, hour, minute, second and millisecond (UTC)
+SummarySource::time_point make_startdate(const std::array<int, 7>& start_date);
+
+
+// Adapter for the Opm::EclIO loaders. The loader is owned by the loader map and
+// referenced through its slot, reopen replaces the loader in the map.
+
+template <typename T>
+class LoaderSource : public SummarySource {
+
+public:
+
+    LoaderSource(std::unique_ptr<T>& loader, const std::filesystem::path& file);
+
+    FileType file_type() const override;
+    std::string rootname() const override { return m_loader->rootname(); }
+
+    bool has_key(const std::string& key) const override { return m_loader->hasKey(key); }
+    std::vector<std::string> keyword_list() const override;
+    std::vector<std::string> keyword_list(const std::string& pattern) const override;
+    std::string get_unit(const std::string& key) const override { return m_loader->get_unit(key); }
+    bool all_steps_available() const override { return m_loader->all_steps_available(); }
+    int number_of_time_steps() const override { return m_loader->numberOfTimeSteps(); }
+
+    time_point startdate() const override { return m_loader->startdate(); }
+    std::array<int, 7> start_date() const override;
+
+    std::tuple<double, double> io_elapsed() const override { return m_loader->get_io_elapsed(); }
+
+    void load(const std::vector<std::string>& keys) override;
+    const std::vector<float>& get(const std::string& key) const override { return m_loader->get(key); }
+
+    bool reopen() override;
+
+protected:
+
+    std::vector<size_t> make_report_step_index() const override;
+
+private:
+
+    std::unique_ptr<T>& m_loader;
+};
+
+template <> FileType LoaderSource<Opm::EclIO::ESmry>::file_type() const;
+template <> FileType LoaderSource<Opm::EclIO::ExtESmry>::file_type() const;
+template <> std::array<int, 7> LoaderSource<Opm::EclIO::ESmry>::start_date() const;
+template <> std::array<int, 7> LoaderSource<Opm::EclIO::ExtESmry>::start_date() const;
+
+extern template class LoaderSource<Opm::EclIO::ESmry>;
+extern template class LoaderSource<Opm::EclIO::ExtESmry>;
+
+using ESmrySource = LoaderSource<Opm::EclIO::ESmry>;
+using ExtESmrySource = LoaderSource<Opm::EclIO::ExtESmry>;
+
+using source_list_type = std::vector<std::unique_ptr<SummarySource>>;
+
+
+// index of the last time step in each report step for Opm::EclIO loaders, the time steps
+// with TIME equal to TIME at the next report step (time and rstep_time from get_at_rstep)
+std::vector<size_t> rstep_time_index(const std::vector<float>& time, const std::vector<float>& rstep_time);
+
+
+// one source for each case, smry_files is used for change detection and reopen. An ESMRY
+// case with a SMSPEC file name is opened from the ESMRY cache (see EsmryCache), FORMATTED
+// cases are parsed from smry_files without a loader. REMOTE and RESTART sources are created
+// by the caller and passed in opened_sources by case index, null for the other cases
+source_list_type make_summary_sources(const std::vector<FileType>& file_type,
+                                      std::unordered_map<int, std::unique_ptr<Opm::EclIO::ESmry>>& esmry_loader,
+                                      std::unordered_map<int, std::unique_ptr<Opm::EclIO::ExtESmry>>& lodsmry_loader,
+                                      const std::vector<std::filesystem::path>& smry_files = {},
+                                      source_list_type opened_sources = {});
+
+std::unique_ptr<SummarySource> make_summary_source(FileType file_type, int smry_ind,
+                                      std::unordered_map<int, std::unique_ptr<Opm::EclIO::ESmry>>& esmry_loader,
+                                      std::unordered_map<int, std::unique_ptr<Opm::EclIO::ExtESmry>>& lodsmry_loader,
+                                      const std::filesystem::path& smry_file = {});
+
+#endif // SMRY_APPL_SUMMARY_SOURCE_HPP
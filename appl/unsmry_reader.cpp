@@ -0,0 +1,508 @@
+/*
+   Copyright 2022 Equinor ASA.
+
+   This file is part of the Open Porous Media project (OPM).
+
+   OPM is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   OPM is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#include <appl/unsmry_reader.hpp>
+
+#include <opm/io/eclipse/EclFile.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+namespace {
+
+// binary summary arrays are written as Fortran records, big endian, with a 4 byte
+// length marker before and after each record. Numeric array data is split in
+// blocks of 1000 items, one record for each block
+
+const size_t block_size = 1000;
+
+int32_t read_int(const char* p)
+{
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return static_cast<int32_t>(__builtin_bswap32(v));
+}
+
+float read_float(const char* p)
+{
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    v = __builtin_bswap32(v);
+
+    float f;
+    std::memcpy(&f, &v, sizeof(f));
+    return f;
+}
+
+size_t element_size(const std::string& type)
+{
+    if ((type == "INTE") || (type == "REAL") || (type == "LOGI"))
+        return 4;
+    else if ((type == "DOUB") || (type == "CHAR"))
+        return 8;
+    else if (type == "MESS")
+        return 0;
+    else if (type.substr(0, 2) == "C0")
+        return std::stoi(type.substr(1));
+
+    throw std::runtime_error("unknown array type '" + type + "' in summary file");
+}
+
+std::string trim(const std::string& str)
+{
+    auto p = str.find_last_not_of(' ');
+    return p == std::string::npos ? "" : str.substr(0, p + 1);
+}
+
+} // anonymous namespace
+
+
+UnsmryReader::UnsmryReader(const std::filesystem::path& unsmry_file) :
+    m_file(unsmry_file)
+{
+    m_fd = ::open(m_file.c_str(), O_RDONLY);
+
+    if (m_fd < 0)
+        throw std::runtime_error("Error opening UNSMRY file " + m_file.string());
+
+    struct stat st;
+
+    if (::fstat(m_fd, &st) != 0) {
+        ::close(m_fd);
+        throw std::runtime_error("Error reading size of UNSMRY file " + m_file.string());
+    }
+
+    m_size = static_cast<size_t>(st.st_size);
+
+    if (m_size > 0) {
+        void* addr = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_fd, 0);
+
+        if (addr == MAP_FAILED) {
+            ::close(m_fd);
+            throw std::runtime_error("Error with memory map of UNSMRY file " + m_file.string());
+        }
+
+        m_data = static_cast<const char*>(addr);
+        ::madvise(addr, m_size, MADV_WILLNEED);
+    }
+
+    // destructor not called if the constructor throws
+
+    try {
+        this->index_records();
+    } catch (...) {
+        this->close();
+        throw;
+    }
+}
+
+UnsmryReader::~UnsmryReader()
+{
+    this->close();
+}
+
+void UnsmryReader::close()
+{
+    if (m_data != nullptr)
+        ::munmap(const_cast<char*>(m_data), m_size);
+
+    if (m_fd >= 0)
+        ::close(m_fd);
+
+    m_data = nullptr;
+    m_fd = -1;
+}
+
+void UnsmryReader::index_records()
+{
+    size_t pos = 0;
+    bool seqhdr = false;
+
+    // array header is one record of 16 bytes, name (8 characters), number of items and type
+
+    while (pos + 24 <= m_size) {
+
+        if (read_int(m_data + pos) != 16)
+            throw std::runtime_error("Error in UNSMRY file " + m_file.string() + ", array header expected");
+
+        std::string name = trim(std::string(m_data + pos + 4, 8));
+        size_t count = static_cast<size_t>(read_int(m_data + pos + 12));
+        std::string type(m_data + pos + 16, 4);
+
+        size_t data_pos = pos + 24;
+        size_t elm_size = element_size(type);
+
+        // skip data records, stop at last complete array
+
+        size_t remaining = count * elm_size;
+        size_t next = data_pos;
+        bool complete = true;
+
+        while (remaining > 0) {
+            if (next + 4 > m_size) {
+                complete = false;
+                break;
+            }
+
+            size_t len = static_cast<size_t>(read_int(m_data + next));
+
+            if ((len == 0) || (len > remaining) || (next + len + 8 > m_size)) {
+                complete = false;
+                break;
+            }
+
+            remaining -= len;
+            next += len + 8;
+        }
+
+        if (!complete)
+            break;
+
+        if (name == "SEQHDR") {
+            seqhdr = true;
+        } else if (name == "PARAMS") {
+
+            if (m_params_offset.size() == 0)
+                m_nlist = count;
+            else if (count != m_nlist)
+                throw std::runtime_error("Error in UNSMRY file " + m_file.string() + ", PARAMS with different size");
+
+            // PARAMS blocks must be full blocks of 1000 values, except the last one
+
+            if ((count > 0) && (static_cast<size_t>(read_int(m_data + data_pos)) != std::min(count, block_size) * 4))
+                throw std::runtime_error("Error in UNSMRY file " + m_file.string() + ", unexpected PARAMS block size");
+
+            m_params_offset.push_back(data_pos);
+            m_report_start.push_back(seqhdr);
+            seqhdr = false;
+        }
+
+        pos = next;
+    }
+}
+
+std::vector<std::vector<float>> UnsmryReader::get(const std::vector<int>& columns) const
+{
+    size_t num_steps = m_params_offset.size();
+
+    for (auto col : columns)
+        if ((col < 0) || (static_cast<size_t>(col) >= m_nlist))
+            throw std::invalid_argument("column " + std::to_string(col) + " out of range in UNSMRY file " + m_file.string());
+
+    // columns visited in file order within each record
+
+    std::vector<size_t> order(columns.size());
+
+    for (size_t n = 0; n < order.size(); n++)
+        order[n] = n;
+
+    std::sort(order.begin(), order.end(), [&columns](size_t a, size_t b) { return columns[a] < columns[b]; });
+
+    std::vector<size_t> byte_offset(columns.size());
+
+    for (size_t n = 0; n < columns.size(); n++) {
+        size_t col = static_cast<size_t>(columns[order[n]]);
+        byte_offset[n] = (col / block_size) * (block_size * 4 + 8) + 4 + (col % block_size) * 4;
+    }
+
+    std::vector<std::vector<float>> result(columns.size(), std::vector<float>(num_steps));
+
+    #pragma omp parallel for schedule(static)
+    for (size_t t = 0; t < num_steps; t++) {
+        const char* record = m_data + m_params_offset[t];
+
+        for (size_t n = 0; n < order.size(); n++)
+            result[order[n]][t] = read_float(record + byte_offset[n]);
+    }
+
+    return result;
+}
+
+std::vector<float> UnsmryReader::get(int column) const
+{
+    return std::move(this->get(std::vector<int>{ column })[0]);
+}
+
+
+UnsmrySource::UnsmrySource(std::unique_ptr<Opm::EclIO::ESmry>& loader, const std::filesystem::path& smspec_file) :
+    ESmrySource(loader, smspec_file)
+{
+    m_unsmry_file = smspec_file;
+    m_unsmry_file.replace_extension(".UNSMRY");
+}
+
+void UnsmrySource::load(const std::vector<std::string>& keys)
+{
+    // SMSPEC index made on first load, cases only opened for the keyword list don't need it
+
+    if (!m_index_loaded) {
+        try {
+            m_index = make_smspec_index(m_file);
+        } catch (const std::exception&) {
+            m_index.clear();
+        }
+
+        m_index_loaded = true;
+    }
+
+    std::vector<std::string> loader_keys = this->load_from_reader(keys);
+
+    ESmrySource::load(loader_keys);
+}
+
+const std::vector<float>& UnsmrySource::get(const std::string& key) const
+{
+    auto it = m_data.find(key);
+
+    if (it != m_data.end())
+        return it->second;
+
+    if (this->load_from_reader({ key }).empty())
+        return m_data.at(key);
+
+    return ESmrySource::get(key);
+}
+
+const UnsmryReader* UnsmrySource::reader() const
+{
+    size_t num_steps = static_cast<size_t>(this->number_of_time_steps());
+
+    // reader kept until reopen, made again if the file has grown since it was mapped
+
+    if ((m_reader) && (m_reader->number_of_time_steps() >= num_steps))
+        return m_reader.get();
+
+    if (m_reader_failed)
+        return nullptr;
+
+    m_reader.reset();
+
+    try {
+        m_reader = std::make_unique<UnsmryReader>(m_unsmry_file);
+    } catch (const std::exception&) {
+        m_reader_failed = true;
+        return nullptr;
+    }
+
+    if (m_reader->number_of_time_steps() < num_steps) {
+        m_reader.reset();
+        m_reader_failed = true;
+        return nullptr;
+    }
+
+    return m_reader.get();
+}
+
+std::vector<std::string> UnsmrySource::load_from_reader(const std::vector<std::string>& keys) const
+{
+    // SMSPEC index made on first load, cases only opened for the keyword list don't need it
+
+    if (!m_index_loaded) {
+        try {
+            m_index = make_smspec_index(m_file);
+        } catch (const std::exception&) {
+            m_index.clear();
+        }
+
+        m_index_loaded = true;
+    }
+
+    std::vector<std::string> reader_keys;
+    std::vector<std::string> loader_keys;
+    std::vector<int> columns;
+
+    for (auto& key : keys) {
+        if (m_data.count(key) > 0)
+            continue;
+
+        auto it = m_index.find(key);
+
+        if (it != m_index.end()) {
+            reader_keys.push_back(key);
+            columns.push_back(it->second);
+        } else {
+            loader_keys.push_back(key);
+        }
+    }
+
+    if (reader_keys.empty())
+        return loader_keys;
+
+    auto unsmry = this->reader();
+
+    if (unsmry == nullptr) {
+        loader_keys.insert(loader_keys.end(), reader_keys.begin(), reader_keys.end());
+        return loader_keys;
+    }
+
+    try {
+        size_t num_steps = static_cast<size_t>(this->number_of_time_steps());
+
+        auto data = unsmry->get(columns);
+
+        for (size_t n = 0; n < reader_keys.size(); n++) {
+            data[n].resize(num_steps);
+            m_data[reader_keys[n]] = std::move(data[n]);
+        }
+
+    } catch (const std::exception&) {
+        loader_keys.insert(loader_keys.end(), reader_keys.begin(), reader_keys.end());
+    }
+
+    return loader_keys;
+}
+
+std::vector<size_t> UnsmrySource::make_report_step_index() const
+{
+    auto unsmry = this->reader();
+
+    if (unsmry == nullptr)
+        return ESmrySource::make_report_step_index();
+
+    std::vector<size_t> index = unsmry->report_step_index();
+
+    // report step still being written ends at the last time step seen by the loader
+
+    size_t num_steps = static_cast<size_t>(this->number_of_time_steps());
+
+    while ((index.size() > 0) && (index.back() >= num_steps))
+        index.pop_back();
+
+    if ((num_steps > 0) && ((index.empty()) || (index.back() != num_steps - 1)))
+        index.push_back(num_steps - 1);
+
+    return index;
+}
+
+bool UnsmrySource::reopen()
+{
+    bool updated = ESmrySource::reopen();
+
+    if (updated) {
+        m_data.clear();
+        m_reader.reset();
+        m_reader_failed = false;
+    }
+
+    return updated;
+}
+
+
+std::vector<size_t> last_step_index(const std::vector<bool>& report_start)
+{
+    std::vector<size_t> index;
+
+    for (size_t t = 1; t < report_start.size(); t++)
+        if (report_start[t])
+            index.push_back(t - 1);
+
+    if (report_start.size() > 0)
+        index.push_back(report_start.size() - 1);
+
+    return index;
+}
+
+
+std::unordered_map<std::string, int> make_smspec_index(const std::filesystem::path& smspec_file)
+{
+    Opm::EclIO::EclFile smspec(smspec_file.string());
+
+    smspec.loadData();
+
+    auto keywords = smspec.get<std::string>("KEYWORDS");
+    auto nums = smspec.get<int>("NUMS");
+    auto dimens = smspec.get<int>("DIMENS");
+
+    std::vector<std::string> wgnames;
+
+    if (smspec.hasKey("WGNAMES"))
+        wgnames = smspec.get<std::string>("WGNAMES");
+    else if (smspec.hasKey("NAMES"))
+        wgnames = smspec.get<std::string>("NAMES");
+
+    int nI = dimens[1];
+    int nJ = dimens[2];
+
+    auto ijk = [&](int num) {
+        int i = (num - 1) % nI + 1;
+        int j = ((num - 1) / nI) % nJ + 1;
+        int k = (num - 1) / (nI * nJ) + 1;
+
+        return std::to_string(i) + "," + std::to_string(j) + "," + std::to_string(k);
+    };
+
+    std::unordered_map<std::string, int> index;
+
+    for (size_t n = 0; n < keywords.size(); n++) {
+
+        std::string key = trim(keywords[n]);
+        std::string wgname = n < wgnames.size() ? trim(wgnames[n]) : "";
+        int num = n < nums.size() ? nums[n] : 0;
+
+        bool no_wgname = (wgname.size() == 0) || (wgname == ":+:+:+:+");
+
+        std::string key_str;
+
+        switch (key[0]) {
+        case 'A':
+        case 'R':
+            if (num > 0)
+                key_str = key + ":" + std::to_string(num);
+            break;
+        case 'B':
+            if (num > 0)
+                key_str = key + ":" + ijk(num);
+            break;
+        case 'C':
+            if ((!no_wgname) && (num > 0))
+                key_str = key + ":" + wgname + ":" + ijk(num);
+            break;
+        case 'G':
+        case 'W':
+            if (!no_wgname)
+                key_str = key + ":" + wgname;
+            break;
+        case 'S':
+            if ((!no_wgname) && (num > 0))
+                key_str = key + ":" + wgname + ":" + std::to_string(num);
+            break;
+        case 'F':
+            key_str = key;
+            break;
+        default:
+            if ((key == "TIME") || (key == "YEARS") || (key == "DAY") || (key == "MONTH") || (key == "YEAR")
+                || (key == "TIMESTEP") || (key == "ELAPSED") || (key == "TCPU") || (key == "MSUMLINS")
+                || (key == "MSUMNEWT") || (key == "NEWTON") || (key == "NLINEARS"))
+                key_str = key;
+        }
+
+        // first occurrence used for duplicate keys
+
+        if (key_str.size() > 0)
+            index.emplace(key_str, static_cast<int>(n));
+    }
+
+    return index;
+}
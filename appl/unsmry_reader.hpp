@@ -0,0 +1,134 @@
+/*
+   Copyright 2022 Equinor ASA.
+
+   This file is part of the Open Porous Media project (OPM).
+
+   OPM is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   OPM is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#ifndef SMRY_APPL_UNSMRY_READER_HPP
+#define SMRY_APPL_UNSMRY_READER_HPP
+
+#include <appl/summary_source.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+// index of the last time step in each report step from flags for the first time step in
+// each report step. The last time step ends the last report step.
+
+std::vector<size_t> last_step_index(const std::vector<bool>& report_start);
+
+
+// Column extractor for unified summary files (UNSMRY, binary). The file is memory mapped
+// and the offsets of all PARAMS records are indexed in one pass when opened. Any set of
+// columns is then extracted in a single sequential pass over the PARAMS records, split
+// on record ranges between threads. A file still being written is read up to the last
+// complete PARAMS record.
+
+class UnsmryReader
+{
+public:
+
+    explicit UnsmryReader(const std::filesystem::path& unsmry_file);
+    ~UnsmryReader();
+
+    UnsmryReader(const UnsmryReader&) = delete;
+    UnsmryReader& operator=(const UnsmryReader&) = delete;
+
+    size_t number_of_time_steps() const { return m_params_offset.size(); }
+    size_t number_of_params() const { return m_nlist; }
+
+    // index of the last time step in each report step, as SummarySource::report_step_index
+    std::vector<size_t> report_step_index() const { return last_step_index(m_report_start); }
+
+    // one vector for each column (index in PARAMS), same order as columns
+    std::vector<std::vector<float>> get(const std::vector<int>& columns) const;
+
+    std::vector<float> get(int column) const;
+
+private:
+
+    void index_records();
+    void close();
+
+    std::filesystem::path m_file;
+
+    int m_fd = -1;
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+
+    size_t m_nlist = 0;
+    std::vector<size_t> m_params_offset;
+
+    // true for first time step in each report step (after SEQHDR)
+    std::vector<bool> m_report_start;
+};
+
+
+// SMSPEC case with a unified UNSMRY file. Vectors found in the SMSPEC index are extracted
+// with UnsmryReader, one pass over the PARAMS records for all keys in a load call, and
+// also for single keys in get. Other keys, and all keys if the UNSMRY file can not be
+// read, are loaded by the ESmry loader. The reader is kept until the case is reopened,
+// and made again if the loader has more time steps than the mapped file. Vectors are
+// cut to the number of time steps seen by the loader, a file still being written can
+// have more time steps when read later.
+
+class UnsmrySource : public ESmrySource {
+
+public:
+
+    UnsmrySource(std::unique_ptr<Opm::EclIO::ESmry>& loader, const std::filesystem::path& smspec_file);
+
+    void load(const std::vector<std::string>& keys) override;
+    const std::vector<float>& get(const std::string& key) const override;
+
+    bool reopen() override;
+
+protected:
+
+    std::vector<size_t> make_report_step_index() const override;
+
+private:
+
+    // nullptr if the UNSMRY file can not be read
+    const UnsmryReader* reader() const;
+
+    // loads keys in the SMSPEC index with the reader, returns keys not loaded
+    std::vector<std::string> load_from_reader(const std::vector<std::string>& keys) const;
+
+    std::filesystem::path m_unsmry_file;
+
+    mutable std::unordered_map<std::string, int> m_index;
+    mutable bool m_index_loaded = false;
+
+    mutable std::unique_ptr<UnsmryReader> m_reader;
+    mutable bool m_reader_failed = false;
+
+    mutable std::unordered_map<std::string, std::vector<float>> m_data;
+};
+
+
+// column in PARAMS for each summary key in SMSPEC file. Keys are made as in Opm::EclIO::ESmry
+// for field, well, group, region, block, aquifer, connection and segment vectors,
+// other keys only found in ESmry are not in the index.
+
+std::unordered_map<std::string, int> make_smspec_index(const std::filesystem::path& smspec_file);
+
+#endif // SMRY_APPL_UNSMRY_READER_HPP
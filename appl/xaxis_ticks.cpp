@@ -29,12 +29,21 @@
 
 XaxisTicks::XaxisTicks(QChart *chart):
     QGraphicsItem(chart),
-    m_chart(chart)
+    m_chart(chart),
+    m_font("serifed style")   // default on Linux
 {
+    m_font.setPointSize(8);
+
+    // labels and font are created once, paint only updates text and position
+    // for labels which have changed.
+
     for (int n = 0; n < max_number_of_labels; n++){
         m_labels.push_back(std::make_unique<QGraphicsSimpleTextItem>(m_chart));
+        m_labels.back()->setFont(m_font);
         m_labels.back()->setVisible(false);
     }
+
+    m_grid_lines.reserve(max_number_of_labels);
 }
 
 QRectF XaxisTicks::boundingRect() const
@@ -45,6 +54,28 @@ QRectF XaxisTicks::boundingRect() const
 }
 
 
+int XaxisTicks::label_shift(const QString& lbl)
+{
+    switch (lbl.length()) {
+    case 4:
+        return 10;
+    case 8:
+        return 20;
+    case 10:
+        return 25;
+    case 11:
+        return 28;
+    case 17:
+        return 43;
+    case 20:
+        return 50;
+    case 24:
+        return 60;
+    default:
+        return 0;
+    }
+}
+
 
 void XaxisTicks::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
 {
@@ -56,58 +87,34 @@ void XaxisTicks::paint(QPainter *painter, const QStyleOptionGraphicsItem *option
 
     auto lbl_ypos = bot_plot + (bot_chart - bot_plot)*0.05;
 
-    for (int n = 0; n < max_number_of_labels; n++)
-        m_labels[n]->setVisible(false);
+    int num_ticks = static_cast<int>(m_xaxis_ticks.size());
 
-    if (m_xaxis_ticks.size() > 0) {
+    m_grid_lines.clear();
 
-        for (int n = 0; n <  m_xaxis_ticks.size(); n++) {
+    for (int n = 0; n < num_ticks; n++) {
 
-            QPainterPath path3;
+        qreal xpos = rect2.x() + rect2.width()*static_cast<qreal>(std::get<1>(m_xaxis_ticks[n]));
 
-            qreal xpos = rect2.x() + rect2.width()*static_cast<qreal>(std::get<1>(m_xaxis_ticks[n]));
+        m_grid_lines.append(QLineF(xpos, rect2.y(), xpos, rect2.y() + rect2.height()));
 
-            path3.moveTo(xpos, rect2.y());
-            path3.lineTo(xpos, rect2.y() + rect2.height());
+        const QString& lbl = std::get<0>(m_xaxis_ticks[n]);
 
-            painter->setPen(QPen(Qt::gray, 0.5, Qt::SolidLine));
-
-            painter->drawPath(path3);
+        if (m_labels[n]->text() != lbl)
+            m_labels[n]->setText(lbl);
 
+        m_labels[n]->setPos(xpos - label_shift(lbl), lbl_ypos );
 
-            QString lbl = QString::fromStdString(std::get<0>(m_xaxis_ticks[n]));
+        if (!m_labels[n]->isVisible())
+            m_labels[n]->setVisible(true);
+    }
 
-            m_labels[n]->setText(lbl);
+    for (int n = num_ticks; n < max_number_of_labels; n++)
+        if (m_labels[n]->isVisible())
+            m_labels[n]->setVisible(false);
 
-            QFont font1("serifed style");  // default on Linux
-            font1.setPointSize(8);
-
-            //font1.setFamily("Arial");  // default on Windows
-            //font1.setFamily("serifed style");  // default on Linux
-
-            int left_shift;
-
-            if (lbl.length() == 4)
-                left_shift = 10;
-            else if (lbl.length() == 8)
-                left_shift = 20;
-            else if (lbl.length() == 10)
-                left_shift = 25;
-            else if (lbl.length() == 11)
-                left_shift = 28;
-            else if (lbl.length() == 17)
-                left_shift = 43;
-            else if (lbl.length() == 20)
-                left_shift = 50;
-            else if (lbl.length() == 24)
-                left_shift = 60;
-            else
-                left_shift = 0;
-
-            m_labels[n]->setFont(font1);
-            m_labels[n]->setPos(xpos - left_shift, lbl_ypos );
-            m_labels[n]->setVisible(true);
-        }
+    if (m_grid_lines.size() > 0) {
+        painter->setPen(QPen(Qt::gray, 0.5, Qt::SolidLine));
+        painter->drawLines(m_grid_lines);
     }
 }
 
@@ -117,7 +124,7 @@ void XaxisTicks::prepare_update()
 }
 
 
-void XaxisTicks::set_xaxis_ticks(const std::vector<std::tuple<std::string, double>>& xaxis_ticks)
+void XaxisTicks::set_xaxis_ticks(const tick_list_type& xaxis_ticks)
 {
     if (xaxis_ticks.size() > max_number_of_labels)
         throw std::runtime_error("number of xaxis ticks " + std::to_string(xaxis_ticks.size()) + " are larger than maximum " +
@@ -22,8 +22,12 @@
 #include <QtCharts/QChartGlobal>
 #include <QtWidgets/QGraphicsItem>
 #include <QtGui/QFont>
+#include <QtCore/QLineF>
+#include <QtCore/QVector>
 
 #include <memory>
+#include <vector>
+#include <tuple>
 
 QT_BEGIN_NAMESPACE
 class QGraphicsSceneMouseEvent;
@@ -33,9 +37,12 @@ class QChart;
 class XaxisTicks : public QGraphicsItem
 {
 public:
+    // label, relative position along plot area
+    using tick_list_type = std::vector<std::tuple<QString, double>>;
+
     XaxisTicks(QChart *parent);
 
-    void set_xaxis_ticks(const std::vector<std::tuple<std::string, double>>& xaxis_ticks);
+    void set_xaxis_ticks(const tick_list_type& xaxis_ticks);
 
     QRectF boundingRect() const;
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *option,QWidget *widget);
@@ -49,9 +56,14 @@ private:
     const int max_number_of_labels = 25;
 
     QChart *m_chart;
-    std::vector<std::tuple<std::string, double>> m_xaxis_ticks;
+    tick_list_type m_xaxis_ticks;
+
+    QFont m_font;
+    QVector<QLineF> m_grid_lines;
 
     std::vector<std::unique_ptr<QGraphicsSimpleTextItem>> m_labels;
+
+    int label_shift(const QString& lbl);
 };
 
 #endif // XAXISTICKS_H
@@ -34,6 +34,12 @@
 #include <boost/algorithm/string.hpp>
 
 #include <appl/qsum_cmdf.hpp>
+#include <appl/esmry_cache.hpp>
+#include <appl/formatted_smry.hpp>
+#include <appl/case_discovery.hpp>
+#include <appl/daemon_client.hpp>
+#include <appl/smry_daemon.hpp>
+#include <appl/restart_chain.hpp>
 #include <appl/derived_smry.hpp>
 
 #include <appl/qsum_func_lib.hpp>
@@ -60,20 +66,51 @@ namespace Qt
 
 static void printHelp()
 {
-    std::cout << "\nUsage: qsummary [file_1] [file_2] .. [file_n]  [OPTIONS] \n";
+    std::cout << "\nUsage: qsummary [case_1] [case_2] .. [case_n]  [OPTIONS] \n";
+    std::cout << "\n A case is a summary file or root name, a folder searched recursively for summary files \n";
+    std::cout << " or a quoted pattern, example 'realization-*/iter-0/eclipse/model/*.SMSPEC'. Cases found \n";
+    std::cout << " in folders and patterns without summary data are skipped \n";
 
     std::cout << "\noptions: \n\n";
 
     std::cout << " -a   Create plot with all vectors. Useful for smaller models.  \n";
     std::cout << "      Execution of program will stop if number of charts is greater than 200 \n";
+    std::cout << " -c   Cache expanded command file (option -f). Reused when command file, list (option -l) \n";
+    std::cout << "      and number of summary files are unchanged. Cache folder $XDG_CACHE_HOME/qsummary \n";
+    std::cout << " -e   Use ESMRY cache for SMSPEC cases. Cases are converted to ESMRY in the background \n";
+    std::cout << "      when first opened, the cached file is used while SMSPEC and UNSMRY are unchanged. \n";
+    std::cout << "      Cache folder $XDG_CACHE_HOME/qsummary/esmry. Formatted summary files (FSMSPEC) \n";
+    std::cout << "      are converted to ESMRY in this folder when opened, without -e these are read directly \n";
+    std::cout << " -g   Use OpenGL rendering for all charts. Default is OpenGL only for ensemble charts \n";
+    std::cout << "      and charts with many data points. Set LIBGL_ALWAYS_SOFTWARE=1 to use Mesa (llvmpipe) \n";
+    std::cout << "      on hosts without a GPU. \n";
     std::cout << " -h   Print help message and exit \n";
+    std::cout << " -i   Wildcard patterns (-v and -a) only expand to vectors found in all summary files. \n";
+    std::cout << "      Default is vectors found in any of the summary files \n";
     std::cout << " -z   Ignore summary vectors with only zero values \n";
     std::cout << " -l   Command line list to be used in command file  \n";
+    std::cout << " -L   Live case from a running simulator, name of local socket. Time steps pushed by the \n";
+    std::cout << "      simulator are added to charts when received, see appl/live_source.hpp for the format. \n";
+    std::cout << "      Waits up to 10 seconds for the first time step. Option can be repeated \n";
+    std::cout << " -r   Follow restart chains. A restart case is shown as one case joined with its base runs, \n";
+    std::cout << "      base runs are used up to the first time step of the restart run \n";
+    std::cout << " -m   Show all charts as ensemble charts, P10, P50 and P90 with members in background. \n";
+    std::cout << "      Default is ensemble charts when more than 9 cases of one vector in chart \n";
     std::cout << " -v   Create plot with vector. Example -v FOPR,FOPT will create \n";
     std::cout << "      one chart for each vector. Each chart holding series for all summary files. \n";
     std::cout << " -s   Separate charts on input folders. Simulation cases located in different  \n";
     std::cout << "      folders will not be placed on same chart when using this option. \n";
     std::cout << " -x   Set xrange for all charts, example  -x 2020-01,2020-03  \n";
+    std::cout << " --cases-from [file]  Cases from file, one case (file, folder or pattern) on each line. \n";
+    std::cout << "      Relative paths are relative to the folder of the file \n";
+    std::cout << " --daemon[=name]  Run as summary daemon, cases opened by clients are kept open with loaded \n";
+    std::cout << "      vectors in memory. Default name qsummary-daemon, socket in temp folder. Only the user \n";
+    std::cout << "      running the daemon can connect \n";
+    std::cout << " --use-daemon[=name]  Open cases through a running summary daemon. Cases already opened \n";
+    std::cout << "      by another qsummary window are not opened and loaded again. Cases are opened \n";
+    std::cout << "      directly if no daemon is running \n";
+    std::cout << " --rstep  Plot report steps only, not every time step written by the simulator. Use \n";
+    std::cout << "      command :rstep to switch a chart back to all time steps \n";
 
     std::cout << "\ncommands: \n\n";
 
@@ -82,9 +119,16 @@ static void printHelp()
     std::cout << " :r    reload data and update all charts\n";
     std::cout << " :pdf  create pdf file (open file dialog) \n";
     std::cout << " :pdf [file_name] create pdf file save to file name. \n";
+    std::cout << " :pdf [file_name] [from-to] [raster] export charts from-to (1-5 or 3), raster renders pages as images in parallel \n";
     std::cout << " :m   switch markers on or off, all series  \n";
+    std::cout << " :gl  switch OpenGL rendering on or off, all charts  \n";
+    std::cout << " :gl auto  OpenGL rendering for ensemble charts and charts with many data points \n";
     std::cout << " :e   exit application  \n";
-    std::cout << " :ens switch to esemble mode (this part of the code is under construction)  \n";
+    std::cout << " :ens switch ensemble mode on or off. New vectors added as ensemble, all cases  \n";
+    std::cout << " :ens band|density|lines  draw ensemble members as P10-P90 and min-max bands (default), \n";
+    std::cout << "      density image or one line for each member \n";
+    std::cout << " :rstep  switch between report steps only and all time steps, active chart \n";
+    std::cout << " :rstep on|off  report steps only on or off, all charts \n";
 
     std::cout << "\ncontrols: \n\n";
 
@@ -118,15 +162,41 @@ int main(int argc, char *argv[])
     bool plot_all    = false;
     bool separate    = false;
     bool ignore_zero = false;
+    bool use_opengl  = false;
+    bool intersect   = false;
+    bool cmdf_cache  = false;
+    bool esmry_cache = false;
+    bool ensemble    = false;
+    bool restart_chains = false;
+    bool report_steps = false;
 
     int max_threads  = 16;
     std::string xrange_str;
     std::string cmd_file;
     std::string cmdl_list;
+    std::string cases_from;
+    std::vector<std::string> live_cases;
+
+    bool run_daemon  = false;
+    bool use_daemon  = false;
+    std::string daemon_name = "qsummary-daemon";
+
+    const int opt_cases_from = 1000;
+    const int opt_daemon = 1001;
+    const int opt_use_daemon = 1002;
+    const int opt_rstep = 1003;
+
+    static struct option long_options[] = {
+        { "cases-from", required_argument, nullptr, opt_cases_from },
+        { "daemon", optional_argument, nullptr, opt_daemon },
+        { "use-daemon", optional_argument, nullptr, opt_use_daemon },
+        { "rstep", no_argument, nullptr, opt_rstep },
+        { nullptr, 0, nullptr, 0 }
+    };
 
     std::string smry_vect = "";
 
-    while ((c = getopt(argc, argv, "ahf:l:v:x:n:sz")) != -1) {
+    while ((c = getopt_long(argc, argv, "aceghif:l:L:mrv:x:n:sz", long_options, nullptr)) != -1) {
         switch (c) {
         case 'h':
             printHelp();
@@ -137,6 +207,18 @@ int main(int argc, char *argv[])
         case 'a':
             plot_all = true;
             break;
+        case 'c':
+            cmdf_cache = true;
+            break;
+        case 'e':
+            esmry_cache = true;
+            break;
+        case 'g':
+            use_opengl = true;
+            break;
+        case 'i':
+            intersect = true;
+            break;
         case 'f':
             cmd_file = optarg;
             break;
@@ -149,12 +231,37 @@ int main(int argc, char *argv[])
         case 'l':
             cmdl_list = optarg;
             break;
+        case 'L':
+            live_cases.push_back(optarg);
+            break;
+        case 'm':
+            ensemble = true;
+            break;
+        case 'r':
+            restart_chains = true;
+            break;
         case 's':
             separate = true;
             break;
         case 'z':
             ignore_zero = true;
             break;
+        case opt_cases_from:
+            cases_from = optarg;
+            break;
+        case opt_daemon:
+            run_daemon = true;
+            if (optarg != nullptr)
+                daemon_name = optarg;
+            break;
+        case opt_use_daemon:
+            use_daemon = true;
+            if (optarg != nullptr)
+                daemon_name = optarg;
+            break;
+        case opt_rstep:
+            report_steps = true;
+            break;
         default:
             return EXIT_FAILURE;
         }
@@ -162,40 +269,37 @@ int main(int argc, char *argv[])
 
     int argOffset = optind;
 
-    std::replace( xrange_str.begin(), xrange_str.end(), ',', ' ');
+    if (run_daemon) {
 
-    std::vector<std::string> arg_vect;
+        QCoreApplication app(argc, argv);
 
-    for (size_t n = argOffset; n < argc; n++) {
+        SmryDaemon daemon(daemon_name);
 
-        std::string file_arg = argv[n];
+        if (!daemon.listen())
+            return EXIT_FAILURE;
 
-        std::filesystem::path filename(file_arg);
-        std::string ext = filename.extension().string();
+        std::cout << "\nsummary daemon listening on " << daemon_socket_path(daemon_name).string() << std::endl;
+
+        return app.exec();
+    }
 
-        auto l = file_arg.size();
+    std::replace( xrange_str.begin(), xrange_str.end(), ',', ' ');
 
-        if ((ext != ".SMSPEC") && (ext != ".FSMSPEC") && (ext != ".ESMRY")) {
+    auto start_discovery = std::chrono::system_clock::now();
 
-            if (file_arg.substr(l-1) == ".")
-                file_arg = file_arg + "SMSPEC";
-            else if (file_arg.size() <  7)
-                file_arg = file_arg + ".SMSPEC";
-            else if (file_arg.substr(l-7) != ".SMSPEC")
-                file_arg = file_arg + ".SMSPEC";
-        }
+    CaseDiscovery discovery(max_threads);
 
-        l = file_arg.size();
+    if (cases_from.size() > 0)
+        discovery.add_cases_from(cases_from);
 
-        if (file_arg.substr(l-7) == ".SMSPEC"){
-            std::string unsmry_str = file_arg.substr(0, l-7) + ".UNSMRY";
-            std::filesystem::path unsmry_file(unsmry_str);
+    for (size_t n = argOffset; n < argc; n++)
+        discovery.add_argument(argv[n]);
 
-            if (std::filesystem::exists(unsmry_file))
-                arg_vect.push_back(file_arg);
+    std::vector<std::string> arg_vect = discovery.find_cases();
 
-        } else
-            arg_vect.push_back(file_arg);
+    if (discovery.discovery_used()) {
+        std::chrono::duration<double> elapsed_discovery = std::chrono::system_clock::now() - start_discovery;
+        discovery.print_summary(elapsed_discovery.count());
     }
 
     std::vector<std::filesystem::path> smry_files;
@@ -236,6 +340,77 @@ int main(int argc, char *argv[])
         exit(1);
     }
 
+    // cases opened by the summary daemon are used through DaemonSource (FileType::REMOTE) and
+    // restart cases through RestartChainSource (FileType::RESTART), other cases are opened below
+
+    source_list_type opened_sources(arg_vect.size());
+
+    if (use_daemon) {
+
+        auto client = std::make_shared<SmryDaemonClient>(daemon_name);
+
+        if (client->connect()) {
+
+            for (size_t n = 0; n < arg_vect.size(); n++) {
+                try {
+                    opened_sources[n] = std::make_unique<DaemonSource>(client, arg_vect[n]);
+                } catch (const std::exception& e) {
+                    std::cout << "\n!Warning, " << e.what() << ", case opened without daemon";
+                }
+            }
+
+        } else {
+            std::cout << "\n!Warning, no summary daemon running on " << daemon_socket_path(daemon_name).string();
+            std::cout << ", cases opened without daemon";
+        }
+    }
+
+    // base runs shared by restart cases are opened once
+    RestartSegmentPool segment_pool;
+
+    if (restart_chains) {
+
+        for (size_t n = 0; n < arg_vect.size(); n++) {
+
+            std::string ext = std::filesystem::path(arg_vect[n]).extension().string();
+
+            if ((opened_sources[n] != nullptr) || ((ext != ".SMSPEC") && (ext != ".ESMRY")))
+                continue;
+
+            auto chain = RestartChainSource::restart_chain(arg_vect[n]);
+
+            if (chain.size() > 1)
+                opened_sources[n] = std::make_unique<RestartChainSource>(chain, segment_pool);
+        }
+    }
+
+    // formatted cases are read with FormattedSource (FileType::FORMATTED). With the ESMRY cache these
+    // are opened from ESMRY files in the cache folder, converted when opened first time or updated.
+    // FUNSMRY is parsed in parallel using up to max_threads threads
+
+    omp_set_num_threads(std::min(omp_get_num_procs(), max_threads));
+
+    for (size_t n = 0; n < arg_vect.size(); n++) {
+        std::filesystem::path filename(arg_vect[n]);
+
+        if ((opened_sources[n] != nullptr) || (filename.extension() != ".FSMSPEC"))
+            continue;
+
+        if (esmry_cache && !EsmryCache::is_valid(filename))
+            if (!EsmryCache::convert(filename))
+                std::cout << "\n!Warning, conversion of formatted summary file " << arg_vect[n] << " failed";
+
+        if (esmry_cache && EsmryCache::is_valid(filename))
+            continue;
+
+        try {
+            opened_sources[n] = std::make_unique<FormattedSource>(filename);
+        } catch (const std::exception& e) {
+            std::string message = "Error opening formatted summary file " + filename.string() + " in main function, ";
+            throw std::runtime_error(message + e.what());
+        }
+    }
+
     std::cout << "\nNumber of threads: " << nthreads;
 
     omp_set_num_threads(nthreads);
@@ -259,7 +434,26 @@ int main(int argc, char *argv[])
         smry_files[n] = filename;
         std::string ext = filename.extension().string();
 
-        if (ext == ".SMSPEC") {
+        if (opened_sources[n] != nullptr) {
+            file_type[n] = opened_sources[n]->file_type();
+            continue;
+        }
+
+        bool use_cache = ((ext == ".SMSPEC") || (ext == ".FSMSPEC")) && esmry_cache;
+
+        if (use_cache && EsmryCache::is_valid(filename)) {
+            file_type[n] = FileType::ESMRY;
+
+            // smry_files keeps the SMSPEC or FSMSPEC file name, used for change detection on reload
+
+            try {
+                lodsmry_vect[n] = std::make_unique<Opm::EclIO::ExtESmry>(EsmryCache::cached_file(filename));
+            } catch (...){
+                std::string message = "Error opening cached ESMRY file for " + filename.string() + " in main function";
+                throw std::runtime_error(message);
+            }
+
+        } else if ((ext == ".SMSPEC") || (ext == ".FSMSPEC")) {
             file_type[n] = FileType::SMSPEC;
             
             int t = 0;
@@ -294,13 +488,27 @@ int main(int argc, char *argv[])
         }
     }
     
+    std::vector<std::filesystem::path> esmry_convert_list;
+
     for (size_t n=0; n < num_files; n++){
         if (file_type[n] == FileType::SMSPEC)
             esmry_loader[n] = std::move(esmry_vect[n]);
         else if (file_type[n] == FileType::ESMRY)
             lodsmry_loader[n] = std::move(lodsmry_vect[n]);
+
+        if (esmry_cache && (file_type[n] == FileType::SMSPEC) && (smry_files[n].extension() == ".SMSPEC")
+                && EsmryCache::is_cacheable(smry_files[n]))
+            esmry_convert_list.push_back(smry_files[n]);
     }
 
+    if (esmry_cache)
+        std::cout << "\nESMRY cache, cases to be converted: " << esmry_convert_list.size();
+
+    // one source for each case, used by all functions below and by SmryAppl
+
+    source_list_type sources = make_summary_sources(file_type, esmry_loader, lodsmry_loader, smry_files,
+                                                    std::move(opened_sources));
+
     auto end_open = std::chrono::system_clock::now();
 
     std::chrono::duration<double> elapsed_seconds = end_open-start_open;
@@ -324,39 +532,44 @@ int main(int argc, char *argv[])
     QLocale::setDefault(QLocale(QLocale::English, QLocale::UnitedStates));
 
     SmryAppl::input_list_type input_charts;
+    SmryAppl::chart_props_list_type chart_props;
     SmryAppl::loader_list_type loaders;
 
     std::unique_ptr<DerivedSmry> derived_smry;
 
+    SmryStatsCache stats_cache(smry_files.size());
+
     if (plot_all){
 
         if (smry_vect.size() > 0)
             std::cout << "\n! Warning, -v option ignored since option -a (= plot all) used \n\n";
 
-        std::vector<std::string> keyw_list;
-        if (file_type[0] == FileType::SMSPEC)
-            keyw_list = esmry_loader[0]->keywordList();
-        else if (file_type[0] == FileType::ESMRY)
-            keyw_list = lodsmry_loader[0]->keywordList();
+        auto catalogue = QSum::make_keyword_catalogue(sources);
+
+        std::vector<std::string> keyw_list = QSum::expand_pattern(catalogue, "*", intersect);
 
-        QSum::update_input(input_charts, keyw_list, file_type, esmry_loader, lodsmry_loader, max_number_of_charts, xrange_str);
+        QSum::update_input(input_charts, keyw_list, catalogue, max_number_of_charts, xrange_str);
 
-        QSum::pre_load_smry(smry_files, input_charts, file_type, esmry_loader, lodsmry_loader, nthreads);
+        QSum::pre_load_smry(smry_files, input_charts, sources, nthreads,
+                            {}, {}, &stats_cache);
 
         if (ignore_zero)
-            QSum::remove_zero_vect(smry_files, input_charts, file_type, esmry_loader, lodsmry_loader);
+            QSum::remove_zero_vect(smry_files, input_charts, sources, &stats_cache);
 
 
     } else if (smry_vect.size() > 0){
 
-        QSum::chart_input_from_string(smry_vect, input_charts, file_type, esmry_loader, lodsmry_loader, max_number_of_charts, xrange_str);
+        auto catalogue = QSum::make_keyword_catalogue(sources);
+
+        QSum::chart_input_from_string(smry_vect, input_charts, catalogue, max_number_of_charts, xrange_str, intersect);
 
         //QSum::print_input_charts(input_charts);
 
-        QSum::pre_load_smry(smry_files, input_charts, file_type, esmry_loader, lodsmry_loader, nthreads);
+        QSum::pre_load_smry(smry_files, input_charts, sources, nthreads,
+                            {}, {}, &stats_cache);
 
         if (ignore_zero)
-            QSum::remove_zero_vect(smry_files, input_charts, file_type, esmry_loader, lodsmry_loader);
+            QSum::remove_zero_vect(smry_files, input_charts, sources, &stats_cache);
 
         if (separate)
             input_charts = QSum::charts_separate_folders(smry_files, input_charts);
@@ -364,32 +577,60 @@ int main(int argc, char *argv[])
 
     } else if (cmd_file.size() > 0) {
 
-        QsumCMDF cmdfile(cmd_file, num_files, cmdl_list);
+        QsumCMDF cmdfile(cmd_file, num_files, cmdl_list, cmdf_cache);
 
         cmdfile.make_charts_from_cmd(input_charts, xrange_str);
 
-        QSum::check_summary_vectors(input_charts, file_type, esmry_loader, lodsmry_loader);
+        chart_props = cmdfile.get_chart_props();
 
-        QSum::pre_load_smry(smry_files, input_charts, file_type, esmry_loader, lodsmry_loader, nthreads);
+        QSum::check_summary_vectors(input_charts, sources);
 
-        if (separate)
+        QSum::pre_load_smry(smry_files, input_charts, sources, nthreads,
+                            chart_props, cmdfile.get_preload_list(), &stats_cache);
+
+        if (separate) {
             input_charts = QSum::charts_separate_folders(smry_files, input_charts);
 
+            // charts split on folders, groups from command file not valid for the new charts
+            if (std::any_of(chart_props.begin(), chart_props.end(),
+                            [](const auto& props){ return std::get<0>(props).size() > 0; }))
+                std::cout << "\n! Warning, GROUP directives in command file ignored since option -s used \n";
+
+            chart_props.clear();
+        }
+
         if (cmdfile.count_define() > 0){
             std::tuple<double,double> io_elapsed;
 
-            derived_smry = std::make_unique<DerivedSmry>(cmdfile, file_type, esmry_loader, lodsmry_loader);
+            derived_smry = std::make_unique<DerivedSmry>(cmdfile, sources);
 
         }
     }
 
+    if (ensemble) {
+        chart_props.resize(input_charts.size());
+
+        for (auto& props : chart_props)
+            std::get<3>(props) = true;
+    }
+
     std::cout << std::endl;
 
 
-    loaders = std::make_tuple(smry_files, file_type, std::move(esmry_loader), std::move(lodsmry_loader));
+    loaders = std::make_tuple(smry_files, file_type, std::move(esmry_loader), std::move(lodsmry_loader),
+                              std::move(sources));
+
 
+    SmryAppl window(arg_vect, loaders, input_charts, derived_smry, chart_props, std::move(stats_cache), report_steps);
 
-    SmryAppl window(arg_vect, loaders, input_charts, derived_smry);
+    if (use_opengl)
+        window.set_render_mode(RenderMode::opengl);
+
+    const int live_wait_msecs = 10000;
+
+    for (auto& live_case : live_cases)
+        if (!window.add_live_source(live_case, live_wait_msecs))
+            return EXIT_FAILURE;
 
     window.resize(1400, 700);
 
@@ -399,5 +640,11 @@ int main(int argc, char *argv[])
 
     window.show();
 
+    // converted files are used from next launch, or on reload if the case is
+    // unchanged. Conversion is stopped when the application is closed
+
+    EsmryConverter esmry_converter;
+    esmry_converter.start(esmry_convert_list);
+
     return a.exec();
 }
@@ -0,0 +1,659 @@
+/*
+   Copyright 2022 Equinor ASA.
+
+   This file is part of the Open Porous Media project (OPM).
+
+   OPM is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   OPM is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+
+// Benchmarks for the main load and plot paths on synthetic summary cases. Cases are
+// generated with a fixed seed, odd cases as SMSPEC/UNSMRY and even cases as ESMRY.
+// Results are written as one json object for each benchmark (json lines).
+//
+//   qsum_bench -w 200 -t 5000 -c 4 -r 5 -o results.json
+//
+// UNSMRY column extraction (UnsmryReader) is compared to ESmry::loadData on the SMSPEC
+// cases, and on a scaled copy of an existing case with option -u:
+//
+//   qsum_bench -u ../tests/smry_files/SENS1.SMSPEC -k 200
+//
+// Run with QT_QPA_PLATFORM=offscreen on hosts without a display.
+
+#include <QtWidgets/QApplication>
+#include <QtTest/QtTest>
+
+#include <appl/smry_appl.hpp>
+#include <appl/qsum_cmdf.hpp>
+#include <appl/derived_smry.hpp>
+#include <appl/qsum_func_lib.hpp>
+#include <appl/unsmry_reader.hpp>
+
+#include <tests/qsum_test_utility.hpp>
+
+#include <opm/io/eclipse/ESmry.hpp>
+#include <opm/io/eclipse/ExtESmry.hpp>
+#include <opm/io/eclipse/EclOutput.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <getopt.h>
+#include <omp.h>
+
+
+namespace {
+
+struct BenchConfig {
+    int num_wells = 100;
+    int num_tsteps = 2000;
+    int num_cases = 4;
+    int num_charts = 50;
+    int num_pdf_pages = 10;
+    int repeat = 3;
+    std::filesystem::path data_dir = "qsum_bench_data";
+    std::string out_file;
+    std::filesystem::path scale_case;
+    int scale = 100;
+};
+
+const std::vector<std::string> well_vectors = { "WOPR", "WWPR", "WGPR", "WBHP", "WGIR" };
+const std::vector<std::string> well_units = { "SM3/DAY", "SM3/DAY", "SM3/DAY", "BARSA", "SM3/DAY" };
+
+const std::vector<std::string> field_vectors = { "FOPR", "FWPR", "FGPR", "FOPT" };
+const std::vector<std::string> field_units = { "SM3/DAY", "SM3/DAY", "SM3/DAY", "SM3" };
+
+// report step every 30 time steps, 1 day time steps
+const int rstep_interval = 30;
+
+
+std::string well_name(int n)
+{
+    std::ostringstream ss;
+    ss << "W" << std::setw(4) << std::setfill('0') << n + 1;
+    return ss.str();
+}
+
+
+// smspec keys and data for one case, first vector is TIME. Same wells for all cases,
+// rates differ between cases since the seed depends on case index. WGIR is zero for
+// all wells.
+
+void make_case_data(const BenchConfig& config, int case_ind,
+                    std::vector<std::string>& keywords, std::vector<std::string>& wgnames,
+                    std::vector<std::string>& units, std::vector<std::vector<float>>& data)
+{
+    std::mt19937 gen(1234 + case_ind);
+    std::uniform_real_distribution<float> q0_dist(100.0, 2000.0);
+    std::uniform_real_distribution<float> decline_dist(1e-4, 2e-3);
+    std::uniform_real_distribution<float> wct_dist(0.0, 2e-3);
+    std::normal_distribution<float> noise(0.0, 0.02);
+
+    size_t nt = config.num_tsteps;
+
+    keywords = { "TIME" };
+    wgnames = { ":+:+:+:+" };
+    units = { "DAYS" };
+    data.clear();
+
+    std::vector<float> time(nt);
+
+    for (size_t t = 0; t < nt; t++)
+        time[t] = static_cast<float>(t + 1);
+
+    data.push_back(time);
+
+    std::vector<std::vector<float>> field(field_vectors.size(), std::vector<float>(nt, 0.0));
+
+    for (int w = 0; w < config.num_wells; w++){
+
+        float q0 = q0_dist(gen);
+        float decline = decline_dist(gen);
+        float wct_rate = wct_dist(gen);
+        float gor = 100.0 + 50.0 * noise(gen);
+
+        std::vector<std::vector<float>> well(well_vectors.size(), std::vector<float>(nt, 0.0));
+
+        for (size_t t = 0; t < nt; t++){
+            float liquid = q0 * std::exp(-decline * time[t]) * (1.0 + noise(gen));
+            float wct = 1.0 - std::exp(-wct_rate * time[t]);
+
+            well[0][t] = liquid * (1.0 - wct);
+            well[1][t] = liquid * wct;
+            well[2][t] = well[0][t] * gor;
+            well[3][t] = 250.0 - 0.01 * time[t] + noise(gen);
+        }
+
+        for (size_t v = 0; v < well_vectors.size(); v++){
+            keywords.push_back(well_vectors[v]);
+            wgnames.push_back(well_name(w));
+            units.push_back(well_units[v]);
+            data.push_back(well[v]);
+        }
+
+        for (size_t t = 0; t < nt; t++)
+            for (size_t v = 0; v < 3; v++)
+                field[v][t] += well[v][t];
+    }
+
+    for (size_t t = 1; t < nt; t++)
+        field[3][t] = field[3][t - 1] + field[0][t] * (time[t] - time[t - 1]);
+
+    for (size_t v = 0; v < field_vectors.size(); v++){
+        keywords.push_back(field_vectors[v]);
+        wgnames.push_back(":+:+:+:+");
+        units.push_back(field_units[v]);
+        data.push_back(field[v]);
+    }
+}
+
+
+void write_smspec_case(const BenchConfig& config, int case_ind, const std::filesystem::path& smspec_file)
+{
+    std::vector<std::string> keywords, wgnames, units;
+    std::vector<std::vector<float>> data;
+
+    make_case_data(config, case_ind, keywords, wgnames, units, data);
+
+    int nlist = static_cast<int>(keywords.size());
+
+    {
+        Opm::EclIO::EclOutput outfile(smspec_file.string(), false, std::ios::out);
+
+        outfile.write<int>("INTEHEAD", { 1, 100 });
+        outfile.write<std::string>("RESTART", std::vector<std::string>(9, ""));
+        outfile.write<int>("DIMENS", { nlist, 10, 10, 10, 0, -1 });
+        outfile.write<std::string>("KEYWORDS", keywords);
+        outfile.write<std::string>("WGNAMES", wgnames);
+        outfile.write<int>("NUMS", std::vector<int>(nlist, 0));
+        outfile.write<std::string>("UNITS", units);
+        outfile.write<int>("STARTDAT", { 1, 1, 2020, 0, 0, 0 });
+    }
+
+    std::filesystem::path unsmry_file = smspec_file;
+    unsmry_file.replace_extension(".UNSMRY");
+
+    Opm::EclIO::EclOutput outfile(unsmry_file.string(), false, std::ios::out);
+
+    std::vector<float> params(nlist);
+
+    for (int t = 0; t < config.num_tsteps; t++){
+
+        if (t % rstep_interval == 0)
+            outfile.write<int>("SEQHDR", { 0 });
+
+        for (int n = 0; n < nlist; n++)
+            params[n] = data[n][t];
+
+        outfile.write<int>("MINISTEP", { t });
+        outfile.write<float>("PARAMS", params);
+    }
+}
+
+
+void write_esmry_case(const BenchConfig& config, int case_ind, const std::filesystem::path& esmry_file)
+{
+    std::vector<std::string> keywords, wgnames, units;
+    std::vector<std::vector<float>> data;
+
+    make_case_data(config, case_ind, keywords, wgnames, units, data);
+
+    std::vector<std::string> keycheck;
+
+    for (size_t n = 0; n < keywords.size(); n++)
+        if (wgnames[n] == ":+:+:+:+")
+            keycheck.push_back(keywords[n]);
+        else
+            keycheck.push_back(keywords[n] + ":" + wgnames[n]);
+
+    std::vector<int> rstep(config.num_tsteps, 0);
+    std::vector<int> tstep(config.num_tsteps);
+
+    for (int t = 0; t < config.num_tsteps; t++){
+        rstep[t] = (t + 1) % rstep_interval == 0 ? 1 : 0;
+        tstep[t] = t;
+    }
+
+    rstep.back() = 1;
+
+    Opm::EclIO::EclOutput outfile(esmry_file.string(), false, std::ios::out);
+
+    outfile.write<int>("START", { 1, 1, 2020, 0, 0, 0, 0 });
+    outfile.write<std::string>("KEYCHECK", keycheck);
+    outfile.write<std::string>("UNITS", units);
+    outfile.write<int>("RSTEP", rstep);
+    outfile.write<int>("TSTEP", tstep);
+
+    for (size_t n = 0; n < data.size(); n++)
+        outfile.write<float>("V" + std::to_string(n), data[n]);
+}
+
+
+std::vector<std::string> make_cases(const BenchConfig& config)
+{
+    std::filesystem::create_directories(config.data_dir);
+
+    std::vector<std::string> fname_list(config.num_cases);
+
+    #pragma omp parallel for
+    for (int n = 0; n < config.num_cases; n++){
+        std::filesystem::path fname = config.data_dir / ("BENCH_" + std::to_string(n + 1));
+
+        if (n % 2 == 0){
+            fname.replace_extension(".SMSPEC");
+            write_smspec_case(config, n, fname);
+        } else {
+            fname.replace_extension(".ESMRY");
+            write_esmry_case(config, n, fname);
+        }
+
+        fname_list[n] = fname.string();
+    }
+
+    return fname_list;
+}
+
+
+// one chart for each well, WOPR for all cases
+
+SmryAppl::input_list_type make_input_charts(const BenchConfig& config)
+{
+    SmryAppl::input_list_type input_charts;
+
+    int num_charts = std::min(config.num_wells, config.num_charts);
+
+    for (int w = 0; w < num_charts; w++){
+        std::vector<SmryAppl::vect_input_type> vect_list;
+
+        for (int n = 0; n < config.num_cases; n++)
+            vect_list.push_back({ n, "WOPR:" + well_name(w), -1, false });
+
+        input_charts.push_back({ vect_list, "" });
+    }
+
+    return input_charts;
+}
+
+
+std::string write_define_cmdf(const BenchConfig& config)
+{
+    std::filesystem::path cmd_file = config.data_dir / "bench_define.txt";
+
+    std::ofstream ofs(cmd_file);
+
+    int num_wells = std::min(config.num_wells, config.num_charts);
+
+    for (int n = 0; n < config.num_cases; n++)
+        for (int w = 0; w < num_wells; w++){
+            std::string sind = std::to_string(n + 1);
+            std::string wname = well_name(w);
+
+            ofs << "DEFINE " << sind << ":WLPR:" << wname << " SM3/DAY = ${" << sind << ":WOPR:"
+                << wname << "}+${" << sind << ":WWPR:" << wname << "}\n";
+        }
+
+    ofs << "\nADD CHART\n";
+
+    for (int n = 0; n < config.num_cases; n++)
+        ofs << "ADD SERIES " << n + 1 << " WLPR:" << well_name(0) << "\n";
+
+    return cmd_file.string();
+}
+
+
+struct BenchResult {
+    std::string name;
+    std::vector<double> elapsed;
+};
+
+
+// elapsed time in ms for each repetition, setup is not included in timing
+
+BenchResult run_bench(const std::string& name, int repeat, const std::function<void()>& setup,
+                      const std::function<void()>& func)
+{
+    BenchResult result { name, {} };
+
+    for (int r = 0; r < repeat; r++){
+        setup();
+
+        auto start = std::chrono::steady_clock::now();
+        func();
+        auto end = std::chrono::steady_clock::now();
+
+        result.elapsed.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+    }
+
+    return result;
+}
+
+
+std::string to_json(const BenchResult& result, const BenchConfig& config)
+{
+    std::vector<double> sorted = result.elapsed;
+    std::sort(sorted.begin(), sorted.end());
+
+    std::ostringstream ss;
+    ss << std::fixed << std::setprecision(3);
+
+    ss << "{\"bench\": \"" << result.name << "\"";
+    ss << ", \"cases\": " << config.num_cases;
+    ss << ", \"wells\": " << config.num_wells;
+    ss << ", \"tsteps\": " << config.num_tsteps;
+    ss << ", \"threads\": " << omp_get_max_threads();
+    ss << ", \"repeat\": " << sorted.size();
+    ss << ", \"min_ms\": " << sorted.front();
+    ss << ", \"median_ms\": " << sorted[sorted.size() / 2];
+    ss << ", \"max_ms\": " << sorted.back();
+    ss << "}";
+
+    return ss.str();
+}
+
+
+// copy of SMSPEC case with time steps repeated config.scale times, TIME shifted for each copy
+
+std::string make_scaled_copy(const BenchConfig& config)
+{
+    std::filesystem::create_directories(config.data_dir);
+
+    std::filesystem::path smspec_file = config.data_dir / "SCALED.SMSPEC";
+    std::filesystem::copy_file(config.scale_case, smspec_file, std::filesystem::copy_options::overwrite_existing);
+
+    std::filesystem::path orig_unsmry = config.scale_case;
+    orig_unsmry.replace_extension(".UNSMRY");
+
+    UnsmryReader reader(orig_unsmry);
+
+    size_t nlist = reader.number_of_params();
+    size_t nstep = reader.number_of_time_steps();
+
+    std::vector<int> columns(nlist);
+    std::iota(columns.begin(), columns.end(), 0);
+
+    auto data = reader.get(columns);
+    int time_ind = make_smspec_index(config.scale_case).at("TIME");
+
+    float time_shift = data[time_ind].back();
+
+    std::filesystem::path unsmry_file = smspec_file;
+    unsmry_file.replace_extension(".UNSMRY");
+
+    Opm::EclIO::EclOutput outfile(unsmry_file.string(), false, std::ios::out);
+
+    std::vector<float> params(nlist);
+    int ministep = 0;
+
+    // SEQHDR before the first time step in each report step
+
+    std::vector<bool> report_end(nstep, false);
+
+    for (auto t : reader.report_step_index())
+        report_end[t] = true;
+
+    for (int k = 0; k < config.scale; k++)
+        for (size_t t = 0; t < nstep; t++){
+
+            if ((t == 0) || (report_end[t - 1]))
+                outfile.write<int>("SEQHDR", { 0 });
+
+            for (size_t n = 0; n < nlist; n++)
+                params[n] = data[n][t];
+
+            params[time_ind] += time_shift * k;
+
+            outfile.write<int>("MINISTEP", { ministep++ });
+            outfile.write<float>("PARAMS", params);
+        }
+
+    return smspec_file.string();
+}
+
+
+// all vectors in SMSPEC case, ESmry::loadData compared to UnsmryReader
+
+void bench_unsmry(const std::string& smspec_file, const std::string& label, const BenchConfig& config,
+                  std::vector<BenchResult>& results)
+{
+    std::filesystem::path unsmry_file = smspec_file;
+    unsmry_file.replace_extension(".UNSMRY");
+
+    std::vector<float> ref_data;
+    std::vector<float> reader_data;
+
+    auto index = make_smspec_index(smspec_file);
+    std::string check_key = index.count("FOPR") > 0 ? "FOPR" : "TIME";
+
+    results.push_back(run_bench("unsmry_esmry_loaddata" + label, config.repeat, []{}, [&]{
+        Opm::EclIO::ESmry smry(smspec_file);
+        smry.loadData();
+        ref_data = smry.get(check_key);
+    }));
+
+    results.push_back(run_bench("unsmry_mmap_reader" + label, config.repeat, []{}, [&]{
+        auto index = make_smspec_index(smspec_file);
+
+        std::vector<std::string> keys;
+        std::vector<int> columns;
+
+        for (auto& entry : index){
+            keys.push_back(entry.first);
+            columns.push_back(entry.second);
+        }
+
+        UnsmryReader reader(unsmry_file);
+        auto data = reader.get(columns);
+
+        auto it = std::find(keys.begin(), keys.end(), check_key);
+        reader_data = data[std::distance(keys.begin(), it)];
+    }));
+
+    if (ref_data != reader_data)
+        std::cout << "\n!Warning, UnsmryReader and ESmry not equal for " << check_key << " in " << smspec_file << "\n";
+}
+
+
+void printHelp()
+{
+    std::cout << "\nUsage: qsum_bench [OPTIONS] \n";
+
+    std::cout << "\noptions: \n\n";
+
+    std::cout << " -w   Number of wells in each case, default 100 \n";
+    std::cout << " -t   Number of time steps, default 2000 \n";
+    std::cout << " -c   Number of cases, default 4 \n";
+    std::cout << " -n   Max number of charts, one chart for each well, default 50 \n";
+    std::cout << " -p   Number of charts exported to pdf, default 10 \n";
+    std::cout << " -r   Number of repetitions for each benchmark, default 3 \n";
+    std::cout << " -d   Folder for generated summary files, default qsum_bench_data \n";
+    std::cout << " -o   Write results to file, default is standard output only \n";
+    std::cout << " -u   SMSPEC case used for UNSMRY benchmark, scaled up with option -k \n";
+    std::cout << " -k   Number of copies of time steps in scaled case (-u), default 100 \n";
+    std::cout << " -h   Print help message and exit \n\n";
+}
+
+} // namespace
+
+
+int main(int argc, char *argv[])
+{
+    BenchConfig config;
+
+    int c = 0;
+
+    while ((c = getopt(argc, argv, "c:d:hk:n:o:p:r:t:u:w:")) != -1) {
+        switch (c) {
+        case 'c':
+            config.num_cases = std::stoi(optarg);
+            break;
+        case 'd':
+            config.data_dir = optarg;
+            break;
+        case 'h':
+            printHelp();
+            exit(0);
+        case 'k':
+            config.scale = std::max(1, std::stoi(optarg));
+            break;
+        case 'n':
+            config.num_charts = std::stoi(optarg);
+            break;
+        case 'o':
+            config.out_file = optarg;
+            break;
+        case 'p':
+            config.num_pdf_pages = std::stoi(optarg);
+            break;
+        case 'r':
+            config.repeat = std::max(1, std::stoi(optarg));
+            break;
+        case 't':
+            config.num_tsteps = std::stoi(optarg);
+            break;
+        case 'u':
+            config.scale_case = optarg;
+            break;
+        case 'w':
+            config.num_wells = std::stoi(optarg);
+            break;
+        default:
+            printHelp();
+            exit(1);
+        }
+    }
+
+    if ((config.num_cases < 1) || (config.num_wells < 1) || (config.num_tsteps < 2)){
+        std::cout << "\n!Error, at least one case, one well and two time steps needed \n\n";
+        exit(1);
+    }
+
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+
+    std::vector<BenchResult> results;
+
+    std::vector<std::string> fname_list;
+
+    results.push_back(run_bench("generate", 1, []{}, [&]{ fname_list = make_cases(config); }));
+
+    SmryAppl::input_list_type input_charts = make_input_charts(config);
+    SmryAppl::loader_list_type loaders;
+
+    std::vector<std::string> smspec_list, esmry_list;
+
+    for (auto& fname : fname_list)
+        if (std::filesystem::path(fname).extension() == ".SMSPEC")
+            smspec_list.push_back(fname);
+        else
+            esmry_list.push_back(fname);
+
+    results.push_back(run_bench("open_smspec", config.repeat, []{},
+                                [&]{ loaders = QSum::make_loaders(smspec_list); }));
+
+    if (esmry_list.size() > 0)
+        results.push_back(run_bench("open_esmry", config.repeat, []{},
+                                    [&]{ loaders = QSum::make_loaders(esmry_list); }));
+
+    auto new_loaders = [&]{ loaders = QSum::make_loaders(fname_list); };
+
+    auto pre_load = [&]{
+        QSum::pre_load_smry(std::get<0>(loaders), input_charts, std::get<1>(loaders),
+                            std::get<2>(loaders), std::get<3>(loaders), omp_get_max_threads());
+    };
+
+    results.push_back(run_bench("preload", config.repeat, new_loaders, pre_load));
+
+    if (smspec_list.size() > 0)
+        bench_unsmry(smspec_list[0], "", config, results);
+
+    if (!config.scale_case.empty())
+        bench_unsmry(make_scaled_copy(config), "_scaled", config, results);
+
+    {
+        std::string cmd_file = write_define_cmdf(config);
+
+        std::unique_ptr<DerivedSmry> derived_smry;
+
+        results.push_back(run_bench("derived_smry", config.repeat, new_loaders, [&]{
+            QsumCMDF cmdfile(cmd_file, config.num_cases, "");
+            derived_smry = std::make_unique<DerivedSmry>(cmdfile, std::get<1>(loaders),
+                                                         std::get<2>(loaders), std::get<3>(loaders));
+        }));
+    }
+
+    std::unique_ptr<SmryAppl> window;
+    std::unique_ptr<DerivedSmry> derived_smry;
+
+    results.push_back(run_bench("create_series", config.repeat, [&]{ window.reset(); new_loaders(); pre_load(); }, [&]{
+        window = std::make_unique<SmryAppl>(fname_list, loaders, input_charts, derived_smry);
+    }));
+
+    window->resize(1400, 700);
+    window->show();
+
+    QLineEdit* cmdline = window->get_cmdline();
+
+    size_t num_charts = window->number_of_charts();
+
+    // rescale x and y axis for all charts, from first to last non-zero
+
+    results.push_back(run_bench("yaxis_rescale", config.repeat,
+                                [&]{ QTest::keyEvent(QTest::Click, cmdline, Qt::Key_Home); }, [&]{
+        for (size_t n = 0; n < num_charts; n++){
+            QTest::keyEvent(QTest::Click, cmdline, Qt::Key_X, Qt::ControlModifier);
+
+            if (n < num_charts - 1)
+                QTest::keyEvent(QTest::Click, cmdline, Qt::Key_PageDown);
+        }
+    }));
+
+    std::filesystem::path pdf_file = std::filesystem::absolute(config.data_dir / "bench.pdf");
+
+    size_t num_pages = std::min(num_charts, static_cast<size_t>(std::max(1, config.num_pdf_pages)));
+    std::string pdf_cmd = ":pdf " + pdf_file.string() + " 1-" + std::to_string(num_pages);
+
+    results.push_back(run_bench("pdf_export", config.repeat, [&]{ std::filesystem::remove(pdf_file); },
+                                [&]{ QSum::add_cmd_line(pdf_cmd, cmdline); }));
+
+    if (!std::filesystem::exists(pdf_file))
+        std::cout << "\n!Warning, pdf file " << pdf_file << " not written \n";
+
+    std::ofstream ofs;
+
+    if (config.out_file.size() > 0)
+        ofs.open(config.out_file);
+
+    for (auto& result : results){
+        std::string json = to_json(result, config);
+
+        std::cout << json << std::endl;
+
+        if (ofs.is_open())
+            ofs << json << "\n";
+    }
+
+    return 0;
+}
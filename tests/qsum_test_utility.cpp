@@ -55,7 +55,7 @@ SmryAppl::loader_list_type QSum::make_loaders(std::vector<std::string>& fname_li
             throw std::invalid_argument("Invalid file type");
     }
 
-    loaders = std::make_tuple(smry_files, ftype_list, std::move(esmry_loader), std::move(ext_esmry_loader));
+    loaders = std::make_tuple(smry_files, ftype_list, std::move(esmry_loader), std::move(ext_esmry_loader), source_list_type());
 
     return loaders;
 }
@@ -0,0 +1,90 @@
+/*
+   Copyright 2022 Equinor ASA.
+
+   This file is part of the Open Porous Media project (OPM).
+
+   OPM is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   OPM is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#include <QtTest/QtTest>
+
+#include <appl/case_discovery.hpp>
+#include <tests/qsum_test_utility.hpp>
+
+#include <fstream>
+
+class TestQsummary: public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void test_case_discovery();
+};
+
+
+void TestQsummary::test_case_discovery()
+{
+    QCOMPARE(natural_less("realization-2", "realization-10"), true);
+    QCOMPARE(natural_less("realization-10", "realization-2"), false);
+    QCOMPARE(natural_less("CASE_01", "CASE_1A"), true);
+
+    QTemporaryDir ens_dir;
+    QVERIFY(ens_dir.isValid());
+
+    std::filesystem::path ens_path(ens_dir.path().toStdString());
+
+    for (int r : { 0, 1, 2, 10 }) {
+        auto model = ens_path / ("realization-" + std::to_string(r)) / "iter-0" / "eclipse" / "model";
+        std::filesystem::create_directories(model);
+        std::filesystem::copy_file("../tests/smry_files/SENS0.SMSPEC", model / "CASE.SMSPEC");
+
+        // realization-2 has not written any time steps yet
+
+        if (r == 2)
+            std::ofstream(model / "CASE.UNSMRY").close();
+        else
+            std::filesystem::copy_file("../tests/smry_files/SENS0.UNSMRY", model / "CASE.UNSMRY");
+    }
+
+    // ESMRY with same root name as SMSPEC is not a separate case
+
+    std::filesystem::copy_file("../tests/smry_files/SENS0.ESMRY", ens_path / "realization-1/iter-0/eclipse/model/CASE.ESMRY");
+
+    CaseDiscovery pattern_discovery;
+    pattern_discovery.add_argument((ens_path / "realization-*/iter-*/eclipse/model/*.SMSPEC").string());
+
+    auto cases = pattern_discovery.find_cases();
+
+    QCOMPARE(cases.size(), size_t(3));
+    QCOMPARE(pattern_discovery.skipped().size(), size_t(1));
+    QVERIFY(cases[2].find("realization-10") != std::string::npos);
+
+    CaseDiscovery dir_discovery;
+    dir_discovery.add_argument(ens_path.string());
+    dir_discovery.add_argument((ens_path / "realization-0").string());
+
+    auto dir_cases = dir_discovery.find_cases();
+
+    QCOMPARE(dir_cases.size(), size_t(3));
+    QCOMPARE(dir_discovery.discovery_used(), true);
+
+    for (size_t n = 0; n < cases.size(); n++)
+        QCOMPARE(std::filesystem::path(dir_cases[n]).lexically_normal().string(),
+                 std::filesystem::path(cases[n]).lexically_normal().string());
+}
+
+
+QTEST_MAIN(TestQsummary)
+
+#include "test_case_discovery.moc"
@@ -43,6 +43,8 @@ private slots:
    void test_3a();
    void test_3b();
    void test_3c();
+   void test_cache();
+   void test_5a();
 };
 
 // https://doc.qt.io/qt-6/qtest-tutorial.html
@@ -783,6 +785,90 @@ void TestQsummary::test_3c()
 }
 
 
+void TestQsummary::test_cache()
+{
+    QTemporaryDir cache_dir;
+    QVERIFY(cache_dir.isValid());
+
+    qputenv("XDG_CACHE_HOME", cache_dir.path().toLocal8Bit());
+
+    std::string cmd_file = "../tests/cmd_files/test3c.txt";
+
+    SmryAppl::input_list_type ref_charts;
+    SmryAppl::input_list_type cached_charts;
+
+    {
+        QsumCMDF cmdfile(cmd_file, 3, "", true);
+        QCOMPARE(cmdfile.loaded_from_cache(), false);
+
+        cmdfile.make_charts_from_cmd(ref_charts, "");
+    }
+
+    {
+        QsumCMDF cmdfile(cmd_file, 3, "", true);
+        QCOMPARE(cmdfile.loaded_from_cache(), true);
+        QCOMPARE(cmdfile.count_define(), 9);
+
+        cmdfile.make_charts_from_cmd(cached_charts, "");
+    }
+
+    QCOMPARE(cached_charts.size(), ref_charts.size());
+
+    for (size_t n = 0; n < ref_charts.size(); n++)
+        QCOMPARE(std::get<0>(cached_charts[n]), std::get<0>(ref_charts[n]));
+
+    // number of cases is part of the cache key
+    {
+        QsumCMDF cmdfile(cmd_file, 2, "", true);
+        QCOMPARE(cmdfile.loaded_from_cache(), false);
+        QCOMPARE(cmdfile.count_define(), 6);
+    }
+}
+
+
+void TestQsummary::test_5a()
+{
+    // GROUP and PRELOAD directives, ensemble chart
+
+    std::string cmd_file = "../tests/cmd_files/test5a.txt";
+    QsumCMDF cmdfile(cmd_file, 3, "PROD-1,PROD-2");
+
+    SmryAppl::input_list_type input_charts;
+
+    cmdfile.make_charts_from_cmd(input_charts, "");
+
+    auto chart_props = cmdfile.get_chart_props();
+
+    QCOMPARE(input_charts.size(), 6);
+    QCOMPARE(chart_props.size(), 6);
+
+    std::vector<QsumCMDF::chart_props_type> ref_props;
+
+    ref_props.push_back({"FIELD", false, false, false});
+    ref_props.push_back({"WELLS", true, false, false});
+    ref_props.push_back({"WELLS", true, false, false});
+    ref_props.push_back({"HISTORY", true, true, false});
+    ref_props.push_back({"", false, false, false});
+    ref_props.push_back({"", false, false, true});
+
+    for (size_t n = 0; n < chart_props.size(); n++)
+        QCOMPARE(chart_props[n], ref_props[n]);
+
+    QCOMPARE(std::get<0>(input_charts[5]).size(), 3);
+
+    auto preload = cmdfile.get_preload_list();
+
+    QCOMPARE(preload.size(), 3);
+
+    std::vector<std::string> ref_preload_1 = {"FOPR", "FWPR"};
+    std::vector<std::string> ref_preload_2 = {"FOPR", "FWPR", "FGPR"};
+
+    QCOMPARE(preload[0] == ref_preload_1, true);
+    QCOMPARE(preload[1] == ref_preload_2, true);
+    QCOMPARE(preload[2] == ref_preload_1, true);
+}
+
+
 QTEST_MAIN(TestQsummary)
 
 #include "test_cmdf_input_charts.moc"
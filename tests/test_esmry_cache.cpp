@@ -0,0 +1,99 @@
+/*
+   Copyright 2022 Equinor ASA.
+
+   This file is part of the Open Porous Media project (OPM).
+
+   OPM is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   OPM is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#include <QtTest/QtTest>
+
+#include <appl/esmry_cache.hpp>
+#include <tests/qsum_test_utility.hpp>
+
+#include <chrono>
+
+#include <opm/io/eclipse/ESmry.hpp>
+#include <opm/io/eclipse/ExtESmry.hpp>
+
+class TestQsummary: public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void test_esmry_cache();
+};
+
+
+void TestQsummary::test_esmry_cache()
+{
+    QTemporaryDir cache_dir;
+    QTemporaryDir case_dir;
+    QVERIFY(cache_dir.isValid() && case_dir.isValid());
+
+    qputenv("XDG_CACHE_HOME", cache_dir.path().toLocal8Bit());
+
+    std::filesystem::path case_path(case_dir.path().toStdString());
+    std::filesystem::path smspec_file = case_path / "SENS0.SMSPEC";
+
+    std::filesystem::copy_file("../tests/smry_files/SENS0.SMSPEC", smspec_file);
+    std::filesystem::copy_file("../tests/smry_files/SENS0.UNSMRY", case_path / "SENS0.UNSMRY");
+
+    QCOMPARE(EsmryCache::is_cacheable(smspec_file), true);
+    QCOMPARE(EsmryCache::is_valid(smspec_file), false);
+
+    QCOMPARE(EsmryCache::convert(smspec_file), true);
+    QCOMPARE(EsmryCache::is_valid(smspec_file), true);
+    QCOMPARE(EsmryCache::cached_file(smspec_file).stem().string(), std::string("SENS0"));
+
+    std::unordered_map<int, std::unique_ptr<Opm::EclIO::ESmry>> esmry_loader;
+    std::unordered_map<int, std::unique_ptr<Opm::EclIO::ExtESmry>> lodsmry_loader;
+
+    esmry_loader[0] = std::make_unique<Opm::EclIO::ESmry>(smspec_file);
+    lodsmry_loader[1] = std::make_unique<Opm::EclIO::ExtESmry>(EsmryCache::cached_file(smspec_file));
+
+    auto sources = make_summary_sources({ FileType::SMSPEC, FileType::ESMRY }, esmry_loader, lodsmry_loader,
+                                        { smspec_file, smspec_file });
+
+    QCOMPARE(sources[1]->file_type() == FileType::ESMRY, true);
+    QCOMPARE(sources[0]->start_date() == sources[1]->start_date(), true);
+    QCOMPARE(sources[0]->keyword_list() == sources[1]->keyword_list(), true);
+
+    for (auto& key : sources[0]->keyword_list())
+        QCOMPARE(sources[0]->get(key) == sources[1]->get(key), true);
+
+    QCOMPARE(sources[1]->reopen(), false);
+
+    // updated case, cached file no longer valid and source continues with SMSPEC
+
+    auto ftime = std::filesystem::last_write_time(smspec_file);
+    std::filesystem::last_write_time(case_path / "SENS0.UNSMRY", ftime + std::chrono::seconds(10));
+    std::filesystem::last_write_time(smspec_file, ftime + std::chrono::seconds(10));
+
+    QCOMPARE(EsmryCache::is_valid(smspec_file), false);
+    QCOMPARE(sources[1]->reopen(), true);
+    QCOMPARE(sources[1]->file_type() == FileType::SMSPEC, true);
+    QCOMPARE(sources[1]->get("FOPT") == sources[0]->get("FOPT"), true);
+
+    // converted again, back to cached file on next reload without a data change
+
+    QCOMPARE(EsmryCache::convert(smspec_file), true);
+    QCOMPARE(sources[1]->reopen(), false);
+    QCOMPARE(sources[1]->file_type() == FileType::ESMRY, true);
+}
+
+
+QTEST_MAIN(TestQsummary)
+
+#include "test_esmry_cache.moc"
@@ -0,0 +1,144 @@
+/*
+   Copyright 2022 Equinor ASA.
+
+   This file is part of the Open Porous Media project (OPM).
+
+   OPM is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   OPM is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#include <QtTest/QtTest>
+
+#include <appl/formatted_smry.hpp>
+#include <appl/esmry_cache.hpp>
+#include <tests/qsum_test_utility.hpp>
+
+#include <cmath>
+#include <fstream>
+
+#include <opm/io/eclipse/ESmry.hpp>
+#include <opm/io/eclipse/ExtESmry.hpp>
+#include <opm/io/eclipse/EclFile.hpp>
+#include <opm/io/eclipse/EclOutput.hpp>
+
+class TestQsummary: public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void test_formatted_smry();
+};
+
+
+// formatted copy of a binary file, all arrays written with the same name and type
+
+static void write_formatted(const std::filesystem::path& binary_file, const std::filesystem::path& formatted_file)
+{
+    Opm::EclIO::EclFile input(binary_file.string());
+    input.loadData();
+
+    Opm::EclIO::EclOutput output(formatted_file.string(), true, std::ios::out);
+
+    auto array_list = input.getList();
+
+    for (size_t n = 0; n < array_list.size(); n++) {
+        auto& [name, type, size] = array_list[n];
+
+        if (type == Opm::EclIO::INTE)
+            output.write(name, input.get<int>(n));
+        else if (type == Opm::EclIO::REAL)
+            output.write(name, input.get<float>(n));
+        else if (type == Opm::EclIO::DOUB)
+            output.write(name, input.get<double>(n));
+        else if (type == Opm::EclIO::LOGI)
+            output.write(name, input.get<bool>(n));
+        else if ((type == Opm::EclIO::CHAR) || (type == Opm::EclIO::C0NN))
+            output.write(name, input.get<std::string>(n));
+    }
+}
+
+void TestQsummary::test_formatted_smry()
+{
+    QTemporaryDir cache_dir;
+    QTemporaryDir case_dir;
+    QVERIFY(cache_dir.isValid() && case_dir.isValid());
+
+    qputenv("XDG_CACHE_HOME", cache_dir.path().toLocal8Bit());
+
+    std::filesystem::path case_path(case_dir.path().toStdString());
+    std::filesystem::path fsmspec_file = case_path / "SENS1.FSMSPEC";
+
+    write_formatted("../tests/smry_files/SENS1.SMSPEC", fsmspec_file);
+    write_formatted("../tests/smry_files/SENS1.UNSMRY", case_path / "SENS1.FUNSMRY");
+
+    Opm::EclIO::ESmry smry("../tests/smry_files/SENS1.SMSPEC");
+    smry.loadData();
+
+    FormattedSmryReader reader(fsmspec_file);
+
+    QCOMPARE(reader.number_of_time_steps(), smry.get("TIME").size());
+    QVERIFY(reader.keyword_list().size() > 100);
+
+    // formatted values have 8 significant digits
+
+    for (size_t n = 0; n < reader.keyword_list().size(); n++) {
+        auto& key = reader.keyword_list()[n];
+        auto& ref = smry.get(key);
+
+        QCOMPARE(reader.units()[n], smry.get_unit(key));
+
+        for (size_t t = 0; t < ref.size(); t++)
+            QVERIFY(std::abs(reader.get(n)[t] - ref[t]) <= 1e-6 * std::abs(ref[t]));
+    }
+
+    // source served from the parsed data, no ESMRY file written
+
+    FormattedSource source(fsmspec_file);
+
+    QCOMPARE(source.file_type() == FileType::FORMATTED, true);
+    QCOMPARE(source.rootname(), std::string("SENS1"));
+    QCOMPARE(source.number_of_time_steps(), smry.numberOfTimeSteps());
+    QCOMPARE(source.keyword_list().size(), reader.keyword_list().size());
+    QCOMPARE(source.get("FOPT").size(), smry.get("FOPT").size());
+    QCOMPARE(source.get_unit("FOPT"), smry.get_unit("FOPT"));
+    QCOMPARE(source.report_step_index().size(), smry.get_at_rstep("TIME").size());
+    QCOMPARE(source.startdate() == smry.startdate(), true);
+    QCOMPARE(source.reopen(), false);
+    QCOMPARE(EsmryCache::is_valid(fsmspec_file), false);
+
+    // errors found when parsing chunks in parallel are thrown after the parallel loop
+
+    std::filesystem::path bad_fsmspec = case_path / "BAD.FSMSPEC";
+    std::filesystem::copy_file(fsmspec_file, bad_fsmspec);
+
+    {
+        std::ofstream ofs(case_path / "BAD.FUNSMRY");
+        ofs << " 'SEQHDR  '           1 'INTE'\n           0\n";
+        ofs << " 'PARAMS  '           2 'REAL'\n   1.0000000E+00   2.0000000E+00\n";
+    }
+
+    QVERIFY_THROWS_EXCEPTION(std::runtime_error, FormattedSmryReader bad_reader(bad_fsmspec));
+
+    QCOMPARE(EsmryCache::is_cacheable(fsmspec_file), true);
+    QCOMPARE(EsmryCache::convert(fsmspec_file), true);
+
+    Opm::EclIO::ExtESmry cached(EsmryCache::cached_file(fsmspec_file));
+
+    QCOMPARE(cached.start_v()[2], smry.start_v()[2]);
+    QCOMPARE(cached.get_at_rstep("FOPT").size(), smry.get_at_rstep("FOPT").size());
+}
+
+
+QTEST_MAIN(TestQsummary)
+
+#include "test_formatted_smry.moc"
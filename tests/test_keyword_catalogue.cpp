@@ -0,0 +1,181 @@
+/*
+   Copyright 2022 Equinor ASA.
+
+   This file is part of the Open Porous Media project (OPM).
+
+   OPM is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   OPM is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#include <QtTest/QtTest>
+
+#include <appl/keyword_catalogue.hpp>
+#include <appl/qsum_func_lib.hpp>
+#include <tests/qsum_test_utility.hpp>
+
+#include <opm/io/eclipse/ESmry.hpp>
+#include <opm/io/eclipse/ExtESmry.hpp>
+
+
+class TestQsummary: public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void test_patterns();
+    void test_prefix_range();
+    void test_update_case();
+    void test_loaders();
+    void test_expand_pattern();
+};
+
+
+void TestQsummary::test_patterns()
+{
+    KeywordCatalogue catalogue;
+
+    catalogue.add_case({"FOPR", "WOPR:PROD-2", "WOPR:PROD-1", "WWCT:PROD-1", "WOPRH:PROD-1", "TIME"});
+    catalogue.add_case({"FOPR", "WOPR:PROD-3", "GOPR:G1"});
+
+    QCOMPARE(catalogue.number_of_cases(), 2);
+
+    // pattern results follow the order of the input key list
+
+    std::vector<std::string> ref1 = {"WOPR:PROD-2", "WOPR:PROD-1"};
+    QCOMPARE(catalogue.keyword_list(0, "WOPR:*") == ref1, true);
+
+    std::vector<std::string> ref2 = {"WOPR:PROD-1", "WWCT:PROD-1", "WOPRH:PROD-1"};
+    QCOMPARE(catalogue.keyword_list(0, "*:PROD-1") == ref2, true);
+
+    std::vector<std::string> ref3 = {"PROD-3"};
+    QCOMPARE(catalogue.item_names(1, "WOPR", "*") == ref3, true);
+
+    QCOMPARE(catalogue.keyword_list(1, "WWCT:*").size(), 0);
+
+    QCOMPARE(catalogue.has_key(0, "WOPR:PROD-3"), false);
+    QCOMPARE(catalogue.has_key(1, "WOPR:PROD-3"), true);
+    QCOMPARE(catalogue.has_key(0, "WOPR:PROD-1"), true);
+    QCOMPARE(catalogue.has_key(1, "XXXX"), false);
+    QCOMPARE(catalogue.has_key(2, "FOPR"), false);
+}
+
+
+void TestQsummary::test_prefix_range()
+{
+    KeywordCatalogue catalogue;
+
+    catalogue.add_case({"FOPR", "WOPR:B", "WOPR:A", "WWCT:A", "WOPRH:A", "TIME"});
+
+    auto range = catalogue.prefix_range(0, "WOPR");
+
+    QCOMPARE(range.second - range.first, 3);
+    QCOMPARE(catalogue.sorted_key(0, range.first) == "WOPR:A", true);
+
+    range = catalogue.prefix_range(0, "WOPR:");
+    QCOMPARE(range.second - range.first, 2);
+
+    range = catalogue.prefix_range(0, "X");
+    QCOMPARE(range.second - range.first, 0);
+
+    range = catalogue.prefix_range(0, "");
+    QCOMPARE(range.second - range.first, 6);
+
+    QCOMPARE(KeywordCatalogue::literal_prefix("WOPR:P*") == "WOPR:P", true);
+    QCOMPARE(KeywordCatalogue::literal_prefix("*:P1").empty(), true);
+}
+
+
+void TestQsummary::test_update_case()
+{
+    KeywordCatalogue catalogue;
+
+    catalogue.add_case({"FOPR", "WOPR:A"});
+    catalogue.add_case({"FOPR"});
+
+    catalogue.update_case(0, {"FOPR", "WOPR:A", "WOPR:NEW"});
+
+    QCOMPARE(catalogue.has_key(0, "WOPR:NEW"), true);
+    QCOMPARE(catalogue.has_key(1, "WOPR:NEW"), false);
+    QCOMPARE(catalogue.keyword_list(0, "WOPR:*").size(), 2);
+
+    QVERIFY_THROWS_EXCEPTION(std::invalid_argument, catalogue.update_case(5, {"FOPR"}));
+}
+
+
+void TestQsummary::test_loaders()
+{
+    // catalogue must give the same result as the loaders
+
+    std::vector<std::string> fname_list;
+
+    fname_list.push_back("../tests/smry_files/SENS0.ESMRY");
+    fname_list.push_back("../tests/smry_files/SENS1.SMSPEC");
+
+    SmryAppl::loader_list_type loaders = QSum::make_loaders(fname_list);
+
+    auto& file_type = std::get<1>(loaders);
+    auto& esmry_loader = std::get<2>(loaders);
+    auto& lodsmry_loader = std::get<3>(loaders);
+
+    auto catalogue = QSum::make_keyword_catalogue(file_type, esmry_loader, lodsmry_loader);
+
+    QCOMPARE(catalogue.number_of_cases(), 2);
+
+    for (auto pattern : {"W*", "WOPR:*", "*:PROD*", "F?PR", "G*"}) {
+        QCOMPARE(catalogue.keyword_list(0, pattern) == lodsmry_loader[0]->keywordList(pattern), true);
+        QCOMPARE(catalogue.keyword_list(1, pattern) == esmry_loader[1]->keywordList(pattern), true);
+    }
+
+    for (auto& key : esmry_loader[1]->keywordList())
+        QCOMPARE(catalogue.has_key(1, key), true);
+}
+
+
+void TestQsummary::test_expand_pattern()
+{
+    // well P3 only in second case, well P1 only in first case
+
+    KeywordCatalogue catalogue;
+
+    catalogue.add_case({"FOPR", "WOPR:P1", "WOPR:P2", "WWCT:P1", "WWCT:P2"});
+    catalogue.add_case({"FOPR", "WOPR:P2", "WOPR:P3", "WWCT:P3"});
+
+    std::vector<std::string> ref1 = {"WOPR:P1", "WOPR:P2", "WOPR:P3"};
+    QCOMPARE(QSum::expand_pattern(catalogue, "WOPR:*") == ref1, true);
+
+    std::vector<std::string> ref2 = {"WOPR:P2"};
+    QCOMPARE(QSum::expand_pattern(catalogue, "WOPR:*", true) == ref2, true);
+
+    std::vector<std::string> ref3 = {"WOPR+WWCT:P1", "WOPR+WWCT:P2", "WOPR+WWCT:P3"};
+    QCOMPARE(QSum::expand_pattern(catalogue, "WOPR+WWCT:*") == ref3, true);
+
+    std::vector<std::string> ref4 = {"WOPR:P2"};
+    QCOMPARE(QSum::expand_pattern(catalogue, "WOPR+WWCT:*", true) == ref4, true);
+
+    // one chart per well, with series for each case having the vector
+
+    SmryAppl::input_list_type input_charts;
+    std::string vect_string = "WOPR:*";
+
+    QSum::chart_input_from_string(vect_string, input_charts, catalogue, 100, "");
+
+    QCOMPARE(input_charts.size(), 3);
+    QCOMPARE(std::get<0>(input_charts[0]).size(), 1);
+    QCOMPARE(std::get<0>(input_charts[1]).size(), 2);
+    QCOMPARE(std::get<0>(std::get<0>(input_charts[2])[0]), 1);
+}
+
+
+QTEST_MAIN(TestQsummary)
+
+#include "test_keyword_catalogue.moc"
@@ -0,0 +1,139 @@
+/*
+   Copyright 2022 Equinor ASA.
+
+   This file is part of the Open Porous Media project (OPM).
+
+   OPM is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   OPM is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#include <QtTest/QtTest>
+
+#include <appl/live_source.hpp>
+#include <appl/series_data.hpp>
+#include <tests/qsum_test_utility.hpp>
+
+class TestQsummary: public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void test_live_source();
+};
+
+
+void TestQsummary::test_live_source()
+{
+    std::vector<std::string> keys = { "TIME", "FOPR", "WOPR:PROD" };
+    std::vector<std::string> units = { "DAYS", "SM3/DAY", "SM3/DAY" };
+
+    std::string stream = encode_live_header({ 1, 1, 2020, 0, 0, 0, 0 }, keys, units);
+
+    for (int n = 0; n < 5; n++)
+        stream += encode_live_step({ float(n * 10), float(n * 100), float(n) }, n == 0);
+
+    // frames split at arbitrary positions, as received from a socket
+
+    LiveSource source("LIVE");
+    LiveFrameDecoder decoder;
+
+    for (size_t pos = 0; pos < stream.size(); pos += 7)
+        decoder.feed(stream.data() + pos, std::min<size_t>(7, stream.size() - pos), source);
+
+    QCOMPARE(source.number_of_time_steps(), 5);
+    QCOMPARE(source.get("FOPR")[3], 300.0f);
+    QCOMPARE(source.get_unit("WOPR:PROD"), std::string("SM3/DAY"));
+    QCOMPARE(source.keyword_list("W*").size(), size_t(1));
+
+    // only the first time step flagged, all time steps used as report steps
+    QCOMPARE(source.report_step_index().size(), size_t(5));
+
+    QCOMPARE(source.reopen(), true);
+    QCOMPARE(source.reopen(), false);
+    QCOMPARE(source.finished(), false);
+
+    std::string end = encode_live_end();
+    decoder.feed(end.data(), end.size(), source);
+    QCOMPARE(source.finished(), true);
+
+    std::string bad_step = encode_live_step({ 1.0f });
+    QVERIFY_THROWS_EXCEPTION(std::runtime_error, decoder.feed(bad_step.data(), bad_step.size(), source));
+
+    // rejected header leaves the case as it was
+
+    QVERIFY_THROWS_EXCEPTION(std::invalid_argument, source.set_header({ 1, 1, 2021, 0, 0, 0, 0 }, { "FOPR", "FGPR" },
+                                                                      { "SM3/DAY", "SM3/DAY" }));
+    QCOMPARE(source.number_of_keys(), size_t(3));
+    QCOMPARE(source.has_key("FGPR"), false);
+    QCOMPARE(source.number_of_time_steps(), 5);
+
+    // producer connected to the local server
+
+    LiveSource live_source("QSUM_TEST_LIVE");
+    LiveFeed feed("qsum_test_live", 0, live_source);
+
+    QVERIFY(feed.listen());
+
+    QSignalSpy header_spy(&feed, &LiveFeed::header_received);
+    QSignalSpy steps_spy(&feed, &LiveFeed::steps_received);
+
+    QLocalSocket producer;
+    producer.connectToServer("qsum_test_live");
+    QVERIFY(producer.waitForConnected(5000));
+
+    producer.write(stream.data(), stream.size());
+    producer.flush();
+
+    QTRY_COMPARE(live_source.number_of_time_steps(), 5);
+    QVERIFY(header_spy.count() > 0);
+
+    std::string more = encode_live_step({ 50.0f, 500.0f, 5.0f });
+    producer.write(more.data(), more.size());
+    producer.flush();
+
+    QTRY_COMPARE(live_source.number_of_time_steps(), 6);
+    QVERIFY(steps_spy.count() > 0);
+    QCOMPARE(steps_spy.last().at(1).toInt(), 5);
+    QCOMPARE(live_source.get("TIME").back(), 50.0f);
+
+    // series data for live cases is appended one time step at the time, stats merged from
+    // the appended values only give the same result as a pass over all values
+
+    const std::vector<float>& timev = live_source.get("TIME");
+    const std::vector<float>& fopr = live_source.get("FOPR");
+
+    SeriesData streamed;
+    std::vector<int64_t> time_ms;
+    std::vector<double> values;
+
+    for (size_t n = 0; n < timev.size(); n++) {
+        streamed.append({ int64_t(timev[n]) }, { fopr[n] });
+        time_ms.push_back(int64_t(timev[n]));
+        values.push_back(fopr[n]);
+    }
+
+    SeriesData assigned;
+    assigned.assign(std::move(time_ms), std::move(values));
+
+    QCOMPARE(streamed.min_value(), assigned.min_value());
+    QCOMPARE(streamed.max_value(), assigned.max_value());
+    QCOMPARE(streamed.p90(), assigned.p90());
+    QCOMPARE(streamed.min_max_value(true) == assigned.min_max_value(true), true);
+    QCOMPARE(streamed.first_nonzero(), assigned.first_nonzero());
+    QCOMPARE(streamed.max_time(), assigned.max_time());
+}
+
+
+QTEST_MAIN(TestQsummary)
+
+#include "test_live_source.moc"
@@ -0,0 +1,107 @@
+/*
+   Copyright 2022 Equinor ASA.
+
+   This file is part of the Open Porous Media project (OPM).
+
+   OPM is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   OPM is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#include <QtTest/QtTest>
+
+#include <appl/qsum_func_lib.hpp>
+#include <tests/qsum_test_utility.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+class TestQsummary: public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void test_remove_zero();
+};
+
+
+void TestQsummary::test_remove_zero()
+{
+    // series index and case index differ, derived series are kept
+
+    std::vector<std::string> fname_list;
+
+    fname_list.push_back("../tests/smry_files/SENS0.ESMRY");
+    fname_list.push_back("../tests/smry_files/SENS1.SMSPEC");
+
+    SmryAppl::loader_list_type loaders = QSum::make_loaders(fname_list);
+
+    auto& file_type = std::get<1>(loaders);
+    auto& esmry_loader = std::get<2>(loaders);
+    auto& lodsmry_loader = std::get<3>(loaders);
+
+    auto keyw_list = esmry_loader[1]->keywordList();
+
+    SmryAppl::input_list_type input_charts;
+
+    for (auto& key : keyw_list)
+        input_charts.push_back({ { {1, key, -1, false}, {0, key, -1, false} }, "" });
+
+    input_charts.push_back({ { {0, "DERIVED", -1, true} }, "" });
+
+    QSum::remove_zero_vect(std::get<0>(loaders), input_charts, file_type, esmry_loader, lodsmry_loader);
+
+    auto all_zero = [](const std::vector<float>& data) {
+        return std::all_of(data.begin(), data.end(), [](float v){ return !(std::abs(v) > 0.0); });
+    };
+
+    size_t num_series = 0;
+
+    for (auto& chart : input_charts)
+        for (auto& vect : std::get<0>(chart)) {
+
+            num_series++;
+
+            if ((std::get<3>(vect)) || (std::get<1>(vect) == "TIMESTEP"))
+                continue;
+
+            if (std::get<0>(vect) == 1)
+                QCOMPARE(all_zero(esmry_loader[1]->get(std::get<1>(vect))), false);
+            else
+                QCOMPARE(all_zero(lodsmry_loader[0]->get(std::get<1>(vect))), false);
+        }
+
+    // TIMESTEP kept if all steps are available, otherwise nonzero values
+
+    size_t num_nonzero = 1;
+
+    for (auto& key : keyw_list) {
+        bool steps = key == "TIMESTEP";
+
+        if ((steps && esmry_loader[1]->all_steps_available()) || (!all_zero(esmry_loader[1]->get(key))))
+            num_nonzero++;
+
+        if (!lodsmry_loader[0]->hasKey(key))
+            continue;
+
+        if ((steps && lodsmry_loader[0]->all_steps_available()) || (!all_zero(lodsmry_loader[0]->get(key))))
+            num_nonzero++;
+    }
+
+    QCOMPARE(num_series, num_nonzero);
+    QCOMPARE(std::get<3>(std::get<0>(input_charts.back())[0]), true);
+}
+
+
+QTEST_MAIN(TestQsummary)
+
+#include "test_remove_zero.moc"
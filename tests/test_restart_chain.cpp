@@ -0,0 +1,125 @@
+/*
+   Copyright 2022 Equinor ASA.
+
+   This file is part of the Open Porous Media project (OPM).
+
+   OPM is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   OPM is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#include <QtTest/QtTest>
+
+#include <appl/restart_chain.hpp>
+#include <tests/qsum_test_utility.hpp>
+
+#include <cmath>
+#include <numeric>
+
+#include <opm/io/eclipse/EclOutput.hpp>
+
+class TestQsummary: public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void test_restart_chain();
+};
+
+
+static void write_esmry(const std::filesystem::path& fname, const std::vector<std::string>& keys,
+                        const std::vector<std::vector<float>>& data, const std::string& restart = "")
+{
+    Opm::EclIO::EclOutput output(fname.string(), false, std::ios::out);
+
+    std::vector<std::string> units(keys.size(), "");
+    units[0] = "DAYS";
+
+    output.write<int>("START", { 1, 1, 2020, 0, 0, 0, 0 });
+
+    if (restart.size() > 0)
+        output.write<std::string>("RESTART", { restart });
+
+    output.write<std::string>("KEYCHECK", keys);
+    output.write<std::string>("UNITS", units);
+    output.write<int>("RSTEP", std::vector<int>(data[0].size(), 1));
+
+    std::vector<int> tstep(data[0].size());
+    std::iota(tstep.begin(), tstep.end(), 0);
+    output.write<int>("TSTEP", tstep);
+
+    for (size_t n = 0; n < keys.size(); n++)
+        output.write<float>("V" + std::to_string(n), data[n]);
+}
+
+void TestQsummary::test_restart_chain()
+{
+    QTemporaryDir tmp_dir;
+    QVERIFY(tmp_dir.isValid());
+
+    std::filesystem::path dir(tmp_dir.path().toStdString());
+
+    // base run 0 - 100 days, restart from day 50 with a new well
+
+    write_esmry(dir / "BASE.ESMRY", { "TIME", "FOPR" },
+                { { 0, 25, 50, 75, 100 }, { 1, 2, 3, 4, 5 } });
+
+    write_esmry(dir / "RST.ESMRY", { "TIME", "FOPR", "WOPR:PROD" },
+                { { 60, 70, 80 }, { 30, 40, 50 }, { 7, 8, 9 } }, "BASE");
+
+    auto chain = RestartChainSource::restart_chain(dir / "RST.ESMRY");
+
+    QCOMPARE(chain.size(), size_t(2));
+    QCOMPARE(chain[0].filename().string(), std::string("BASE.ESMRY"));
+    QCOMPARE(RestartChainSource::restart_chain(dir / "BASE.ESMRY").size(), size_t(1));
+
+    RestartSegmentPool pool;
+    RestartChainSource source(chain, pool);
+
+    QCOMPARE(source.number_of_segments(), size_t(2));
+    QCOMPARE(source.number_of_time_steps(), 6);
+    QCOMPARE(source.rootname(), std::string("RST"));
+
+    std::vector<float> time = { 0, 25, 50, 60, 70, 80 };
+    std::vector<float> fopr = { 1, 2, 3, 30, 40, 50 };
+
+    source.load({ "TIME", "FOPR", "WOPR:PROD" });
+
+    QCOMPARE(source.reopen(), false);
+    QCOMPARE(source.get("TIME"), time);
+    QCOMPARE(source.get("FOPR"), fopr);
+
+    auto wopr = source.get("WOPR:PROD");
+
+    QVERIFY(std::isnan(wopr[0]) && std::isnan(wopr[2]));
+    QCOMPARE(wopr[3], 7.0f);
+
+    // base run shared with a second restart case
+
+    write_esmry(dir / "RST2.ESMRY", { "TIME", "FOPR" }, { { 90, 110 }, { 60, 70 } }, "BASE");
+
+    RestartChainSource source2(RestartChainSource::restart_chain(dir / "RST2.ESMRY"), pool);
+
+    QCOMPARE(pool.size(), size_t(1));
+
+    // base run data loaded by the first chain is used by the second
+
+    QCOMPARE(source2.get("TIME").size(), size_t(6));
+    QCOMPARE(source2.get("FOPR")[0], 1.0f);
+    QCOMPARE(source2.get("FOPR")[4], 60.0f);
+    QCOMPARE(source.get("FOPR"), fopr);
+}
+
+
+QTEST_MAIN(TestQsummary)
+
+#include "test_restart_chain.moc"
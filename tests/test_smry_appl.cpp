@@ -29,6 +29,9 @@
 
 #include <chrono>
 #include <thread>
+#include <cmath>
+#include <fstream>
+#include <regex>
 
 
 class TestQsummary: public QObject
@@ -46,6 +49,14 @@ private slots:
     void test_reload_2();
     void test_reload_3();
     void test_scale_axis_ctrl_x();
+    void test_render_mode();
+    void test_series_data();
+    void test_pdf_export();
+    void test_autocomplete();
+    void test_lazy_charts();
+    void test_ensemble_chart();
+    void test_time_window();
+    void test_report_steps();
 };
 
 const int max_number_of_charts = 2000;
@@ -285,7 +296,7 @@ void TestQsummary::test_show_markers()
     QSum::chart_input_from_string(smry_vect, input_charts, file_type, esmry_loader, ext_smry_loader, max_number_of_charts, xrange_str);
 
     // make loaders for smryAppl
-    loaders = std::make_tuple(smry_files, file_type, std::move(esmry_loader), std::move(ext_smry_loader));
+    loaders = std::make_tuple(smry_files, file_type, std::move(esmry_loader), std::move(ext_smry_loader), source_list_type());
 
     // derived summary object for smryAP
     std::unique_ptr<DerivedSmry> derived_smry;
@@ -374,7 +385,7 @@ void TestQsummary::test_delete()
     QSum::chart_input_from_string(smry_vect, input_charts, file_type, esmry_loader, ext_smry_loader, max_number_of_charts, xrange_str);
 
     // make loaders for smryAppl
-    loaders = std::make_tuple(smry_files, file_type, std::move(esmry_loader), std::move(ext_smry_loader));
+    loaders = std::make_tuple(smry_files, file_type, std::move(esmry_loader), std::move(ext_smry_loader), source_list_type());
 
     // derived summary object for smryAP
     std::unique_ptr<DerivedSmry> derived_smry;
@@ -535,7 +546,7 @@ void TestQsummary::test_scale_axis_vect_opt()
     QSum::chart_input_from_string(smry_vect, input_charts, file_type, esmry_loader, ext_smry_loader, max_number_of_charts, xrange_str);
 
     // make loaders for smryAppl
-    loaders = std::make_tuple(smry_files, file_type, std::move(esmry_loader), std::move(ext_smry_loader));
+    loaders = std::make_tuple(smry_files, file_type, std::move(esmry_loader), std::move(ext_smry_loader), source_list_type());
 
     // derived summary object for smryAP
     std::unique_ptr<DerivedSmry> derived_smry;
@@ -640,7 +651,7 @@ void TestQsummary::test_scale_axis_ctrl_x()
     QSum::chart_input_from_string(smry_vect, input_charts, file_type, esmry_loader, ext_smry_loader, max_number_of_charts, xrange_str);
 
     // make loaders for smryAppl
-    loaders = std::make_tuple(smry_files, file_type, std::move(esmry_loader), std::move(ext_smry_loader));
+    loaders = std::make_tuple(smry_files, file_type, std::move(esmry_loader), std::move(ext_smry_loader), source_list_type());
 
     // derived summary object for smryAP
     std::unique_ptr<DerivedSmry> derived_smry;
@@ -703,7 +714,7 @@ void TestQsummary::test_scale_axis_interactive_1()
     //QSum::chart_input_from_string(smry_vect, input_charts, file_type, esmry_loader, ext_smry_loader, max_number_of_charts, xrange_str);
 
     // make loaders for smryAppl
-    loaders = std::make_tuple(smry_files, file_type, std::move(esmry_loader), std::move(ext_smry_loader));
+    loaders = std::make_tuple(smry_files, file_type, std::move(esmry_loader), std::move(ext_smry_loader), source_list_type());
 
     // derived summary object for smryAP
     std::unique_ptr<DerivedSmry> derived_smry;
@@ -817,7 +828,7 @@ void TestQsummary::test_scale_axis_interactive_2()
     //QSum::chart_input_from_string(smry_vect, input_charts, file_type, esmry_loader, ext_smry_loader, max_number_of_charts, xrange_str);
 
     // make loaders for smryAppl
-    loaders = std::make_tuple(smry_files, file_type, std::move(esmry_loader), std::move(ext_smry_loader));
+    loaders = std::make_tuple(smry_files, file_type, std::move(esmry_loader), std::move(ext_smry_loader), source_list_type());
 
     // derived summary object for smryAP
     std::unique_ptr<DerivedSmry> derived_smry;
@@ -943,7 +954,7 @@ void TestQsummary::test_reload_1()
     QSum::chart_input_from_string(smry_vect, input_charts, file_type, esmry_loader, ext_smry_loader, max_number_of_charts, xrange_str);
 
     // make loaders for smryAppl
-    loaders = std::make_tuple(smry_files, file_type, std::move(esmry_loader), std::move(ext_smry_loader));
+    loaders = std::make_tuple(smry_files, file_type, std::move(esmry_loader), std::move(ext_smry_loader), source_list_type());
 
     // derived summary object for smryAP
     std::unique_ptr<DerivedSmry> derived_smry;
@@ -1147,7 +1158,7 @@ void TestQsummary::test_reload_2()
     derived_smry = std::make_unique<DerivedSmry>(cmdfile, file_type, esmry_loader, ext_smry_loader);
 
     // make loaders for smryAppl
-    loaders = std::make_tuple(smry_files, file_type, std::move(esmry_loader), std::move(ext_smry_loader));
+    loaders = std::make_tuple(smry_files, file_type, std::move(esmry_loader), std::move(ext_smry_loader), source_list_type());
 
 
     SmryAppl window(fname_list, loaders, input_charts, derived_smry);
@@ -1304,7 +1315,7 @@ void TestQsummary::test_reload_3()
     derived_smry = std::make_unique<DerivedSmry>(cmdfile, file_type, esmry_loader, ext_smry_loader);
 
     // make loaders for smryAppl
-    loaders = std::make_tuple(smry_files, file_type, std::move(esmry_loader), std::move(ext_smry_loader));
+    loaders = std::make_tuple(smry_files, file_type, std::move(esmry_loader), std::move(ext_smry_loader), source_list_type());
 
 
     SmryAppl window(fname_list, loaders, input_charts, derived_smry);
@@ -1343,6 +1354,460 @@ void TestQsummary::test_reload_3()
 }
 
 
+void TestQsummary::test_render_mode()
+{
+    SmryAppl::input_list_type input_charts;
+
+    std::vector<std::string> fname_list;
+
+    fname_list.push_back("../tests/smry_files/SENS0.ESMRY");
+    fname_list.push_back("../tests/smry_files/SENS1.SMSPEC");
+
+    SmryAppl::loader_list_type loaders = QSum::make_loaders(fname_list);
+
+    std::unique_ptr<DerivedSmry> derived_smry;
+
+    SmryAppl window(fname_list, loaders, input_charts, derived_smry);
+
+    window.resize(1400, 700);
+
+    QLineEdit* cmdline = window.get_cmdline();
+
+    QSum::add_cmd_line("1FOPR", cmdline );
+    QSum::add_cmd_line("2FOPR", cmdline );
+
+    auto smry_series = window.get_smry_series(0);
+
+    // few data points, raster rendering in automatic mode
+
+    QCOMPARE(window.render_mode() == RenderMode::automatic, true);
+    QCOMPARE(window.opengl_active(0), false);
+    QCOMPARE(smry_series[0]->useOpenGL(), false);
+    QCOMPARE(smry_series[1]->useOpenGL(), false);
+
+    window.set_render_mode(RenderMode::opengl);
+
+    QCOMPARE(smry_series[0]->useOpenGL(), true);
+    QCOMPARE(smry_series[1]->useOpenGL(), true);
+
+    QSum::add_cmd_line(":gl", cmdline );
+
+    QCOMPARE(window.render_mode() == RenderMode::raster, true);
+    QCOMPARE(smry_series[0]->useOpenGL(), false);
+    QCOMPARE(smry_series[1]->useOpenGL(), false);
+
+    QSum::add_cmd_line(":gl", cmdline );
+
+    QCOMPARE(window.render_mode() == RenderMode::opengl, true);
+    QCOMPARE(smry_series[0]->useOpenGL(), true);
+
+    QSum::add_cmd_line(":gl auto", cmdline );
+
+    QCOMPARE(window.render_mode() == RenderMode::automatic, true);
+    QCOMPARE(smry_series[0]->useOpenGL(), false);
+    QCOMPARE(smry_series[1]->useOpenGL(), false);
+}
+
+
+void TestQsummary::test_series_data()
+{
+    SmryAppl::input_list_type input_charts;
+
+    std::vector<std::string> fname_list;
+
+    fname_list.push_back("../tests/smry_files/SENS0.ESMRY");
+
+    SmryAppl::loader_list_type loaders = QSum::make_loaders(fname_list);
+
+    std::unique_ptr<DerivedSmry> derived_smry;
+
+    SmryAppl window(fname_list, loaders, input_charts, derived_smry);
+
+    QLineEdit* cmdline = window.get_cmdline();
+
+    QSum::add_cmd_line("1FOPR", cmdline );
+
+    auto smry_series = window.get_smry_series(0);
+
+    const auto& data = smry_series[0]->data();
+    auto points = smry_series[0]->points();
+
+    QCOMPARE(data.size(), static_cast<size_t>(points.size()));
+
+    double min_val = std::numeric_limits<double>::max();
+    double max_val = -1.0*std::numeric_limits<double>::max();
+
+    for (size_t n = 0; n < data.size(); n++){
+        QCOMPARE(static_cast<double>(data.time()[n]), points[n].x());
+        QCOMPARE(data.values()[n], points[n].y());
+
+        min_val = std::min(min_val, points[n].y());
+        max_val = std::max(max_val, points[n].y());
+    }
+
+    QCOMPARE(data.min_value(), min_val);
+    QCOMPARE(data.max_value(), max_val);
+
+    // scaling updates values, statistics and Qt points
+
+    smry_series[0]->scale_values(2.0);
+
+    points = smry_series[0]->points();
+
+    QCOMPARE(data.max_value(), 2.0 * max_val);
+    QCOMPARE(points.back().y(), data.values().back());
+    QCOMPARE(std::get<1>(smry_series[0]->get_min_max_value()), 2.0 * max_val);
+}
+
+
+// number of page objects in pdf file, page tree nodes (/Type /Pages) not counted
+
+int count_pdf_pages(const std::filesystem::path& pdf_file)
+{
+    std::ifstream infile(pdf_file, std::ios::binary);
+    std::string content((std::istreambuf_iterator<char>(infile)), std::istreambuf_iterator<char>());
+
+    std::regex page_regex("/Type\\s*/Page[^s]");
+
+    return static_cast<int>(std::distance(std::sregex_iterator(content.begin(), content.end(), page_regex), std::sregex_iterator()));
+}
+
+void TestQsummary::test_pdf_export()
+{
+    SmryAppl::input_list_type input_charts;
+
+    std::vector<std::string> fname_list;
+
+    fname_list.push_back("../tests/smry_files/SENS0.ESMRY");
+    fname_list.push_back("../tests/smry_files/SENS1.SMSPEC");
+
+    SmryAppl::loader_list_type loaders = QSum::make_loaders(fname_list);
+
+    std::unique_ptr<DerivedSmry> derived_smry;
+
+    SmryAppl window(fname_list, loaders, input_charts, derived_smry);
+
+    window.resize(1400, 700);
+
+    QLineEdit* cmdline = window.get_cmdline();
+
+    QSum::add_cmd_line("1FOPR", cmdline );
+    QSum::add_cmd_line("2FOPR", cmdline );
+
+    QTest::keyEvent(QTest::Click, cmdline, Qt::Key_PageDown);
+
+    QSum::add_cmd_line("1FWCT", cmdline );
+
+    std::filesystem::path testf1("test_export_1.pdf");
+    std::filesystem::path testf2("test_export_2.pdf");
+
+    QSum::add_cmd_line(":pdf test_export_1.pdf", cmdline );
+    QSum::add_cmd_line(":pdf test_export_2.pdf 2 raster", cmdline );
+
+    QCOMPARE(std::filesystem::exists(testf1), true);
+    QCOMPARE(std::filesystem::exists(testf2), true);
+
+    QCOMPARE(std::filesystem::file_size(testf1) > 0, true);
+    QCOMPARE(std::filesystem::file_size(testf2) > 0, true);
+
+    QCOMPARE(count_pdf_pages(testf1), 2);
+    QCOMPARE(count_pdf_pages(testf2), 1);
+
+    // chart range before file name
+
+    std::filesystem::path testf4("test_export_4.pdf");
+
+    QSum::add_cmd_line(":pdf 2-2 test_export_4.pdf", cmdline );
+
+    QCOMPARE(std::filesystem::exists(testf4), true);
+    QCOMPARE(count_pdf_pages(testf4), 1);
+
+    // invalid chart range, no file written
+
+    std::filesystem::path testf3("test_export_3.pdf");
+
+    QSum::add_cmd_line(":pdf test_export_3.pdf 2-1", cmdline );
+
+    QCOMPARE(std::filesystem::exists(testf3), false);
+
+    std::filesystem::remove(testf1);
+    std::filesystem::remove(testf2);
+    std::filesystem::remove(testf4);
+}
+
+
+void TestQsummary::test_autocomplete()
+{
+    SmryAppl::input_list_type input_charts;
+
+    std::vector<std::string> fname_list;
+
+    fname_list.push_back("../tests/smry_files/SENS0.ESMRY");
+
+    SmryAppl::loader_list_type loaders = QSum::make_loaders(fname_list);
+
+    std::unique_ptr<DerivedSmry> derived_smry;
+
+    SmryAppl window(fname_list, loaders, input_charts, derived_smry);
+
+    QLineEdit* cmdline = window.get_cmdline();
+
+    // prefix match, first match in sorted order
+
+    QSum::add_cmd_line("1WOPR:P", cmdline );
+
+    auto smry_series = window.get_smry_series(0);
+
+    QCOMPARE(smry_series.size(), 1);
+    QCOMPARE(smry_series[0]->objectName().endsWith("WOPR:PROD-1"), true);
+
+    // no prefix match, fuzzy match on well name
+
+    QSum::add_cmd_line("1WOPR:P4", cmdline );
+
+    smry_series = window.get_smry_series(0);
+
+    QCOMPARE(smry_series.size(), 2);
+    QCOMPARE(smry_series[1]->objectName().endsWith("WOPR:PROD-4"), true);
+}
+
+
+void TestQsummary::test_lazy_charts()
+{
+    SmryAppl::input_list_type input_charts;
+
+    input_charts.push_back({ { {0, "FOPR", -1, false} }, "" });
+    input_charts.push_back({ { {0, "WOPR:PROD-1", -1, false} }, "" });
+    input_charts.push_back({ { {0, "WOPR:PROD-2", -1, false}, {0, "WOPR:PROD-3", -1, false} }, "" });
+
+    SmryAppl::chart_props_list_type chart_props;
+
+    chart_props.push_back({"FIELD", false, false, false});
+    chart_props.push_back({"WELLS", true, false, false});
+    chart_props.push_back({"WELLS", true, true, false});
+
+    std::vector<std::string> fname_list;
+
+    fname_list.push_back("../tests/smry_files/SENS0.ESMRY");
+
+    SmryAppl::loader_list_type loaders = QSum::make_loaders(fname_list);
+
+    std::unique_ptr<DerivedSmry> derived_smry;
+
+    SmryAppl window(fname_list, loaders, input_charts, derived_smry, chart_props);
+
+    QCOMPARE(window.number_of_charts(), 3);
+
+    QCOMPARE(window.number_of_series(0), 1);
+    QCOMPARE(window.number_of_series(1), 0);
+    QCOMPARE(window.number_of_series(2), 0);
+
+    QCOMPARE(window.is_lazy_pending(1), true);
+    QCOMPARE(std::get<2>(window.chart_props(2)), true);
+
+    QLineEdit* cmdline = window.get_cmdline();
+
+    // series added when chart is shown
+
+    QTest::keyEvent(QTest::Click, cmdline, Qt::Key_PageDown);
+
+    QCOMPARE(window.number_of_series(1), 1);
+    QCOMPARE(window.is_lazy_pending(1), false);
+    QCOMPARE(window.number_of_series(2), 0);
+
+    QTest::keyEvent(QTest::Click, cmdline, Qt::Key_End);
+
+    QCOMPARE(window.number_of_series(2), 2);
+}
+
+
+void TestQsummary::test_ensemble_chart()
+{
+    SmryAppl::input_list_type input_charts;
+
+    input_charts.push_back({ { {0, "FOPR", -1, false}, {1, "FOPR", -1, false}, {2, "FOPR", -1, false} }, "" });
+    input_charts.push_back({ { {0, "FGPR", -1, false} }, "" });
+
+    SmryAppl::chart_props_list_type chart_props;
+
+    chart_props.push_back({"", false, false, true});
+    chart_props.push_back({"", false, false, false});
+
+    std::vector<std::string> fname_list;
+
+    fname_list.push_back("../tests/smry_files/SENS0.ESMRY");
+    fname_list.push_back("../tests/smry_files/SENS1.ESMRY");
+    fname_list.push_back("../tests/smry_files/SENS2.ESMRY");
+
+    SmryAppl::loader_list_type loaders = QSum::make_loaders(fname_list);
+
+    std::unique_ptr<DerivedSmry> derived_smry;
+
+    SmryAppl window(fname_list, loaders, input_charts, derived_smry, chart_props);
+
+    QCOMPARE(window.number_of_charts(), 2);
+
+    QCOMPARE(window.is_ensemble_chart(0), true);
+    QCOMPARE(window.is_ensemble_chart(1), false);
+
+    // members in background, min, P10, P50, P90 and max as series
+
+    QCOMPARE(window.number_of_ens_members(0), 3);
+    QCOMPARE(window.number_of_series(0), 5);
+    QCOMPARE(window.number_of_series(1), 1);
+
+    const EnsembleData& ens_data = window.ensemble_data(0);
+
+    QCOMPARE(ens_data.number_of_members(), 3);
+    QCOMPARE(ens_data.time_grid().size() > 0, true);
+
+    auto p_values = ens_data.percentiles({0.0, 50.0, 100.0});
+
+    for (size_t t = 0; t < ens_data.time_grid().size(); t++) {
+        if (!std::isnan(p_values[1][t])) {
+            QCOMPARE(p_values[0][t] <= p_values[1][t], true);
+            QCOMPARE(p_values[1][t] <= p_values[2][t], true);
+        }
+    }
+
+    QCOMPARE(window.get_chart(0)->title().startsWith("FOPR"), true);
+
+    // members drawn as one item, one series for each member in lines mode
+
+    QCOMPARE(window.ensemble_mode() == EnsembleMode::band, true);
+    QCOMPARE(window.ensemble_band(0) != nullptr, true);
+
+    auto counts = ens_data.density(100, 50, ens_data.time_grid().front(), ens_data.time_grid().back(),
+                                   ens_data.min_value(), ens_data.max_value());
+
+    QCOMPARE(*std::max_element(counts.begin(), counts.end()) <= 3, true);
+    QCOMPARE(*std::max_element(counts.begin(), counts.end()) > 0, true);
+
+    window.set_ensemble_mode(EnsembleMode::lines);
+
+    QCOMPARE(window.ensemble_band(0) == nullptr, true);
+    QCOMPARE(window.number_of_ens_members(0), 3);
+    QCOMPARE(window.number_of_series(0), 5);
+
+    // delete removes the ensemble, chart left empty
+
+    QTest::keyEvent(QTest::Click, &window, Qt::Key_Delete);
+
+    QCOMPARE(window.is_ensemble_chart(0), false);
+    QCOMPARE(window.number_of_ens_members(0), 0);
+    QCOMPARE(window.number_of_series(0), 0);
+}
+
+
+void TestQsummary::test_time_window()
+{
+    SmryAppl::input_list_type input_charts;
+
+    input_charts.push_back({ { {0, "FOPR", -1, false} }, "" });
+    input_charts.push_back({ { {0, "FOPR", -1, false} }, "2002 2003" });
+
+    std::vector<std::string> fname_list;
+
+    fname_list.push_back("../tests/smry_files/NORNE_ATW2013.ESMRY");
+
+    SmryAppl::loader_list_type loaders = QSum::make_loaders(fname_list);
+
+    std::unique_ptr<DerivedSmry> derived_smry;
+
+    SmryAppl window(fname_list, loaders, input_charts, derived_smry);
+
+    QCOMPARE(window.number_of_charts(), 2);
+
+    SmrySeries* full = window.get_smry_series(0)[0];
+    SmrySeries* sliced = window.get_smry_series(1)[0];
+
+    QCOMPARE(full->is_sliced(), false);
+    QCOMPARE(sliced->is_sliced(), true);
+
+    // window is the x-range with one width added on each side
+
+    auto time_window = window.time_window(1);
+
+    QCOMPARE(sliced->data().min_time() <= time_window.first, true);
+    QCOMPARE(sliced->data().max_time() >= time_window.second, true);
+    QCOMPARE(sliced->data().size() < full->data().size(), true);
+
+    // full x-range from the extent of the vector, not from the sliced data
+
+    QCOMPARE(sliced->get_min_max_xrange() == full->get_min_max_xrange(), true);
+
+    // zoom out to full range, series extended
+
+    window.get_smry_xaxis(1)->resetAxisRange();
+
+    QCOMPARE(sliced->data().size(), full->data().size());
+    QCOMPARE(sliced->data().min_time(), full->data().min_time());
+    QCOMPARE(sliced->data().max_time(), full->data().max_time());
+
+    // :x command narrows the window again
+
+    window.grab();
+
+    QLineEdit* cmdline = window.get_cmdline();
+
+    QTest::keyEvent(QTest::Click, cmdline, Qt::Key_PageDown);
+    QSum::add_cmd_line(":x 2004 2005", cmdline);
+
+    QCOMPARE(sliced->data().size() < full->data().size(), true);
+}
+
+
+void TestQsummary::test_report_steps()
+{
+    SmryAppl::input_list_type input_charts;
+
+    input_charts.push_back({ { {0, "FOPR", -1, false} }, "" });
+    input_charts.push_back({ { {0, "FOPR", -1, false} }, "" });
+
+    std::vector<std::string> fname_list;
+
+    fname_list.push_back("../tests/smry_files/NORNE_ATW2013.ESMRY");
+
+    SmryAppl::loader_list_type loaders = QSum::make_loaders(fname_list);
+
+    std::unique_ptr<DerivedSmry> derived_smry;
+
+    SmryAppl window(fname_list, loaders, input_charts, derived_smry, {}, {}, true);
+
+    QCOMPARE(window.report_steps(0), true);
+    QCOMPARE(window.report_steps(1), true);
+
+    SmrySeries* chart_1 = window.get_smry_series(0)[0];
+    SmrySeries* chart_2 = window.get_smry_series(1)[0];
+
+    size_t rstep_size = chart_1->data().size();
+
+    QCOMPARE(rstep_size > 0, true);
+    QCOMPARE(chart_2->data().size(), rstep_size);
+
+    // second chart back to all time steps, x-range unchanged
+
+    window.grab();
+
+    QLineEdit* cmdline = window.get_cmdline();
+
+    QTest::keyEvent(QTest::Click, cmdline, Qt::Key_PageDown);
+    QSum::add_cmd_line(":rstep", cmdline);
+
+    QCOMPARE(window.report_steps(0), true);
+    QCOMPARE(window.report_steps(1), false);
+
+    QCOMPARE(chart_2->data().size() > rstep_size, true);
+    QCOMPARE(chart_1->data().size(), rstep_size);
+    QCOMPARE(chart_1->get_min_max_xrange() == chart_2->get_min_max_xrange(), true);
+
+    QSum::add_cmd_line(":rstep on", cmdline);
+
+    QCOMPARE(window.report_steps(1), true);
+    QCOMPARE(chart_2->data().size(), rstep_size);
+}
+
+
 QTEST_MAIN(TestQsummary)
 
 #include "test_smry_appl.moc"
@@ -0,0 +1,98 @@
+/*
+   Copyright 2022 Equinor ASA.
+
+   This file is part of the Open Porous Media project (OPM).
+
+   OPM is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   OPM is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#include <QtTest/QtTest>
+
+#include <appl/daemon_client.hpp>
+#include <appl/smry_daemon.hpp>
+#include <tests/qsum_test_utility.hpp>
+
+#include <future>
+
+#include <opm/io/eclipse/ESmry.hpp>
+
+class TestQsummary: public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void test_smry_daemon();
+};
+
+
+void TestQsummary::test_smry_daemon()
+{
+    SmryDaemon daemon("qsum_test_daemon");
+    QVERIFY(daemon.listen());
+
+    Opm::EclIO::ESmry esmry("../tests/smry_files/SENS0.SMSPEC");
+
+    // clients block while waiting for replies, the daemon needs the event loop
+
+    auto open_case = []() {
+        auto client = std::make_shared<SmryDaemonClient>("qsum_test_daemon");
+
+        if (!client->connect())
+            throw std::runtime_error("not connected");
+
+        DaemonSource source(client, "../tests/smry_files/SENS0.SMSPEC");
+        source.load({ "TIME", "FOPR" });
+
+        // error reply from the daemon, connection still usable
+
+        bool error_reply = false;
+
+        try {
+            client->load(0, { "NOT_A_KEY" });
+        } catch (const std::runtime_error&) {
+            error_reply = true;
+        }
+
+        return std::make_tuple(source.rootname(), source.keyword_list().size(), source.get("FOPR"),
+                               source.reopen(), error_reply, source.report_step_index());
+    };
+
+    for (int n = 0; n < 2; n++) {
+        auto result = std::async(std::launch::async, open_case);
+
+        QTRY_VERIFY(result.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+
+        auto [rootname, num_keys, fopr, updated, error_reply, rstep_index] = result.get();
+
+        QCOMPARE(rootname, esmry.rootname());
+        QCOMPARE(num_keys, esmry.keywordList().size());
+        QCOMPARE(fopr, esmry.get("FOPR"));
+        QCOMPARE(updated, false);
+        QCOMPARE(error_reply, true);
+
+        // report steps from the daemon, same as for the case opened directly
+        QCOMPARE(rstep_index == rstep_time_index(esmry.get("TIME"), esmry.get_at_rstep("TIME")), true);
+    }
+
+    // second client used the case opened by the first one
+    QCOMPARE(daemon.number_of_cases(), size_t(1));
+
+    SmryDaemonClient no_daemon("qsum_test_no_daemon");
+    QCOMPARE(no_daemon.connect(), false);
+}
+
+
+QTEST_MAIN(TestQsummary)
+
+#include "test_smry_daemon.moc"
@@ -0,0 +1,143 @@
+/*
+   Copyright 2022 Equinor ASA.
+
+   This file is part of the Open Porous Media project (OPM).
+
+   OPM is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   OPM is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#include <QtTest/QtTest>
+
+#include <appl/qsum_func_lib.hpp>
+#include <tests/qsum_test_utility.hpp>
+
+#include <limits>
+
+#include <opm/io/eclipse/ESmry.hpp>
+
+class TestQsummary: public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void test_smry_stats();
+};
+
+
+void TestQsummary::test_smry_stats()
+{
+    SmryStats stats = make_smry_stats({ 0.0, 0.0, 3.0, -1.0, 0.0, 5.0, 0.0 });
+
+    QCOMPARE(stats.min, -1.0f);
+    QCOMPARE(stats.max, 5.0f);
+    QCOMPARE(stats.first_nonzero, 2L);
+    QCOMPARE(stats.last_nonzero, 5L);
+    QCOMPARE(stats.all_zero, false);
+    QCOMPARE(stats.all_nonzero, false);
+    QCOMPARE(stats.size, size_t(7));
+
+    stats = make_smry_stats(std::vector<float>(10, 0.0));
+
+    QCOMPARE(stats.all_zero, true);
+    QCOMPARE(stats.first_nonzero, -1L);
+
+    // NaN for time steps without data is left out
+
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+
+    stats = make_smry_stats({ nan, 2.0, nan, -4.0 });
+
+    QCOMPARE(stats.has_nan, true);
+    QCOMPARE(stats.min, -4.0f);
+    QCOMPARE(stats.max, 2.0f);
+    QCOMPARE(stats.p90, 2.0f);
+    QCOMPARE(stats.first_nonzero, 1L);
+
+    // series data, all negative values and points appended
+
+    SeriesData data;
+    data.assign({ 0, 1, 2, 3 }, { -3.0, -1.0, 0.0, -2.0 });
+
+    QCOMPARE(data.max_value(), 0.0);
+    QCOMPARE(std::get<1>(data.min_max_value(true)), -1.0);
+    QCOMPARE(data.p90(), 0.0);
+
+    data.append({ 4 }, { 5.0 });
+
+    QCOMPARE(data.max_value(), 5.0);
+    QCOMPARE(data.min_value(), -3.0);
+    QCOMPARE(data.last_nonzero(), 4L);
+    QCOMPARE(data.max_time(), int64_t(4));
+    QCOMPARE(data.p90(), 5.0);
+
+    // stats from cache give the same series data as a pass over the values
+
+    std::vector<float> vect = { 0.0, 0.0, 1500.0, 300.0, 0.0 };
+
+    SeriesData ref_data;
+    ref_data.assign({ 0, 1, 2, 3, 4 }, { 0.0, 0.0, 1500.0f * 1e-3f, 300.0f * 1e-3f, 0.0 });
+
+    SeriesData cached_data;
+    cached_data.assign({ 0, 1, 2, 3, 4 }, { 0.0, 0.0, 1500.0f * 1e-3f, 300.0f * 1e-3f, 0.0 },
+                       make_smry_stats(vect), 1e-3f);
+
+    QCOMPARE(cached_data.min_value(), ref_data.min_value());
+    QCOMPARE(cached_data.max_value(), ref_data.max_value());
+    QCOMPARE(cached_data.p90(), ref_data.p90());
+    QCOMPARE(cached_data.min_max_value(true) == ref_data.min_max_value(true), true);
+    QCOMPARE(cached_data.first_nonzero(), ref_data.first_nonzero());
+    QCOMPARE(cached_data.last_nonzero(), ref_data.last_nonzero());
+    QCOMPARE(cached_data.all_nonzero(), ref_data.all_nonzero());
+
+    // remove_zero_vect gives same result with stats from cache
+
+    SmryAppl::loader_list_type loaders;
+    auto& file_type = std::get<1>(loaders);
+    auto& esmry_loader = std::get<2>(loaders);
+    auto& lodsmry_loader = std::get<3>(loaders);
+
+    file_type.push_back(FileType::SMSPEC);
+    esmry_loader[0] = std::make_unique<Opm::EclIO::ESmry>("../tests/smry_files/SENS1.SMSPEC");
+    std::get<0>(loaders).push_back("../tests/smry_files/SENS1.SMSPEC");
+
+    auto keyw_list = esmry_loader[0]->keywordList();
+
+    SmryAppl::input_list_type input_charts;
+
+    for (auto& key : keyw_list)
+        input_charts.push_back({ { {0, key, -1, false} }, "" });
+
+    auto ref_charts = input_charts;
+
+    QSum::remove_zero_vect(std::get<0>(loaders), ref_charts, file_type, esmry_loader, lodsmry_loader);
+
+    SmryStatsCache stats_cache(1);
+
+    QSum::pre_load_smry(std::get<0>(loaders), input_charts, file_type, esmry_loader, lodsmry_loader, 1,
+                        {}, {}, &stats_cache);
+
+    QVERIFY(stats_cache.find(0, keyw_list[0]) != nullptr);
+
+    QSum::remove_zero_vect(std::get<0>(loaders), input_charts, file_type, esmry_loader, lodsmry_loader, &stats_cache);
+
+    QCOMPARE(input_charts.size(), ref_charts.size());
+
+    for (size_t n = 0; n < input_charts.size(); n++)
+        QCOMPARE(std::get<1>(std::get<0>(input_charts[n])[0]), std::get<1>(std::get<0>(ref_charts[n])[0]));
+}
+
+
+QTEST_MAIN(TestQsummary)
+
+#include "test_smry_stats.moc"
@@ -0,0 +1,97 @@
+/*
+   Copyright 2022 Equinor ASA.
+
+   This file is part of the Open Porous Media project (OPM).
+
+   OPM is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   OPM is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#include <QtTest/QtTest>
+
+#include <appl/qsum_func_lib.hpp>
+#include <appl/live_source.hpp>
+#include <tests/qsum_test_utility.hpp>
+
+class TestQsummary: public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void test_summary_source();
+};
+
+
+void TestQsummary::test_summary_source()
+{
+    // same case as ESMRY and SMSPEC, sources must give the same result
+
+    std::vector<std::string> fname_list;
+
+    fname_list.push_back("../tests/smry_files/SENS0.ESMRY");
+    fname_list.push_back("../tests/smry_files/SENS0.SMSPEC");
+
+    SmryAppl::loader_list_type loaders = QSum::make_loaders(fname_list);
+
+    auto sources = make_summary_sources(std::get<1>(loaders), std::get<2>(loaders), std::get<3>(loaders),
+                                        std::get<0>(loaders));
+
+    QCOMPARE(sources.size(), size_t(2));
+    QCOMPARE(sources[0]->file_type() == FileType::ESMRY, true);
+    QCOMPARE(sources[1]->file_type() == FileType::SMSPEC, true);
+
+    QCOMPARE(sources[0]->start_date() == sources[1]->start_date(), true);
+    QCOMPARE(sources[0]->startdate() == sources[1]->startdate(), true);
+    QCOMPARE(sources[0]->keyword_list() == sources[1]->keyword_list(), true);
+
+    for (auto& source : sources)
+        source->load({"TIME", "FOPR", "FOPT"});
+
+    for (auto key : {"TIME", "FOPR", "FOPT"}) {
+        SmrySpan span0 = sources[0]->get_span(key);
+        SmrySpan span1 = sources[1]->get_span(key);
+
+        QCOMPARE(span0.size, span1.size);
+        QCOMPARE(std::equal(span0.begin(), span0.end(), span1.begin()), true);
+        QCOMPARE(span1.data, sources[1]->get(key).data());
+    }
+
+    QCOMPARE(sources[0]->get_unit("FOPR"), sources[1]->get_unit("FOPR"));
+
+    // files not modified, nothing to reopen
+
+    QCOMPARE(sources[0]->has_changed(), false);
+    QCOMPARE(sources[1]->reopen(), false);
+
+    // sources opened by the caller are kept, REMOTE and RESTART cases are not opened from the loader maps
+
+    source_list_type opened_sources(3);
+    opened_sources[2] = std::make_unique<LiveSource>("LIVE");
+
+    const SummarySource* live = opened_sources[2].get();
+
+    auto all_sources = make_summary_sources({ FileType::ESMRY, FileType::SMSPEC, FileType::LIVE }, std::get<2>(loaders),
+                                            std::get<3>(loaders), std::get<0>(loaders), std::move(opened_sources));
+
+    QCOMPARE(all_sources.size(), size_t(3));
+    QCOMPARE(all_sources[2].get() == live, true);
+    QCOMPARE(all_sources[0]->rootname(), sources[0]->rootname());
+
+    QVERIFY_THROWS_EXCEPTION(std::invalid_argument,
+                             make_summary_sources({ FileType::REMOTE }, std::get<2>(loaders), std::get<3>(loaders)));
+}
+
+
+QTEST_MAIN(TestQsummary)
+
+#include "test_summary_source.moc"
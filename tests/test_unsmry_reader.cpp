@@ -0,0 +1,95 @@
+/*
+   Copyright 2022 Equinor ASA.
+
+   This file is part of the Open Porous Media project (OPM).
+
+   OPM is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   OPM is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#include <QtTest/QtTest>
+
+#include <appl/unsmry_reader.hpp>
+#include <tests/qsum_test_utility.hpp>
+
+#include <opm/io/eclipse/ESmry.hpp>
+
+class TestQsummary: public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void test_unsmry_reader();
+};
+
+
+void TestQsummary::test_unsmry_reader()
+{
+    // all columns found in smspec index must be equal to data from ESmry
+
+    Opm::EclIO::ESmry smry("../tests/smry_files/SENS1.SMSPEC");
+    smry.loadData();
+
+    auto index = make_smspec_index("../tests/smry_files/SENS1.SMSPEC");
+
+    UnsmryReader reader("../tests/smry_files/SENS1.UNSMRY");
+
+    QCOMPARE(reader.number_of_time_steps(), smry.get("TIME").size());
+
+    std::vector<std::string> keys;
+    std::vector<int> columns;
+
+    for (auto& entry : index) {
+        QCOMPARE(smry.hasKey(entry.first), true);
+
+        keys.push_back(entry.first);
+        columns.push_back(entry.second);
+    }
+
+    QVERIFY(keys.size() > 100);
+
+    auto data = reader.get(columns);
+
+    for (size_t n = 0; n < keys.size(); n++)
+        QCOMPARE(data[n] == smry.get(keys[n]), true);
+
+    QCOMPARE(reader.get(index.at("FOPT")) == smry.get("FOPT"), true);
+
+    // last time step in each report step, same as from TIME at report steps in ESmry
+
+    auto esmry_loader = std::make_unique<Opm::EclIO::ESmry>("../tests/smry_files/SENS1.SMSPEC");
+    ESmrySource esmry_source(esmry_loader, "../tests/smry_files/SENS1.SMSPEC");
+
+    QCOMPARE(reader.report_step_index() == esmry_source.report_step_index(), true);
+
+    // source for unified case, keys in smspec index from reader and other keys from loader
+
+    auto unsmry_loader = std::make_unique<Opm::EclIO::ESmry>("../tests/smry_files/SENS1.SMSPEC");
+    UnsmrySource unsmry_source(unsmry_loader, "../tests/smry_files/SENS1.SMSPEC");
+
+    auto all_keys = smry.keywordList();
+    unsmry_source.load(all_keys);
+
+    for (auto& key : all_keys)
+        QCOMPARE(unsmry_source.get(key) == smry.get(key), true);
+
+    QCOMPARE(unsmry_source.report_step_index() == esmry_source.report_step_index(), true);
+    QCOMPARE(unsmry_source.reopen(), false);
+
+    QCOMPARE(last_step_index({ true, false, true, true, false }) == std::vector<size_t>({ 1, 2, 4 }), true);
+}
+
+
+QTEST_MAIN(TestQsummary)
+
+#include "test_unsmry_reader.moc"